@@ -0,0 +1,115 @@
+/*! \file
+ *  \brief Declares class ArrowheadSolver
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Linear algebra through a LinAlgBackend
+ *
+ */
+
+#ifndef __ARROWHEADSOLVER_H
+#define __ARROWHEADSOLVER_H
+
+#include <vector>
+
+#include <gsl/gsl_vector.h>
+#include <gsl/gsl_matrix.h>
+
+class LinAlgBackend;
+
+//  Class ArrowheadSolver
+/// Solves linear systems with block arrowhead structure
+/**
+ * In a vertex fit, the parameters and constraints of each track
+ * couple only among themselves and to the shared vertex parameters.
+ * After suitable reordering, the matrix M of the linear system
+ * M*x = y then has "block arrowhead" structure: square diagonal blocks
+ * A_i (one per track), which couple to the shared rows s through
+ * B_i = M[i,s], and no elements between different blocks:
+ *
+ *     | A_1         B_1 |
+ *     |     A_2     B_2 |
+ *     |         ... ... |
+ *     | B_1^T B_2^T ... C |
+ *
+ * Such a system is solved by eliminating each block independently,
+ * S = C - sum B_i^T A_i^-1 B_i, r = y_s - sum B_i^T A_i^-1 y_i,
+ * solving S*x_s = r and back substituting x_i = A_i^-1 (y_i - B_i x_s).
+ * The cost is linear in the number of blocks, instead of cubic in the
+ * total dimension for a dense LU decomposition.
+ *
+ * The structure is found by analyse from the nonzero elements of M,
+ * given the indices of the rows known to be shared (e.g. the vertex
+ * parameters). The blocks are the connected components of the
+ * remaining rows; as long as a block is larger than maxblocksize,
+ * its most strongly coupled row (e.g. the Lagrange multiplier of a
+ * momentum constraint that involves all tracks) is made shared as well.
+ *
+ * M need not be symmetric, but its pattern must be.
+ *
+ * The LU decompositions and the BLAS operations go through a LinAlgBackend,
+ * by default LinAlgBackend::getDefault(); NewFitterGSL sets its own.
+ *
+ */
+class ArrowheadSolver {
+  public:
+    /// Constructor
+    ArrowheadSolver (int maxblocksize_ = 32   ///< Maximum size of a block
+                    );
+    /// Virtual destructor
+    virtual ~ArrowheadSolver();
+
+    /// Set the linear algebra backend; it must live as long as it is used
+    virtual void setLinAlgBackend (const LinAlgBackend& linalg_);
+    /// The linear algebra backend
+    virtual const LinAlgBackend& getLinAlgBackend() const;
+
+    /// Find the block structure of M; false if it has no useful arrowhead structure
+    virtual bool analyse (const gsl_matrix *M,             ///< The matrix
+                          const std::vector<int>& shared   ///< Indices of rows known to be shared
+                         );
+    /// Solve M*x = y with the structure found by the last analyse; 0 if successful
+    virtual int solve (      gsl_vector *x,      ///< The solution
+                             double& det,        ///< The determinant of M
+                       const gsl_matrix *M,      ///< The matrix
+                       const gsl_vector *y       ///< The right hand side
+                      );
+
+    /// Number of blocks found by the last analyse
+    virtual int getNBlocks() const;
+    /// Number of shared rows found by the last analyse
+    virtual int getNShared() const;
+    /// Size of the largest block found by the last analyse
+    virtual int getMaxBlockSize() const;
+
+  protected:
+    /// Copy constructor disabled
+    ArrowheadSolver (const ArrowheadSolver& rhs);
+    /// Assignment disabled
+    ArrowheadSolver& operator= (const ArrowheadSolver& rhs);
+
+    /// Find the representative of i (union find)
+    int findRoot (int i);
+    /// Find the blocks of the rows with status 0
+    void findBlocks (const gsl_matrix *M);
+
+    const LinAlgBackend *linalg;   ///< Linear algebra backend, not owned
+    int maxblocksize;              ///< Maximum size of a block
+    int largestblock;              ///< Size of the largest block
+    std::vector<int> sharedrows;   ///< Indices of the shared rows
+    std::vector<int> blockrows;    ///< Indices of the block rows, ordered by block
+    std::vector<int> blockstart;   ///< Block ib consists of blockrows[blockstart[ib]...blockstart[ib+1]-1]
+    std::vector<int> parent;       ///< Work array for union find
+    std::vector<int> status;       ///< Work array: 0 for block rows, 1 for given, 2 for additional shared rows
+    std::vector<int> degree;       ///< Work array: number of coupled rows
+
+    std::vector<double> A;         ///< Work space for the current block A_i, LU decomposed
+    std::vector<double> BT;        ///< Work space for B_i^T = M[s,i]
+    std::vector<double> Z;         ///< A_i^-1 B_i for all blocks
+    std::vector<double> z;         ///< A_i^-1 y_i for all blocks
+    std::vector<double> S;         ///< Schur complement
+    std::vector<double> r;         ///< Right hand side, then solution of the reduced system
+    std::vector<size_t> perm;      ///< Work space for permutations
+};
+
+#endif // __ARROWHEADSOLVER_H
@@ -13,6 +13,8 @@
 #include "BaseFitObject.h"
 #include "BaseFitter.h"
 
+class CounterRandom;
+
 // class BaseEvent
 /// Abstract base class for different kinds of events
 /**
@@ -30,12 +32,30 @@
 
 class BaseEvent  {
   public: 
+    BaseEvent(): random (0) {};
     virtual ~BaseEvent() {};
     /// provides four-momenta (i.e. read values from ntuple, run toy MC, ...)
     virtual void genEvent() = 0;
     /// do it!
     virtual int fitEvent (BaseFitter& fitter) = 0;
-  
+    
+    /// Return a new event with the same settings (not the same content), 0 if not possible
+    virtual BaseEvent *copy() const {return 0;};
+    
+    /// Use random in genEvent instead of a global generator; 0: global generator
+    virtual void setRandom (CounterRandom *random_) {random = random_;};
+    /// Get the generator set with setRandom
+    virtual CounterRandom *getRandom() const {return random;};
+    
+    /// Number of fit objects for comparisons of start and fitted values
+    virtual int getNFitObjects() const {return 0;};
+    /// Fit object i before the fit
+    virtual BaseFitObject* getStartFitObject (int i) {return 0;};
+    /// Fit object i after the fit
+    virtual BaseFitObject* getFittedFitObject (int i) {return 0;};
+    
+  protected:
+    CounterRandom *random;  ///< Generator for genEvent, not owned
 };
 
 
@@ -126,6 +126,10 @@ class BaseFitObject {
     virtual BaseFitObject *copy() const = 0;
     
     /// Assign from anther object, if of same type
+    /** A valid inverse covariance matrix of the source is taken over,
+     *  so that objects restored from a prepared copy need not invert
+     *  their covariance matrix again (see precompute).
+     */
     virtual BaseFitObject& assign (const BaseFitObject& source   ///< The source object
                                   );
     
@@ -259,6 +263,13 @@ class BaseFitObject {
     /// invalidate any cached quantities
     virtual void invalidateCache() const {cachevalid=false;};
     virtual void updateCache() const=0;
+    /// Calculate the inverse covariance matrix and the cache, if they are not valid
+    /** These quantities do not depend on the constraints; 
+     *  if an object is prepared once and then used as source of assign
+     *  for every fit (e.g. of the permutations of a jet pairing),
+     *  they need not be recalculated at the start of each fit.
+     */
+    virtual void precompute() const;
 
     // these are the mothods that fill the fitter's matrices/vectors
 
@@ -43,17 +43,35 @@
 
 #include<vector>
 #include<string>
-#include<map>
+#include<chrono>
+
+#include "TraceValues.h"
 
 class BaseFitObject;
 class BaseConstraint;
 class BaseHardConstraint;
 class BaseSoftConstraint;
 class BaseTracer;
+class FitProfile;
+class LinAlgBackend;
+class StartValueSeeder;
 
 //  Class BaseConstraint:
 /// Abstract base class for fitting engines of kinematic fits
 /**
+ *
+ * The work of a fit can be limited with setBudget, e.g. for a bound 
+ * on the latency in online use. When the budget is exhausted, the fit
+ * stops and the fit objects are left at the best iterate so far 
+ * (the one with the smallest chi2 of those that fulfill the hard constraints
+ * to 0.01 standard deviations, or the one with the smallest constraint violation);
+ * getError() then returns BUDGETEXHAUSTED, and getConstraintViolation()
+ * tells how well the constraints are fulfilled.
+ * Fitters that obey the budget return true from supportsBudget();
+ * so far, these are NewFitterGSL and CompositeFitter.
+ *
+ * With setSeeder, analytic start values for unmeasured neutrinos and
+ * ISR photons are set at the start of each fit, see StartValueSeeder.
  *
  * Author: Jenny List, Benno List
  * Last update: $Date: 2011/03/03 15:03:02 $
@@ -62,6 +80,9 @@ class BaseTracer;
  */
 class BaseFitter {
   public:
+    /// Error code of a fit that was stopped because the budget was exhausted; the result is usable
+    enum {BUDGETEXHAUSTED = -2};
+    
     BaseFitter();
     virtual ~BaseFitter();
     virtual void addFitObject (BaseFitObject* fitobject_);
@@ -84,6 +105,10 @@ class BaseFitter {
   
     virtual void reset();
     virtual bool initialize() = 0;
+    /// Whether the fitter can handle soft constraints
+    virtual bool supportsSoftConstraints() const;
+    /// Whether the fitter obeys the budget set with setBudget; default: false
+    virtual bool supportsBudget() const;
     
     virtual BaseTracer *getTracer();
     virtual const BaseTracer *getTracer() const;
@@ -91,6 +116,33 @@ class BaseFitter {
                           );
     virtual void setTracer(BaseTracer& newTracer
                           );
+    /// Attach a FitProfile that records time per phase and fallback counts; 0: none
+    virtual void setProfile (FitProfile *profile_);
+    /// The attached FitProfile, 0 if none
+    virtual FitProfile *getProfile() const;
+    
+    /// Limit the work of each fit; 0: no limit
+    virtual void setBudget (double seconds,       ///< Wall time per fit, in seconds
+                            int evaluations = 0   ///< Number of evaluations (parameter updates) per fit
+                           );
+    /// Wall time limit per fit in seconds, 0 if none
+    virtual double getBudgetSeconds() const;
+    /// Evaluation limit per fit, 0 if none
+    virtual int getBudgetEvaluations() const;
+    /// Number of evaluations of the last fit
+    virtual int getEvaluations() const;
+    /// Largest |value|/error of the hard constraints at the current parameter values
+    virtual double getConstraintViolation() const;
+    
+    /// Set the linear algebra backend; default: LinAlgBackend::getDefault() at construction
+    virtual void setLinAlgBackend (const LinAlgBackend& linalg_);
+    /// The linear algebra backend
+    virtual const LinAlgBackend& getLinAlgBackend() const;
+    
+    /// Set a StartValueSeeder, called at the start of each fit; 0: none
+    virtual void setSeeder (const StartValueSeeder *seeder_);
+    /// The StartValueSeeder, 0 if none
+    virtual const StartValueSeeder *getSeeder() const;
     
     virtual const double *getGlobalCovarianceMatrix (int& idim ///< 1st dimension of global covariance matrix
                                                           ) const;                 
@@ -104,6 +156,19 @@ class BaseFitter {
     BaseFitter& operator= (const BaseFitter& rhs);
     
     
+    /// Start the clock and evaluation count of the budget; call at the start of fit()
+    void startBudget();
+    /// Count an evaluation, i.e. an update of the parameters of the fit objects
+    void countEvaluation() {++nevaluations;};
+    /// Whether a budget is set
+    bool hasBudget() const {return budgetseconds > 0 || budgetevaluations > 0;};
+    /// Whether the budget of the current fit is exhausted
+    bool budgetExhausted() const;
+    /// Whether an iterate with chi2 and constraint violation viol is better than the best one so far
+    static bool isBetterIterate (double chi2, double viol, double chi2best, double violbest);
+    /// Let the seeder, if any, set the start values; call at the start of fit()
+    void seedStartValues();
+    
     typedef std::vector <BaseFitObject *> FitObjectContainer;
     typedef std::vector <BaseHardConstraint *> ConstraintContainer;
     typedef std::vector <BaseSoftConstraint *> SoftConstraintContainer;
@@ -119,13 +184,23 @@ class BaseFitter {
     int     covDim;   ///< dimension of global covariance matrix
     double *cov;      ///< global covariance matrix of last fit problem
     bool    covValid; ///< Flag whether global covariance is valid
+    
+    FitProfile *profile;  ///< Profile, not owned; 0 if not profiled
+    const LinAlgBackend *linalg;  ///< Linear algebra backend, not owned
+    const StartValueSeeder *seeder;  ///< Start value seeder, not owned; 0 if none
+    
+    double budgetseconds;     ///< Wall time limit per fit in seconds, 0: none
+    int    budgetevaluations; ///< Evaluation limit per fit, 0: none
+    int    nevaluations;      ///< Evaluations of the current fit
+    std::chrono::steady_clock::time_point budgetstart;  ///< Start time of the current fit
 
 #ifndef FIT_TRACEOFF    
     BaseTracer *tracer;
 #endif 
   public:  
 #ifndef FIT_TRACEOFF    
-    std::map<std::string, double> traceValues;
+    /// Values for the tracer, see TraceValues; set by NewFitterGSL whether or not a tracer is attached
+    TraceValues traceValues;
 #endif 
 
 };
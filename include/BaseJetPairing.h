@@ -39,6 +39,8 @@ class BaseJetPairing {
     
     // getters
     virtual int getNPerm() const = 0;
+    /// Number of jets in each permutation
+    virtual int getNJets() const = 0;
     
     // does the job
     virtual int nextPermutation (JetFitObject *permObjects[]) = 0;
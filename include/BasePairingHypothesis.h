@@ -0,0 +1,67 @@
+/*! \file
+ *  \brief Declares class BasePairingHypothesis
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Added getChi2Bound for pruning of permutations
+ * - 18.10.2026 Recommend replaceFO for reattaching the constraints
+ *
+ */
+
+#ifndef __BASEPAIRINGHYPOTHESIS_H
+#define __BASEPAIRINGHYPOTHESIS_H
+
+#include <vector>
+
+class JetFitObject;
+class BaseFitter;
+class BaseHardConstraint;
+
+//  Class BasePairingHypothesis
+/// Abstract base class for the fit of one jet pairing hypothesis
+/**
+ * A BasePairingHypothesis knows how to fit the jets of one permutation,
+ * as delivered by BaseJetPairing::nextPermutation:
+ * it owns the constraints (and the fitter) of the event hypothesis,
+ * attaches the permuted jets to the constraints and runs the fit.
+ *
+ * The PairingFitDriver fits several permutations concurrently;
+ * it calls copy() once per thread, so a derived class must
+ * not share any constraint or fitter between copies.
+ * Rather than calling resetFOList and addToFOList for every permutation,
+ * fitPermutation should build the constraints once and reattach the 
+ * permuted jets with ParticleConstraint::replaceFO.
+ *
+ * For pruning of hopeless permutations, getChi2Bound may return
+ * a cheap estimate of the lowest chi2 the fit can reach.
+ * A convenient choice is maxConstraintPull2, evaluated for the hard
+ * constraints with the permuted jets attached, but before the fit:
+ * for a single constraint, (value/error)^2 is the chi2 of the linearised
+ * fit to that constraint alone, and adding more constraints can only
+ * increase the chi2.
+ *
+ */
+class BasePairingHypothesis {
+  public:
+    virtual ~BasePairingHypothesis() {};
+
+    /// Return a new, independent copy of itself
+    virtual BasePairingHypothesis *copy() const = 0;
+
+    /// Attach the jets to the constraints and fit them; returns the fit probability
+    virtual double fitPermutation (JetFitObject *permObjects[]  ///< The permuted jets
+                                  ) = 0;
+
+    /// The fitter used in fitPermutation
+    virtual BaseFitter& getFitter() = 0;
+
+    /// Estimate a lower bound of the chi2 of the fit of this permutation; 0: no estimate
+    virtual double getChi2Bound (JetFitObject *permObjects[]  ///< The permuted, unfitted jets
+                                ) {return 0;};
+
+    /// Largest squared pull (value/error)^2 of the constraints at the current parameter values
+    static double maxConstraintPull2 (const std::vector<BaseHardConstraint *>& constraints  ///< The hard constraints
+                                     );
+};
+
+#endif // __BASEPAIRINGHYPOTHESIS_H
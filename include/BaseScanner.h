@@ -0,0 +1,110 @@
+/*! \file
+ *  \brief Declares class BaseScanner
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Split scan into prepareScan and restoreFitObjects for adaptive scans
+ *
+ */
+
+#ifndef __BASESCANNER_H
+#define __BASESCANNER_H
+
+#include <vector>
+
+#include "ThreadPool.h"
+#include "ScanResult.h"
+
+class BaseFitter;
+class BaseFitObject;
+class BaseHardConstraint;
+
+//  Class BaseScanner
+/// Abstract base class for scans of a fit problem over a grid of two parameters
+/**
+ * For each point of the grid, all parameters are set to their values
+ * at the start of the scan, except the two scanned parameters,
+ * and scanPoint evaluates the point and stores the result in a ScanResult.
+ *
+ * The grid is processed on a ThreadPool, one column (ix) per work item.
+ * Every thread needs its own fitter, with its own fit objects and
+ * constraints, set up for the same fit problem (i.e. with the same
+ * parameter numbering); a scanner constructed with a single fitter
+ * runs serially. The result does not depend on the number of threads.
+ *
+ * At the end of scan, the fit objects of all fitters are restored
+ * to their state at the start of the scan.
+ *
+ */
+class BaseScanner: protected ParallelTask {
+  public:
+    /// Constructor for a serial scan
+    BaseScanner (BaseFitter& fitter_          ///< The fitter
+                );
+    /// Constructor for a parallel scan
+    BaseScanner (const std::vector<BaseFitter *>& fitters_  ///< One fitter per thread, not owned
+                );
+    /// Virtual destructor
+    virtual ~BaseScanner();
+
+    /// Scan parameters xglobal and yglobal; false if the parameters do not exist
+    virtual bool scan (int xglobal,
+                       int nx,
+                       double xstart,
+                       double xstop,
+                       int yglobal,
+                       int ny,
+                       double ystart,
+                       double ystop);
+
+    /// The result of the last scan
+    virtual const ScanResult& getResult() const;
+    /// Number of threads used
+    virtual int getNThreads() const;
+
+  protected:
+    /// Copy constructor disabled
+    BaseScanner (const BaseScanner& rhs);
+    /// Assignment disabled
+    BaseScanner& operator= (const BaseScanner& rhs);
+
+    typedef std::vector <BaseFitObject *> FitObjectContainer;
+    typedef std::vector <BaseHardConstraint *> ConstraintContainer;
+
+    typedef FitObjectContainer::iterator FitObjectIterator;
+    typedef ConstraintContainer::iterator ConstraintIterator;
+
+    /// Evaluate all points of column itask
+    virtual void execute (int itask, int ithread);
+
+    /// Evaluate point (ix, iy) with the fitter of thread ithread and store the result
+    virtual void scanPoint (int ix, int iy, int ithread) = 0;
+    /// Called before the grid is processed, after the start values have been saved
+    virtual void startScan();
+    /// Called after the grid has been processed, before the start values are restored
+    virtual void endScan();
+
+    /// Initialize the fitters, set the grid, save the start values; false if the parameters do not exist
+    bool prepareScan (int xglobal, int nx, double xstart, double xstop,
+                      int yglobal, int ny, double ystart, double ystop);
+    /// Restore the fit objects of all fitters to the state saved by prepareScan
+    void restoreFitObjects();
+
+    /// Set the parameters of the fitter of thread ithread to the values of point (ix, iy)
+    void setParameters (int ix, int iy, int ithread);
+    /// Set the parameters of the fitter of thread ithread to the start values, with x and y
+    void setParameters (double x, double y, int ithread);
+    /// Get the current value of global parameter iglobal from the fitter of thread ithread
+    double getParameter (int iglobal, int ithread) const;
+
+    ThreadPool pool;                   ///< The worker threads
+    std::vector<BaseFitter *> fitters; ///< One fitter per thread
+    /// Copies of the fit objects at the start of the scan, per thread
+    std::vector<FitObjectContainer> fitobjects_backup;
+    int idim;                          ///< Number of global parameters
+    std::vector<double> parsave;       ///< Parameter values at the start of the scan
+    std::vector<std::vector<double> > par;   ///< Work space per thread
+    ScanResult result;                 ///< The result
+};
+
+#endif // __BASESCANNER_H
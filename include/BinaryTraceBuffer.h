@@ -0,0 +1,117 @@
+/*! \file
+ *  \brief Declares class BinaryTraceBuffer and struct BinaryTraceRecord
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#ifndef __BINARYTRACEBUFFER_H
+#define __BINARYTRACEBUFFER_H
+
+#include <cstdint>
+#include <atomic>
+
+//  Struct BinaryTraceRecord
+/// Fixed-layout record of one tracer call, as stored in a BinaryTraceBuffer
+struct BinaryTraceRecord {
+  enum {NPARMAX = 48};                            ///< Maximum number of stored parameters
+  enum {INITIALIZE = 0, STEP, SUBSTEP, FINISH};   ///< Values of type
+
+  uint64_t sequence;   ///< Record number + 1 if the record is complete, 0 otherwise
+  int64_t  eventid;    ///< Event number, as set in the tracer
+  int64_t  fitid;      ///< Number of the fit within the tracer
+  int32_t  tracerid;   ///< Number of the tracer
+  int32_t  type;       ///< Tracer call: INITIALIZE, STEP, SUBSTEP or FINISH
+  int32_t  flag;       ///< Flag of substep
+  int32_t  iteration;  ///< Fitter iteration
+  int32_t  error;      ///< Fitter error code
+  int32_t  npar;       ///< Number of valid entries of par
+  double   chi2;       ///< Current chi2
+  double   alpha;      ///< Trace value alpha (step length)
+  double   phi;        ///< Trace value phi (merit function)
+  double   mu;         ///< Trace value mu (penalty parameter)
+  double   detW;       ///< Trace value detW
+  double   par[NPARMAX];  ///< Current fit parameters, in the order of the fit objects
+};
+
+//  Class BinaryTraceBuffer
+/// Ring buffer of BinaryTraceRecord objects, optionally memory mapped to a file
+/**
+ * Records are appended without locks: each append reserves the next record
+ * number with an atomic increment and writes to slot number % capacity,
+ * so several BinaryTracer objects (e.g. one per thread) may share one buffer.
+ * When the buffer is full, the oldest records are overwritten.
+ *
+ * If a file name is given, the buffer is a shared memory mapping of that
+ * file; the operating system writes it to disk, also if the program crashes,
+ * so the last records before a crash are preserved.
+ * The file is read by a BinaryTraceReader.
+ *
+ * A writer claims a slot by atomically setting its sequence to 0,
+ * and marks the record complete by writing its sequence number last;
+ * a reader that runs while records are written checks it before and
+ * after copying a record. If a writer finds its slot still claimed
+ * by another writer (which can only happen when the buffer wraps around
+ * within one append), the record is dropped and counted rather than waiting.
+ *
+ */
+class BinaryTraceBuffer {
+  public:
+    /// File header, followed by capacity records
+    struct Header {
+      char magic[8];                ///< "KFTRACE"
+      uint32_t version;             ///< Layout version
+      uint32_t recordsize;          ///< sizeof (BinaryTraceRecord)
+      uint64_t capacity;            ///< Number of record slots
+      std::atomic<uint64_t> next;   ///< Number of records appended so far
+      std::atomic<uint64_t> ndropped;   ///< Number of records dropped because their slot was busy
+    };
+
+    /// Constructor
+    BinaryTraceBuffer (const char *filename = 0,   ///< File to map, 0: memory only
+                       long capacity_ = 65536      ///< Number of record slots
+                      );
+    /// Virtual destructor, unmaps the buffer
+    virtual ~BinaryTraceBuffer();
+
+    /// False if the file could not be created or mapped
+    virtual bool isValid() const;
+    /// Number of record slots
+    virtual long getCapacity() const;
+    /// Number of records appended so far (including overwritten ones)
+    virtual uint64_t getNRecords() const;
+    /// Number of records dropped because their slot was being written
+    virtual uint64_t getNDropped() const;
+
+    /// Append a copy of record; only the first record.npar parameters are copied
+    void append (const BinaryTraceRecord& record);
+
+    /// Copy record number seq to record; false if it is not available (anymore)
+    bool getRecord (uint64_t seq, BinaryTraceRecord& record) const;
+
+    /// Check magic, version and sizes of a header
+    static bool checkHeader (const Header& header);
+    /// Copy record number seq from the slots of a buffer; false if it is not available
+    static bool readRecord (const Header& header,             ///< The header of the buffer
+                            const BinaryTraceRecord *slots,   ///< The record slots
+                            uint64_t seq,                     ///< The record number
+                            BinaryTraceRecord& record         ///< The copy
+                           );
+    enum {VERSION = 1};
+
+  protected:
+    /// Copy constructor disabled
+    BinaryTraceBuffer (const BinaryTraceBuffer& rhs);
+    /// Assignment disabled
+    BinaryTraceBuffer& operator= (const BinaryTraceBuffer& rhs);
+
+    int fd;                       ///< File descriptor, -1 if memory only
+    void *mapping;                ///< Start of the mapped memory
+    unsigned long mapsize;        ///< Size of the mapped memory
+    Header *header;               ///< The header
+    BinaryTraceRecord *records;   ///< The record slots
+    uint64_t capacity;            ///< Number of slots
+};
+
+#endif // __BINARYTRACEBUFFER_H
@@ -0,0 +1,70 @@
+/*! \file
+ *  \brief Declares class BinaryTraceReader
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#ifndef __BINARYTRACEREADER_H
+#define __BINARYTRACEREADER_H
+
+#include <iostream>
+#include <cstdint>
+
+#include "BinaryTraceBuffer.h"
+
+#ifdef MARLIN_USE_ROOT
+class TTree;
+#endif
+
+//  Class BinaryTraceReader
+/// Reads a trace file written through a BinaryTraceBuffer
+/**
+ * The file is mapped read only; it may be read after the writing program
+ * has finished or crashed, or while it is still running.
+ * Only the last getCapacity() records are available.
+ *
+ * writeCSV writes one line per record; with ROOT, createTree
+ * fills the records into a TTree with one entry per record.
+ *
+ */
+class BinaryTraceReader {
+  public:
+    /// Constructor
+    BinaryTraceReader (const char *filename   ///< The trace file
+                      );
+    /// Virtual destructor, unmaps the file
+    virtual ~BinaryTraceReader();
+
+    /// False if the file could not be mapped or has a wrong header
+    virtual bool isValid() const;
+    /// Number of record slots of the file
+    virtual long getCapacity() const;
+    /// Number of records written so far (including overwritten ones)
+    virtual uint64_t getNRecords() const;
+    /// Number of the oldest record that is still available
+    virtual uint64_t getFirstRecord() const;
+    /// Copy record number seq to record; false if it is not available
+    virtual bool getRecord (uint64_t seq, BinaryTraceRecord& record) const;
+
+    /// Write all available records as comma separated values; returns the number of records
+    virtual long writeCSV (std::ostream& os) const;
+#ifdef MARLIN_USE_ROOT
+    /// Create a TTree (in the current directory) from all available records
+    virtual TTree *createTree (const char *name = "trace") const;
+#endif
+
+  protected:
+    /// Copy constructor disabled
+    BinaryTraceReader (const BinaryTraceReader& rhs);
+    /// Assignment disabled
+    BinaryTraceReader& operator= (const BinaryTraceReader& rhs);
+
+    void *mapping;                        ///< Start of the mapped memory
+    unsigned long mapsize;                ///< Size of the mapped memory
+    const BinaryTraceBuffer::Header *header;   ///< The header, 0 if invalid
+    const BinaryTraceRecord *records;     ///< The record slots
+};
+
+#endif // __BINARYTRACEREADER_H
@@ -0,0 +1,87 @@
+/*! \file
+ *  \brief Declares class BinaryTracer
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Added fillRecord and replay for TriggeredTracer
+ *
+ */
+
+#ifndef __BINARYTRACER_H
+#define __BINARYTRACER_H
+
+#include <cstdint>
+
+#include "BaseTracer.h"
+#include "BinaryTraceBuffer.h"
+
+//  Class BinaryTracer
+/// Tracer that writes fixed-size binary records to a BinaryTraceBuffer
+/**
+ * Each call of initialize, step, substep and finish appends one
+ * BinaryTraceRecord with the iteration, error code, chi2, the standard
+ * trace values and the current parameters of the fit objects.
+ * No text is formatted and no memory is allocated during the fit,
+ * so the tracer can stay enabled in production running.
+ *
+ * One BinaryTracer should be used per fitter (i.e. per thread);
+ * several tracers may write to the same buffer, distinguished by their
+ * tracer id. The records are converted to text or a TTree by a BinaryTraceReader.
+ *
+ */
+class BinaryTracer: public BaseTracer {
+  public:
+    /// Constructor
+    BinaryTracer (BinaryTraceBuffer& buffer_,  ///< The buffer, not owned
+                  int tracerid_ = 0            ///< Number stored in all records
+                 );
+    /// Virtual destructor
+    virtual ~BinaryTracer();
+
+    /// Called at the start of a new fit (during initialization)
+    virtual void initialize (BaseFitter& fitter);
+    /// Called at the end of each step
+    virtual void step (BaseFitter& fitter);
+    /// Called at intermediate points during a step
+    virtual void substep (BaseFitter& fitter,
+                          int flag
+                          );
+    /// Called at the end of a fit
+    virtual void finish (BaseFitter& fitter);
+
+    /// Set the event number stored in the following records
+    virtual void setEventId (int64_t eventid_);
+    /// Get the event number stored in the records
+    virtual int64_t getEventId() const;
+
+    /// Write a record filled earlier (e.g. by a TriggeredTracer), then call the next tracer
+    virtual void replay (BaseFitter& fitter,              ///< The fitter, as passed on to the next tracer
+                         const BinaryTraceRecord& record  ///< The record, including its chi2 and iteration
+                        );
+
+    /// Fill fitter state, trace values and parameters into record; ids are not touched
+    static void fillRecord (BaseFitter& fitter,           ///< The fitter
+                            int type,                     ///< The record type
+                            int flag,                     ///< The substep flag
+                            BinaryTraceRecord& r          ///< The record
+                           );
+
+  protected:
+    /// Copy constructor disabled
+    BinaryTracer (const BinaryTracer& rhs);
+    /// Assignment disabled
+    BinaryTracer& operator= (const BinaryTracer& rhs);
+
+    /// Fill record from the fitter and append it to the buffer
+    void write (BaseFitter& fitter, int type, int flag);
+    /// Set the ids of r and append it to the buffer; a new fit starts at type INITIALIZE
+    void writeRecord (const BinaryTraceRecord& r);
+
+    BinaryTraceBuffer& buffer;   ///< The buffer
+    int tracerid;                ///< The tracer id
+    int64_t eventid;             ///< The current event number
+    int64_t fitid;               ///< Number of the current fit, incremented in initialize
+    BinaryTraceRecord record;    ///< Record being filled
+};
+
+#endif // __BINARYTRACER_H
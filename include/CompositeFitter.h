@@ -0,0 +1,159 @@
+/*! \file
+ *  \brief Declares class CompositeFitter
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Seed the start values before the first engine
+ * - 18.10.2026 With a budget, try only engines that obey it
+ *
+ */
+
+#ifndef __COMPOSITEFITTER_H
+#define __COMPOSITEFITTER_H
+
+#include "BaseFitter.h"
+
+#include <vector>
+#include <map>
+#include <string>
+#include <iostream>
+
+//  Class CompositeFitter
+/// A fitter that tries a chain of fit engines until one succeeds
+/**
+ * The CompositeFitter is set up like any other fitter (addFitObject,
+ * addConstraint, ...) and passes the problem on to its engines:
+ * the engines work on the same fit objects and constraints,
+ * no copies are made.
+ * The engines are tried in turn until one returns getError()==0
+ * (or BUDGETEXHAUSTED); engines that cannot handle the problem
+ * (e.g. OPALFitterGSL if there are soft constraints, see
+ * BaseFitter::supportsSoftConstraints) are skipped.
+ * If a budget is set (setBudget), only engines that obey it
+ * (BaseFitter::supportsBudget) are tried, so that the budget
+ * bounds the time of the whole fit; with the default chain,
+ * these are the two NewFitterGSL engines.
+ * Before a fallback engine starts, the parameters and covariance
+ * matrices of the fit objects are reset to their values before the fit;
+ * if the budget is exhausted before, no further engine starts, and the
+ * fit objects keep the result of the last engine.
+ * The result (parameters, errors, chi2, probability, covariance matrix)
+ * is that of the last engine that was tried;
+ * getEngine returns it, getIterations counts the iterations of all engines.
+ *
+ * The default engines, cheapest first, are OPALFitterGSL, NewFitterGSL,
+ * NewFitterGSL with trust region, and NewtonFitterGSL;
+ * clearEngines and addEngine set up a different chain.
+ *
+ * For every topology (see FitProfileMap::getTopology) and engine, the
+ * number of attempts, of successes and the time spent are recorded.
+ * With adaptive ordering (setAdaptive), the engines with at least nmin
+ * attempts in a topology are ordered among themselves by time per attempt
+ * divided by success rate, which minimises the expected time per fit
+ * if failures are independent; engines with fewer attempts keep
+ * their place in the chain.
+ * Since fallback engines only see the events the others failed on,
+ * their success rate is rather underestimated.
+ *
+ * Tracer, profile, linear algebra backend and the remaining budget are 
+ * passed on to each engine before it starts; the profile thus counts
+ * every attempt as a fit. A seeder (setSeeder) is not passed on:
+ * the start values are seeded once, before the first engine.
+ *
+ */
+class CompositeFitter : public BaseFitter {
+  public:
+    /// Statistics of one engine in one topology
+    struct EngineStats {
+      EngineStats();
+      long   nattempts;   ///< Number of fits tried
+      long   nsuccess;    ///< Number of fits with getError()==0
+      double seconds;     ///< Total wall time of the fits
+    };
+
+    /// Constructor, sets up the default engines
+    CompositeFitter();
+    /// Virtual destructor, deletes the default engines
+    virtual ~CompositeFitter();
+
+    /// The fit method, returns the fit probability
+    virtual double fit();
+    /// Get the error code of the last fit, from the last engine that was tried; 1 if no engine is capable
+    virtual int getError() const;
+    /// Get the fit probability of the last fit
+    virtual double getProbability() const;
+    /// Get the chi**2 of the last fit
+    virtual double getChi2() const;
+    /// Get the number of degrees of freedom of the last fit
+    virtual int    getDoF() const;
+    /// Get the number of iterations of the last fit, summed over all engines
+    virtual int    getIterations() const;
+    /// Does nothing: the engines initialize themselves
+    virtual bool initialize();
+    /// Whether any of the engines can handle soft constraints
+    virtual bool supportsSoftConstraints() const;
+    /// Whether any of the engines obeys the budget
+    virtual bool supportsBudget() const;
+
+    /// Remove all engines
+    virtual void clearEngines();
+    /// Append an engine to the chain; it is not owned, and must not be used otherwise meanwhile
+    virtual void addEngine (BaseFitter& engine);
+    /// Number of engines
+    virtual int getNEngines() const;
+    /// Engine iengine
+    virtual BaseFitter *getEngine (int iengine) const;
+    /// The engine that produced the result of the last fit, 0 if none
+    virtual BaseFitter *getEngine() const;
+    /// Number of engines tried in the last fit
+    virtual int getNAttempts() const;
+
+    /// Switch adaptive ordering of the engines on or off
+    virtual void setAdaptive (bool on,        ///< Adaptive ordering on/off
+                              int nmin_ = 20  ///< Attempts needed before an engine is reordered
+                             );
+    /// The statistics of engine iengine in a topology; all 0 if there are none
+    virtual EngineStats getStatistics (const std::string& topology, int iengine) const;
+    /// Reset the statistics
+    virtual void clearStatistics();
+    /// Print the statistics per topology and engine
+    virtual void printStatistics (std::ostream& os) const;
+
+  protected:
+    /// Copy constructor disabled
+    CompositeFitter (const CompositeFitter& rhs);
+    /// Assignment disabled
+    CompositeFitter& operator= (const CompositeFitter& rhs);
+
+    /// Whether engine iengine can handle the current problem
+    bool isCapable (int iengine) const;
+    /// Fill order with the engines to try, in that order
+    void selectOrder (const std::vector<EngineStats>& stats);
+    /// Store the parameters and covariance matrices of the fit objects
+    void saveStart();
+    /// Reset the parameters and covariance matrices of the fit objects to the stored values
+    void restoreStart();
+    /// Hand the current problem and settings to engine; false if the budget is exhausted
+    bool setupEngine (BaseFitter& engine);
+
+    typedef std::map<std::string, std::vector<EngineStats> > StatsMap;
+
+    std::vector<BaseFitter *> engines;        ///< The engines, in the order of the chain
+    std::vector<BaseFitter *> ownedengines;   ///< The default engines, owned
+    std::vector<int> order;                   ///< The engines to try in the current fit
+    std::vector<double> startvalues;          ///< Parameters and covariances before the fit
+
+    bool adaptive;          ///< Adaptive ordering on/off
+    int nmin;               ///< Attempts needed before an engine is reordered
+    StatsMap statistics;    ///< Statistics per topology
+
+    BaseFitter *lastengine; ///< Engine of the last result, 0 if none
+    int nattempts;          ///< Number of engines tried in the last fit
+    int ierr;               ///< Error code of the last fit; 1 if no engine could do it
+    int nit;                ///< Number of iterations of all engines in the last fit
+    double fitprob;         ///< Fit probability of the last fit
+    double chi2;            ///< chi2 of the last fit
+    int dof;                ///< Degrees of freedom of the last fit
+};
+
+#endif // __COMPOSITEFITTER_H
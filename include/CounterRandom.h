@@ -0,0 +1,68 @@
+/*! \file
+ *  \brief Declares class CounterRandom
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#ifndef __COUNTERRANDOM_H
+#define __COUNTERRANDOM_H
+
+#include <cstdint>
+
+//  Class CounterRandom:
+/// Counter-based random number generator with independent streams
+/**
+ * The random numbers are calculated as a function of a seed, a stream number
+ * and the position within the stream (Philox4x32-10, Salmon et al.,
+ * "Parallel random numbers: as easy as 1, 2, 3", SC11).
+ * There is no state other than these three numbers, so
+ * setStream gives immediate access to any stream,
+ * e.g. one stream per toy event. The numbers of an event
+ * then depend only on the seed and the event number,
+ * not on the thread or the order in which the events are generated.
+ *
+ * The interface follows the corresponding methods of ROOT's TRandom.
+ *
+ */
+class CounterRandom {
+  public:
+    /// Constructor
+    CounterRandom (uint64_t seed_ = 0  ///< The seed, common to all streams
+                  );
+    /// Virtual destructor
+    virtual ~CounterRandom() {};
+
+    /// Set the seed and restart stream 0
+    virtual void setSeed (uint64_t seed_);
+    /// Get the seed
+    virtual uint64_t getSeed() const;
+    /// Restart at the beginning of stream stream_
+    virtual void setStream (uint64_t stream_);
+    /// Get the current stream number
+    virtual uint64_t getStream() const;
+
+    /// Uniform random number in ]0, 1[
+    virtual double Rndm();
+    /// Fill array with n uniform random numbers in ]0, 1[
+    virtual void RndmArray (int n,          ///< Number of random numbers
+                            double *array   ///< The array to fill
+                           );
+    /// Gaussian random number
+    virtual double Gaus (double mean = 0,   ///< Mean
+                         double sigma = 1   ///< Standard deviation
+                        );
+
+  protected:
+    /// Calculate the next block of 4 32-bit words
+    void nextBlock();
+
+    uint64_t seed;      ///< The key
+    uint64_t stream;    ///< The stream number
+    uint64_t counter;   ///< Number of blocks used in the stream
+    uint32_t block[4];  ///< The current block
+    int nused;          ///< Number of 64-bit halves of block used (0..2)
+};
+
+#endif // __COUNTERRANDOM_H
@@ -24,6 +24,7 @@ class DijetEventILC : public BaseEvent {
     virtual ~DijetEventILC();
     virtual void genEvent();
     virtual int fitEvent (BaseFitter& fitter);
+    virtual DijetEventILC *copy() const;
     
     MomentumConstraint& getPxConstraint() {return pxc;};
     MomentumConstraint& getPyConstraint() {return pyc;};
@@ -34,14 +35,24 @@ class DijetEventILC : public BaseEvent {
     void setDebug (bool _debug) {debug = _debug;};
     
     ParticleFitObject* getTrueFitObject (int i) {return bfo[i];};
-    ParticleFitObject* getStartFitObject (int i) {return bfostart[i];};
-    ParticleFitObject* getFittedFitObject (int i) {return bfosmear[i];};
+    virtual int getNFitObjects() const {return NBFO;};
+    virtual ParticleFitObject* getStartFitObject (int i) {return bfostart[i];};
+    virtual ParticleFitObject* getFittedFitObject (int i) {return bfosmear[i];};
     FourVector* getTrueFourVector (int i) {return fv[i];};
     
     bool leptonic, leptonasjet, debug;
     
   protected:
   
+    /// Delete the four-vectors and fit objects of the previous event
+    void clearEvent();
+    /// n uniform random numbers, from random if set, else from the global generator
+    void getRandoms (int n, double r[]);
+    /// Gaussian random number, from random if set, else from the global generator
+    double getGaus();
+    /// Isotropic decay of mother into d1 and d2
+    void decay (const FourVector& mother, FourVector& d1, FourVector& d2);
+    
     enum {NFV = 3, NBFO = 2};
     FourVector *fv[NFV];
     FourVector *fvsmear[NFV];
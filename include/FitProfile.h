@@ -0,0 +1,370 @@
+/*! \file
+ *  \brief Declares classes FitProfile, FitProfileTimer and FitProfileFitCounter
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Added hardware performance counters, per class attribution
+ *              and FitProfileMap
+ * - 18.10.2026 Added counter SOLVEARROWHEAD
+ * - 18.10.2026 Added counter COVFACTORREUSED
+ * - 18.10.2026 Added counter EIGENREFINED
+ * - 18.10.2026 Added counter SOLVENULLSPACE
+ * - 18.10.2026 Added counter BUDGETEXHAUSTED
+ * - 18.10.2026 Added FitProfileFitCounter
+ *
+ */
+
+#ifndef __FITPROFILE_H
+#define __FITPROFILE_H
+
+#include <iostream>
+#include <cstdint>
+#include <chrono>
+#include <map>
+#include <string>
+#include <typeinfo>
+#include <typeindex>
+#include <thread>
+
+#include "PerfCounterGroup.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+class BaseFitter;
+
+//  Class FitProfile
+/// Time per fit phase and counts of numerical fallbacks of a fitter
+/**
+ * A FitProfile is attached to a fitter with BaseFitter::setProfile;
+ * without a profile the fitters do not measure anything.
+ * Times are measured in ticks of the time stamp counter (CPU cycles,
+ * on x86) or in nanoseconds (elsewhere); for every phase, the number
+ * of calls, the total number of ticks and a histogram of log2(ticks) 
+ * per call are kept.
+ *
+ * A FitProfile is not thread safe: every thread (i.e. every fitter
+ * of a PairingFitDriver, ToyMCDriver, ...) needs its own profile.
+ * The profiles of all threads are merged with add and printed with print.
+ *
+ * Phases may be nested: the line search phase includes the
+ * 2nd order correction, for example.
+ *
+ * With setHardwareCounters(true), every timed phase also reads a
+ * PerfCounterGroup (cycles, instructions, cache misses, branch misses).
+ * The counter group is opened on first use by the thread that runs
+ * the fit, and reopened if the profile moves to another thread.
+ * Each reading is a system call (about a microsecond), so this is
+ * meant for dedicated profiling runs.
+ *
+ * With setObjectProfiling(true), fitters additionally attribute time
+ * (and counts, if enabled) of the assembly phases to the classes of the
+ * individual fit objects and constraints, e.g. JetFitObject or PConstraint;
+ * this measures every single call and is therefore slower still.
+ *
+ */
+class FitProfile {
+  public:
+    /// The fit phases
+    enum {INITIALIZE,          ///< BaseFitter::initialize
+          ASSEMBLEM,           ///< Setting up the matrix of the linear system
+          ASSEMBLEY,           ///< Setting up the right hand side
+          SOLVESYSTEM,         ///< Solving the linear system
+          LINESEARCH,          ///< Step length determination (calcLimitedDx, optimizeScale, step cutting)
+          SECONDORDERCORR,     ///< 2nd order correction
+          DETERMINELAMBDAS,    ///< Least squares estimate of the Lagrange multipliers
+          COVMATRIX,           ///< Calculation of the covariance matrix
+          NPHASES};
+    /// The counters
+    enum {FITS,                ///< Number of fits
+          FAILEDFITS,          ///< Number of fits with getError() != 0, except BaseFitter::BUDGETEXHAUSTED
+          BUDGETEXHAUSTED,     ///< Number of fits stopped because the budget was exhausted
+          ITERATIONS,          ///< Number of iterations
+          SOLVELU,             ///< Linear systems solved by LU decomposition
+          SOLVEARROWHEAD,      ///< Linear systems solved by an ArrowheadSolver
+          SOLVENULLSPACE,      ///< Linear systems solved in the null space of the constraints
+          SOLVESVD,            ///< Linear systems that needed the SVD (or eigenvalue) fallback
+          SOLVEFAILED,         ///< Linear systems that could not be solved
+          CHOLESKYFAILED,      ///< Failed Cholesky decompositions
+          COVFACTORREUSED,     ///< Iterations that reused the decomposition of the covariance matrix
+          EIGENREFINED,        ///< Eigenvalue decompositions obtained by refining the previous one
+          SECONDORDERTRIED,    ///< 2nd order corrections tried
+          SECONDORDEROK,       ///< 2nd order corrections accepted
+          PTLPRETRIES,         ///< Recalculations of the Newton step because of negative p^T L p
+          STEPCUTS,            ///< Reductions of the step length
+          NCOUNTERS};
+    enum {NBINS = 48};         ///< Number of histogram bins; bin i: 2^i <= ticks < 2^(i+1)
+
+    /// Statistics of one phase of one class of fit objects or constraints
+    struct ObjectStats {
+      ObjectStats();
+      long ncalls;                                    ///< Number of calls
+      uint64_t ticks;                                 ///< Total ticks
+      long ncounted;                                  ///< Number of calls with hardware counts
+      uint64_t events[PerfCounterGroup::NEVENTS];     ///< Total hardware counts
+    };
+    /// Key of the per class statistics: phase and class
+    typedef std::pair<int, std::type_index> ObjectKey;
+
+    /// Constructor, all counters zero, hardware counters and object profiling off
+    FitProfile();
+    /// Virtual destructor
+    virtual ~FitProfile();
+
+    /// Switch reading of hardware performance counters on or off
+    virtual void setHardwareCounters (bool on);
+    /// Switch attribution to fit object and constraint classes on or off
+    virtual void setObjectProfiling (bool on);
+    /// Whether hardware counters are switched on
+    bool hasHardwareCounters() const {return hardwarecounters;};
+    /// Whether object profiling is switched on
+    bool isObjectProfiling() const {return objectprofiling;};
+    /// Read the hardware counters if they are switched on and available; false otherwise
+    bool readCounters (uint64_t values[PerfCounterGroup::NEVENTS]) {
+      return hardwarecounters && readCountersSlow (values);
+    };
+
+    /// Current value of the tick counter
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+      return __rdtsc();
+#else
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    };
+    /// Approximate number of ticks per second (measured once)
+    static double getTicksPerSecond();
+
+    /// Add one call of a phase that took ticks
+    void addTime (int phase, uint64_t ticks);
+    /// Add the hardware counts end-start of one call of a phase
+    void addEvents (int phase, const uint64_t *start, const uint64_t *end);
+    /// Add one call of an object of class type in a phase, with hardware counts if start and end are given
+    void addObject (int phase, const std::type_info& type, uint64_t ticks, 
+                    const uint64_t *start = 0, const uint64_t *end = 0);
+    /// Increase a counter
+    void count (int counter, long n = 1) {counters[counter] += n;};
+
+    /// Reset everything
+    void clear();
+    /// Add the contents of rhs (e.g. the profile of another thread)
+    void add (const FitProfile& rhs);
+
+    /// Number of calls of a phase
+    long getNCalls (int phase) const {return ncalls[phase];};
+    /// Total number of ticks of a phase
+    uint64_t getTicks (int phase) const {return ticks[phase];};
+    /// Number of calls of a phase in histogram bin ibin
+    long getHist (int phase, int ibin) const {return hist[phase][ibin];};
+    /// Value of a counter
+    long getCount (int counter) const {return counters[counter];};
+    /// Number of calls of a phase with hardware counts
+    long getNCounted (int phase) const {return ncounted[phase];};
+    /// Total hardware count of event ievent (see PerfCounterGroup) in a phase
+    uint64_t getEvents (int phase, int ievent) const {return events[phase][ievent];};
+    /// The statistics per phase and class
+    const std::map<ObjectKey, ObjectStats>& getObjectStats() const {return objectstats;};
+
+    /// Name of a phase
+    static const char *getPhaseName (int phase);
+    /// Name of a counter
+    static const char *getCounterName (int counter);
+
+    /// Readable (demangled) name of a class
+    static std::string getClassName (const std::type_index& type);
+
+    /// Print a summary of the phases and counters, and of hardware counts and classes if any
+    void print (std::ostream& os) const;
+    /// Print the histograms of the phases
+    void printHistograms (std::ostream& os) const;
+
+  protected:
+    /// Copy constructor disabled
+    FitProfile (const FitProfile& rhs);
+    /// Assignment disabled
+    FitProfile& operator= (const FitProfile& rhs);
+
+    /// Open the counter group for the calling thread if necessary and read it
+    bool readCountersSlow (uint64_t values[PerfCounterGroup::NEVENTS]);
+
+    long ncalls[NPHASES];           ///< Number of calls per phase
+    uint64_t ticks[NPHASES];        ///< Total ticks per phase
+    long hist[NPHASES][NBINS];      ///< Histogram of log2(ticks) per phase
+    long counters[NCOUNTERS];       ///< The counters
+    long ncounted[NPHASES];         ///< Number of calls per phase with hardware counts
+    uint64_t events[NPHASES][PerfCounterGroup::NEVENTS];   ///< Hardware counts per phase
+    std::map<ObjectKey, ObjectStats> objectstats;          ///< Statistics per phase and class
+
+    bool hardwarecounters;          ///< Hardware counters switched on
+    bool objectprofiling;           ///< Object profiling switched on
+    PerfCounterGroup *perf;         ///< Counter group, owned; 0 until first use
+    std::thread::id perfthread;     ///< Thread that opened perf
+};
+
+//  Class FitProfileTimer
+/// Measures the time of a fit phase from construction until stop or destruction
+/**
+ * Does nothing if the profile is 0.
+ * Reads the hardware counters as well if they are switched on in the profile.
+ */
+class FitProfileTimer {
+  public:
+    /// Constructor, starts the measurement
+    FitProfileTimer (FitProfile *profile_,   ///< The profile, may be 0
+                     int phase_              ///< The phase
+                    )
+    : profile (profile_), phase (phase_), start (0), counting (false)
+    {
+      if (!profile) return;
+      counting = profile->readCounters (startevents);
+      start = FitProfile::now();
+    };
+    /// Destructor, stops the measurement
+    ~FitProfileTimer() {stop();};
+    /// Stop the measurement and add it to the profile; further calls do nothing
+    void stop() {
+      if (!profile) return;
+      profile->addTime (phase, FitProfile::now() - start);
+      uint64_t endevents[PerfCounterGroup::NEVENTS];
+      if (counting && profile->readCounters (endevents)) profile->addEvents (phase, startevents, endevents);
+      profile = 0;
+    };
+
+  protected:
+    FitProfile *profile;   ///< The profile
+    int phase;             ///< The phase
+    uint64_t start;        ///< Tick counter at the start
+    bool counting;         ///< Whether startevents is valid
+    uint64_t startevents[PerfCounterGroup::NEVENTS];  ///< Hardware counts at the start
+};
+
+//  Class FitProfileFitCounter
+/// Counts a fit in a FitProfile when it goes out of scope
+/**
+ * Counts FITS, ITERATIONS and, for a nonzero error code, FAILEDFITS
+ * with the values that error code and number of iterations have
+ * at destruction, i.e. on every return from fit().
+ */
+class FitProfileFitCounter {
+  public:
+    /// Constructor
+    FitProfileFitCounter (FitProfile *profile_,   ///< The profile, may be 0
+                          const int& ierr_,       ///< The error code of the fitter
+                          const int& nit_         ///< The number of iterations of the fitter
+                         )
+    : profile (profile_), ierr (ierr_), nit (nit_)
+    {};
+    /// Destructor, counts the fit
+    ~FitProfileFitCounter() {
+      if (!profile) return;
+      profile->count (FitProfile::FITS);
+      profile->count (FitProfile::ITERATIONS, nit);
+      if (ierr) profile->count (FitProfile::FAILEDFITS);
+    };
+
+  protected:
+    FitProfile *profile;   ///< The profile
+    const int& ierr;       ///< The error code
+    const int& nit;        ///< The number of iterations
+};
+
+//  Class FitProfileObjectTimer
+/// Measures one call of a fit object or constraint within a phase
+/**
+ * Does nothing if the profile is 0 or object profiling is off.
+ */
+class FitProfileObjectTimer {
+  public:
+    /// Constructor, starts the measurement
+    FitProfileObjectTimer (FitProfile *profile_,       ///< The profile, may be 0
+                           int phase_,                 ///< The phase
+                           const std::type_info& type_ ///< The class of the object, i.e. typeid (*object)
+                          )
+    : profile (profile_ && profile_->isObjectProfiling() ? profile_ : 0), 
+      phase (phase_), type (&type_), start (0), counting (false)
+    {
+      if (!profile) return;
+      counting = profile->readCounters (startevents);
+      start = FitProfile::now();
+    };
+    /// Destructor, stops the measurement
+    ~FitProfileObjectTimer() {
+      if (!profile) return;
+      uint64_t ticks = FitProfile::now() - start;
+      uint64_t endevents[PerfCounterGroup::NEVENTS];
+      if (counting && profile->readCounters (endevents)) 
+        profile->addObject (phase, *type, ticks, startevents, endevents);
+      else
+        profile->addObject (phase, *type, ticks);
+    };
+
+  protected:
+    /// Copy constructor disabled
+    FitProfileObjectTimer (const FitProfileObjectTimer& rhs);
+    /// Assignment disabled
+    FitProfileObjectTimer& operator= (const FitProfileObjectTimer& rhs);
+
+    FitProfile *profile;          ///< The profile
+    int phase;                    ///< The phase
+    const std::type_info *type;   ///< The class
+    uint64_t start;               ///< Tick counter at the start
+    bool counting;                ///< Whether startevents is valid
+    uint64_t startevents[PerfCounterGroup::NEVENTS];  ///< Hardware counts at the start
+};
+
+//  Class FitProfileMap
+/// One FitProfile per fit topology
+/**
+ * The topology of a fit is the set of classes of its fit objects,
+ * hard and soft constraints, with multiplicities, e.g.
+ * "4 JetFitObject | 5 PConstraint | 0", so that, say, 4-jet and 6-jet
+ * fits are profiled separately.
+ *
+ * Call select before each fit: it attaches the profile of the fitter's
+ * current topology to the fitter, creating it with the settings of the
+ * map if necessary. Like FitProfile, a FitProfileMap belongs to one thread;
+ * the maps of several threads are merged with add.
+ *
+ */
+class FitProfileMap {
+  public:
+    /// Constructor
+    FitProfileMap();
+    /// Virtual destructor, deletes the profiles
+    virtual ~FitProfileMap();
+
+    /// Switch hardware counters on or off for all current and future profiles
+    virtual void setHardwareCounters (bool on);
+    /// Switch object profiling on or off for all current and future profiles
+    virtual void setObjectProfiling (bool on);
+
+    /// Attach the profile of the fitter's topology to the fitter and return it
+    virtual FitProfile *select (BaseFitter& fitter);
+    /// Get the profile of a topology; 0 if there is none
+    virtual const FitProfile *getProfile (const std::string& topology) const;
+    /// The topology of a fitter
+    static std::string getTopology (BaseFitter& fitter);
+
+    /// Add the profiles of rhs
+    void add (const FitProfileMap& rhs);
+    /// Delete all profiles
+    void clear();
+    /// Print a summary for each topology
+    void print (std::ostream& os) const;
+
+  protected:
+    /// Copy constructor disabled
+    FitProfileMap (const FitProfileMap& rhs);
+    /// Assignment disabled
+    FitProfileMap& operator= (const FitProfileMap& rhs);
+
+    /// Get or create the profile of a topology
+    FitProfile *getOrCreate (const std::string& topology);
+
+    std::map<std::string, FitProfile *> profiles;   ///< The profiles, owned
+    bool hardwarecounters;                          ///< Setting for new profiles
+    bool objectprofiling;                           ///< Setting for new profiles
+};
+
+#endif // __FITPROFILE_H
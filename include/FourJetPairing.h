@@ -44,6 +44,9 @@ class FourJetPairing : public BaseJetPairing {
     /// Number of permutaions
     virtual int getNPerm() const {return NPERM;};
     
+    /// Number of jets per permutation
+    virtual int getNJets() const {return NJETS;};
+    
     /// does the job
     virtual int nextPermutation (JetFitObject *permObjects[]);
     
@@ -26,6 +26,9 @@ class FourJetZHPairing : public BaseJetPairing {
     /// Number of permutaions
     virtual int getNPerm() const {return NPERM;};
     
+    /// Number of jets per permutation
+    virtual int getNJets() const {return NJETS;};
+    
     /// does the job
     virtual int nextPermutation (JetFitObject *permObjects[]);
     
@@ -27,6 +27,101 @@
 #include <cmath>
 #include <cassert>
 
+class FourVector;
+
+//  Class FourVectorExpr:
+/// Base class of FourVector and of expressions of four vectors
+/**
+ * The arithmetic operators of four vectors return light-weight expression
+ * objects (expression templates), so that a sum like a+b+c+d is evaluated
+ * component by component in one pass when it is converted to a FourVector
+ * or when one of its getters (e.g. getM()) is called, without a FourVector
+ * temporary for each intermediate sum.
+ *
+ * Expressions keep references to the FourVector objects they are built
+ * from and must not outlive them: "auto s = a + f();", with f returning
+ * a FourVector, dangles. Assign expressions to a FourVector instead.
+ *
+ */
+template <class Expr>
+class FourVectorExpr {
+  public:
+    /// The expression object itself
+    const Expr& self() const { return static_cast<const Expr&>(*this); }
+
+    /// Evaluate the momentum three vector
+    ThreeVector getP3()  const { return ThreeVector (self().getPx(), self().getPy(), self().getPz()); }
+
+    double getM2()    const { double e = self().getE(); return std::abs(e*e-getP2()); }
+    double getM()     const { return std::sqrt(getM2()); }
+    double getMass()  const { return std::sqrt(getM2()); }
+
+    double getP2()    const { return getP3().getP2(); }
+    double getP()     const { return std::sqrt(getP2()); }
+    double getPt2()   const { return getP3().getPt2(); }
+    double getPt()    const { return std::sqrt(getPt2()); }
+
+    double getPhi()   const { return getP3().getPhi(); }
+    double getTheta() const { return getP3().getTheta(); }
+    double getEta()   const { return getP3().getEta(); }
+
+    double getComponent (int i) const {
+      switch (i) {
+        case 1: return self().getPx();
+        case 2: return self().getPy();
+        case 3: return self().getPz();
+      }
+      return self().getE();
+    }
+};
+
+// How expressions hold their operands: FourVectors by reference,
+// (temporary) expression objects by value
+template <class Expr> struct FourVectorOperand { typedef const Expr type; };
+template <> struct FourVectorOperand<FourVector> { typedef const FourVector& type; };
+
+/// Sum of two four vector expressions
+template <class L, class R>
+class FourVectorSum: public FourVectorExpr<FourVectorSum<L, R> > {
+  public:
+    FourVectorSum (const L& lhs_, const R& rhs_): lhs (lhs_), rhs (rhs_) {}
+    double getE()  const { return lhs.getE()  + rhs.getE(); }
+    double getPx() const { return lhs.getPx() + rhs.getPx(); }
+    double getPy() const { return lhs.getPy() + rhs.getPy(); }
+    double getPz() const { return lhs.getPz() + rhs.getPz(); }
+  private:
+    typename FourVectorOperand<L>::type lhs;
+    typename FourVectorOperand<R>::type rhs;
+};
+
+/// Difference of two four vector expressions
+template <class L, class R>
+class FourVectorDiff: public FourVectorExpr<FourVectorDiff<L, R> > {
+  public:
+    FourVectorDiff (const L& lhs_, const R& rhs_): lhs (lhs_), rhs (rhs_) {}
+    double getE()  const { return lhs.getE()  - rhs.getE(); }
+    double getPx() const { return lhs.getPx() - rhs.getPx(); }
+    double getPy() const { return lhs.getPy() - rhs.getPy(); }
+    double getPz() const { return lhs.getPz() - rhs.getPz(); }
+  private:
+    typename FourVectorOperand<L>::type lhs;
+    typename FourVectorOperand<R>::type rhs;
+};
+
+/// Multiple of a four vector expression
+template <class A>
+class FourVectorScaled: public FourVectorExpr<FourVectorScaled<A> > {
+  public:
+    FourVectorScaled (double a_, const A& v_): a (a_), v (v_) {}
+    double getE()  const { return a*v.getE(); }
+    double getPx() const { return a*v.getPx(); }
+    double getPy() const { return a*v.getPy(); }
+    double getPz() const { return a*v.getPz(); }
+  private:
+    double a;
+    typename FourVectorOperand<A>::type v;
+};
+
 //  Class FourVector:
 /// Yet another four vector class, with metric +---
 /**
@@ -36,7 +131,7 @@
  *          by: $Author: blist $
  *
  */
-class FourVector {
+class FourVector: public FourVectorExpr<FourVector> {
   public:
     /// Default constructor
     inline FourVector();
@@ -46,6 +141,9 @@ class FourVector {
     inline FourVector(double E_, const ThreeVector& p_);
     /// Constructor from three momentum and mass
     inline FourVector(const ThreeVector& p_, double m_);
+    /// Evaluate an expression, e.g. a sum of four vectors
+    template <class Expr>
+    inline FourVector(const FourVectorExpr<Expr>& rhs);
     // automatically generated copy constructor and assignment is fine
     
     /// Returns the energy / 0 component
@@ -90,12 +188,18 @@ class FourVector {
     inline const ThreeVector& getThreeVector() const { return p;}
     
     FourVector& boost (const FourVector& P);
+    /// Boost with P, whose mass M is already known; saves a square root
+    FourVector& boost (const FourVector& P, double M);
     void decayto (FourVector& d1, FourVector& d2) const;
+    /// Isotropic decay with the two random numbers r1 (for phi) and r2 (for cos theta) in [0, 1]
+    void decayto (FourVector& d1, FourVector& d2, double r1, double r2) const;
     
     inline void setValues (double E_, double px_, double py_, double pz_);
     
-    inline FourVector& operator+= (const FourVector& rhs);
-    inline FourVector& operator-= (const FourVector& rhs);
+    template <class Expr>
+    inline FourVector& operator+= (const FourVectorExpr<Expr>& rhs);
+    template <class Expr>
+    inline FourVector& operator-= (const FourVectorExpr<Expr>& rhs);
     
     inline FourVector& operator*= (double rhs);
   
@@ -119,6 +223,11 @@ FourVector::FourVector(double E_, const ThreeVector& p_)
 FourVector::FourVector(const ThreeVector& p_, double m)
 : E(std::sqrt(p_.getP2() + m*m)), p(p_)
 {}
+
+template <class Expr>
+FourVector::FourVector(const FourVectorExpr<Expr>& rhs)
+: E(rhs.self().getE()), p(rhs.self().getPx(), rhs.self().getPy(), rhs.self().getPz())
+{}
     
 double FourVector::getE()  const { return E; }
 double FourVector::getPx() const { return p.getPx(); }
@@ -154,15 +263,19 @@ void FourVector::setValues(double E_, double px_, double py_, double pz_) {
   p.setValues (px_, py_, pz_);
 }
 
-FourVector& FourVector::operator+= (const FourVector& rhs) {
-  p += rhs.p;
-  E += rhs.E;
+// each component of rhs depends only on the same component of its
+// operands, so rhs may contain *this
+template <class Expr>
+FourVector& FourVector::operator+= (const FourVectorExpr<Expr>& rhs) {
+  E += rhs.self().getE();
+  p += rhs.getP3();
   return *this;
 }
 
-FourVector& FourVector::operator-= (const FourVector& rhs) {
-  p -= rhs.p;
-  E -= rhs.E;
+template <class Expr>
+FourVector& FourVector::operator-= (const FourVectorExpr<Expr>& rhs) {
+  E -= rhs.self().getE();
+  p -= rhs.getP3();
   return *this;
 }
 
@@ -176,40 +289,47 @@ FourVector& FourVector::operator*= (double rhs) {
  * \relates  FourVector
  * \brief Sum of two four vectors
  */
-inline FourVector operator+ (const FourVector& lhs, const FourVector& rhs) {
-  return FourVector (lhs.getE()+rhs.getE(), lhs.getPx()+rhs.getPx(), lhs.getPy()+rhs.getPy(), lhs.getPz()+rhs.getPz());
+template <class L, class R>
+inline FourVectorSum<L, R> operator+ (const FourVectorExpr<L>& lhs, const FourVectorExpr<R>& rhs) {
+  return FourVectorSum<L, R> (lhs.self(), rhs.self());
 }
 
 /**
  * \relates  FourVector
  * \brief Difference of two four vectors
  */
-inline FourVector operator- (const FourVector& lhs, const FourVector& rhs) {
-  return FourVector (lhs.getE()-rhs.getE(), lhs.getPx()-rhs.getPx(), lhs.getPy()-rhs.getPy(), lhs.getPz()-rhs.getPz());
+template <class L, class R>
+inline FourVectorDiff<L, R> operator- (const FourVectorExpr<L>& lhs, const FourVectorExpr<R>& rhs) {
+  return FourVectorDiff<L, R> (lhs.self(), rhs.self());
 }
 
 /**
  * \relates FourVector
  * \brief Negative of a four vector
  */
-inline FourVector operator- (const FourVector& rhs) {
-  return FourVector (-rhs.getE(), -rhs.getPx(), -rhs.getPy(), -rhs.getPz());
+template <class A>
+inline FourVectorScaled<A> operator- (const FourVectorExpr<A>& rhs) {
+  return FourVectorScaled<A> (-1, rhs.self());
 }
 
 /**
  * \relates  FourVector
  * \brief Scalar product of a four vector
  */
-inline FourVector operator* (double lhs, const FourVector& rhs) {
-  return FourVector (lhs*rhs.getE(), lhs*rhs.getPx(), lhs*rhs.getPy(), lhs*rhs.getPz());
+template <class A>
+inline FourVectorScaled<A> operator* (double lhs, const FourVectorExpr<A>& rhs) {
+  return FourVectorScaled<A> (lhs, rhs.self());
 }
 
 /**
  * \relates  FourVector
  * \brief Scalar product of a four vector
  */
-inline double operator* (const FourVector& lhs, const FourVector& rhs) {
-  return lhs.getE()*rhs.getE() - lhs.getPx()*rhs.getPx() - lhs.getPy()*rhs.getPy() - lhs.getPz()*rhs.getPz();
+template <class L, class R>
+inline double operator* (const FourVectorExpr<L>& lhs, const FourVectorExpr<R>& rhs) {
+  const L& l = lhs.self();
+  const R& r = rhs.self();
+  return l.getE()*r.getE() - l.getPx()*r.getPx() - l.getPy()*r.getPy() - l.getPz()*r.getPz();
 }
 
 
@@ -217,10 +337,12 @@ inline double operator* (const FourVector& lhs, const FourVector& rhs) {
  * \relates  FourVector
  * \brief Prints a four vector
  */
+template <class Expr>
 inline std::ostream& operator<< (std::ostream& os, 
-                                 const FourVector& rhs 
+                                 const FourVectorExpr<Expr>& rhs 
                                 ) {
-  os << "(" << rhs.getE() << ", " << rhs.getPx() << ", " << rhs.getPy() << ", " << rhs.getPz() << ")";
+  const Expr& v = rhs.self();
+  os << "(" << v.getE() << ", " << v.getPx() << ", " << v.getPy() << ", " << v.getPz() << ")";
   return os;
 }
 
@@ -0,0 +1,65 @@
+/*! \file
+ *  \brief Declares class GSLLinAlgBackend
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Added dtrsv
+ *
+ */
+
+#ifndef __GSLLINALGBACKEND_H
+#define __GSLLINALGBACKEND_H
+
+#include "LinAlgBackend.h"
+
+//  Class GSLLinAlgBackend
+/// LinAlgBackend that calls GSL
+/**
+ * Every method calls the GSL function of the same name.
+ *
+ */
+class GSLLinAlgBackend: public LinAlgBackend {
+  public:
+    /// Constructor
+    GSLLinAlgBackend();
+    /// Virtual destructor
+    virtual ~GSLLinAlgBackend();
+
+    virtual const char *getName() const;
+
+    virtual double ddot (const gsl_vector *x, const gsl_vector *y) const;
+    virtual double dnrm2 (const gsl_vector *x) const;
+    virtual double dasum (const gsl_vector *x) const;
+    virtual size_t idamax (const gsl_vector *x) const;
+    virtual void dcopy (const gsl_vector *x, gsl_vector *y) const;
+    virtual void daxpy (double alpha, const gsl_vector *x, gsl_vector *y) const;
+    virtual void dscal (double alpha, gsl_vector *x) const;
+
+    virtual void dgemv (CBLAS_TRANSPOSE_t TransA, double alpha, const gsl_matrix *A,
+                        const gsl_vector *x, double beta, gsl_vector *y) const;
+    virtual void dsymv (CBLAS_UPLO_t Uplo, double alpha, const gsl_matrix *A,
+                        const gsl_vector *x, double beta, gsl_vector *y) const;
+    virtual void dgemm (CBLAS_TRANSPOSE_t TransA, CBLAS_TRANSPOSE_t TransB, double alpha,
+                        const gsl_matrix *A, const gsl_matrix *B, double beta, gsl_matrix *C) const;
+    virtual void dsymm (CBLAS_SIDE_t Side, CBLAS_UPLO_t Uplo, double alpha,
+                        const gsl_matrix *A, const gsl_matrix *B, double beta, gsl_matrix *C) const;
+    virtual void dtrsv (CBLAS_UPLO_t Uplo, CBLAS_TRANSPOSE_t TransA, CBLAS_DIAG_t Diag,
+                        const gsl_matrix *A, gsl_vector *x) const;
+
+    virtual int LUDecomp (gsl_matrix *A, gsl_permutation *p, int *signum) const;
+    virtual double LUDet (gsl_matrix *LU, int signum) const;
+    virtual int LUSolve (const gsl_matrix *LU, const gsl_permutation *p, const gsl_vector *b, gsl_vector *x) const;
+    virtual int LUSvx (const gsl_matrix *LU, const gsl_permutation *p, gsl_vector *x) const;
+    virtual int LUInvert (const gsl_matrix *LU, const gsl_permutation *p, gsl_matrix *inverse) const;
+
+    virtual int choleskyDecomp (gsl_matrix *A) const;
+    virtual int choleskySolve (const gsl_matrix *LLT, const gsl_vector *b, gsl_vector *x) const;
+    virtual int choleskySvx (const gsl_matrix *LLT, gsl_vector *x) const;
+    virtual int choleskyInvert (gsl_matrix *LLT) const;
+
+    virtual void scaleSym (gsl_matrix *Mscal, const gsl_matrix *M, const gsl_vector *e) const;
+    virtual bool isfinite (const gsl_vector *v) const;
+    virtual bool isfinite (const gsl_matrix *m) const;
+};
+
+#endif // __GSLLINALGBACKEND_H
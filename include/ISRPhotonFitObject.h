@@ -84,12 +84,17 @@ class ISRPhotonFitObject : public ParticleFitObject {
     virtual double getSecondDerivative_Meta_Local( int iMeta, int ilocal , int jlocal, int metaSet ) const;
 
     virtual int getNPar() const {return NPAR;}
+    
+    /// Set the start value of p_z; clipped to the allowed range like in the constructor
+    virtual bool setPz (double pz_,          ///< The new p_z
+                        bool warn = true     ///< Whether to warn if |p_z| < PzMin is clipped
+                       );
   
   protected:
     
     enum {NPAR=3}; // well, it's actually 1...Daniel should update
 
-    virtual double PgFromPz(double pz);
+    virtual double PgFromPz(double pz, bool warn = true);
     
     void updateCache() const;
   
@@ -11,21 +11,60 @@
  * -
  *
  */ 
-#ifdef MARLIN_USE_ROOT
 
 #ifndef __ITERATIONSCANNER_H
 #define __ITERATIONSCANNER_H
 
-#include <vector>
-
-class BaseFitter;
-class BaseFitObject;
-class BaseHardConstraint;
+#include "BaseScanner.h"
 
-class IterationScanner {
+//  Class IterationScanner
+/// Maps the number of fit iterations as a function of the start values of two parameters
+/**
+ * For each grid point the fit is started from the start values of the
+ * scan, with the two scanned parameters set to the point's coordinates.
+ * The result holds chi2, number of iterations and error code of the fit,
+ * the fitted values of the two parameters (xend, yend) and the final 
+ * trace values alpha, mu and phi, which NewFitterGSL records also 
+ * without tracer (0 for other fitters, and with FIT_TRACEOFF).
+ *
+ * adaptiveScan maps the same quantities on a quadtree instead
+ * (see AdaptiveScanResult): starting from a coarse grid, 
+ * a cell is divided into four only if its fit result differs from 
+ * that of a neighbouring cell - in the error code, by more than 
+ * the iteration tolerance in the number of iterations, or by more than
+ * the solution tolerance (relative to the scan range) in the fitted 
+ * x or y. The fits are thus concentrated along the boundaries 
+ * of the convergence basins. All fits of a level run in parallel;
+ * the refinement decisions do not depend on the number of threads.
+ *
+ */
+class IterationScanner: public BaseScanner {
   public:
+    /// Constructor for a serial scan
     IterationScanner (BaseFitter& fitter_);
+    /// Constructor for a parallel scan, one fitter per thread
+    IterationScanner (const std::vector<BaseFitter *>& fitters_);
     
+    /// Set the differences between neighbouring cells that lead to refinement
+    void setRefinement (int nittolerance_,      ///< Allowed difference of iterations (default 0)
+                        double soltolerance_    ///< Allowed difference of solutions, relative to the range (default 1E-3)
+                       );
+
+    /// Scan on a quadtree; false if the parameters do not exist
+    bool adaptiveScan (int xglobal, 
+                       double xstart,
+                       double xstop,
+                       int yglobal, 
+                       double ystart,
+                       double ystop,
+                       int nstart,         ///< Number of cells per direction at level 0
+                       int maxlevel        ///< Number of refinement levels
+                      );
+    /// The result of the last adaptive scan
+    const AdaptiveScanResult& getAdaptiveResult() const;
+    
+#ifdef MARLIN_USE_ROOT
+    /// Scan and write a histogram of the number of iterations
     void doScan (int xglobal, 
                  int nx,
                  double xstart,
@@ -36,21 +75,34 @@ class IterationScanner {
                  double ystop,
                  const char *idprefix="",
                  const char *titleprefix="");
-  
+    /// Adaptive scan; write histograms of the number of iterations and the level at the finest binning
+    void doAdaptiveScan (int xglobal, 
+                         double xstart,
+                         double xstop,
+                         int yglobal, 
+                         double ystart,
+                         double ystop,
+                         int nstart,
+                         int maxlevel,
+                         const char *idprefix="",
+                         const char *titleprefix="");
+#endif
   
   protected:
-    
-    typedef std::vector <BaseFitObject *> FitObjectContainer;
-    typedef std::vector <BaseHardConstraint *> ConstraintContainer;
-    
-    typedef FitObjectContainer::iterator FitObjectIterator;
-    typedef ConstraintContainer::iterator ConstraintIterator;
-    
-    BaseFitter& fitter;
-
+    /// Fit from point (ix, iy), or from pending cell itask in an adaptive scan
+    virtual void execute (int itask, int ithread);
+    /// Fit from point (ix, iy)
+    virtual void scanPoint (int ix, int iy, int ithread);
+    /// Fit from (point.x, point.y), fill the rest of point
+    void fitPoint (ScanPoint& point, int ithread);
+    /// Check whether two cells differ enough to be refined
+    bool differ (const ScanPoint& p1, const ScanPoint& p2) const;
 
+    int nittolerance;                  ///< Allowed difference of iterations
+    double soltolerance;               ///< Allowed relative difference of solutions
+    bool adaptive;                     ///< True during an adaptive scan
+    AdaptiveScanResult adaptiveresult; ///< Result of the adaptive scan
+    std::vector<int> pending;          ///< Cells to be fitted in the current pass
 };
 
 #endif /* #ifndef __ITERATIONSCANNER_H */
-
-#endif // MARLIN_USE_ROOT
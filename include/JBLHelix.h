@@ -47,7 +47,7 @@ class JBLHelix {
     
     /// Get value of parameter i 
     double getPar (int i        ///< Parameter number i (i=0...4)
-                  );
+                  ) const;
     /// Set value of parameter i 
     JBLHelix& setPar (int i,       ///< Parameter number i (i=0...4)
                       double par_  ///< New parameter value
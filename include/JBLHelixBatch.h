@@ -0,0 +1,116 @@
+/*! \file
+ *  \brief Declares class JBLHelixBatch
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Fixed closest points of nested circles
+ * - 18.10.2026 Vectorized loops over pairs
+ *
+ */
+
+#ifndef __JBLHELIXBATCH_H
+#define __JBLHELIXBATCH_H
+
+#include <vector>
+
+class JBLHelix;
+class ThreeVector;
+
+// Class JBLHelixBatch
+/// A set of helices, for closest approach calculations of many pairs at once
+/**
+ * Stores the parameters (kappa, phi0, theta, dca, z0) of many helices
+ * as a structure of arrays, together with the quantities that
+ * JBLHelix::getClosestApproach derives from them (center point, radius,
+ * sin and cos of phi0, cot theta), which are computed once per helix
+ * instead of once per pair.
+ *
+ * getClosestApproaches and getAllClosestApproaches compute, for many
+ * pairs, the same arc lengths as JBLHelix::getClosestApproach.
+ * The loop over pairs has no branches and no aliasing between
+ * input and output arrays, and is marked with "omp simd", so the compiler
+ * can vectorize it; this needs vectorized versions of atan2 and acos,
+ * which GCC takes from glibc's libmvec with -ffast-math.
+ * CMakeLists.txt therefore compiles JBLHelixBatch.cc with
+ * -O3 -ffast-math -fopenmp-simd; otherwise the loops stay scalar.
+ * getAllClosestApproaches runs over contiguous ranges of the second
+ * helix, so no gather instructions are needed.
+ *
+ * Differences to JBLHelix::getClosestApproach:
+ * - If one circle lies within the other, return value 0 and the points
+ *   closest in (x, y) are returned: on the line through the centers,
+ *   on the side of the inner circle's center (JBLHelix returns NaN).
+ * - A pair involving a straight line (|kappa| <= 1E-7) gets return value -1
+ *   and arc lengths 0 (JBLHelix asserts).
+ *
+ */
+
+class JBLHelixBatch {
+  public:
+    /// Constructor, no helices
+    JBLHelixBatch ();
+    /// Destructor
+    ~JBLHelixBatch();
+
+    /// Remove all helices
+    void clear();
+    /// Reserve space for n helices
+    void reserve (int n);
+    /// Add a helix, return its index
+    int addHelix (double kappa,    ///< kappa
+                  double phi0,     ///< phi0
+                  double theta,    ///< theta
+                  double dca,      ///< dca
+                  double z0        ///< z0
+                 );
+    /// Add a helix, return its index
+    int addHelix (const JBLHelix& helix);
+    /// Number of helices
+    int getNHelices() const;
+
+    /// Closest approach for pairs (ihelix0[i], ihelix1[i]), i=0...npairs-1; see JBLHelix::getClosestApproach
+    void getClosestApproaches (int npairs,              ///< Number of pairs
+                               const int *ihelix0,      ///< Index of the first helix of each pair
+                               const int *ihelix1,      ///< Index of the second helix of each pair
+                               double *s0,              ///< First helix's arc length of the best point
+                               double *s1,              ///< Second helix's arc length of the best point
+                               double *s02nd,           ///< First helix's arc length of the 2nd best point
+                               double *s12nd,           ///< Second helix's arc length of the 2nd best point
+                               int *result              ///< Number of intersections (0, 1, 2), -1 for straight lines
+                              ) const;
+    /// Closest approach for all pairs (i, j), i < j, in the order (0,1), (0,2), ..., (1,2), ...
+    /** The output arrays must have room for getNPairs() entries */
+    void getAllClosestApproaches (double *s0,           ///< First helix's arc length of the best point
+                                  double *s1,           ///< Second helix's arc length of the best point
+                                  double *s02nd,        ///< First helix's arc length of the 2nd best point
+                                  double *s12nd,        ///< Second helix's arc length of the 2nd best point
+                                  int *result           ///< Number of intersections (0, 1, 2), -1 for straight lines
+                                 ) const;
+    /// Number of pairs (i, j), i < j
+    int getNPairs() const;
+
+    /// Get point along trajectory of helix ihelix into existing 3-vector
+    void getTrajectoryPointEx (int ihelix,         ///< The helix
+                               double s,           ///< The arc length
+                               ThreeVector& p      ///< The point
+                              ) const;
+
+  private:
+    /// Copy constructor disabled
+    JBLHelixBatch (const JBLHelixBatch& rhs);
+    /// Assignment disabled
+    JBLHelixBatch& operator= (const JBLHelixBatch& rhs);
+
+    std::vector<double> kappa;      ///< kappa
+    std::vector<double> phi0;       ///< phi0
+    std::vector<double> dca;        ///< dca
+    std::vector<double> z0;         ///< z0
+    std::vector<double> r;          ///< Signed radius 1/kappa, 0 for straight lines
+    std::vector<double> sphi0;      ///< sin (phi0)
+    std::vector<double> cphi0;      ///< cos (phi0)
+    std::vector<double> xc;         ///< x of center point
+    std::vector<double> yc;         ///< y of center point
+    std::vector<double> cottheta;   ///< cot (theta)
+};
+
+#endif // __JBLHELIXBATCH_H
@@ -0,0 +1,125 @@
+/*! \file
+ *  \brief Declares class LinAlgBackend
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Added dtrsv
+ *
+ */
+
+#ifndef __LINALGBACKEND_H
+#define __LINALGBACKEND_H
+
+#include <cstddef>
+
+#include <gsl/gsl_vector.h>
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_permutation.h>
+#include <gsl/gsl_blas.h>
+
+//  Class LinAlgBackend
+/// Abstract base class for the linear algebra operations of the fitters
+/**
+ * The fitters NewFitterGSL, NewtonFitterGSL and OPALFitterGSL keep
+ * their vectors and matrices in gsl_vector and gsl_matrix objects,
+ * but do all BLAS operations, LU and Cholesky decompositions through
+ * a LinAlgBackend, set with BaseFitter::setLinAlgBackend.
+ *
+ * The methods have the same arguments and semantics as the GSL
+ * functions of the same name (gsl_blas_dgemm, gsl_linalg_LU_decomp etc.),
+ * except that ddot returns the result.
+ * Errors are reported with GSL_ERROR, as by GSL.
+ *
+ * Implementations:
+ * - GSLLinAlgBackend: calls GSL
+ * - SmallLinAlgBackend: header only loops for small matrices,
+ *   without the per call overhead of GSL's BLAS
+ *
+ * The default backend, used by all fitters created afterwards, is
+ * GSLLinAlgBackend, or SmallLinAlgBackend if compiled with
+ * FIT_LINALG_SMALL; it can be changed at run time with setDefault.
+ *
+ * Backends have no state and can be used by several threads at once.
+ *
+ */
+class LinAlgBackend {
+  public:
+    /// Virtual destructor
+    virtual ~LinAlgBackend();
+
+    /// Name of the backend
+    virtual const char *getName() const = 0;
+
+    /// Returns x^T y
+    virtual double ddot (const gsl_vector *x, const gsl_vector *y) const = 0;
+    /// Returns |x|
+    virtual double dnrm2 (const gsl_vector *x) const = 0;
+    /// Returns sum |x_i|
+    virtual double dasum (const gsl_vector *x) const = 0;
+    /// Returns index of the largest |x_i|
+    virtual size_t idamax (const gsl_vector *x) const = 0;
+    /// y = x
+    virtual void dcopy (const gsl_vector *x, gsl_vector *y) const = 0;
+    /// y = alpha x + y
+    virtual void daxpy (double alpha, const gsl_vector *x, gsl_vector *y) const = 0;
+    /// x = alpha x
+    virtual void dscal (double alpha, gsl_vector *x) const = 0;
+
+    /// y = alpha op(A) x + beta y
+    virtual void dgemv (CBLAS_TRANSPOSE_t TransA, double alpha, const gsl_matrix *A,
+                        const gsl_vector *x, double beta, gsl_vector *y) const = 0;
+    /// y = alpha A x + beta y for symmetric A
+    virtual void dsymv (CBLAS_UPLO_t Uplo, double alpha, const gsl_matrix *A,
+                        const gsl_vector *x, double beta, gsl_vector *y) const = 0;
+    /// C = alpha op(A) op(B) + beta C
+    virtual void dgemm (CBLAS_TRANSPOSE_t TransA, CBLAS_TRANSPOSE_t TransB, double alpha,
+                        const gsl_matrix *A, const gsl_matrix *B, double beta, gsl_matrix *C) const = 0;
+    /// C = alpha A B + beta C (Side=CblasLeft) or C = alpha B A + beta C (CblasRight) for symmetric A
+    virtual void dsymm (CBLAS_SIDE_t Side, CBLAS_UPLO_t Uplo, double alpha,
+                        const gsl_matrix *A, const gsl_matrix *B, double beta, gsl_matrix *C) const = 0;
+    /// x = op(A)^-1 x for triangular A
+    virtual void dtrsv (CBLAS_UPLO_t Uplo, CBLAS_TRANSPOSE_t TransA, CBLAS_DIAG_t Diag,
+                        const gsl_matrix *A, gsl_vector *x) const = 0;
+
+    /// LU decomposition of A in place
+    virtual int LUDecomp (gsl_matrix *A, gsl_permutation *p, int *signum) const = 0;
+    /// Determinant from the LU decomposition
+    virtual double LUDet (gsl_matrix *LU, int signum) const = 0;
+    /// Solve A x = b with the LU decomposition
+    virtual int LUSolve (const gsl_matrix *LU, const gsl_permutation *p, const gsl_vector *b, gsl_vector *x) const = 0;
+    /// Solve A x = b in place with the LU decomposition
+    virtual int LUSvx (const gsl_matrix *LU, const gsl_permutation *p, gsl_vector *x) const = 0;
+    /// Inverse of A from the LU decomposition
+    virtual int LUInvert (const gsl_matrix *LU, const gsl_permutation *p, gsl_matrix *inverse) const = 0;
+
+    /// Cholesky decomposition of the symmetric, positive definite A in place
+    virtual int choleskyDecomp (gsl_matrix *A) const = 0;
+    /// Solve A x = b with the Cholesky decomposition
+    virtual int choleskySolve (const gsl_matrix *LLT, const gsl_vector *b, gsl_vector *x) const = 0;
+    /// Solve A x = b in place with the Cholesky decomposition
+    virtual int choleskySvx (const gsl_matrix *LLT, gsl_vector *x) const = 0;
+    /// Replace the Cholesky decomposition by the inverse of A
+    virtual int choleskyInvert (gsl_matrix *LLT) const = 0;
+
+    /// Mscal_ij = e_i e_j M_ij
+    virtual void scaleSym (gsl_matrix *Mscal, const gsl_matrix *M, const gsl_vector *e) const = 0;
+    /// True if all elements of v are finite
+    virtual bool isfinite (const gsl_vector *v) const = 0;
+    /// True if all elements of m are finite
+    virtual bool isfinite (const gsl_matrix *m) const = 0;
+
+    /// The default backend for new fitters
+    static const LinAlgBackend& getDefault();
+    /// Set the default backend for new fitters; not thread safe, call before fitters are created
+    static void setDefault (const LinAlgBackend& backend);
+
+    /// The GSLLinAlgBackend instance
+    static const LinAlgBackend& getGSL();
+    /// The SmallLinAlgBackend instance
+    static const LinAlgBackend& getSmall();
+
+  private:
+    static const LinAlgBackend *defaultbackend;   ///< The backend set with setDefault, 0 if none
+};
+
+#endif // __LINALGBACKEND_H
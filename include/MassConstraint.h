@@ -69,6 +69,12 @@ class MassConstraint : public ParticleConstraint {
                          );
     
     virtual int getVarBasis() const;
+    
+    /// Get the invariant mass that the fit objects with the flag of fo must have to fulfil the constraint; returns the flag of fo, 0 if fo is not in the constraint
+    int getTargetMass (const BaseFitObject *fo,   ///< The fit object
+                       double& target,            ///< Result: the mass
+                       double partners[4]         ///< Result: E, px, py, pz of the other fit objects with the flag of fo
+                      ) const;
   
   protected:
 
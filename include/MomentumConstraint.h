@@ -63,6 +63,11 @@ class MomentumConstraint : public ParticleConstraint {
     virtual void invalidateCache() const;
 
     virtual int getVarBasis() const;
+    
+    /// Get the factors of E, px, py, pz of fitobject fo in the constraint; returns how often fo is in the constraint
+    int getFactors (const BaseFitObject *fo,   ///< The fit object
+                    double fact[4]             ///< Result: factors of E, px, py, pz
+                   ) const;
   
   protected:
     void updateCache() const;
@@ -34,6 +34,10 @@
 #include <gsl/gsl_permutation.h>
 #include <gsl/gsl_eigen.h>
 
+class ArrowheadSolver;
+class ParticleFitObject;
+class MomentumConstraint;
+
 // Class NewFitterGSL
 /// A kinematic fitter using the Newton-Raphson method to solve the equations
 /**
@@ -41,6 +45,9 @@
  * to solve the system of equations arising from the Lagrange multiplier
  * method
  *
+ * Fits without hard constraints are done with the Levenberg-Marquardt
+ * method, without Lagrange multipliers and merit function.
+ *
  * Author: Benno List
  * Last update: $Date: 2011/05/03 13:16:41 $
  *          by: $Author: blist $
@@ -60,7 +67,7 @@ class NewFitterGSL : public BaseFitter {
     /// The fit method, returns  the fit probability
     virtual double fit();
     
-    /// Get the error code of the last fit: 0=OK, 1=failed
+    /// Get the error code of the last fit: 0=OK, 1=failed, BUDGETEXHAUSTED: stopped at the best iterate
     virtual int getError() const;
     
     /// Get the fit probability of the last fit
@@ -71,6 +78,8 @@ class NewFitterGSL : public BaseFitter {
     virtual int    getDoF() const;
     /// Get the number of iterations of the last fit
     virtual int  getIterations() const;
+    /// Get the number of rejected trial steps (trust region steps or step lengths) of the last fit
+    virtual int  getRejectedSteps() const;
 
     /// Get the number of hard constraints of the last fit
     virtual int    getNcon() const;
@@ -86,10 +95,25 @@ class NewFitterGSL : public BaseFitter {
 
     /// Initialize the fitter
     virtual bool initialize();
+    /// True: the budget is obeyed
+    virtual bool supportsBudget() const;
   
     /// Set the Debug Level
     virtual void setDebug (int debuglevel);
     
+    /// Solve the Newton step with an ArrowheadSolver if the system has block arrowhead structure
+    virtual void setArrowheadSolver (bool on);
+    /// Solve the Newton step in the null space of the constraints, with a positive definite reduced Hessian
+    virtual void setNullSpaceSolver (bool on);
+    /// Eliminate unmeasured neutrinos and invisible Zs by solving the momentum constraints for their momenta
+    virtual void setEliminateUnmeasured (bool on);
+    /// Control the step length with a trust region (Byrd-Omojokun SQP) instead of a line search
+    virtual void setTrustRegion (bool on,           ///< Use the trust region
+                                 double radius = 0  ///< Initial radius, in units of the parameter errors; 0: keep the current one
+                                );
+    /// Declare a fit object whose parameters couple to many others, e.g. the vertex of a vertex fit
+    virtual void addSharedFitObject (BaseFitObject *fo);
+    
     /// Determine best lambda values
     virtual void determineLambdas (gsl_vector *vecxnew,        ///< vector with new lambda values
                                    const gsl_matrix *MatM,     ///< matrix with constraint derivatives
@@ -219,6 +243,58 @@ class NewFitterGSL : public BaseFitter {
                             gsl_vector *vecw         ///< Work vector w
                      );  
                          
+    // Calculate a trust region step and the new vector x
+    int calcTrustRegionDx (      bool& converged,         ///< Result: true if the step is negligible
+                                 gsl_vector *vecxnew,     ///< Result: New vector x
+                                 gsl_vector *vecx,        ///< Current vector x
+                                 gsl_vector *vecdx,       ///< Result: Update vector dx
+                                 gsl_vector *vecdxscal,   ///< Result: Update vector dx, scaled
+                           const gsl_vector *vece,        ///< Current ``error'' set of x
+                                 gsl_matrix *MatM,        ///< Matrix M
+                                 gsl_matrix *MatMscal,    ///< Matrix M, scaled
+                                 gsl_vector *vecy,        ///< Vector y
+                                 gsl_vector *vecyscal,    ///< Vector y, scaled,
+                                 gsl_matrix *MatW,        ///< Work matrix
+                                 gsl_matrix *MatW2,       ///< Work matrix
+                                 gsl_matrix *MatW3,       ///< Work matrix
+                                 gsl_vector *vecw1,       ///< Work vector
+                                 gsl_vector *vecw2,       ///< Work vector
+                                 gsl_permutation *permW   ///< Work permutation vector
+                          );
+    
+    /// Calculate a Levenberg-Marquardt step and the new vector x, for fits without hard constraints
+    int calcLevenbergMarquardtDx (      bool& converged,         ///< Result: true if the step is negligible
+                                        gsl_vector *vecxnew,     ///< Result: New vector x
+                                        gsl_vector *vecx,        ///< Current vector x
+                                        gsl_vector *vecdx,       ///< Result: Update vector dx
+                                        gsl_vector *vecdxscal,   ///< Result: Update vector dx, scaled
+                                  const gsl_vector *vece,        ///< Current ``error'' set of x
+                                        gsl_matrix *MatM,        ///< Matrix M
+                                        gsl_matrix *MatMscal,    ///< Matrix M, scaled
+                                        gsl_vector *vecy,        ///< Vector y
+                                        gsl_vector *vecyscal,    ///< Vector y, scaled,
+                                        gsl_matrix *MatW         ///< Work matrix
+                                 );
+    
+    /// Calculate the scaled step within the given radius, 
+    /// from the decomposition by decomposeConstDer and the reduced Hessian Z^T G Z
+    void solveTrustRegion (      gsl_vector *vecdxscal,   ///< Result: Update vector dx, scaled
+                                 double radius,           ///< Trust region radius
+                                 int rankA,               ///< rank of A
+                           const gsl_vector *vecyscal,    ///< Vector y, scaled
+                           const gsl_matrix *MatMscal,    ///< Matrix M, scaled
+                           const gsl_matrix *MatW,        ///< Q and R from decomposeConstDer
+                           const gsl_matrix *MatW3,       ///< Reduced Hessian
+                                 gsl_vector *vecw1,       ///< Work vector
+                                 gsl_vector *vecw2,       ///< Work vector
+                           const gsl_permutation *permW   ///< Permutation from decomposeConstDer
+                          );
+    
+    // Calculate the constraint part of the merit function, with constraint values from vecc
+    double meritConstraintNorm (const gsl_vector *vecc,   ///< Vector with constraint values
+                                const gsl_vector *vece    ///< Current errors x
+                               );
+                         
     // Calculate mu for the merit function                                
     double calcMu (const gsl_vector *vecx,           ///< Current vector x
                    const gsl_vector *vece,           ///< Current errors x
@@ -271,21 +347,21 @@ class NewFitterGSL : public BaseFitter {
     static void debug_print (const gsl_vector *v, const char *name);
 
     // z = x + a y
-    static void add (gsl_vector *vecz, const gsl_vector *vecx, double a, const gsl_vector *vecy);
+    void add (gsl_vector *vecz, const gsl_vector *vecx, double a, const gsl_vector *vecy);
     
     // Check whether all elements are finite
-    static bool isfinite (const gsl_vector *vec);
+    bool isfinite (const gsl_vector *vec) const;
     
     // Check whether all elements are finite
-    static bool isfinite (const gsl_matrix *mat);
+    bool isfinite (const gsl_matrix *mat) const;
     
     /// Compute the Moore-Penrose pseudo-inverse A+ of A, using SVD
-    static void MoorePenroseInverse (gsl_matrix *Ainv,     ///< Result: m x n matrix A+
-                                     gsl_matrix *A,        ///< Input: n x m matrix A, n >= m (is destroyed!)
-                                     gsl_matrix *W,        ///< Work matrix, at least m x m
-                                     gsl_vector *w,        ///< Work vector w, at least m
-                                     double eps = 0        ///< Singular values < eps*(max(abs(s_i))) are set to 0
-                                    );
+    void MoorePenroseInverse (gsl_matrix *Ainv,     ///< Result: m x n matrix A+
+                              gsl_matrix *A,        ///< Input: n x m matrix A, n >= m (is destroyed!)
+                              gsl_matrix *W,        ///< Work matrix, at least m x m
+                              gsl_vector *w,        ///< Work vector w, at least m
+                              double eps = 0        ///< Singular values < eps*(max(abs(s_i))) are set to 0
+                             );
     double calcpTLp (const gsl_vector *vecdx,          ///< Current step dx
                      const gsl_matrix *MatM,           ///< Current matrix M
                            gsl_vector *vecw            ///< Work vector w
@@ -323,13 +399,65 @@ class NewFitterGSL : public BaseFitter {
                                gsl_vector *vecw,
                                double eps
                      );
+                     
+    /// QR decomposition with column pivoting of the constraint derivatives A^T, 
+    /// found in rows 0..npar-1 and columns npar..idim-1 of MatA
+    int decomposeConstDer (      int& rankA,              ///< rank of A (= number of lin. indep. constraints)
+                                 gsl_matrix *MatQR,       ///< Result: Q in rows and columns 0..npar-1, R in rows 0..npar-1, columns npar..idim-1
+                           const gsl_matrix *MatA,        ///< matrix with constraint derivatives
+                                 gsl_vector *vecw1,       ///< work vector
+                                 gsl_vector *vecw2,       ///< work vector
+                                 gsl_permutation *permW,  ///< Result: the column permutation in the first ncon elements
+                                 double eps = 0           ///< Diagonal elements of R < eps*|R_00| are set to 0
+                          );
+                     
+    /// solve system of equations Mscal*dxscal = yscal in the null space of the constraints,
+    /// with the reduced Hessian made positive definite
+    int solveNullSpace (      gsl_vector *vecdxscal, 
+                              double& detW,
+                        const gsl_vector *vecyscal, 
+                        const gsl_matrix *MatMscal,  
+                              gsl_matrix *MatW,   
+                              gsl_matrix *MatW2,   
+                              gsl_matrix *MatW3,   
+                              gsl_vector *vecw1,
+                              gsl_vector *vecw2,
+                              gsl_permutation *permW,
+                              double eps
+                       );
+                       
+    /// Find unmeasured fit objects that can be eliminated through three momentum constraints
+    void findEliminations ();
+    
+    /// Set the momenta of the eliminated fit objects such that their momentum constraints are fulfilled
+    bool projectEliminated (gsl_vector *vecx);
+    
+    /// Set the lambdas of the eliminated constraints such that the Lagrangian does not depend 
+    /// on the eliminated parameters, and update MatM and vecy accordingly
+    void adjustEliminatedLambdas (gsl_vector *vecx,      ///< vector with current x values
+                                  gsl_matrix *MatM,      ///< The matrix M at vecx
+                                  gsl_vector *vecy       ///< The vector y at vecx
+                                 );
+                     
+    /// solve system of equations Mscal*dxscal = yscal in the variables left after the elimination
+    int solveReduced (      gsl_vector *vecdxscal, 
+                            double& detW,
+                      const gsl_vector *vecy, 
+                      const gsl_vector *vece, 
+                      const gsl_matrix *MatM,  
+                            gsl_matrix *MatW,   
+                            gsl_matrix *MatW2,   
+                            gsl_vector *vecw,
+                            double epsLU,
+                            double epsSV
+                     );
 
   public:
     unsigned int idim;
     gsl_vector *x;
     gsl_vector *xold;
     gsl_vector *xnew;
-//     gsl_vector *xbest;
+    gsl_vector *xbest;
     gsl_vector *dx;
     gsl_vector *dxscal;
 //     gsl_vector *grad;
@@ -345,7 +473,7 @@ class NewFitterGSL : public BaseFitter {
     gsl_matrix *W;
     gsl_matrix *W2;
     gsl_matrix *W3;
-    // these are only used locally in calcCovMatrix
+    // these are only used locally in calcCovMatrix and solveReduced
     gsl_matrix *M1;
     gsl_matrix *M2;
     gsl_matrix *M3;
@@ -376,6 +504,38 @@ class NewFitterGSL : public BaseFitter {
     int imerit;
     bool try2ndOrderCorr;
     
+    ArrowheadSolver *arrowhead;                      ///< Block arrowhead solver, 0 if not used
+    std::vector<BaseFitObject *> sharedfitobjects;   ///< Fit objects shared by the blocks
+    std::vector<int> sharedrows;                     ///< Work array: global parameter numbers of shared fit objects
+    bool nullspace;                                  ///< Solve the Newton step in the null space of the constraints
+    
+    /// An unmeasured fit object whose momentum is fixed by three momentum constraints
+    struct Elimination {
+      ParticleFitObject *fo;                         ///< The eliminated fit object, parametrised by E, theta, phi
+      MomentumConstraint *con[3];                    ///< The eliminated constraints
+      double Finv[3][3];                             ///< Inverse of the factors of px, py, pz of fo in the constraints
+    };
+    bool eliminate;                                  ///< Eliminate unmeasured fit objects
+    std::vector<Elimination> eliminations;           ///< The eliminated fit objects
+    std::vector<int> keptrows;                       ///< Global numbers of the variables of the reduced system
+    std::vector<int> elimrows;                       ///< Global numbers of the eliminated parameters
+    std::vector<int> elimcons;                       ///< Global numbers of the eliminated constraints
+    gsl_matrix *Sred;                                ///< Derivatives of the eliminated parameters w.r.t. the reduced variables
+    gsl_vector *yred;
+    gsl_vector *yredscal;
+    gsl_vector *ered;
+    gsl_vector *dxredscal;
+    
+    bool trustregion;                                ///< Control the step length by a trust region
+    double trradius0;                                ///< Initial trust region radius
+    double trradius;                                 ///< Current trust region radius
+    double trmu;                                     ///< Penalty parameter of the trust region merit function
+    int nrejected;                                   ///< Number of rejected trial steps in the last fit
+    gsl_matrix *Wcg;                                 ///< Work vectors of the conjugate gradient iteration
+    double lmlambda;                                 ///< Damping of the Levenberg-Marquardt step, 0: not yet set
+    double lmnu;                                     ///< Factor for the next increase of lmlambda
+    double violbest;                                 ///< Constraint violation of xbest
+    
     int debug;
 };
 
@@ -94,6 +94,12 @@ class NewtonFitterGSL : public BaseFitter {
     /// Calculate the vector dx to update the parameters; returns fail code, 0=OK
     int calcDxSVD ();
     
+    /// Calculate eigenvalues and eigenvectors of Mscal into Meval and Mevec; returns fail code, 0=OK
+    int calcEigen ();
+    
+    /// Refine the eigenvectors of the previous calcEigen call for the current Mscal; false if Mscal has changed too much
+    bool refineEigen ();
+    
     /// Print a Matrix M and a vector y of dimension idim
     void printMy (double M[], double y[], int idim);
     
@@ -159,6 +165,7 @@ class NewtonFitterGSL : public BaseFitter {
     gsl_permutation *permM;
     gsl_eigen_symmv_workspace *ws; 
     unsigned int wsdim;
+    bool evecvalid;    ///< Mevec holds the eigenvectors of a previous Mscal of this fit
     
     double chi2best;
     double chi2new;
@@ -136,6 +136,8 @@ class OPALFitterGSL : public BaseFitter {
     virtual int    getNunm() const;
     
     virtual bool initialize();
+    /// False: soft constraints are not supported
+    virtual bool supportsSoftConstraints() const;
   
     /// Set the Debug Level
     virtual void setDebug (int debuglevel);
@@ -162,13 +164,26 @@ class OPALFitterGSL : public BaseFitter {
     
     static void debug_print (gsl_matrix *m, const char *name);
     static void debug_print (gsl_vector *v, const char *name);
+
+    /// Decompose the symmetric matrix A into Adec: Cholesky if A is positive definite, else LU; 0 if A is regular
+    int decomposeSym (const gsl_matrix *A,      ///< The matrix
+                      gsl_matrix *Adec,         ///< The decomposition
+                      gsl_permutation *perm,    ///< The permutation, for LU
+                      bool& cholesky            ///< true for Cholesky, false for LU
+                     );
+    /// Replace v by A^-1 v, with the decomposition from decomposeSym
+    int solveSym (const gsl_matrix *Adec, const gsl_permutation *perm, bool cholesky, gsl_vector *v);
+    /// Replace B by A^-1 B, with the decomposition from decomposeSym
+    int solveSym (const gsl_matrix *Adec, const gsl_permutation *perm, bool cholesky, gsl_matrix *B);
+    /// Calculate Ainv = A^-1 from the decomposition from decomposeSym
+    int invertSym (const gsl_matrix *Adec, const gsl_permutation *perm, bool cholesky, gsl_matrix *Ainv);
     
   private:
     gsl_vector *f; 
     gsl_vector *r; 
     gsl_matrix *Fetaxi; 
     gsl_matrix *S; 
-    gsl_matrix *Sinv; 
+    gsl_matrix *SLU;          ///< Decomposition of S, see decomposeSym
     gsl_matrix *SinvFxi; 
     gsl_matrix *SinvFeta; 
     gsl_matrix *W1; 
@@ -177,8 +192,9 @@ class OPALFitterGSL : public BaseFitter {
     gsl_matrix *HU; 
     gsl_matrix *IGV; 
     gsl_matrix *V; 
-    gsl_matrix *VLU; 
-    gsl_matrix *Vinv; 
+    gsl_matrix *VLU;          ///< Decomposition of Vetaeta, see decomposeSym
+    gsl_matrix *Vsv;          ///< Vetaeta at the time of its decomposition
+    gsl_matrix *Vinv;         ///< Inverse of Vetaeta, only for the error calculation
     gsl_matrix *Vnew; 
     gsl_matrix *Minv; 
     gsl_matrix *dxdt; 
@@ -198,6 +214,10 @@ class OPALFitterGSL : public BaseFitter {
     gsl_permutation *permS; ///< Helper permutation vector
     gsl_permutation *permU; ///< Helper permutation vector
     gsl_permutation *permV; ///< Helper permutation vector
+
+    bool Scholesky;           ///< SLU is a Cholesky decomposition
+    bool Vcholesky;           ///< VLU is a Cholesky decomposition
+    bool Vvalid;              ///< VLU is the decomposition of Vsv
     
     int debug;
     
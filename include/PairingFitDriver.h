@@ -0,0 +1,182 @@
+/*! \file
+ *  \brief Declares class PairingFitDriver
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Added pruning of permutations with chi2 bounds
+ * - 18.10.2026 Reuse inverse covariance matrices and caches of the jets across permutations
+ *
+ */
+
+#ifndef __PAIRINGFITDRIVER_H
+#define __PAIRINGFITDRIVER_H
+
+#include <vector>
+#include <atomic>
+
+#include "ThreadPool.h"
+#include "JetFitObject.h"
+
+class BaseJetPairing;
+class BasePairingHypothesis;
+
+//  Class PairingFitResult
+/// Result of the fit of one jet permutation
+class PairingFitResult {
+  public:
+    PairingFitResult();
+
+    int    iperm;      ///< Number of the permutation (0 ... nperm-1)
+    bool   fitted;     ///< False if the fit was cancelled or pruned before it started
+    bool   pruned;     ///< True if the fit was skipped because its bound exceeded the best chi2
+    double bound;      ///< Chi2 bound from BasePairingHypothesis::getChi2Bound (if pruning is on)
+    int    error;      ///< Error code of the fitter (getError())
+    double prob;       ///< Fit probability
+    double chi2;       ///< Fit chi2
+    int    nit;        ///< Number of iterations
+    /// The fitted jets, in the order in which the pairing stores them
+    std::vector<JetFitObject> fitted_jets;
+};
+
+//  Class PairingFitDriver
+/// Fits all jet permutations of an event concurrently and selects the best ones
+/**
+ * Instead of looping over BaseJetPairing::nextPermutation and calling
+ * BaseFitter::fit for each permutation in turn, the PairingFitDriver
+ * distributes the permutations of an event over a ThreadPool.
+ * Every thread works on its own copy of the BasePairingHypothesis
+ * (i.e. its own constraints and fitter) and on its own copies of the jets,
+ * so the jets handed to the pairing are not touched during the fits.
+ * The constraint-independent quantities of the jets (inverse covariance
+ * matrix, trigonometric and derivative caches) are calculated once per
+ * event (BaseFitObject::precompute) and passed on by assign, so every
+ * permutation starts from the same prepared state.
+ *
+ * After fitPermutations, the successful fits (getError()==0) are ranked
+ * by decreasing fit probability (ties: increasing chi2); the best
+ * topk results can be retrieved with getResult, and applyResult
+ * copies the fitted jets of a result back to the jets of the pairing.
+ *
+ * Optionally, no further permutations are started once a fit has
+ * reached a probability of at least the cancel probability;
+ * fits that are already running are completed.
+ * Pruning (setPruning) adds a cheap pre-filter stage: first, 
+ * BasePairingHypothesis::getChi2Bound is evaluated for all permutations,
+ * then the permutations are fitted in the order of increasing bound,
+ * and a permutation is skipped if prunefactor times its bound exceeds
+ * the lowest chi2 of all successful fits so far.
+ * Since the bound usually is an estimate from a linearisation,
+ * a prunefactor below 1 makes the pruning more conservative.
+ * The number of pruned fits is counted per event and in total.
+ *
+ * With cancellation or pruning enabled the set of fitted permutations 
+ * depends on the scheduling, without them the result is independent 
+ * of the number of threads.
+ *
+ * With more than one thread, the GSL error handler is switched off
+ * while the permutations are fitted (see ThreadPool::run); the fitters
+ * rely on this to be thread safe, so other code must not set a
+ * GSL error handler meanwhile.
+ *
+ */
+class PairingFitDriver: protected ParallelTask {
+  public:
+    /// Constructor
+    PairingFitDriver (const BasePairingHypothesis& hypothesis_,  ///< Prototype of the hypothesis, copied per thread
+                      int nthreads = 0                           ///< Number of threads, 0: one per core
+                     );
+    /// Virtual destructor
+    virtual ~PairingFitDriver();
+
+    /// Set number of results to keep; 0 keeps all successful fits
+    virtual void setTopK (int topk_);
+    /// Do not start new fits once a fit has reached this probability
+    virtual void setCancelProbability (double probcut_);
+    /// Switch pruning with chi2 bounds on or off
+    virtual void setPruning (bool prune_,              ///< Pruning on/off
+                             double prunefactor_ = 1   ///< Prune if prunefactor*bound > best chi2
+                            );
+
+    /// Fit all permutations of pairing; returns the number of successful fits
+    virtual int fitPermutations (BaseJetPairing& pairing);
+
+    /// Number of permutations of the last event
+    virtual int getNPerm() const;
+    /// Number of permutations actually fitted in the last event
+    virtual int getNFitted() const;
+    /// Number of permutations pruned in the last event
+    virtual int getNPruned() const;
+    /// Total number of permutations seen since construction or resetStatistics
+    virtual long getNPermTotal() const;
+    /// Total number of permutations pruned since construction or resetStatistics
+    virtual long getNPrunedTotal() const;
+    /// Reset the total counters
+    virtual void resetStatistics();
+    /// Number of ranked results (at most topk)
+    virtual int getNResults() const;
+    /// Get ranked result irank (0 = best)
+    virtual const PairingFitResult& getResult (int irank = 0) const;
+    /// Get result of permutation iperm, whether successful or not
+    virtual const PairingFitResult& getPermutationResult (int iperm) const;
+    /// Copy the fitted jets of ranked result irank to the jets of the pairing
+    virtual bool applyResult (int irank = 0);
+
+    /// Number of threads used
+    virtual int getNThreads() const;
+
+  protected:
+    /// Copy constructor disabled
+    PairingFitDriver (const PairingFitDriver& rhs);
+    /// Assignment disabled
+    PairingFitDriver& operator= (const PairingFitDriver& rhs);
+
+    /// Depending on phase, calculate the bound or do the fit of work item itask
+    virtual void execute (int itask, int ithread);
+    
+    /// Prepare the jet copies of thread ithread for permutation iperm
+    void setupPermutation (int iperm, int ithread);
+    /// Calculate the chi2 bound of permutation iperm
+    void boundPermutation (int iperm, int ithread);
+    /// Fit permutation iperm
+    void fitPermutation (int iperm, int ithread);
+    /// Lower the best chi2 so far to chi2, if it is lower
+    void updateBestChi2 (double chi2);
+
+    /// Determine the jets and the permutation table from pairing
+    void readPermutations (BaseJetPairing& pairing);
+    /// Create per-thread copies of the jets of the current event
+    void copyJets();
+    /// Sort the successful results into ranking
+    void rankResults();
+
+    ThreadPool pool;                  ///< The worker threads
+    int topk;                         ///< Number of results to keep
+    double probcut;                   ///< Cancel probability
+    bool prune;                       ///< Pruning on/off
+    double prunefactor;               ///< Factor applied to the bounds
+    
+    enum {PHASE_BOUND, PHASE_FIT};
+    int phase;                        ///< What execute does
+
+    int nperm;                        ///< Number of permutations
+    int njets;                        ///< Number of jets per permutation
+    std::vector<JetFitObject *> jets; ///< The distinct jets of the event, as stored by the pairing
+    std::vector<int> permtable;       ///< nperm x njets indices into jets
+
+    std::vector<BasePairingHypothesis *> hypotheses;      ///< One hypothesis per thread
+    std::vector<std::vector<JetFitObject *> > jetcopies;  ///< One set of jet copies per thread
+    std::vector<std::vector<JetFitObject *> > permjets;   ///< Per-thread permuted jet pointers
+
+    std::vector<PairingFitResult> results;  ///< Results per permutation
+    std::vector<int> ranking;               ///< Permutation numbers of the ranked results
+    std::vector<int> fitorder;              ///< Order in which the permutations are fitted
+
+    long npermtotal;                        ///< Total number of permutations
+    long nprunedtotal;                      ///< Total number of pruned permutations
+    
+    std::atomic<double> bestchi2;           ///< Lowest chi2 of a successful fit so far
+
+    std::atomic<bool> cancelled;            ///< Set once a fit passed probcut
+};
+
+#endif // __PAIRINGFITDRIVER_H
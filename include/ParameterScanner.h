@@ -18,21 +18,34 @@
  * -
  *
  */ 
-#ifdef MARLIN_USE_ROOT
 
 #ifndef __PARAMETERSCANNER_H
 #define __PARAMETERSCANNER_H
 
-#include <vector>
-
-class BaseFitter;
-class BaseFitObject;
-class BaseHardConstraint;
+#include "BaseScanner.h"
 
-class ParameterScanner {
+//  Class ParameterScanner
+/// Evaluates chi2, constraints and the first step of the fit over a grid of two parameters
+/**
+ * The result holds the chi2 of the fit objects and the constraint values
+ * at each grid point. For a NewFitterGSL, it also holds the Lagrange 
+ * multipliers, the merit function phi1 for penalty parameter mumerit,
+ * the end point of the full Newton step (xfull, yfull), and
+ * alpha, mu and end point (xend, yend) of the limited step.
+ *
+ */
+class ParameterScanner: public BaseScanner {
   public:
+    /// Constructor for a serial scan
     ParameterScanner (BaseFitter& fitter_);
+    /// Constructor for a parallel scan, one fitter per thread
+    ParameterScanner (const std::vector<BaseFitter *>& fitters_);
     
+    /// Set the penalty parameter of the merit function
+    void setMuMerit (double mumerit_);
+
+#ifdef MARLIN_USE_ROOT
+    /// Scan and write histograms and graphs
     void doScan (int xglobal, 
                  int nx,
                  double xstart,
@@ -44,23 +57,15 @@ class ParameterScanner {
                  const char *idprefix="",
                  const char *titleprefix="",
                  double mumerit=0);
-  
+#endif
   
   protected:
-    
-    typedef std::vector <BaseFitObject *> FitObjectContainer;
-    typedef std::vector <BaseHardConstraint *> ConstraintContainer;
-    
-    typedef FitObjectContainer::iterator FitObjectIterator;
-    typedef ConstraintContainer::iterator ConstraintIterator;
-    
-    BaseFitter& fitter;
+    /// Evaluate point (ix, iy)
+    virtual void scanPoint (int ix, int iy, int ithread);
+
+    double mumerit;   ///< Penalty parameter of the merit function
     
     enum {NCONMAX=100};
-
-
 };
 
 #endif /* #ifndef __PARAMETERSCANNER_H */
-
-#endif // MARLIN_USE_ROOT
@@ -112,6 +112,17 @@ class ParticleConstraint: public BaseHardConstraint {
       fitobjects.resize (0);
       flags.resize (0);
     }; 
+    /// Replaces ParticleFitObject number ifo of the list and its flag
+    /** Reattaches the constraint to other fit objects (e.g. for the next
+     *  jet permutation) without rebuilding the list.
+     */
+    virtual void replaceFO(int ifo, ParticleFitObject& fitobject, int flag = 1
+                           ){
+      assert (ifo >= 0 && ifo < (int) fitobjects.size());
+      fitobjects[ifo] = reinterpret_cast < BaseFitObject* > ( &fitobject );
+      flags[ifo] = flag;
+      invalidateCache();
+    }; 
 
     /// Invalidates any cached values for the next event
     virtual void invalidateCache() const 
@@ -0,0 +1,57 @@
+/*! \file
+ *  \brief Declares class PerfCounterGroup
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#ifndef __PERFCOUNTERGROUP_H
+#define __PERFCOUNTERGROUP_H
+
+#include <cstdint>
+
+//  Class PerfCounterGroup
+/// A group of hardware performance counters of the calling thread
+/**
+ * Opens cycles, instructions, cache misses and branch misses as one
+ * group with the Linux perf_event_open system call, so that all four
+ * are counted over the same time intervals. Only user space is counted,
+ * and only for the thread that constructed the group.
+ *
+ * If the counters are not available (not Linux, no PMU in a virtual
+ * machine, perf_event_paranoid too restrictive), isValid returns false
+ * and read fails.
+ *
+ * If the kernel has to multiplex the counters, the values are scaled
+ * by enabled time / running time and are therefore estimates.
+ *
+ */
+class PerfCounterGroup {
+  public:
+    /// The counted events
+    enum {CYCLES, INSTRUCTIONS, CACHEMISSES, BRANCHMISSES, NEVENTS};
+
+    /// Constructor, opens and starts the counters for the calling thread
+    PerfCounterGroup();
+    /// Virtual destructor, closes the counters
+    virtual ~PerfCounterGroup();
+
+    /// False if the counters could not be opened
+    virtual bool isValid() const;
+    /// Read the current values of all counters; false on failure
+    bool read (uint64_t values[NEVENTS]) const;
+
+    /// Name of an event
+    static const char *getEventName (int ievent);
+
+  protected:
+    /// Copy constructor disabled
+    PerfCounterGroup (const PerfCounterGroup& rhs);
+    /// Assignment disabled
+    PerfCounterGroup& operator= (const PerfCounterGroup& rhs);
+
+    int fds[NEVENTS];   ///< File descriptors, fds[0] is the group leader; -1 if not open
+};
+
+#endif // __PERFCOUNTERGROUP_H
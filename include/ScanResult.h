@@ -0,0 +1,196 @@
+/*! \file
+ *  \brief Declares classes ScanResult, ScanPoint and AdaptiveScanResult
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Added ScanPoint and AdaptiveScanResult
+ *
+ */
+
+#ifndef __SCANRESULT_H
+#define __SCANRESULT_H
+
+#include <vector>
+#include <string>
+#include <map>
+
+#ifdef MARLIN_USE_ROOT
+class TH2F;
+#endif
+
+//  Class ScanResult
+/// Results of a two-dimensional parameter scan, stored in plain arrays
+/**
+ * The grid has nx x ny points; point (ix, iy), ix = 0 ... nx-1, 
+ * iy = 0 ... ny-1, lies at the centre of a bin, as in a TH2F with 
+ * nx bins from xstart to xstop and ny bins from ystart to ystop.
+ * All quantities are stored in one vector each, with index ix*ny+iy;
+ * constraint values and lambdas have an additional index icon, 
+ * with index (ix*ny+iy)*ncon+icon.
+ *
+ * Which quantities are filled depends on the scanner;
+ * quantities that are not filled are 0.
+ *
+ */
+class ScanResult {
+  public:
+    ScanResult();
+
+    /// Set the grid and set all quantities to 0
+    void setGrid (int xglobal_, int nx_, double xstart_, double xstop_,
+                  int yglobal_, int ny_, double ystart_, double ystop_, 
+                  int ncon_);
+
+    /// Index of point (ix, iy)
+    int index (int ix, int iy) const {return ix*ny+iy;};
+    /// x value of column ix
+    double getX (int ix) const;
+    /// y value of row iy
+    double getY (int iy) const;
+    /// Number of grid points
+    int getNPoints() const {return nx*ny;};
+
+    /// The quantities that can be retrieved with getValue
+    enum {CHI2, ALPHA, LOG2ALPHA, MU, PHI, NIT, ERROR, XEND, YEND, XFULL, YFULL, CON, LAMBDA, NQUANTITIES};
+    /// Get a quantity at point (ix, iy); icon is used for CON and LAMBDA only
+    double getValue (int quantity, int ix, int iy, int icon = 0) const;
+    /// Name of a quantity, as used in histogram ids
+    static const char *getQuantityName (int quantity);
+
+#ifdef MARLIN_USE_ROOT
+    /// Create a histogram of a quantity
+    TH2F *createHist (int quantity,       ///< The quantity
+                      const char *id,     ///< Histogram id
+                      const char *title,  ///< Histogram title
+                      int icon = 0        ///< Constraint number, for CON and LAMBDA
+                     ) const;
+#endif
+
+    int xglobal;               ///< Global number of x parameter
+    int nx;                    ///< Number of points in x
+    double xstart;             ///< Lower edge in x
+    double xstop;              ///< Upper edge in x
+    int yglobal;               ///< Global number of y parameter
+    int ny;                    ///< Number of points in y
+    double ystart;             ///< Lower edge in y
+    double ystop;              ///< Upper edge in y
+    int ncon;                  ///< Number of constraints
+    std::string xname;         ///< Name of x parameter
+    std::string yname;         ///< Name of y parameter
+    std::vector<std::string> connames;  ///< Names of the constraints
+
+    std::vector<double> chi2;  ///< Chi2 (at the start point or after the fit)
+    std::vector<double> alpha; ///< Step length alpha
+    std::vector<double> mu;    ///< Penalty parameter mu
+    std::vector<double> phi;   ///< Merit function
+    std::vector<int>    nit;   ///< Number of iterations
+    std::vector<int>    error; ///< Fit error code
+    std::vector<double> xend;  ///< x after the fit or the (limited) step
+    std::vector<double> yend;  ///< y after the fit or the (limited) step
+    std::vector<double> xfull; ///< x after a full Newton step
+    std::vector<double> yfull; ///< y after a full Newton step
+    std::vector<double> con;   ///< Constraint values
+    std::vector<double> lambda;   ///< Lagrange multipliers
+};
+
+//  Class ScanPoint
+/// Result of the fit started from one point of a scan
+class ScanPoint {
+  public:
+    ScanPoint();
+
+    /// Get a quantity (ScanResult::CHI2 ... ScanResult::YEND)
+    double getValue (int quantity) const;
+
+    double x;       ///< Start value of x parameter
+    double y;       ///< Start value of y parameter
+    double chi2;    ///< Chi2 after the fit
+    double alpha;   ///< Last step length alpha
+    double mu;      ///< Last penalty parameter mu
+    double phi;     ///< Last merit function
+    int    nit;     ///< Number of iterations
+    int    error;   ///< Fit error code
+    double xend;    ///< Fitted x
+    double yend;    ///< Fitted y
+};
+
+//  Class AdaptiveScanResult
+/// Results of an adaptive scan, on a quadtree of cells
+/**
+ * Level 0 is a grid of nstart x nstart cells over the scan range;
+ * a cell at level l with indices (ix, iy) is divided into the four cells
+ * (2ix, 2iy) ... (2ix+1, 2iy+1) at level l+1.
+ * Every evaluated cell holds the fit result started at its centre;
+ * cells that were not divided are leaves. 
+ * Cells are stored in order of increasing level.
+ *
+ * getValue and createHist look up the leaf that covers a point of 
+ * the finest grid (nstart*2^maxlevel points per direction).
+ *
+ */
+class AdaptiveScanResult {
+  public:
+    AdaptiveScanResult();
+
+    /// One cell of the quadtree
+    struct Cell {
+      int level;        ///< Refinement level, 0 = coarsest
+      int ix;           ///< x index at this level
+      int iy;           ///< y index at this level
+      bool leaf;        ///< True if the cell was not divided
+      ScanPoint point;  ///< Fit result from the centre of the cell
+    };
+
+    /// Remove all cells and set the range
+    void setRange (int xglobal_, double xstart_, double xstop_,
+                   int yglobal_, double ystart_, double ystop_,
+                   int nstart_, int maxlevel_);
+    /// Add a cell at the centre of (level, ix, iy); returns its number
+    int addCell (int level, int ix, int iy);
+    /// Number of cells per direction at level
+    int getNPoints (int level) const {return nstart << level;};
+    /// x value of the centre of column ix at level
+    double getX (int level, int ix) const;
+    /// y value of the centre of row iy at level
+    double getY (int level, int iy) const;
+    /// Number of the cell with indices (ix, iy) at level, or of the deepest cell covering it; -1 if none
+    int findCell (int level, int ix, int iy) const;
+
+    /// Number of evaluated cells (i.e. fits)
+    int getNCells() const {return cells.size();};
+    /// Number of leaf cells
+    int getNLeaves() const;
+
+    enum {LEVEL = ScanResult::NQUANTITIES};   ///< Additional quantity: level of the leaf
+    /// Get a quantity at point (ix, iy) of the finest grid
+    double getValue (int quantity, int ix, int iy) const;
+#ifdef MARLIN_USE_ROOT
+    /// Create a histogram of a quantity with the binning of the finest grid
+    TH2F *createHist (int quantity,       ///< The quantity
+                      const char *id,     ///< Histogram id
+                      const char *title   ///< Histogram title
+                     ) const;
+#endif
+
+    int xglobal;               ///< Global number of x parameter
+    double xstart;             ///< Lower edge in x
+    double xstop;              ///< Upper edge in x
+    int yglobal;               ///< Global number of y parameter
+    double ystart;             ///< Lower edge in y
+    double ystop;              ///< Upper edge in y
+    int nstart;                ///< Number of cells per direction at level 0
+    int maxlevel;              ///< Finest level
+    std::string xname;         ///< Name of x parameter
+    std::string yname;         ///< Name of y parameter
+
+    std::vector<Cell> cells;   ///< The cells
+
+  protected:
+    /// Key of cell (level, ix, iy) in cellindex
+    static long long key (int level, int ix, int iy) {
+      return ((long long)level << 48) | ((long long)ix << 24) | (long long)iy;
+    };
+    std::map<long long, int> cellindex;   ///< Cell number by key
+};
+
+#endif // __SCANRESULT_H
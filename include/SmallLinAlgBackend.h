@@ -0,0 +1,601 @@
+/*! \file
+ *  \brief Declares and implements class SmallLinAlgBackend
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Added dtrsv
+ * - 18.10.2026 Scratch vectors on the stack, in-place Cholesky inversion
+ *
+ */
+
+#ifndef __SMALLLINALGBACKEND_H
+#define __SMALLLINALGBACKEND_H
+
+#include "LinAlgBackend.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <stdint.h>
+
+#include <gsl/gsl_errno.h>
+
+//  Class SmallLinAlgBackend
+/// LinAlgBackend for small matrices, header only
+/**
+ * The fit problems have 10 to 40 dimensions, so all matrices fit
+ * into the L1 cache, and the cost of GSL's BLAS is dominated by
+ * the per call overhead (argument checks, dispatch through CBLAS,
+ * element access through gsl_matrix_get/set).
+ *
+ * This backend works directly on the data arrays. All inner loops
+ * run along rows with unit stride (gsl_matrix is row major)
+ * and use __restrict pointers, so that the compiler can vectorize
+ * them. dgemm loops over blocks of BLOCKSIZE columns of op(A),
+ * so that the rows of op(B) in use stay in the cache also for
+ * larger matrices.
+ *
+ * Scratch vectors of up to MAXSTACK elements live on the stack,
+ * so that the solves do not allocate memory.
+ *
+ * The decompositions use the same algorithms (partial pivoting,
+ * storage of L and L^T) as GSL, so results agree with GSLLinAlgBackend
+ * up to rounding.
+ *
+ */
+class SmallLinAlgBackend: public LinAlgBackend {
+  public:
+    enum {BLOCKSIZE = 32};   ///< Block size for dgemm
+    enum {MAXSTACK = 128};   ///< Maximum size of scratch vectors on the stack
+
+    /// Constructor
+    SmallLinAlgBackend() {}
+    /// Virtual destructor
+    virtual ~SmallLinAlgBackend() {}
+
+    virtual const char *getName() const {return "small";}
+
+    virtual double ddot (const gsl_vector *x, const gsl_vector *y) const {
+      size_t n = x->size;
+      const double *__restrict xd = x->data;
+      const double *__restrict yd = y->data;
+      double result = 0;
+      if (x->stride == 1 && y->stride == 1) {
+        for (size_t i = 0; i < n; ++i) result += xd[i]*yd[i];
+      }
+      else {
+        for (size_t i = 0; i < n; ++i) result += xd[i*x->stride]*yd[i*y->stride];
+      }
+      return result;
+    }
+
+    virtual double dnrm2 (const gsl_vector *x) const {
+      // scaled as in BLAS, to avoid overflow
+      double scale = 0, ssq = 1;
+      for (size_t i = 0; i < x->size; ++i) {
+        double a = std::fabs (x->data[i*x->stride]);
+        if (a == 0) continue;
+        if (scale < a) {
+          ssq = 1 + ssq*(scale/a)*(scale/a);
+          scale = a;
+        }
+        else ssq += (a/scale)*(a/scale);
+      }
+      return scale*std::sqrt (ssq);
+    }
+
+    virtual double dasum (const gsl_vector *x) const {
+      double result = 0;
+      for (size_t i = 0; i < x->size; ++i) result += std::fabs (x->data[i*x->stride]);
+      return result;
+    }
+
+    virtual size_t idamax (const gsl_vector *x) const {
+      size_t result = 0;
+      double max = 0;
+      for (size_t i = 0; i < x->size; ++i) {
+        double a = std::fabs (x->data[i*x->stride]);
+        if (a > max || std::isnan (a)) {
+          result = i;
+          if (std::isnan (a)) break;
+          max = a;
+        }
+      }
+      return result;
+    }
+
+    virtual void dcopy (const gsl_vector *x, gsl_vector *y) const {
+      if (x->size != y->size) {
+        GSL_ERROR_VOID ("invalid length", GSL_EBADLEN);
+      }
+      for (size_t i = 0; i < x->size; ++i) y->data[i*y->stride] = x->data[i*x->stride];
+    }
+
+    virtual void daxpy (double alpha, const gsl_vector *x, gsl_vector *y) const {
+      if (x->size != y->size) {
+        GSL_ERROR_VOID ("invalid length", GSL_EBADLEN);
+      }
+      size_t n = x->size;
+      const double *__restrict xd = x->data;
+      double *__restrict yd = y->data;
+      if (x->stride == 1 && y->stride == 1) {
+        for (size_t i = 0; i < n; ++i) yd[i] += alpha*xd[i];
+      }
+      else {
+        for (size_t i = 0; i < n; ++i) yd[i*y->stride] += alpha*xd[i*x->stride];
+      }
+    }
+
+    virtual void dscal (double alpha, gsl_vector *x) const {
+      for (size_t i = 0; i < x->size; ++i) x->data[i*x->stride] *= alpha;
+    }
+
+    virtual void dgemv (CBLAS_TRANSPOSE_t TransA, double alpha, const gsl_matrix *A,
+                        const gsl_vector *x, double beta, gsl_vector *y) const {
+      size_t m = A->size1, n = A->size2;
+      bool trans = (TransA != CblasNoTrans);
+      if ((trans ? m : n) != x->size || (trans ? n : m) != y->size) {
+        GSL_ERROR_VOID ("invalid length", GSL_EBADLEN);
+      }
+      scale (beta, y);
+      if (alpha == 0) return;
+      if (!trans) {
+        // y_i += alpha * row_i . x
+        for (size_t i = 0; i < m; ++i) {
+          const double *__restrict a = A->data + i*A->tda;
+          double sum = 0;
+          if (x->stride == 1) {
+            const double *__restrict xd = x->data;
+            for (size_t j = 0; j < n; ++j) sum += a[j]*xd[j];
+          }
+          else {
+            for (size_t j = 0; j < n; ++j) sum += a[j]*x->data[j*x->stride];
+          }
+          y->data[i*y->stride] += alpha*sum;
+        }
+      }
+      else {
+        // y += alpha * x_i * row_i
+        for (size_t i = 0; i < m; ++i) {
+          double f = alpha*x->data[i*x->stride];
+          if (f == 0) continue;
+          const double *__restrict a = A->data + i*A->tda;
+          if (y->stride == 1) {
+            double *__restrict yd = y->data;
+            for (size_t j = 0; j < n; ++j) yd[j] += f*a[j];
+          }
+          else {
+            for (size_t j = 0; j < n; ++j) y->data[j*y->stride] += f*a[j];
+          }
+        }
+      }
+    }
+
+    virtual void dsymv (CBLAS_UPLO_t Uplo, double alpha, const gsl_matrix *A,
+                        const gsl_vector *x, double beta, gsl_vector *y) const {
+      size_t n = A->size1;
+      if (A->size2 != n) {
+        GSL_ERROR_VOID ("matrix must be square", GSL_ENOTSQR);
+      }
+      if (x->size != n || y->size != n) {
+        GSL_ERROR_VOID ("invalid length", GSL_EBADLEN);
+      }
+      scale (beta, y);
+      if (alpha == 0) return;
+      for (size_t i = 0; i < n; ++i) {
+        double sum = 0;
+        for (size_t j = 0; j < n; ++j) sum += symget (Uplo, A, i, j)*x->data[j*x->stride];
+        y->data[i*y->stride] += alpha*sum;
+      }
+    }
+
+    virtual void dgemm (CBLAS_TRANSPOSE_t TransA, CBLAS_TRANSPOSE_t TransB, double alpha,
+                        const gsl_matrix *A, const gsl_matrix *B, double beta, gsl_matrix *C) const {
+      bool ta = (TransA != CblasNoTrans);
+      bool tb = (TransB != CblasNoTrans);
+      size_t m = ta ? A->size2 : A->size1;
+      size_t k = ta ? A->size1 : A->size2;
+      size_t kb = tb ? B->size2 : B->size1;
+      size_t n = tb ? B->size1 : B->size2;
+      if (m != C->size1 || n != C->size2 || k != kb) {
+        GSL_ERROR_VOID ("invalid length", GSL_EBADLEN);
+      }
+      scale (beta, C);
+      if (alpha == 0) return;
+      if (!tb) {
+        // C_i. += alpha op(A)_il B_l. ; rows of B and C have unit stride
+        for (size_t l0 = 0; l0 < k; l0 += BLOCKSIZE) {
+          size_t l1 = (l0 + BLOCKSIZE < k) ? l0 + BLOCKSIZE : k;
+          for (size_t i = 0; i < m; ++i) {
+            double *__restrict c = C->data + i*C->tda;
+            for (size_t l = l0; l < l1; ++l) {
+              double f = alpha*(ta ? A->data[l*A->tda+i] : A->data[i*A->tda+l]);
+              if (f == 0) continue;
+              const double *__restrict b = B->data + l*B->tda;
+              for (size_t j = 0; j < n; ++j) c[j] += f*b[j];
+            }
+          }
+        }
+      }
+      else if (!ta) {
+        // C_ij += alpha A_i. . B_j. ; both rows have unit stride
+        for (size_t i = 0; i < m; ++i) {
+          const double *__restrict a = A->data + i*A->tda;
+          for (size_t j = 0; j < n; ++j) {
+            const double *__restrict b = B->data + j*B->tda;
+            double sum = 0;
+            for (size_t l = 0; l < k; ++l) sum += a[l]*b[l];
+            C->data[i*C->tda+j] += alpha*sum;
+          }
+        }
+      }
+      else {
+        // C_ij += alpha A_li B_jl
+        for (size_t i = 0; i < m; ++i) {
+          for (size_t j = 0; j < n; ++j) {
+            const double *__restrict b = B->data + j*B->tda;
+            double sum = 0;
+            for (size_t l = 0; l < k; ++l) sum += A->data[l*A->tda+i]*b[l];
+            C->data[i*C->tda+j] += alpha*sum;
+          }
+        }
+      }
+    }
+
+    virtual void dsymm (CBLAS_SIDE_t Side, CBLAS_UPLO_t Uplo, double alpha,
+                        const gsl_matrix *A, const gsl_matrix *B, double beta, gsl_matrix *C) const {
+      size_t m = C->size1, n = C->size2;
+      if (A->size1 != A->size2) {
+        GSL_ERROR_VOID ("matrix A must be square", GSL_ENOTSQR);
+      }
+      if (B->size1 != m || B->size2 != n || A->size1 != (Side == CblasLeft ? m : n)) {
+        GSL_ERROR_VOID ("invalid length", GSL_EBADLEN);
+      }
+      scale (beta, C);
+      if (alpha == 0) return;
+      if (Side == CblasLeft) {
+        // C_i. += alpha A_il B_l.
+        for (size_t i = 0; i < m; ++i) {
+          double *__restrict c = C->data + i*C->tda;
+          for (size_t l = 0; l < m; ++l) {
+            double f = alpha*symget (Uplo, A, i, l);
+            if (f == 0) continue;
+            const double *__restrict b = B->data + l*B->tda;
+            for (size_t j = 0; j < n; ++j) c[j] += f*b[j];
+          }
+        }
+      }
+      else {
+        // C_i. += alpha B_il A_l.
+        for (size_t i = 0; i < m; ++i) {
+          double *__restrict c = C->data + i*C->tda;
+          for (size_t l = 0; l < n; ++l) {
+            double f = alpha*B->data[i*B->tda+l];
+            if (f == 0) continue;
+            for (size_t j = 0; j < n; ++j) c[j] += f*symget (Uplo, A, l, j);
+          }
+        }
+      }
+    }
+
+    virtual void dtrsv (CBLAS_UPLO_t Uplo, CBLAS_TRANSPOSE_t TransA, CBLAS_DIAG_t Diag,
+                        const gsl_matrix *A, gsl_vector *x) const {
+      size_t n = A->size1;
+      if (A->size2 != n) {
+        GSL_ERROR_VOID ("matrix must be square", GSL_ENOTSQR);
+      }
+      if (x->size != n) {
+        GSL_ERROR_VOID ("invalid length", GSL_EBADLEN);
+      }
+      bool trans = (TransA != CblasNoTrans);
+      bool unit = (Diag == CblasUnit);
+      // op(A) is lower triangular: forward substitution, else backward substitution
+      if ((Uplo == CblasLower) != trans) {
+        for (size_t i = 0; i < n; ++i) {
+          double sum = x->data[i*x->stride];
+          for (size_t j = 0; j < i; ++j) sum -= trget (trans, A, i, j)*x->data[j*x->stride];
+          x->data[i*x->stride] = unit ? sum : sum/trget (trans, A, i, i);
+        }
+      }
+      else {
+        for (size_t i = n; i-- > 0; ) {
+          double sum = x->data[i*x->stride];
+          for (size_t j = i+1; j < n; ++j) sum -= trget (trans, A, i, j)*x->data[j*x->stride];
+          x->data[i*x->stride] = unit ? sum : sum/trget (trans, A, i, i);
+        }
+      }
+    }
+
+    virtual int LUDecomp (gsl_matrix *A, gsl_permutation *p, int *signum) const {
+      size_t n = A->size1;
+      if (A->size2 != n) {
+        GSL_ERROR ("LU decomposition requires square matrix", GSL_ENOTSQR);
+      }
+      if (p->size != n) {
+        GSL_ERROR ("permutation length must match matrix size", GSL_EBADLEN);
+      }
+      for (size_t i = 0; i < n; ++i) p->data[i] = i;
+      *signum = 1;
+      size_t tda = A->tda;
+      double *d = A->data;
+      for (size_t j = 0; j + 1 < n; ++j) {
+        // partial pivoting: largest element in column j
+        size_t ipiv = j;
+        double max = std::fabs (d[j*tda+j]);
+        for (size_t i = j+1; i < n; ++i) {
+          double a = std::fabs (d[i*tda+j]);
+          if (a > max) {
+            max = a;
+            ipiv = i;
+          }
+        }
+        if (ipiv != j) {
+          double *__restrict rj = d + j*tda;
+          double *__restrict rp = d + ipiv*tda;
+          for (size_t l = 0; l < n; ++l) {
+            double tmp = rj[l];
+            rj[l] = rp[l];
+            rp[l] = tmp;
+          }
+          size_t tmp = p->data[j];
+          p->data[j] = p->data[ipiv];
+          p->data[ipiv] = tmp;
+          *signum = -*signum;
+        }
+        double ajj = d[j*tda+j];
+        if (ajj == 0) continue;
+        const double *__restrict rj = d + j*tda;
+        for (size_t i = j+1; i < n; ++i) {
+          double *__restrict ri = d + i*tda;
+          double f = (ri[j] /= ajj);
+          if (f == 0) continue;
+          for (size_t l = j+1; l < n; ++l) ri[l] -= f*rj[l];
+        }
+      }
+      return GSL_SUCCESS;
+    }
+
+    virtual double LUDet (gsl_matrix *LU, int signum) const {
+      double det = signum;
+      for (size_t i = 0; i < LU->size1; ++i) det *= LU->data[i*LU->tda+i];
+      return det;
+    }
+
+    virtual int LUSolve (const gsl_matrix *LU, const gsl_permutation *p, const gsl_vector *b, gsl_vector *x) const {
+      if (b->size != LU->size1 || x->size != LU->size1) {
+        GSL_ERROR ("matrix size must match vector sizes", GSL_EBADLEN);
+      }
+      for (size_t i = 0; i < b->size; ++i) x->data[i*x->stride] = b->data[i*b->stride];
+      return LUSvx (LU, p, x);
+    }
+
+    virtual int LUSvx (const gsl_matrix *LU, const gsl_permutation *p, gsl_vector *x) const {
+      size_t n = LU->size1;
+      if (LU->size2 != n) {
+        GSL_ERROR ("LU matrix must be square", GSL_ENOTSQR);
+      }
+      if (p->size != n || x->size != n) {
+        GSL_ERROR ("matrix size must match solution size", GSL_EBADLEN);
+      }
+      if (!isnonsingular (LU)) {
+        GSL_ERROR ("matrix is singular", GSL_EDOM);
+      }
+      Scratch scratch (n);
+      double *w = scratch.data();
+      for (size_t i = 0; i < n; ++i) w[i] = x->data[p->data[i]*x->stride];
+      substitute (LU, w, true);
+      for (size_t i = 0; i < n; ++i) x->data[i*x->stride] = w[i];
+      return GSL_SUCCESS;
+    }
+
+    virtual int LUInvert (const gsl_matrix *LU, const gsl_permutation *p, gsl_matrix *inverse) const {
+      size_t n = LU->size1;
+      if (LU->size2 != n) {
+        GSL_ERROR ("LU matrix must be square", GSL_ENOTSQR);
+      }
+      if (inverse->size1 != n || inverse->size2 != n) {
+        GSL_ERROR ("inverse matrix must match LU matrix dimensions", GSL_EBADLEN);
+      }
+      if (!isnonsingular (LU)) {
+        GSL_ERROR ("matrix is singular", GSL_EDOM);
+      }
+      Scratch scratch (n);
+      double *w = scratch.data();
+      for (size_t j = 0; j < n; ++j) {
+        // column j of P*I
+        for (size_t i = 0; i < n; ++i) w[i] = (p->data[i] == j);
+        substitute (LU, w, true);
+        for (size_t i = 0; i < n; ++i) inverse->data[i*inverse->tda+j] = w[i];
+      }
+      return GSL_SUCCESS;
+    }
+
+    virtual int choleskyDecomp (gsl_matrix *A) const {
+      size_t n = A->size1;
+      if (A->size2 != n) {
+        GSL_ERROR ("cholesky decomposition requires square matrix", GSL_ENOTSQR);
+      }
+      size_t tda = A->tda;
+      double *d = A->data;
+      // L in the lower triangle, row by row:
+      // L_ij = (A_ij - sum_l<j L_il L_jl)/L_jj, L_jj = sqrt (A_jj - sum_l<j L_jl^2)
+      for (size_t i = 0; i < n; ++i) {
+        double *__restrict ri = d + i*tda;
+        for (size_t j = 0; j <= i; ++j) {
+          const double *__restrict rj = d + j*tda;
+          double sum = ri[j];
+          for (size_t l = 0; l < j; ++l) sum -= ri[l]*rj[l];
+          if (j < i) ri[j] = sum/rj[j];
+          else if (sum > 0) ri[i] = std::sqrt (sum);
+          else {
+            GSL_ERROR ("matrix is not positive definite", GSL_EDOM);
+          }
+        }
+      }
+      // L^T in the upper triangle, as GSL
+      for (size_t i = 0; i < n; ++i)
+        for (size_t j = i+1; j < n; ++j) d[i*tda+j] = d[j*tda+i];
+      return GSL_SUCCESS;
+    }
+
+    virtual int choleskySolve (const gsl_matrix *LLT, const gsl_vector *b, gsl_vector *x) const {
+      if (b->size != LLT->size1 || x->size != LLT->size1) {
+        GSL_ERROR ("matrix size must match vector sizes", GSL_EBADLEN);
+      }
+      for (size_t i = 0; i < b->size; ++i) x->data[i*x->stride] = b->data[i*b->stride];
+      return choleskySvx (LLT, x);
+    }
+
+    virtual int choleskySvx (const gsl_matrix *LLT, gsl_vector *x) const {
+      size_t n = LLT->size1;
+      if (LLT->size2 != n) {
+        GSL_ERROR ("cholesky matrix must be square", GSL_ENOTSQR);
+      }
+      if (x->size != n) {
+        GSL_ERROR ("matrix size must match solution size", GSL_EBADLEN);
+      }
+      Scratch scratch (n);
+      double *w = scratch.data();
+      for (size_t i = 0; i < n; ++i) w[i] = x->data[i*x->stride];
+      substitute (LLT, w, false);
+      for (size_t i = 0; i < n; ++i) x->data[i*x->stride] = w[i];
+      return GSL_SUCCESS;
+    }
+
+    virtual int choleskyInvert (gsl_matrix *LLT) const {
+      size_t n = LLT->size1;
+      if (LLT->size2 != n) {
+        GSL_ERROR ("cholesky matrix must be square", GSL_ENOTSQR);
+      }
+      size_t tda = LLT->tda;
+      double *d = LLT->data;
+      // L^-1 in place, row by row: (L^-1)_ij = -(L^-1)_ii sum_j<=l<i L_il (L^-1)_lj;
+      // for ascending j, the elements L_il with l >= j are not yet overwritten
+      for (size_t i = 0; i < n; ++i) {
+        double *__restrict ri = d + i*tda;
+        double dinv = 1/ri[i];
+        for (size_t j = 0; j < i; ++j) {
+          double sum = 0;
+          for (size_t l = j; l < i; ++l) sum += ri[l]*d[l*tda+j];
+          ri[j] = -dinv*sum;
+        }
+        ri[i] = dinv;
+      }
+      // A^-1 = L^-T L^-1, row by row: (A^-1)_ij = sum_l>=i (L^-1)_li (L^-1)_lj for j <= i;
+      // row i of L^-1 is used only for row i of A^-1, the diagonal last
+      for (size_t i = 0; i < n; ++i) {
+        double *__restrict ri = d + i*tda;
+        for (size_t j = 0; j <= i; ++j) {
+          double sum = 0;
+          for (size_t l = i; l < n; ++l) sum += d[l*tda+i]*d[l*tda+j];
+          ri[j] = sum;
+        }
+      }
+      for (size_t i = 0; i < n; ++i)
+        for (size_t j = i+1; j < n; ++j) d[i*tda+j] = d[j*tda+i];
+      return GSL_SUCCESS;
+    }
+
+    virtual void scaleSym (gsl_matrix *Mscal, const gsl_matrix *M, const gsl_vector *e) const {
+      size_t n = M->size1;
+      if (M->size2 != n || Mscal->size1 != n || Mscal->size2 != n || e->size != n) {
+        GSL_ERROR_VOID ("invalid length", GSL_EBADLEN);
+      }
+      Scratch scratch (n);
+      double *ed = scratch.data();
+      for (size_t i = 0; i < n; ++i) ed[i] = e->data[i*e->stride];
+      const double *__restrict ee = ed;
+      for (size_t i = 0; i < n; ++i) {
+        const double *__restrict m = M->data + i*M->tda;
+        double *__restrict ms = Mscal->data + i*Mscal->tda;
+        double ei = ee[i];
+        for (size_t j = 0; j < n; ++j) ms[j] = ei*ee[j]*m[j];
+      }
+    }
+
+    virtual bool isfinite (const gsl_vector *v) const {
+      for (size_t i = 0; i < v->size; ++i) if (!isfinitebits (v->data[i*v->stride])) return false;
+      return true;
+    }
+
+    virtual bool isfinite (const gsl_matrix *m) const {
+      for (size_t i = 0; i < m->size1; ++i) {
+        const double *r = m->data + i*m->tda;
+        for (size_t j = 0; j < m->size2; ++j) if (!isfinitebits (r[j])) return false;
+      }
+      return true;
+    }
+
+  protected:
+    /// Scratch vector, on the stack for up to MAXSTACK elements
+    class Scratch {
+      public:
+        explicit Scratch (size_t n): heap (n > MAXSTACK ? n : 0) {}
+        double *data() {return heap.empty() ? stack : &heap[0];}
+      private:
+        double stack[MAXSTACK];
+        std::vector<double> heap;
+    };
+
+    /// Whether x is finite; tests the exponent bits, because -ffinite-math-only folds std::isfinite to true
+    static bool isfinitebits (double x) {
+      uint64_t bits;
+      std::memcpy (&bits, &x, sizeof (bits));
+      return (bits & 0x7ff0000000000000ULL) != 0x7ff0000000000000ULL;
+    }
+
+    /// Element ij of the symmetric matrix A, of which only the Uplo triangle is used
+    static double symget (CBLAS_UPLO_t Uplo, const gsl_matrix *A, size_t i, size_t j) {
+      if ((Uplo == CblasUpper) == (i > j)) return A->data[j*A->tda+i];
+      return A->data[i*A->tda+j];
+    }
+
+    /// Element (i, j) of op(A)
+    static double trget (bool trans, const gsl_matrix *A, size_t i, size_t j) {
+      return trans ? A->data[j*A->tda+i] : A->data[i*A->tda+j];
+    }
+
+    /// y = beta y, with y = 0 for beta = 0 (as BLAS)
+    static void scale (double beta, gsl_vector *y) {
+      if (beta == 1) return;
+      for (size_t i = 0; i < y->size; ++i) y->data[i*y->stride] = (beta == 0) ? 0 : beta*y->data[i*y->stride];
+    }
+
+    /// C = beta C, with C = 0 for beta = 0 (as BLAS)
+    static void scale (double beta, gsl_matrix *C) {
+      if (beta == 1) return;
+      for (size_t i = 0; i < C->size1; ++i) {
+        double *__restrict c = C->data + i*C->tda;
+        for (size_t j = 0; j < C->size2; ++j) c[j] = (beta == 0) ? 0 : beta*c[j];
+      }
+    }
+
+    /// True if the diagonal of the triangular matrix LU has no zeros
+    static bool isnonsingular (const gsl_matrix *LU) {
+      for (size_t i = 0; i < LU->size1; ++i) if (LU->data[i*LU->tda+i] == 0) return false;
+      return true;
+    }
+
+    /// Replace w by (L U)^-1 w; L has a unit diagonal for unitlower, otherwise U = L^T
+    static void substitute (const gsl_matrix *LU, double *__restrict w, bool unitlower) {
+      size_t n = LU->size1;
+      size_t tda = LU->tda;
+      const double *d = LU->data;
+      // forward substitution with L (lower triangle)
+      for (size_t i = 0; i < n; ++i) {
+        const double *__restrict r = d + i*tda;
+        double sum = w[i];
+        for (size_t l = 0; l < i; ++l) sum -= r[l]*w[l];
+        w[i] = unitlower ? sum : sum/r[i];
+      }
+      // back substitution with U (upper triangle)
+      for (size_t i = n; i-- > 0; ) {
+        const double *__restrict r = d + i*tda;
+        double sum = w[i];
+        for (size_t l = i+1; l < n; ++l) sum -= r[l]*w[l];
+        w[i] = sum/r[i];
+      }
+    }
+};
+
+#endif // __SMALLLINALGBACKEND_H
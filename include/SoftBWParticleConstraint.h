@@ -91,6 +91,14 @@ class SoftBWParticleConstraint: public BaseSoftConstraint {
       fitobjects.push_back (&fitobject);
       flags.push_back (flag);
     }; 
+    /// Replaces ParticleFitObject number ifo of the list and its flag
+    virtual void replaceFO(int ifo, ParticleFitObject& fitobject, int flag = 1
+                           ){
+      assert (ifo >= 0 && ifo < (int) fitobjects.size());
+      fitobjects[ifo] = &fitobject;
+      flags[ifo] = flag;
+      invalidateCache();
+    }; 
     
     /// Returns the value of the constraint function
     virtual double getValue() const = 0;
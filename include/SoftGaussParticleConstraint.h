@@ -87,6 +87,14 @@ class SoftGaussParticleConstraint: public BaseSoftConstraint {
       fitobjects.push_back (&fitobject);
       flags.push_back (flag);
     }; 
+    /// Replaces ParticleFitObject number ifo of the list and its flag
+    virtual void replaceFO(int ifo, ParticleFitObject& fitobject, int flag = 1
+                           ){
+      assert (ifo >= 0 && ifo < (int) fitobjects.size());
+      fitobjects[ifo] = &fitobject;
+      flags[ifo] = flag;
+      invalidateCache();
+    }; 
     /// Resests ParticleFitObject list
     virtual void resetFOList(){
       fitobjects.resize (0);
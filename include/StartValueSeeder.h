@@ -0,0 +1,82 @@
+/*! \file
+ *  \brief Declares class StartValueSeeder
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Seed ISR photons without the warning for pz below PzMin
+ *
+ */
+
+#ifndef __STARTVALUESEEDER_H
+#define __STARTVALUESEEDER_H
+
+#include <vector>
+
+class BaseFitter;
+class BaseFitObject;
+class ParticleFitObject;
+
+//  Class StartValueSeeder
+/// Sets analytic start values for the unmeasured parameters of a fit
+/**
+ * Unmeasured neutrinos (NeutrinoFitObject, ZinvisibleFitObject with
+ * three free, unmeasured parameters) and ISR photons (ISRPhotonFitObject)
+ * usually start at some guess, often far from the solution;
+ * the fit then needs more iterations or fails.
+ * The StartValueSeeder computes better start values from the hard
+ * constraints of the fitter:
+ * - the px and py of a neutrino from the momentum constraints in px and py
+ *   (MomentumConstraint without energy term) in which no other neutrino appears,
+ *   i.e. from the missing transverse momentum
+ * - candidates for the pz of a neutrino: from a pz constraint in which it is
+ *   the only unknown object, and both solutions of the quadratic equation
+ *   that every MassConstraint containing the neutrino (e.g. the W mass)
+ *   gives for its pz
+ * - the pz of an ISR photon from a pz constraint in which it is
+ *   the only unknown object, i.e. from the longitudinal imbalance,
+ *   once the neutrinos are known; a pz below PzMin is set to zero without
+ *   the warning of ISRPhotonFitObject::setPz, since that is frequent for the
+ *   wrong candidates of a neutrino
+ *
+ * Of the candidates for a neutrino, the one for which the hard constraints
+ * are fulfilled best (BaseFitter::getConstraintViolation), after the
+ * ISR photons have been seeded, is kept.
+ * Parameters for which no constraint is suitable keep their value.
+ *
+ * A seeder is attached to a fitter with BaseFitter::setSeeder;
+ * the fitter then calls seed at the start of each fit.
+ * The seeder has no state and can be used by several fitters
+ * and threads at once.
+ *
+ */
+class StartValueSeeder {
+  public:
+    /// Virtual destructor
+    virtual ~StartValueSeeder();
+
+    /// Set the start values of the unmeasured objects of the fitter; returns the number of objects seeded
+    virtual int seed (BaseFitter& fitter   ///< The fitter, with fit objects and constraints
+                     ) const;
+
+  protected:
+    /// Whether fo is a neutrino whose momentum can be seeded
+    static bool isNeutrino (const BaseFitObject *fo);
+    /// Whether fo is an ISR photon whose pz can be seeded
+    static bool isPhoton (const BaseFitObject *fo);
+    /// Whether fo is a neutrino or ISR photon that is not in known
+    static bool isUnknown (const BaseFitObject *fo, const std::vector<const BaseFitObject *>& known);
+
+    /// Set px and py of neutrino fo from the momentum balance; returns whether any of them was found
+    bool seedTransverse (BaseFitter& fitter, ParticleFitObject *fo) const;
+    /// Find the candidates for the pz of neutrino fo
+    void findPzCandidates (BaseFitter& fitter, ParticleFitObject *fo,
+                           const std::vector<const BaseFitObject *>& known,
+                           std::vector<double>& candidates) const;
+    /// Set the pz of the ISR photons from the momentum balance; returns the number of photons seeded
+    int seedPhotons (BaseFitter& fitter, const std::vector<const BaseFitObject *>& known) const;
+
+    /// Set the E, theta, phi parameters of fo to a momentum
+    static void setMomentum (ParticleFitObject *fo, double px, double py, double pz);
+};
+
+#endif // __STARTVALUESEEDER_H
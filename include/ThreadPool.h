@@ -0,0 +1,103 @@
+/*! \file
+ *  \brief Declares classes ThreadPool and ParallelTask
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Switch the GSL error handler off during parallel work
+ *
+ */
+
+#ifndef __THREADPOOL_H
+#define __THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+//  Class ParallelTask:
+/// Abstract base class for work that is distributed by a ThreadPool
+/**
+ * A ParallelTask consists of ntasks independent work items,
+ * numbered 0 ... ntasks-1. execute is called exactly once for each item,
+ * from one of the threads of the pool; ithread (0 ... nthreads-1)
+ * identifies the calling thread, so that derived classes can keep
+ * per-thread work space (fitters, fit object copies, ...)
+ * without locking.
+ *
+ */
+class ParallelTask {
+  public:
+    virtual ~ParallelTask() {};
+
+    /// Process work item itask on thread ithread
+    virtual void execute (int itask,       ///< Number of the work item
+                          int ithread      ///< Number of the calling thread
+                         ) = 0;
+};
+
+//  Class ThreadPool:
+/// A fixed set of worker threads that process ParallelTask objects
+/**
+ * The threads are started once in the constructor and are reused for
+ * every call of run, so that the pool can be used per event without
+ * paying for thread creation.
+ * The calling thread takes part in the work as thread number 0;
+ * a pool with one thread therefore runs everything inline.
+ *
+ * Work items are handed out dynamically, one at a time,
+ * so that long and short fits are balanced across the threads.
+ *
+ * The GSL error handler is a process-wide setting. The fitters switch
+ * it off around decompositions that may fail, and restore it afterwards;
+ * with several threads, one thread could thus restore the aborting default
+ * handler while another one is in such a decomposition.
+ * Therefore, while run processes a task with more than one thread,
+ * the GSL error handler is switched off for the whole process
+ * (and restored when all items are done); parallel fits depend on this.
+ * GSL errors are then reported only through return codes,
+ * which the fitters check.
+ *
+ */
+class ThreadPool {
+  public:
+    /// Constructor; nthreads=0 uses one thread per hardware core
+    ThreadPool (int nthreads = 0  ///< Total number of threads, including the caller
+               );
+    /// Virtual destructor, stops the worker threads
+    virtual ~ThreadPool();
+
+    /// Get the total number of threads (including the calling thread)
+    virtual int getNThreads() const;
+
+    /// Process all work items of task; returns when all items are done
+    virtual void run (ParallelTask& task,  ///< The task to execute
+                      int ntasks           ///< Number of work items
+                     );
+
+  protected:
+    /// Copy constructor disabled
+    ThreadPool (const ThreadPool& rhs);
+    /// Assignment disabled
+    ThreadPool& operator= (const ThreadPool& rhs);
+
+    /// Process work items of the current task until none are left
+    void work (int ithread);
+    /// Main loop of a worker thread
+    void workerLoop (int ithread);
+
+    std::vector<std::thread> workers;  ///< The worker threads (1 ... nthreads-1)
+    std::mutex mutex;                  ///< Protects the members below
+    std::condition_variable wakeup;    ///< Signals a new task to the workers
+    std::condition_variable done;      ///< Signals the end of a task to run
+
+    ParallelTask *currenttask;         ///< The task currently processed
+    int ntask;                         ///< Number of work items of current task
+    std::atomic<int> nexttask;         ///< Next work item to hand out
+    int nbusy;                         ///< Number of workers still busy with current task
+    unsigned long generation;          ///< Incremented for every call of run
+    bool stop;                         ///< Set by the destructor
+};
+
+#endif // __THREADPOOL_H
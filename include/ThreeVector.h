@@ -15,11 +15,102 @@
 #include <iostream>
 #include <cmath>
 
-class ThreeVector {
+class ThreeVector;
+
+// Class ThreeVectorExpr
+//
+// Base class of ThreeVector and of the expression objects returned by the
+// arithmetic operators (expression templates): a+b-2*c is not evaluated
+// operator by operator, with a ThreeVector temporary for each intermediate
+// result, but component by component in one pass, when the expression is
+// converted to a ThreeVector or one of its getters is called.
+//
+// Expressions keep references to the ThreeVector objects they are built
+// from and must not outlive them: "auto s = a + f();", with f returning
+// a ThreeVector, dangles. Assign expressions to a ThreeVector instead.
+template <class Expr>
+class ThreeVectorExpr {
+  public:
+    /// The expression object itself
+    const Expr& self() const { return static_cast<const Expr&>(*this); }
+
+    double getX()     const { return self().getPx(); }
+    double getY()     const { return self().getPy(); }
+    double getZ()     const { return self().getPz(); }
+
+    double getP2()    const { double x = getX(), y = getY(), z = getZ(); return x*x + y*y + z*z; }
+    double getP()     const { return std::sqrt(getP2()); }
+    double getMag()   const { return std::sqrt(getP2()); }
+    double getPt2()   const { double x = getX(), y = getY(); return x*x + y*y; }
+    double getPt()    const { return std::sqrt(getPt2()); }
+    double getR()     const { return std::sqrt(getPt2()); }
+
+    double getPhi()   const { return std::atan2(getY(), getX()); }
+    double getTheta() const { return std::atan2(getPt(), getZ()); }
+    double getEta()   const { return -std::log(std::tan(0.5*getTheta())); }
+
+    double getComponent (int i) const {
+      switch (i) {
+        case 0: return getX();
+        case 1: return getY();
+        case 2: return getZ();
+      }
+      return NAN;
+    }
+};
+
+// How expressions hold their operands: ThreeVectors by reference,
+// (temporary) expression objects by value
+template <class Expr> struct ThreeVectorOperand { typedef const Expr type; };
+template <> struct ThreeVectorOperand<ThreeVector> { typedef const ThreeVector& type; };
+
+/// Sum of two three vector expressions
+template <class L, class R>
+class ThreeVectorSum: public ThreeVectorExpr<ThreeVectorSum<L, R> > {
+  public:
+    ThreeVectorSum (const L& lhs_, const R& rhs_): lhs (lhs_), rhs (rhs_) {}
+    double getPx() const { return lhs.getPx() + rhs.getPx(); }
+    double getPy() const { return lhs.getPy() + rhs.getPy(); }
+    double getPz() const { return lhs.getPz() + rhs.getPz(); }
+  private:
+    typename ThreeVectorOperand<L>::type lhs;
+    typename ThreeVectorOperand<R>::type rhs;
+};
+
+/// Difference of two three vector expressions
+template <class L, class R>
+class ThreeVectorDiff: public ThreeVectorExpr<ThreeVectorDiff<L, R> > {
+  public:
+    ThreeVectorDiff (const L& lhs_, const R& rhs_): lhs (lhs_), rhs (rhs_) {}
+    double getPx() const { return lhs.getPx() - rhs.getPx(); }
+    double getPy() const { return lhs.getPy() - rhs.getPy(); }
+    double getPz() const { return lhs.getPz() - rhs.getPz(); }
+  private:
+    typename ThreeVectorOperand<L>::type lhs;
+    typename ThreeVectorOperand<R>::type rhs;
+};
+
+/// Multiple of a three vector expression
+template <class A>
+class ThreeVectorScaled: public ThreeVectorExpr<ThreeVectorScaled<A> > {
+  public:
+    ThreeVectorScaled (double a_, const A& v_): a (a_), v (v_) {}
+    double getPx() const { return a*v.getPx(); }
+    double getPy() const { return a*v.getPy(); }
+    double getPz() const { return a*v.getPz(); }
+  private:
+    double a;
+    typename ThreeVectorOperand<A>::type v;
+};
+
+class ThreeVector: public ThreeVectorExpr<ThreeVector> {
   public:
     inline ThreeVector();
     inline ThreeVector(double px_, double py_, double pz_);
     // automatically generated copy constructor and assignment is fine
+    /// Evaluate an expression
+    template <class Expr>
+    inline ThreeVector(const ThreeVectorExpr<Expr>& rhs);
     
     inline double getPx()    const;
     inline double getPy()    const;
@@ -43,8 +134,10 @@ class ThreeVector {
     
     inline ThreeVector& setValues(double px_, double py_, double pz_);
 
-    inline ThreeVector& operator+= (const ThreeVector& rhs);
-    inline ThreeVector& operator-= (const ThreeVector& rhs);
+    template <class Expr>
+    inline ThreeVector& operator+= (const ThreeVectorExpr<Expr>& rhs);
+    template <class Expr>
+    inline ThreeVector& operator-= (const ThreeVectorExpr<Expr>& rhs);
     inline ThreeVector& operator*= (double rhs);
     
   private:
@@ -58,6 +151,11 @@ ThreeVector::ThreeVector()
 ThreeVector::ThreeVector(double px_, double py_, double pz_)
 : px(px_), py(py_), pz(pz_)
 {}
+
+template <class Expr>
+ThreeVector::ThreeVector(const ThreeVectorExpr<Expr>& rhs)
+: px(rhs.self().getPx()), py(rhs.self().getPy()), pz(rhs.self().getPz())
+{}
     
 double ThreeVector::getPx() const { return px; }
 double ThreeVector::getPy() const { return py; }
@@ -95,17 +193,21 @@ ThreeVector& ThreeVector::setValues(double px_, double py_, double pz_) {
 }
 
 
-ThreeVector& ThreeVector::operator+= (const ThreeVector& rhs) {
-  px += rhs.px;
-  py += rhs.py;
-  pz += rhs.pz;
+// each component of rhs depends only on the same component of its
+// operands, so rhs may contain *this
+template <class Expr>
+ThreeVector& ThreeVector::operator+= (const ThreeVectorExpr<Expr>& rhs) {
+  px += rhs.self().getPx();
+  py += rhs.self().getPy();
+  pz += rhs.self().getPz();
   return *this;
 }
 
-ThreeVector& ThreeVector::operator-= (const ThreeVector& rhs) {
-  px -= rhs.px;
-  py -= rhs.py;
-  pz -= rhs.pz;
+template <class Expr>
+ThreeVector& ThreeVector::operator-= (const ThreeVectorExpr<Expr>& rhs) {
+  px -= rhs.self().getPx();
+  py -= rhs.self().getPy();
+  pz -= rhs.self().getPz();
   return *this;
 }
 
@@ -116,28 +218,34 @@ ThreeVector& ThreeVector::operator*= (double rhs) {
   return *this;
 }
 
-inline ThreeVector operator+ (const ThreeVector& lhs, const ThreeVector& rhs) {
-  return ThreeVector (lhs.getPx()+rhs.getPx(), lhs.getPy()+rhs.getPy(), lhs.getPz()+rhs.getPz());
+template <class L, class R>
+inline ThreeVectorSum<L, R> operator+ (const ThreeVectorExpr<L>& lhs, const ThreeVectorExpr<R>& rhs) {
+  return ThreeVectorSum<L, R> (lhs.self(), rhs.self());
 }
 
-inline ThreeVector operator- (const ThreeVector& lhs, const ThreeVector& rhs) {
-  return ThreeVector (lhs.getPx()-rhs.getPx(), lhs.getPy()-rhs.getPy(), lhs.getPz()-rhs.getPz());
+template <class L, class R>
+inline ThreeVectorDiff<L, R> operator- (const ThreeVectorExpr<L>& lhs, const ThreeVectorExpr<R>& rhs) {
+  return ThreeVectorDiff<L, R> (lhs.self(), rhs.self());
 }
 
-inline ThreeVector operator- (const ThreeVector& rhs) {
-  return ThreeVector (-rhs.getPx(), -rhs.getPy(), -rhs.getPz());
+template <class A>
+inline ThreeVectorScaled<A> operator- (const ThreeVectorExpr<A>& rhs) {
+  return ThreeVectorScaled<A> (-1, rhs.self());
 }
 
-inline double operator* (const ThreeVector& lhs, const ThreeVector& rhs) {
-  return lhs.getPx()*rhs.getPx() + lhs.getPy()*rhs.getPy() + lhs.getPz()*rhs.getPz();
+template <class L, class R>
+inline double operator* (const ThreeVectorExpr<L>& lhs, const ThreeVectorExpr<R>& rhs) {
+  return lhs.getX()*rhs.getX() + lhs.getY()*rhs.getY() + lhs.getZ()*rhs.getZ();
 }
 
-inline ThreeVector operator* (double lhs, const ThreeVector& rhs) {
-  return ThreeVector (lhs*rhs.getPx(), lhs*rhs.getPy(), lhs*rhs.getPz());
+template <class A>
+inline ThreeVectorScaled<A> operator* (double lhs, const ThreeVectorExpr<A>& rhs) {
+  return ThreeVectorScaled<A> (lhs, rhs.self());
 }
     
-inline std::ostream& operator<< (std::ostream& out, const ThreeVector& v) {
-  out << "(" << v.getPx() << ", " << v.getPy() << ", " << v.getPz() << ")";
+template <class Expr>
+inline std::ostream& operator<< (std::ostream& out, const ThreeVectorExpr<Expr>& v) {
+  out << "(" << v.getX() << ", " << v.getY() << ", " << v.getZ() << ")";
   return out;
 }
 
@@ -0,0 +1,163 @@
+/*! \file
+ *  \brief Declares classes ToyMCDriver, ToyMCStatistics and PullStatistics
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#ifndef __TOYMCDRIVER_H
+#define __TOYMCDRIVER_H
+
+#include <vector>
+#include <map>
+#include <cstdint>
+
+#include "ThreadPool.h"
+#include "CounterRandom.h"
+
+class BaseEvent;
+class BaseFitter;
+
+//  Class PullStatistics
+/// Mean, RMS and histogram of the pulls of one parameter
+class PullStatistics {
+  public:
+    PullStatistics();
+
+    /// Reset all counters
+    void clear();
+    /// Add one pull
+    void fill (double pull);
+    /// Add the contents of rhs
+    void add (const PullStatistics& rhs);
+
+    /// Mean of all pulls
+    double getMean() const;
+    /// RMS of all pulls around the mean
+    double getRMS() const;
+    /// Lower edge of bin ibin
+    static double getBinLow (int ibin);
+
+    enum {NBINS = 50};       ///< Number of histogram bins between -PULLMAX and PULLMAX
+    static const double PULLMAX;
+
+    long n;                  ///< Number of pulls
+    double sum;              ///< Sum of pulls
+    double sum2;             ///< Sum of squared pulls
+    long underflow;          ///< Number of pulls below -PULLMAX
+    long overflow;           ///< Number of pulls above PULLMAX
+    std::vector<long> hist;  ///< Histogram of the pulls
+};
+
+//  Class ToyMCStatistics
+/// Accumulated results of toy Monte Carlo events
+/**
+ * The pull of a measured parameter is
+ * (start value - fitted value)/sqrt(start error^2 - fitted error^2),
+ * filled for successful fits only.
+ * Pulls are indexed by fit object number and local parameter number.
+ *
+ */
+class ToyMCStatistics {
+  public:
+    ToyMCStatistics();
+
+    /// Reset all counters
+    void clear();
+    /// Add the contents of rhs
+    void add (const ToyMCStatistics& rhs);
+    /// Add one pull of parameter ilocal of fit object ifo
+    void fillPull (int ifo, int ilocal, double pull);
+    /// Get the pull statistics of parameter ilocal of fit object ifo; 0 if none was filled
+    const PullStatistics *getPull (int ifo, int ilocal) const;
+    /// Fraction of events with fit error != 0
+    double getFailureRate() const;
+    /// Mean number of iterations of the successful fits
+    double getMeanIterations() const;
+
+    enum {NPROBBINS = 20};          ///< Number of bins of probability histogram
+
+    long nevents;                   ///< Number of events
+    long nfailed;                   ///< Number of events with fit error != 0
+    long nitsum;                    ///< Sum of iterations of the successful fits
+    std::map<int, long> errors;     ///< Number of events per fit error code
+    std::vector<long> probhist;     ///< Histogram of fit probability of successful fits
+    std::vector<PullStatistics> pulls;  ///< Pulls, index ifo*BaseDefs::MAXPAR+ilocal
+};
+
+//  Class ToyMCDriver
+/// Generates and fits toy Monte Carlo events concurrently
+/**
+ * The ToyMCDriver runs genEvent and fitEvent of a BaseEvent
+ * (e.g. TopEventILC or DijetEventILC) for many events on a ThreadPool.
+ * Each thread has its own copy of the event (BaseEvent::copy) and its own
+ * fitter; the fitters are supplied by the caller, one per thread,
+ * and determine the number of threads.
+ *
+ * Event number ievent is generated from stream ievent of a CounterRandom
+ * with the seed of the driver, so its random numbers depend only on the
+ * seed and ievent. The events are processed in blocks of consecutive
+ * events, and the statistics of the blocks are added in block order;
+ * therefore the results are bit-for-bit the same for any number of threads.
+ *
+ */
+class ToyMCDriver: protected ParallelTask {
+  public:
+    /// Constructor
+    ToyMCDriver (const BaseEvent& prototype,                ///< Event to be copied for each thread
+                 const std::vector<BaseFitter *>& fitters_,  ///< One fitter per thread, not owned
+                 uint64_t seed_ = 0                          ///< Seed of the random numbers
+                );
+    /// Virtual destructor
+    virtual ~ToyMCDriver();
+
+    /// Set the seed of the random numbers
+    virtual void setSeed (uint64_t seed_);
+    /// Set the number of events per block (default 1000); part of what makes results reproducible
+    virtual void setBlockSize (int blocksize_);
+
+    /// Generate and fit events firstevent ... firstevent+nevents-1
+    virtual void run (long nevents,        ///< Number of events
+                      long firstevent = 0  ///< Number of first event
+                     );
+
+    /// The statistics accumulated since construction or resetStatistics
+    virtual const ToyMCStatistics& getStatistics() const;
+    /// Reset the statistics and the timing
+    virtual void resetStatistics();
+    /// Wall clock time spent in run, in seconds
+    virtual double getRealTime() const;
+    /// Number of events per second of wall clock time
+    virtual double getEventsPerSecond() const;
+    /// Number of threads used
+    virtual int getNThreads() const;
+
+  protected:
+    /// Copy constructor disabled
+    ToyMCDriver (const ToyMCDriver& rhs);
+    /// Assignment disabled
+    ToyMCDriver& operator= (const ToyMCDriver& rhs);
+
+    /// Process block itask of the current batch
+    virtual void execute (int itask, int ithread);
+    /// Generate and fit event ievent, add the result to stat
+    void processEvent (long ievent, int ithread, ToyMCStatistics& stat);
+
+    ThreadPool pool;                     ///< The worker threads
+    std::vector<BaseEvent *> events;     ///< One event per thread
+    std::vector<BaseFitter *> fitters;   ///< One fitter per thread
+    std::vector<CounterRandom> randoms;  ///< One generator per thread
+
+    uint64_t seed;                       ///< The seed
+    int blocksize;                       ///< Number of events per block
+
+    long batchfirst;                     ///< First event of the current batch
+    long runend;                         ///< One past the last event of the current run
+    std::vector<ToyMCStatistics> blockstats;  ///< Statistics per block of the current batch
+
+    ToyMCStatistics statistics;          ///< The accumulated statistics
+    double realtime;                     ///< Accumulated wall clock time
+};
+
+#endif // __TOYMCDRIVER_H
@@ -0,0 +1,65 @@
+/*! \file
+ *  \brief Declares class TraceValues
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#ifndef __TRACEVALUES_H
+#define __TRACEVALUES_H
+
+#include <string>
+
+//  Class TraceValues:
+/// Named values that a fitter exposes to its tracer
+/**
+ * A fixed array of slots, indexed by key numbers. The standard keys
+ * (ALPHA, PHI, MU, DETW) are known at compile time;
+ * fitter specific keys are registered once with registerKey,
+ * e.g. in the constructor of the fitter, and the returned key number
+ * is used afterwards. Setting a value is a plain array store,
+ * so no strings are constructed and no lookups are done during the fit.
+ *
+ * Key names are global to the program; registering the same name twice
+ * returns the same key number. Registration is thread safe.
+ *
+ */
+class TraceValues {
+  public:
+    /// The standard keys, and the maximum number of keys
+    enum {ALPHA, PHI, MU, DETW, NSTANDARD, MAXKEYS = 32};
+
+    /// Constructor, no value is set
+    TraceValues();
+
+    /// Return the key number of name, registering it if necessary; -1 if no slot is left
+    static int registerKey (const std::string& name);
+    /// Return the key number of name, -1 if it is not registered
+    static int findKey (const std::string& name);
+    /// Return the name of key ikey
+    static const char *getName (int ikey);
+    /// Return the number of registered keys
+    static int getNKeys();
+
+    /// Set the value of key ikey; ignored for ikey < 0
+    void set (int ikey, double value) {
+      if (ikey < 0 || ikey >= MAXKEYS) return;
+      values[ikey] = value;
+      setmask |= 1u << ikey;
+    };
+    /// Set the value of key name (slow, registers the key if necessary)
+    void set (const std::string& name, double value);
+    /// Get the value of key ikey; 0 if it is not set
+    double get (int ikey) const {return isSet (ikey) ? values[ikey] : 0;};
+    /// Check whether key ikey has been set
+    bool isSet (int ikey) const {return ikey >= 0 && ikey < MAXKEYS && (setmask & (1u << ikey));};
+    /// Unset all values
+    void clear() {setmask = 0;};
+
+  protected:
+    double values[MAXKEYS];   ///< The values
+    unsigned int setmask;     ///< Bit ikey is set if values[ikey] is valid
+};
+
+#endif // __TRACEVALUES_H
@@ -0,0 +1,102 @@
+/*! \file
+ *  \brief Declares class TriggeredTracer
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#ifndef __TRIGGEREDTRACER_H
+#define __TRIGGEREDTRACER_H
+
+#include <vector>
+
+#include "BaseTracer.h"
+#include "BinaryTraceBuffer.h"
+
+//  Class TriggeredTracer
+/// Tracer that passes on the trace of selected fits only
+/**
+ * A TriggeredTracer is put in front of another tracer (setNextTracer).
+ * During a fit it only stores one BinaryTraceRecord per tracer call in memory.
+ * At the end of the fit it decides whether the fit is interesting:
+ * - the fit failed (getError() != 0), if traceFailures is set,
+ * - the fit needed more than the iteration threshold, if one is set,
+ * - or the fit is one of every N fits, if a sample rate N is set.
+ *
+ * Otherwise the stored records are discarded; this costs one record fill per call.
+ * If the fit is selected, the stored calls are replayed to the next tracer:
+ * before each call the parameters of the fit objects and the standard
+ * trace values (alpha, phi, mu, detW) are set to the recorded values,
+ * and at the end the final values are restored.
+ * Other fitter quantities (getChi2, getIterations, fitter specific trace
+ * values) are those at the end of the fit, except for a BinaryTracer
+ * as next tracer, which receives the complete records.
+ *
+ * At most maxrecords records are kept per fit: the initialize record and
+ * the last maxrecords-1 others, so the end of a runaway fit is always kept.
+ *
+ */
+class TriggeredTracer: public BaseTracer {
+  public:
+    /// Constructor
+    TriggeredTracer (BaseTracer *next_ = 0   ///< The tracer that receives the selected fits
+                    );
+    /// Virtual destructor
+    virtual ~TriggeredTracer();
+
+    /// Called at the start of a new fit (during initialization)
+    virtual void initialize (BaseFitter& fitter);
+    /// Called at the end of each step
+    virtual void step (BaseFitter& fitter);
+    /// Called at intermediate points during a step
+    virtual void substep (BaseFitter& fitter,
+                          int flag
+                          );
+    /// Called at the end of a fit
+    virtual void finish (BaseFitter& fitter);
+
+    /// Select fits with getError() != 0 (default: true)
+    virtual void setTraceFailures (bool tracefailures_);
+    /// Select fits with more than nit iterations; 0 (default): no threshold
+    virtual void setIterationThreshold (int nit);
+    /// Select one of every n fits; 0 (default): no sampling
+    virtual void setSampleRate (int n);
+    /// Set the maximum number of records kept per fit (default 1000, at least 2)
+    virtual void setMaxRecords (int maxrecords_);
+
+    /// Number of finished fits
+    virtual long getNFits() const;
+    /// Number of fits passed on to the next tracer
+    virtual long getNSelected() const;
+    /// Number of records dropped because of the per fit limit
+    virtual long getNDropped() const;
+
+  protected:
+    /// Copy constructor disabled
+    TriggeredTracer (const TriggeredTracer& rhs);
+    /// Assignment disabled
+    TriggeredTracer& operator= (const TriggeredTracer& rhs);
+
+    /// Store the state of the fitter
+    void store (BaseFitter& fitter, int type, int flag);
+    /// Check whether the finished fit is selected
+    bool isSelected (BaseFitter& fitter) const;
+    /// Pass the stored records on to the next tracer
+    void replay (BaseFitter& fitter);
+    /// Set the fit object parameters (and trace values) of fitter from r
+    static void restore (BaseFitter& fitter, const BinaryTraceRecord& r);
+
+    bool tracefailures;          ///< Select failed fits
+    int itthreshold;             ///< Iteration threshold, 0: none
+    int samplerate;              ///< Sample one of samplerate fits, 0: none
+    int maxrecords;              ///< Maximum number of records per fit
+
+    std::vector<BinaryTraceRecord> records;   ///< Records of the current fit
+    long nrecords;               ///< Number of calls during the current fit
+    long nfits;                  ///< Number of finished fits
+    long nselected;              ///< Number of selected fits
+    long ndropped;               ///< Number of dropped records
+};
+
+#endif // __TRIGGEREDTRACER_H
@@ -26,6 +26,7 @@ class TwoB4JPairing : public BaseJetPairing {
         
     // getters
     virtual int getNPerm() const {return NPERM;};
+    virtual int getNJets() const {return NJETS;};
     
     // does the job
     virtual int nextPermutation (JetFitObject *permObjects[]);
@@ -0,0 +1,117 @@
+/*! \file
+ *  \brief Declares classes VertexConstraintBlock and VertexConstraintRow
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#ifndef __VERTEXCONSTRAINTBLOCK_H
+#define __VERTEXCONSTRAINTBLOCK_H
+
+#include "BaseHardConstraint.h"
+#include "BaseDefs.h"
+
+class VertexFitObject;
+class TrackParticleFitObject;
+class VertexConstraintBlock;
+
+//  Class VertexConstraintRow
+/// One axis of a VertexConstraintBlock
+/**
+ * Behaves like a VertexConstraint for the same vertex, track and axis,
+ * but takes its value and derivatives from the VertexConstraintBlock
+ * it belongs to.
+ *
+ */
+class VertexConstraintRow: public BaseHardConstraint {
+  public:
+    /// Constructor; not usable before setBlock is called
+    VertexConstraintRow ();
+    /// Virtual destructor
+    virtual ~VertexConstraintRow();
+
+    /// Set the block and the axis (0, 1, 2 for x, y, z)
+    virtual void setBlock (const VertexConstraintBlock& block_, int axis_);
+
+    /// Returns the value of the constraint
+    virtual double getValue() const;
+
+    /// Get first order derivatives.
+    /// Call this with a predefined array "der" with the necessary number of entries!
+    virtual void getDerivatives(int idim, double der[]) const;
+
+    virtual bool secondDerivatives(int, int, double*) const;
+    virtual bool firstDerivatives(int, double*) const;
+
+    virtual int getVarBasis() const {return BaseDefs::VARBASIS_VXYZ;}
+
+  protected:
+    const VertexConstraintBlock *block;   ///< The block
+    int axis;                             ///< The axis
+};
+
+//  Class VertexConstraintBlock
+/// Constrains a TrackParticleFitObject to a VertexFitObject in all three coordinates
+/**
+ * Holds the three constraints vertex - track point = 0 for x, y and z,
+ * i.e. the same constraints as three VertexConstraint objects,
+ * as VertexConstraintRow objects that are part of the block.
+ *
+ * The track point and its derivatives w.r.t. all track parameters
+ * are evaluated once for all three rows, and cached until a parameter
+ * of the track or the vertex changes. VertexConstraint evaluates them
+ * separately for each axis and each call.
+ *
+ * A block can be bound to another vertex and track with set,
+ * so that it can be reused without new allocations.
+ *
+ */
+class VertexConstraintBlock {
+  public:
+    /// Constructor; not usable before set is called
+    VertexConstraintBlock ();
+    /// Virtual destructor
+    virtual ~VertexConstraintBlock();
+
+    /// Bind to a vertex and a track
+    virtual void set (const VertexFitObject& vertex_,         ///< The vertex
+                      const TrackParticleFitObject& track_,   ///< The track
+                      int ivertex_                            ///< Track vertex number: 0=start, 1=stop
+                     );
+
+    /// Get the row (constraint) for one axis: 0, 1, 2 for x, y, z
+    virtual VertexConstraintRow& getRow (int axis);
+
+    /// Value of the constraint for one axis
+    virtual double getValue (int axis) const;
+
+    /// Derivatives w.r.t. all global parameters for one axis
+    virtual void getDerivatives (int axis,      ///< The axis
+                                 int idim,      ///< Size of der
+                                 double der[]   ///< The derivatives
+                                ) const;
+
+  protected:
+    /// Copy constructor disabled
+    VertexConstraintBlock (const VertexConstraintBlock& rhs);
+    /// Assignment disabled
+    VertexConstraintBlock& operator= (const VertexConstraintBlock& rhs);
+
+    /// Evaluate values and derivatives, if any parameter has changed
+    void update() const;
+
+    const VertexFitObject *vertex;                         ///< The vertex
+    const TrackParticleFitObject *track;                   ///< The track
+    int ivertex;                                           ///< Track vertex number: 0=start, 1=stop
+    VertexConstraintRow rows[3];                           ///< The rows for x, y, z
+
+    mutable bool cachevalid;                               ///< Cache is filled
+    mutable double vertexpar[BaseDefs::MAXPAR];            ///< Vertex parameters of the cached values
+    mutable double trackpar[BaseDefs::MAXPAR];             ///< Track parameters of the cached values
+    mutable double value[3];                               ///< Values for x, y, z
+    mutable double vertexder[3][BaseDefs::MAXPAR];         ///< Derivatives w.r.t. vertex parameters
+    mutable double trackder[3][BaseDefs::MAXPAR];          ///< Derivatives w.r.t. track parameters
+};
+
+#endif // __VERTEXCONSTRAINTBLOCK_H
@@ -37,6 +37,8 @@ class FourVector;
 class TrackParticleFitObject;
 class BaseFitter;
 class BaseConstraint;
+class VertexConstraintBlock;
+class MomentumConstraint;
 
 // Class VertexFitObject
 /// Class that represents vertices
@@ -54,6 +56,11 @@ class BaseConstraint;
  * of constraints (VertexConstraint and TrackMomentumConstraint objects)
  * for a fitter object.
  *
+ * The vertex constraints of each track are the three rows of one
+ * VertexConstraintBlock, which evaluates the track point once for all axes.
+ * The blocks and momentum constraints are kept, and reused if
+ * addConstraints is called again, e.g. for the next event.
+ *
  * 
  * Author:Benno List, Jenny List
  * $Date: 2008/01/30 09:14:55 $
@@ -302,6 +309,10 @@ class VertexFitObject: public BaseFitObject {
     typedef std::vector<BaseConstraint *> CContainer;
     typedef CContainer::iterator CIterator;
     CContainer constraints;
+    /// Vertex constraints of each track, reused by addVertexConstraints
+    std::vector<VertexConstraintBlock *> blocks;
+    /// Momentum constraints for E, px, py, pz, reused by addMomentumConstraint
+    MomentumConstraint *momentumconstraints[4];
     
 };
     
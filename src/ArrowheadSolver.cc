@@ -0,0 +1,238 @@
+/*! \file
+ *  \brief Implements class ArrowheadSolver
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Linear algebra through a LinAlgBackend
+ *
+ */
+
+#include "ArrowheadSolver.h"
+#include "LinAlgBackend.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include <gsl/gsl_permutation.h>
+
+#undef NDEBUG
+#include <cassert>
+
+ArrowheadSolver::ArrowheadSolver (int maxblocksize_)
+: linalg (&LinAlgBackend::getDefault()), maxblocksize (maxblocksize_), largestblock (0),
+  sharedrows (), blockrows (), blockstart (), parent (), status (), degree (),
+  A (), BT (), Z (), z (), S (), r (), perm ()
+{
+  assert (maxblocksize > 0);
+}
+
+ArrowheadSolver::~ArrowheadSolver()
+{}
+
+void ArrowheadSolver::setLinAlgBackend (const LinAlgBackend& linalg_) {
+  linalg = &linalg_;
+}
+
+const LinAlgBackend& ArrowheadSolver::getLinAlgBackend() const {
+  return *linalg;
+}
+
+int ArrowheadSolver::findRoot (int i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+bool ArrowheadSolver::analyse (const gsl_matrix *M, const std::vector<int>& shared) {
+  assert (M);
+  assert (M->size1 == M->size2);
+  int n = M->size1;
+
+  status.assign (n, 0);
+  for (unsigned int i = 0; i < shared.size(); ++i) {
+    assert (shared[i] >= 0 && shared[i] < n);
+    status[shared[i]] = 1;
+  }
+
+  // Number of other non-shared rows each row couples to
+  degree.assign (n, 0);
+  for (int i = 0; i < n; ++i) {
+    if (status[i]) continue;
+    for (int j = 0; j < n; ++j)
+      if (j != i && !status[j] && gsl_matrix_get (M, i, j) != 0) ++degree[i];
+  }
+
+  // Rows that couple different blocks (e.g. the Lagrange multiplier 
+  // of a momentum constraint that involves all tracks) lead to
+  // oversized blocks; make the row with the highest degree
+  // of each oversized block shared, until all blocks are small enough
+  for (;;) {
+    findBlocks (M);
+    if (2*sharedrows.size() > (unsigned int) n) return false;
+    if (largestblock <= maxblocksize) break;
+    for (int ib = 0; ib < getNBlocks(); ++ib) {
+      if (blockstart[ib+1] - blockstart[ib] <= maxblocksize) continue;
+      int imax = blockrows[blockstart[ib]];
+      for (int k = blockstart[ib]; k < blockstart[ib+1]; ++k) 
+        if (degree[blockrows[k]] > degree[imax]) imax = blockrows[k];
+      status[imax] = 2;
+    }
+  }
+  return getNBlocks() >= 2;
+}
+
+void ArrowheadSolver::findBlocks (const gsl_matrix *M) {
+  int n = M->size1;
+  sharedrows.clear();
+  blockrows.clear();
+  blockstart.clear();
+  largestblock = 0;
+
+  // The blocks are the connected components of the non-shared rows
+  parent.resize (n);
+  for (int i = 0; i < n; ++i) parent[i] = i;
+  for (int i = 0; i < n; ++i) {
+    if (status[i]) continue;
+    for (int j = i+1; j < n; ++j) {
+      if (status[j]) continue;
+      if (gsl_matrix_get (M, i, j) != 0 || gsl_matrix_get (M, j, i) != 0) {
+        int ri = findRoot (i);
+        int rj = findRoot (j);
+        if (ri != rj) parent[std::max (ri, rj)] = std::min (ri, rj);
+      }
+    }
+  }
+
+  // Order the rows by block: a block's root is its smallest row,
+  // so counting rows per root in increasing order gives the block order
+  std::vector<int> blocksize (n, 0);
+  for (int i = 0; i < n; ++i) {
+    if (status[i]) sharedrows.push_back (i);
+    else ++blocksize[findRoot (i)];
+  }
+  std::vector<int> offset (n, -1);
+  for (int i = 0; i < n; ++i) {
+    if (blocksize[i] == 0) continue;
+    offset[i] = blockstart.empty() ? 0 : blockstart.back();
+    if (blockstart.empty()) blockstart.push_back (0);
+    blockstart.push_back (offset[i] + blocksize[i]);
+    largestblock = std::max (largestblock, blocksize[i]);
+  }
+  blockrows.resize (n - sharedrows.size());
+  for (int i = 0; i < n; ++i) {
+    if (status[i]) continue;
+    blockrows[offset[findRoot (i)]++] = i;
+  }
+}
+
+int ArrowheadSolver::solve (gsl_vector *x, double& det, const gsl_matrix *M, const gsl_vector *y) {
+  assert (x && M && y);
+  assert (M->size1 == M->size2);
+  assert (x->size == M->size1 && y->size == M->size1);
+  assert (blockrows.size() + sharedrows.size() == M->size1);
+
+  int ns = sharedrows.size();
+  int nb = getNBlocks();
+  det = 1;
+
+  Z.resize (blockrows.size()*ns);
+  z.resize (blockrows.size());
+  S.resize (ns*ns);
+  r.resize (ns);
+  A.resize (largestblock*largestblock);
+  BT.resize (ns*largestblock);
+  perm.resize (std::max (largestblock, ns));
+
+  // S = C, r = y_s
+  for (int a = 0; a < ns; ++a) {
+    r[a] = gsl_vector_get (y, sharedrows[a]);
+    for (int c = 0; c < ns; ++c) S[a*ns+c] = gsl_matrix_get (M, sharedrows[a], sharedrows[c]);
+  }
+
+  // Eliminate the blocks
+  for (int ib = 0; ib < nb; ++ib) {
+    int first = blockstart[ib];
+    int ni = blockstart[ib+1] - first;
+    const int *rows = &blockrows[first];
+
+    gsl_matrix_view Ai = gsl_matrix_view_array (&A[0], ni, ni);
+    for (int a = 0; a < ni; ++a)
+      for (int c = 0; c < ni; ++c) gsl_matrix_set (&Ai.matrix, a, c, gsl_matrix_get (M, rows[a], rows[c]));
+    gsl_permutation p = {static_cast<size_t>(ni), &perm[0]};
+    int signum;
+    linalg->LUDecomp (&Ai.matrix, &p, &signum);
+    double detA = linalg->LUDet (&Ai.matrix, signum);
+    if (detA == 0 || !std::isfinite (detA)) return 1;
+    det *= detA;
+
+    // z_i = A_i^-1 y_i
+    gsl_vector_view zi = gsl_vector_view_array (&z[first], ni);
+    for (int a = 0; a < ni; ++a) gsl_vector_set (&zi.vector, a, gsl_vector_get (y, rows[a]));
+    linalg->LUSvx (&Ai.matrix, &p, &zi.vector);
+    if (ns == 0) continue;
+
+    // Z_i = A_i^-1 B_i
+    gsl_matrix_view Zi = gsl_matrix_view_array (&Z[first*ns], ni, ns);
+    gsl_matrix_view BTi = gsl_matrix_view_array (&BT[0], ns, ni);
+    for (int a = 0; a < ni; ++a) {
+      for (int c = 0; c < ns; ++c) {
+        gsl_matrix_set (&Zi.matrix, a, c, gsl_matrix_get (M, rows[a], sharedrows[c]));
+        gsl_matrix_set (&BTi.matrix, c, a, gsl_matrix_get (M, sharedrows[c], rows[a]));
+      }
+    }
+    for (int c = 0; c < ns; ++c) {
+      gsl_vector_view col = gsl_matrix_column (&Zi.matrix, c);
+      linalg->LUSvx (&Ai.matrix, &p, &col.vector);
+    }
+
+    // S -= B_i^T Z_i, r -= B_i^T z_i
+    gsl_matrix_view Sv = gsl_matrix_view_array (&S[0], ns, ns);
+    gsl_vector_view rv = gsl_vector_view_array (&r[0], ns);
+    linalg->dgemm (CblasNoTrans, CblasNoTrans, -1, &BTi.matrix, &Zi.matrix, 1, &Sv.matrix);
+    linalg->dgemv (CblasNoTrans, -1, &BTi.matrix, &zi.vector, 1, &rv.vector);
+  }
+
+  // Solve the reduced system S x_s = r
+  if (ns > 0) {
+    gsl_matrix_view Sv = gsl_matrix_view_array (&S[0], ns, ns);
+    gsl_vector_view rv = gsl_vector_view_array (&r[0], ns);
+    gsl_permutation p = {static_cast<size_t>(ns), &perm[0]};
+    int signum;
+    linalg->LUDecomp (&Sv.matrix, &p, &signum);
+    double detS = linalg->LUDet (&Sv.matrix, signum);
+    if (detS == 0 || !std::isfinite (detS)) return 2;
+    det *= detS;
+    // r now contains x_s
+    linalg->LUSvx (&Sv.matrix, &p, &rv.vector);
+    for (int a = 0; a < ns; ++a) gsl_vector_set (x, sharedrows[a], r[a]);
+  }
+
+  // Back substitution x_i = z_i - Z_i x_s
+  for (int ib = 0; ib < nb; ++ib) {
+    int first = blockstart[ib];
+    int ni = blockstart[ib+1] - first;
+    gsl_vector_view zi = gsl_vector_view_array (&z[first], ni);
+    if (ns > 0) {
+      gsl_matrix_view Zi = gsl_matrix_view_array (&Z[first*ns], ni, ns);
+      gsl_vector_view rv = gsl_vector_view_array (&r[0], ns);
+      linalg->dgemv (CblasNoTrans, -1, &Zi.matrix, &rv.vector, 1, &zi.vector);
+    }
+    for (int a = 0; a < ni; ++a) gsl_vector_set (x, blockrows[first+a], gsl_vector_get (&zi.vector, a));
+  }
+
+  return std::isfinite (det) ? 0 : 3;
+}
+
+int ArrowheadSolver::getNBlocks() const {
+  return blockstart.empty() ? 0 : blockstart.size()-1;
+}
+
+int ArrowheadSolver::getNShared() const {
+  return sharedrows.size();
+}
+
+int ArrowheadSolver::getMaxBlockSize() const {
+  return largestblock;
+}
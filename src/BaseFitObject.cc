@@ -69,7 +69,6 @@ BaseFitObject& BaseFitObject::operator= (const BaseFitObject& rhs) {
     
 BaseFitObject& BaseFitObject::assign (const BaseFitObject& source) {
   if (&source != this) {
-    name = 0; 
     setName(source.name);
     for (int i =0; i < BaseDefs::MAXPAR; ++i) {
       par[i]          = source.par[i];
@@ -80,7 +79,14 @@ BaseFitObject& BaseFitObject::assign (const BaseFitObject& source) {
       for (int j = 0; j < BaseDefs::MAXPAR; ++j) 
         cov[i][j] = source.cov[i][j];
     }  
-    covinvvalid = false;
+    // covinv depends only on cov and measured, both copied above
+    covinvvalid = source.covinvvalid;
+    if (covinvvalid) {
+      for (int i =0; i < BaseDefs::MAXPAR; ++i) 
+        for (int j = 0; j < BaseDefs::MAXPAR; ++j) 
+          covinv[i][j] = source.covinv[i][j];
+    }
+    // the cache is class specific, derived classes may copy it
     cachevalid = false;
   }
   return *this;
@@ -314,6 +320,11 @@ bool BaseFitObject::calculateCovInv() const {
   return covinvvalid;
 }
 
+void BaseFitObject::precompute() const {
+  if (!covinvvalid) calculateCovInv();
+  if (!cachevalid) updateCache();
+}
+
 bool BaseFitObject::setParam (int ilocal, double par_, 
                                     bool measured_, bool fixed_) {
 
@@ -433,8 +444,8 @@ double BaseFitObject::getChi2() const {
   if (!covinvvalid) calculateCovInv();
   if (!covinvvalid) return -1;
   double chi2 = 0;
-  static double resid[BaseDefs::MAXPAR];
-  static bool chi2contr[BaseDefs::MAXPAR];
+  double resid[BaseDefs::MAXPAR];
+  bool chi2contr[BaseDefs::MAXPAR];
   for (int i = 0; i < getNPar(); ++i) {
     resid[i] = par[i]-mpar[i];
 
@@ -21,6 +21,10 @@
 #include "BaseFitter.h"
 #include "BaseSoftConstraint.h"
 #include "BaseHardConstraint.h"
+#include "LinAlgBackend.h"
+#include "StartValueSeeder.h"
+
+#include <cmath>
 
 #undef NDEBUG
 #include <cassert>
@@ -29,10 +33,13 @@ BaseFitter::BaseFitter()
   : fitobjects( FitObjectContainer() ),
     constraints( ConstraintContainer() ),
     softconstraints( SoftConstraintContainer() ),
-    covDim (0), cov(0), covValid (false)
+    covDim (0), cov(0), covValid (false), profile (0),
+    linalg (&LinAlgBackend::getDefault()), seeder (0),
+    budgetseconds (0), budgetevaluations (0), nevaluations (0),
+    budgetstart ()
 #ifndef FIT_TRACEOFF    
   , tracer (0),
-    traceValues( std::map<std::string, double> () )
+    traceValues()
 #endif     
 {}
 
@@ -123,6 +130,14 @@ void BaseFitter::reset()
   covValid = false;
 }  
     
+bool BaseFitter::supportsSoftConstraints() const {
+  return true;
+}
+    
+bool BaseFitter::supportsBudget() const {
+  return false;
+}
+    
 BaseTracer *BaseFitter::getTracer() { 
   return tracer; 
 }
@@ -136,6 +151,82 @@ void BaseFitter::setTracer(BaseTracer& newTracer) {
   tracer = &newTracer; 
 }
 
+void BaseFitter::setProfile (FitProfile *profile_) {
+  profile = profile_;
+}
+
+FitProfile *BaseFitter::getProfile() const {
+  return profile;
+}
+
+void BaseFitter::setLinAlgBackend (const LinAlgBackend& linalg_) {
+  linalg = &linalg_;
+}
+
+const LinAlgBackend& BaseFitter::getLinAlgBackend() const {
+  return *linalg;
+}
+
+void BaseFitter::setSeeder (const StartValueSeeder *seeder_) {
+  seeder = seeder_;
+}
+
+const StartValueSeeder *BaseFitter::getSeeder() const {
+  return seeder;
+}
+
+void BaseFitter::setBudget (double seconds, int evaluations) {
+  budgetseconds = seconds > 0 ? seconds : 0;
+  budgetevaluations = evaluations > 0 ? evaluations : 0;
+}
+
+double BaseFitter::getBudgetSeconds() const {
+  return budgetseconds;
+}
+
+int BaseFitter::getBudgetEvaluations() const {
+  return budgetevaluations;
+}
+
+int BaseFitter::getEvaluations() const {
+  return nevaluations;
+}
+
+double BaseFitter::getConstraintViolation() const {
+  double result = 0;
+  for (ConstraintContainer::const_iterator i = constraints.begin(); i != constraints.end(); ++i) {
+    const BaseHardConstraint *c = *i;
+    assert (c);
+    double viol = std::fabs (c->getValue());
+    double error = c->getError();
+    if (error > 0) viol /= error;
+    if (viol > result) result = viol;
+  }
+  return result;
+}
+
+void BaseFitter::startBudget() {
+  nevaluations = 0;
+  if (budgetseconds > 0) budgetstart = std::chrono::steady_clock::now();
+}
+
+bool BaseFitter::budgetExhausted() const {
+  if (budgetevaluations > 0 && nevaluations >= budgetevaluations) return true;
+  return budgetseconds > 0 && 
+         std::chrono::duration<double> (std::chrono::steady_clock::now() - budgetstart).count() >= budgetseconds;
+}
+
+bool BaseFitter::isBetterIterate (double chi2, double viol, double chi2best, double violbest) {
+  // iterates that fulfill the constraints to 0.01 standard deviations are feasible
+  const double violmax = 0.01;
+  if (viol <= violmax && violbest <= violmax) return chi2 < chi2best;
+  return viol < violbest;
+}
+
+void BaseFitter::seedStartValues() {
+  if (seeder) seeder->seed (*this);
+}
+
 const double *BaseFitter::getGlobalCovarianceMatrix (int& idim) const {
   if (covValid && cov) {
     idim = covDim;
@@ -0,0 +1,26 @@
+/*! \file
+ *  \brief Implements class BasePairingHypothesis
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "BasePairingHypothesis.h"
+#include "BaseHardConstraint.h"
+
+#undef NDEBUG
+#include <cassert>
+
+double BasePairingHypothesis::maxConstraintPull2 (const std::vector<BaseHardConstraint *>& constraints) {
+  double result = 0;
+  for (unsigned int icon = 0; icon < constraints.size(); ++icon) {
+    const BaseHardConstraint *c = constraints[icon];
+    assert (c);
+    double error = c->getError();
+    if (error <= 0) continue;
+    double pull = c->getValue()/error;
+    if (pull*pull > result) result = pull*pull;
+  }
+  return result;
+}
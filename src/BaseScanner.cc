@@ -0,0 +1,190 @@
+/*! \file
+ *  \brief Implements class BaseScanner
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Split scan into prepareScan and restoreFitObjects for adaptive scans
+ *
+ */
+
+#include "BaseScanner.h"
+
+#include "BaseFitter.h"
+#include "BaseFitObject.h"
+#include "BaseHardConstraint.h"
+
+#undef NDEBUG
+#include <cassert>
+
+BaseScanner::BaseScanner (BaseFitter& fitter_)
+: pool (1), fitters (1, &fitter_), fitobjects_backup (1),
+  idim (0), parsave (), par (1), result ()
+{}
+
+BaseScanner::BaseScanner (const std::vector<BaseFitter *>& fitters_)
+: pool (fitters_.size()), fitters (fitters_), fitobjects_backup (fitters_.size()),
+  idim (0), parsave (), par (fitters_.size()), result ()
+{
+  assert (fitters.size() > 0);
+  assert (pool.getNThreads() == (int)fitters.size());
+}
+
+BaseScanner::~BaseScanner() {}
+
+bool BaseScanner::scan (int xglobal,
+                        int nx,
+                        double xstart,
+                        double xstop,
+                        int yglobal,
+                        int ny,
+                        double ystart,
+                        double ystop) {
+  if (!prepareScan (xglobal, nx, xstart, xstop, yglobal, ny, ystart, ystop)) return false;
+
+  startScan();
+  pool.run (*this, nx);
+  endScan();
+
+  restoreFitObjects();
+  return true;
+}
+
+bool BaseScanner::prepareScan (int xglobal,
+                               int nx,
+                               double xstart,
+                               double xstop,
+                               int yglobal,
+                               int ny,
+                               double ystart,
+                               double ystop) {
+  if (nx <= 0 || ny <= 0 || xglobal < 0 || yglobal < 0) return false;
+
+  // Assign the global parameter numbers, check that all fitters agree
+  int ncon = -1;
+  for (unsigned int ithread = 0; ithread < fitters.size(); ++ithread) {
+    BaseFitter *fitter = fitters[ithread];
+    assert (fitter);
+    fitter->initialize();
+    FitObjectContainer* fitobjects = fitter->getFitObjects();
+    ConstraintContainer* constraints = fitter->getConstraints();
+    if (fitobjects == 0 || constraints == 0) return false;
+    if (ncon < 0) ncon = constraints->size();
+    if (ncon != (int)constraints->size()) return false;
+  }
+
+  // Get largest global parameter number,
+  // find parameter names
+  BaseFitter& fitter = *fitters[0];
+  FitObjectContainer* fitobjects = fitter.getFitObjects();
+  ConstraintContainer* constraints = fitter.getConstraints();
+
+  result.setGrid (xglobal, nx, xstart, xstop, yglobal, ny, ystart, ystop, ncon);
+  result.xname = "";
+  result.yname = "";
+  idim = 1;
+  for (FitObjectIterator i = fitobjects->begin(); i != fitobjects->end(); ++i) {
+    BaseFitObject *fo = *i;
+    assert (fo);
+    for (int ilocal = 0; ilocal < fo->getNPar(); ++ilocal) {
+      int iglobal = fo->getGlobalParNum (ilocal);
+      if (iglobal >= idim) idim = iglobal+1;
+      if (iglobal == xglobal) result.xname = fo->getParamName (ilocal);
+      if (iglobal == yglobal) result.yname = fo->getParamName (ilocal);
+    }
+  }
+  for (int icon = 0; icon < ncon; ++icon) {
+    BaseHardConstraint *c = (*constraints)[icon];
+    assert (c);
+    int iglobal = c->getGlobalNum();
+    if (iglobal >= idim) idim = iglobal+1;
+    result.connames[icon] = c->getName();
+  }
+
+  if (xglobal >= idim) return false;
+  if (yglobal >= idim) return false;
+
+  // Get starting values
+  parsave.assign (idim, 0);
+  for (FitObjectIterator i = fitobjects->begin(); i != fitobjects->end(); ++i) {
+    BaseFitObject *fo = *i;
+    assert (fo);
+    for (int ilocal = 0; ilocal < fo->getNPar(); ++ilocal) {
+      int iglobal = fo->getGlobalParNum (ilocal);
+      assert (iglobal >= 0 && iglobal < idim);
+      parsave[iglobal] = fo->getParam (ilocal);
+    }
+  }
+
+  // Save the fit objects of all threads
+  for (unsigned int ithread = 0; ithread < fitters.size(); ++ithread) {
+    FitObjectContainer* fos = fitters[ithread]->getFitObjects();
+    FitObjectContainer& backup = fitobjects_backup[ithread];
+    backup.resize (fos->size());
+    for (unsigned int i = 0; i < fos->size(); ++i) {
+      assert ((*fos)[i]);
+      backup[i] = (*fos)[i]->copy();
+      backup[i]->precompute();
+    }
+    par[ithread].assign (idim, 0);
+  }
+  return true;
+}
+
+void BaseScanner::restoreFitObjects() {
+  for (unsigned int ithread = 0; ithread < fitters.size(); ++ithread) {
+    FitObjectContainer* fos = fitters[ithread]->getFitObjects();
+    FitObjectContainer& backup = fitobjects_backup[ithread];
+    for (unsigned int i = 0; i < fos->size(); ++i) {
+      (*fos)[i]->assign (*backup[i]);
+      delete backup[i];
+    }
+    backup.resize (0);
+  }
+}
+
+const ScanResult& BaseScanner::getResult() const {
+  return result;
+}
+
+int BaseScanner::getNThreads() const {
+  return pool.getNThreads();
+}
+
+void BaseScanner::execute (int itask, int ithread) {
+  assert (itask >= 0 && itask < result.nx);
+  for (int iy = 0; iy < result.ny; ++iy) scanPoint (itask, iy, ithread);
+}
+
+void BaseScanner::startScan() {}
+
+void BaseScanner::endScan() {}
+
+void BaseScanner::setParameters (int ix, int iy, int ithread) {
+  setParameters (result.getX (ix), result.getY (iy), ithread);
+}
+
+void BaseScanner::setParameters (double x, double y, int ithread) {
+  assert (ithread >= 0 && ithread < (int)fitters.size());
+  std::vector<double>& p = par[ithread];
+  p = parsave;
+  p[result.xglobal] = x;
+  p[result.yglobal] = y;
+  FitObjectContainer* fitobjects = fitters[ithread]->getFitObjects();
+  for (FitObjectIterator i = fitobjects->begin(); i != fitobjects->end(); ++i) {
+    BaseFitObject *fo = *i;
+    assert (fo);
+    fo->updateParams (&p[0], idim);
+  }
+}
+
+double BaseScanner::getParameter (int iglobal, int ithread) const {
+  assert (ithread >= 0 && ithread < (int)fitters.size());
+  FitObjectContainer* fitobjects = fitters[ithread]->getFitObjects();
+  for (FitObjectIterator i = fitobjects->begin(); i != fitobjects->end(); ++i) {
+    BaseFitObject *fo = *i;
+    assert (fo);
+    for (int ilocal = 0; ilocal < fo->getNPar(); ++ilocal)
+      if (fo->getGlobalParNum (ilocal) == iglobal) return fo->getParam (ilocal);
+  }
+  return 0;
+}
@@ -0,0 +1,140 @@
+/*! \file
+ *  \brief Implements class BinaryTraceBuffer
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "BinaryTraceBuffer.h"
+
+#include <cstring>
+#include <cstddef>
+#include <iostream>
+#include <new>
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#undef NDEBUG
+#include <cassert>
+
+namespace {
+  const char tracemagic[8] = "KFTRACE";
+
+  // number of bytes of a record that are in use, starting at eventid
+  inline size_t payloadSize (const BinaryTraceRecord& record) {
+    int npar = record.npar;
+    if (npar < 0) npar = 0;
+    if (npar > BinaryTraceRecord::NPARMAX) npar = BinaryTraceRecord::NPARMAX;
+    return offsetof (BinaryTraceRecord, par) + npar*sizeof (double) - offsetof (BinaryTraceRecord, eventid);
+  }
+}
+
+BinaryTraceBuffer::BinaryTraceBuffer (const char *filename, long capacity_)
+: fd (-1), mapping (0), mapsize (0), header (0), records (0), capacity (0)
+{
+  if (capacity_ <= 0) capacity_ = 1;
+  mapsize = sizeof (Header) + capacity_*sizeof (BinaryTraceRecord);
+
+  if (filename) {
+    fd = open (filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate (fd, mapsize) != 0) {
+      std::cerr << "BinaryTraceBuffer: cannot create file " << filename << std::endl;
+      if (fd >= 0) close (fd);
+      fd = -1;
+      return;
+    }
+    mapping = mmap (0, mapsize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  else {
+    mapping = mmap (0, mapsize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+  if (mapping == MAP_FAILED) {
+    std::cerr << "BinaryTraceBuffer: cannot map " << mapsize << " bytes" << std::endl;
+    mapping = 0;
+    if (fd >= 0) close (fd);
+    fd = -1;
+    return;
+  }
+
+  header = new (mapping) Header;
+  std::memcpy (header->magic, tracemagic, sizeof (tracemagic));
+  header->version = VERSION;
+  header->recordsize = sizeof (BinaryTraceRecord);
+  header->capacity = capacity_;
+  header->next = 0;
+  header->ndropped = 0;
+  records = reinterpret_cast<BinaryTraceRecord *> (static_cast<char *>(mapping) + sizeof (Header));
+  capacity = capacity_;
+  // the slots are zero (i.e. empty) from ftruncate or the anonymous mapping
+}
+
+BinaryTraceBuffer::~BinaryTraceBuffer() {
+  if (mapping) munmap (mapping, mapsize);
+  if (fd >= 0) close (fd);
+}
+
+bool BinaryTraceBuffer::isValid() const {
+  return header != 0;
+}
+
+long BinaryTraceBuffer::getCapacity() const {
+  return capacity;
+}
+
+uint64_t BinaryTraceBuffer::getNRecords() const {
+  return header ? header->next.load (std::memory_order_acquire) : 0;
+}
+
+uint64_t BinaryTraceBuffer::getNDropped() const {
+  return header ? header->ndropped.load (std::memory_order_relaxed) : 0;
+}
+
+void BinaryTraceBuffer::append (const BinaryTraceRecord& record) {
+  if (!header) return;
+  uint64_t seq = header->next.fetch_add (1, std::memory_order_relaxed);
+  BinaryTraceRecord& slot = records[seq % capacity];
+
+  // claim the slot by marking it incomplete, fill it, then mark it complete;
+  // never wait for another writer that still holds the slot
+  uint64_t old = __atomic_load_n (&slot.sequence, __ATOMIC_RELAXED);
+  if (old == 0 && seq >= capacity) {
+    header->ndropped.fetch_add (1, std::memory_order_relaxed);
+    return;
+  }
+  if (!__atomic_compare_exchange_n (&slot.sequence, &old, 0, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+    header->ndropped.fetch_add (1, std::memory_order_relaxed);
+    return;
+  }
+  std::atomic_thread_fence (std::memory_order_release);
+  std::memcpy (&slot.eventid, &record.eventid, payloadSize (record));
+  __atomic_store_n (&slot.sequence, seq+1, __ATOMIC_RELEASE);
+}
+
+bool BinaryTraceBuffer::getRecord (uint64_t seq, BinaryTraceRecord& record) const {
+  if (!header) return false;
+  return readRecord (*header, records, seq, record);
+}
+
+bool BinaryTraceBuffer::checkHeader (const Header& header) {
+  return std::memcmp (header.magic, tracemagic, sizeof (tracemagic)) == 0
+      && header.version == VERSION
+      && header.recordsize == sizeof (BinaryTraceRecord)
+      && header.capacity > 0;
+}
+
+bool BinaryTraceBuffer::readRecord (const Header& header, const BinaryTraceRecord *slots,
+                                    uint64_t seq, BinaryTraceRecord& record) {
+  assert (slots);
+  if (seq >= header.next.load (std::memory_order_acquire)) return false;
+  const BinaryTraceRecord& slot = slots[seq % header.capacity];
+  if (__atomic_load_n (&slot.sequence, __ATOMIC_ACQUIRE) != seq+1) return false;
+  std::memcpy (&record, &slot, sizeof (BinaryTraceRecord));
+  std::atomic_thread_fence (std::memory_order_acquire);
+  // overwritten while copying?
+  if (__atomic_load_n (&slot.sequence, __ATOMIC_RELAXED) != seq+1 || record.npar < 0 || record.npar > BinaryTraceRecord::NPARMAX) return false;
+  record.sequence = seq+1;
+  return true;
+}
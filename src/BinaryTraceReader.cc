@@ -0,0 +1,155 @@
+/*! \file
+ *  \brief Implements class BinaryTraceReader
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "BinaryTraceReader.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef MARLIN_USE_ROOT
+#include <TTree.h>
+#endif
+
+BinaryTraceReader::BinaryTraceReader (const char *filename)
+: mapping (0), mapsize (0), header (0), records (0)
+{
+  int fd = open (filename, O_RDONLY);
+  if (fd < 0) {
+    std::cerr << "BinaryTraceReader: cannot open file " << filename << std::endl;
+    return;
+  }
+  struct stat st;
+  if (fstat (fd, &st) != 0 || st.st_size < (off_t)sizeof (BinaryTraceBuffer::Header)) {
+    std::cerr << "BinaryTraceReader: file " << filename << " is too short" << std::endl;
+    close (fd);
+    return;
+  }
+  mapsize = st.st_size;
+  mapping = mmap (0, mapsize, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  if (mapping == MAP_FAILED) {
+    std::cerr << "BinaryTraceReader: cannot map file " << filename << std::endl;
+    mapping = 0;
+    return;
+  }
+  const BinaryTraceBuffer::Header *h = static_cast<const BinaryTraceBuffer::Header *>(mapping);
+  if (!BinaryTraceBuffer::checkHeader (*h) ||
+      mapsize < sizeof (BinaryTraceBuffer::Header) + h->capacity*sizeof (BinaryTraceRecord)) {
+    std::cerr << "BinaryTraceReader: file " << filename << " is not a valid trace file" << std::endl;
+    return;
+  }
+  header = h;
+  records = reinterpret_cast<const BinaryTraceRecord *> (static_cast<const char *>(mapping) + sizeof (BinaryTraceBuffer::Header));
+}
+
+BinaryTraceReader::~BinaryTraceReader() {
+  if (mapping) munmap (mapping, mapsize);
+}
+
+bool BinaryTraceReader::isValid() const {
+  return header != 0;
+}
+
+long BinaryTraceReader::getCapacity() const {
+  return header ? header->capacity : 0;
+}
+
+uint64_t BinaryTraceReader::getNRecords() const {
+  return header ? header->next.load (std::memory_order_acquire) : 0;
+}
+
+uint64_t BinaryTraceReader::getFirstRecord() const {
+  if (!header) return 0;
+  uint64_t n = getNRecords();
+  return n > header->capacity ? n - header->capacity : 0;
+}
+
+bool BinaryTraceReader::getRecord (uint64_t seq, BinaryTraceRecord& record) const {
+  if (!header) return false;
+  return BinaryTraceBuffer::readRecord (*header, records, seq, record);
+}
+
+long BinaryTraceReader::writeCSV (std::ostream& os) const {
+  if (!header) return 0;
+  os << "record,event,fit,tracer,type,flag,iteration,error,chi2,alpha,phi,mu,detW,npar";
+  for (int i = 0; i < BinaryTraceRecord::NPARMAX; ++i) os << ",par" << i;
+  os << '\n';
+
+  std::streamsize oldprec = os.precision (17);
+  long n = 0;
+  BinaryTraceRecord r;
+  uint64_t last = getNRecords();
+  for (uint64_t seq = getFirstRecord(); seq < last; ++seq) {
+    if (!getRecord (seq, r)) continue;
+    os << seq << ',' << r.eventid << ',' << r.fitid << ',' << r.tracerid << ','
+       << r.type << ',' << r.flag << ',' << r.iteration << ',' << r.error << ','
+       << r.chi2 << ',' << r.alpha << ',' << r.phi << ',' << r.mu << ',' << r.detW << ','
+       << r.npar;
+    for (int i = 0; i < BinaryTraceRecord::NPARMAX; ++i) {
+      os << ',';
+      if (i < r.npar) os << r.par[i];
+    }
+    os << '\n';
+    ++n;
+  }
+  os.precision (oldprec);
+  return n;
+}
+
+#ifdef MARLIN_USE_ROOT
+TTree *BinaryTraceReader::createTree (const char *name) const {
+  if (!header) return 0;
+  Long64_t record, event, fit;
+  Int_t tracer, type, flag, iteration, error, npar;
+  Double_t chi2, alpha, phi, mu, detW;
+  Double_t par[BinaryTraceRecord::NPARMAX];
+
+  TTree *tree = new TTree (name, "Kinfit binary trace");
+  tree->Branch ("record",    &record,    "record/L");
+  tree->Branch ("event",     &event,     "event/L");
+  tree->Branch ("fit",       &fit,       "fit/L");
+  tree->Branch ("tracer",    &tracer,    "tracer/I");
+  tree->Branch ("type",      &type,      "type/I");
+  tree->Branch ("flag",      &flag,      "flag/I");
+  tree->Branch ("iteration", &iteration, "iteration/I");
+  tree->Branch ("error",     &error,     "error/I");
+  tree->Branch ("chi2",      &chi2,      "chi2/D");
+  tree->Branch ("alpha",     &alpha,     "alpha/D");
+  tree->Branch ("phi",       &phi,       "phi/D");
+  tree->Branch ("mu",        &mu,        "mu/D");
+  tree->Branch ("detW",      &detW,      "detW/D");
+  tree->Branch ("npar",      &npar,      "npar/I");
+  tree->Branch ("par",       par,        "par[npar]/D");
+
+  BinaryTraceRecord r;
+  uint64_t last = getNRecords();
+  for (uint64_t seq = getFirstRecord(); seq < last; ++seq) {
+    if (!getRecord (seq, r)) continue;
+    record = seq;
+    event = r.eventid;
+    fit = r.fitid;
+    tracer = r.tracerid;
+    type = r.type;
+    flag = r.flag;
+    iteration = r.iteration;
+    error = r.error;
+    chi2 = r.chi2;
+    alpha = r.alpha;
+    phi = r.phi;
+    mu = r.mu;
+    detW = r.detW;
+    npar = r.npar;
+    for (int i = 0; i < npar; ++i) par[i] = r.par[i];
+    tree->Fill();
+  }
+  tree->ResetBranchAddresses();
+  return tree;
+}
+#endif
@@ -0,0 +1,101 @@
+/*! \file
+ *  \brief Implements class BinaryTracer
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Added fillRecord and replay for TriggeredTracer
+ *
+ */
+
+#include "BinaryTracer.h"
+
+#include "BaseFitter.h"
+#include "BaseFitObject.h"
+
+#include <cstring>
+
+BinaryTracer::BinaryTracer (BinaryTraceBuffer& buffer_, int tracerid_)
+: buffer (buffer_), tracerid (tracerid_), eventid (0), fitid (-1)
+{
+  std::memset (&record, 0, sizeof (record));
+}
+
+BinaryTracer::~BinaryTracer() {}
+
+void BinaryTracer::initialize (BaseFitter& fitter) {
+  write (fitter, BinaryTraceRecord::INITIALIZE, 0);
+  BaseTracer::initialize (fitter);
+}
+
+void BinaryTracer::step (BaseFitter& fitter) {
+  write (fitter, BinaryTraceRecord::STEP, 0);
+  BaseTracer::step (fitter);
+}
+
+void BinaryTracer::substep (BaseFitter& fitter, int flag) {
+  write (fitter, BinaryTraceRecord::SUBSTEP, flag);
+  BaseTracer::substep (fitter, flag);
+}
+
+void BinaryTracer::finish (BaseFitter& fitter) {
+  write (fitter, BinaryTraceRecord::FINISH, 0);
+  BaseTracer::finish (fitter);
+}
+
+void BinaryTracer::setEventId (int64_t eventid_) {
+  eventid = eventid_;
+}
+
+int64_t BinaryTracer::getEventId() const {
+  return eventid;
+}
+
+void BinaryTracer::replay (BaseFitter& fitter, const BinaryTraceRecord& r) {
+  writeRecord (r);
+  switch (r.type) {
+    case BinaryTraceRecord::INITIALIZE: BaseTracer::initialize (fitter); break;
+    case BinaryTraceRecord::STEP:       BaseTracer::step (fitter); break;
+    case BinaryTraceRecord::SUBSTEP:    BaseTracer::substep (fitter, r.flag); break;
+    case BinaryTraceRecord::FINISH:     BaseTracer::finish (fitter); break;
+  }
+}
+
+void BinaryTracer::write (BaseFitter& fitter, int type, int flag) {
+  fillRecord (fitter, type, flag, record);
+  writeRecord (record);
+}
+
+void BinaryTracer::writeRecord (const BinaryTraceRecord& r) {
+  if (r.type == BinaryTraceRecord::INITIALIZE) ++fitid;
+  if (&r != &record) record = r;
+  record.eventid  = eventid;
+  record.fitid    = fitid;
+  record.tracerid = tracerid;
+  buffer.append (record);
+}
+
+void BinaryTracer::fillRecord (BaseFitter& fitter, int type, int flag, BinaryTraceRecord& r) {
+  r.type      = type;
+  r.flag      = flag;
+  r.iteration = fitter.getIterations();
+  r.error     = fitter.getError();
+  r.chi2      = fitter.getChi2();
+#ifndef FIT_TRACEOFF
+  r.alpha = fitter.traceValues.get (TraceValues::ALPHA);
+  r.phi   = fitter.traceValues.get (TraceValues::PHI);
+  r.mu    = fitter.traceValues.get (TraceValues::MU);
+  r.detW  = fitter.traceValues.get (TraceValues::DETW);
+#endif
+
+  int npar = 0;
+  std::vector<BaseFitObject *> *fitobjects = fitter.getFitObjects();
+  if (fitobjects) {
+    for (unsigned int ifo = 0; ifo < fitobjects->size(); ++ifo) {
+      const BaseFitObject *fo = (*fitobjects)[ifo];
+      if (!fo) continue;
+      for (int ilocal = 0; ilocal < fo->getNPar() && npar < BinaryTraceRecord::NPARMAX; ++ilocal)
+        r.par[npar++] = fo->getParam (ilocal);
+    }
+  }
+  r.npar = npar;
+}
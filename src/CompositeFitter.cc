@@ -0,0 +1,298 @@
+/*! \file
+ *  \brief Implements class CompositeFitter
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Seed the start values before the first engine
+ * - 18.10.2026 With a budget, try only engines that obey it
+ *
+ */
+
+#include "CompositeFitter.h"
+
+#include "BaseFitObject.h"
+#include "BaseHardConstraint.h"
+#include "BaseSoftConstraint.h"
+#include "FitProfile.h"
+#include "LinAlgBackend.h"
+#include "OPALFitterGSL.h"
+#include "NewFitterGSL.h"
+#include "NewtonFitterGSL.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+
+#undef NDEBUG
+#include <cassert>
+
+namespace {
+  // Orders engine numbers by increasing time per successful fit
+  class CostOrder {
+    public:
+      CostOrder (const std::vector<CompositeFitter::EngineStats>& stats_): stats (stats_) {}
+      bool operator() (int i, int j) const {
+        return cost (stats[i]) < cost (stats[j]);
+      }
+    private:
+      static double cost (const CompositeFitter::EngineStats& s) {
+        return s.nsuccess > 0 ? s.seconds/s.nsuccess : std::numeric_limits<double>::infinity();
+      }
+      const std::vector<CompositeFitter::EngineStats>& stats;
+  };
+}
+
+CompositeFitter::EngineStats::EngineStats()
+: nattempts (0), nsuccess (0), seconds (0)
+{}
+
+CompositeFitter::CompositeFitter()
+: engines (), ownedengines (), order (), startvalues (),
+  adaptive (true), nmin (20), statistics (),
+  lastengine (0), nattempts (0), ierr (0), nit (0), fitprob (0), chi2 (0), dof (0)
+{
+  NewFitterGSL *trustfitter = new NewFitterGSL;
+  trustfitter->setTrustRegion (true);
+  ownedengines.push_back (new OPALFitterGSL);
+  ownedengines.push_back (new NewFitterGSL);
+  ownedengines.push_back (trustfitter);
+  ownedengines.push_back (new NewtonFitterGSL);
+  engines = ownedengines;
+}
+
+CompositeFitter::~CompositeFitter() {
+  for (unsigned int i = 0; i < ownedengines.size(); ++i) delete ownedengines[i];
+}
+
+double CompositeFitter::fit() {
+  startBudget();
+  covValid = false;
+  lastengine = 0;
+  nattempts = 0;
+  ierr = 1;
+  nit = 0;
+  fitprob = -1;
+  chi2 = -1;
+  dof = 0;
+
+  std::vector<EngineStats>& stats = statistics[FitProfileMap::getTopology (*this)];
+  stats.resize (engines.size());
+  selectOrder (stats);
+  // seed once; the engines start from the seeded values
+  seedStartValues();
+  saveStart();
+
+  for (unsigned int k = 0; k < order.size(); ++k) {
+    BaseFitter& engine = *engines[order[k]];
+    // if the budget is exhausted, the fit objects keep the state of the last result
+    if (!setupEngine (engine)) break;
+    if (k > 0) restoreStart();
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    fitprob = engine.fit();
+    double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - t0).count();
+
+    lastengine = &engine;
+    ++nattempts;
+    ierr = engine.getError();
+    nit += engine.getIterations();
+    nevaluations += engine.getEvaluations();
+    chi2 = engine.getChi2();
+    dof = engine.getDoF();
+
+    EngineStats& s = stats[order[k]];
+    ++s.nattempts;
+    if (ierr == 0) ++s.nsuccess;
+    s.seconds += seconds;
+
+    if (ierr == 0 || ierr == BUDGETEXHAUSTED) break;
+  }
+
+  // copy the covariance matrix of the result
+  int idim = 0;
+  const double *enginecov = lastengine ? lastengine->getGlobalCovarianceMatrix (idim) : 0;
+  if (enginecov) {
+    if (cov && covDim != idim) {
+      delete[] cov;
+      cov = 0;
+    }
+    covDim = idim;
+    if (!cov) cov = new double[covDim*covDim];
+    std::copy (enginecov, enginecov + covDim*covDim, cov);
+    covValid = true;
+  }
+
+  return fitprob;
+}
+
+int CompositeFitter::getError() const {return ierr;}
+double CompositeFitter::getProbability() const {return fitprob;}
+double CompositeFitter::getChi2() const {return chi2;}
+int CompositeFitter::getDoF() const {return dof;}
+int CompositeFitter::getIterations() const {return nit;}
+
+bool CompositeFitter::initialize() {
+  covValid = false;
+  return true;
+}
+
+bool CompositeFitter::supportsSoftConstraints() const {
+  for (unsigned int i = 0; i < engines.size(); ++i)
+    if (engines[i]->supportsSoftConstraints()) return true;
+  return false;
+}
+
+bool CompositeFitter::supportsBudget() const {
+  for (unsigned int i = 0; i < engines.size(); ++i)
+    if (engines[i]->supportsBudget()) return true;
+  return false;
+}
+
+void CompositeFitter::clearEngines() {
+  engines.clear();
+  statistics.clear();
+}
+
+void CompositeFitter::addEngine (BaseFitter& engine) {
+  assert (&engine != this);
+  engines.push_back (&engine);
+}
+
+int CompositeFitter::getNEngines() const {
+  return engines.size();
+}
+
+BaseFitter *CompositeFitter::getEngine (int iengine) const {
+  assert (iengine >= 0 && iengine < (int)engines.size());
+  return engines[iengine];
+}
+
+BaseFitter *CompositeFitter::getEngine() const {
+  return lastengine;
+}
+
+int CompositeFitter::getNAttempts() const {
+  return nattempts;
+}
+
+void CompositeFitter::setAdaptive (bool on, int nmin_) {
+  adaptive = on;
+  nmin = nmin_ > 1 ? nmin_ : 1;
+}
+
+CompositeFitter::EngineStats CompositeFitter::getStatistics (const std::string& topology, int iengine) const {
+  StatsMap::const_iterator it = statistics.find (topology);
+  if (it == statistics.end() || iengine < 0 || iengine >= (int)it->second.size()) return EngineStats();
+  return it->second[iengine];
+}
+
+void CompositeFitter::clearStatistics() {
+  statistics.clear();
+}
+
+void CompositeFitter::printStatistics (std::ostream& os) const {
+  std::ios_base::fmtflags oldflags = os.flags();
+  std::streamsize oldprec = os.precision (1);
+  os << std::fixed;
+  for (StatsMap::const_iterator it = statistics.begin(); it != statistics.end(); ++it) {
+    os << "Topology: " << it->first << '\n'
+       << std::setw (4) << "#" << ' '
+       << std::setw (20) << std::left << "engine" << std::right
+       << std::setw (12) << "attempts"
+       << std::setw (12) << "successes"
+       << std::setw (16) << "us/attempt" << '\n';
+    for (unsigned int i = 0; i < it->second.size() && i < engines.size(); ++i) {
+      const EngineStats& s = it->second[i];
+      os << std::setw (4) << i << ' '
+         << std::setw (20) << std::left << FitProfile::getClassName (typeid (*engines[i])) << std::right
+         << std::setw (12) << s.nattempts
+         << std::setw (12) << s.nsuccess
+         << std::setw (16) << (s.nattempts > 0 ? 1E6*s.seconds/s.nattempts : 0) << '\n';
+    }
+  }
+  os.precision (oldprec);
+  os.flags (oldflags);
+}
+
+bool CompositeFitter::isCapable (int iengine) const {
+  assert (iengine >= 0 && iengine < (int)engines.size());
+  if (hasBudget() && !engines[iengine]->supportsBudget()) return false;
+  return softconstraints.empty() || engines[iengine]->supportsSoftConstraints();
+}
+
+void CompositeFitter::selectOrder (const std::vector<EngineStats>& stats) {
+  order.clear();
+  for (unsigned int i = 0; i < engines.size(); ++i)
+    if (isCapable (i)) order.push_back (i);
+  if (!adaptive) return;
+
+  // The engines with enough statistics swap places among themselves
+  std::vector<int> slots;
+  std::vector<int> known;
+  for (unsigned int k = 0; k < order.size(); ++k) {
+    if (stats[order[k]].nattempts >= nmin) {
+      slots.push_back (k);
+      known.push_back (order[k]);
+    }
+  }
+  std::stable_sort (known.begin(), known.end(), CostOrder (stats));
+  for (unsigned int k = 0; k < slots.size(); ++k) order[slots[k]] = known[k];
+}
+
+void CompositeFitter::saveStart() {
+  startvalues.clear();
+  for (FitObjectIterator i = fitobjects.begin(); i != fitobjects.end(); ++i) {
+    BaseFitObject *fo = *i;
+    assert (fo);
+    for (int ilocal = 0; ilocal < fo->getNPar(); ++ilocal) {
+      startvalues.push_back (fo->getParam (ilocal));
+      for (int jlocal = ilocal; jlocal < fo->getNPar(); ++jlocal)
+        startvalues.push_back (fo->getCov (ilocal, jlocal));
+    }
+  }
+}
+
+void CompositeFitter::restoreStart() {
+  std::vector<double>::const_iterator v = startvalues.begin();
+  for (FitObjectIterator i = fitobjects.begin(); i != fitobjects.end(); ++i) {
+    BaseFitObject *fo = *i;
+    assert (fo);
+    for (int ilocal = 0; ilocal < fo->getNPar(); ++ilocal) {
+      fo->setParam (ilocal, *v++);
+      for (int jlocal = ilocal; jlocal < fo->getNPar(); ++jlocal)
+        fo->setCov (ilocal, jlocal, *v++);
+    }
+  }
+  assert (v == startvalues.end());
+}
+
+bool CompositeFitter::setupEngine (BaseFitter& engine) {
+  if (hasBudget()) {
+    if (budgetExhausted()) return false;
+    double seconds = 0;
+    if (budgetseconds > 0) {
+      seconds = budgetseconds - std::chrono::duration<double> (std::chrono::steady_clock::now() - budgetstart).count();
+      if (seconds <= 0) return false;
+    }
+    engine.setBudget (seconds, budgetevaluations > 0 ? budgetevaluations - nevaluations : 0);
+  }
+  else {
+    engine.setBudget (0);
+  }
+
+  engine.reset();
+  for (FitObjectIterator i = fitobjects.begin(); i != fitobjects.end(); ++i)
+    engine.addFitObject (*i);
+  for (ConstraintIterator i = constraints.begin(); i != constraints.end(); ++i)
+    engine.addHardConstraint (*i);
+  for (SoftConstraintIterator i = softconstraints.begin(); i != softconstraints.end(); ++i)
+    engine.addSoftConstraint (*i);
+
+  engine.setProfile (profile);
+  engine.setLinAlgBackend (*linalg);
+#ifndef FIT_TRACEOFF
+  engine.setTracer (tracer);
+#endif
+  return true;
+}
@@ -0,0 +1,86 @@
+/*! \file
+ *  \brief Implements class CounterRandom
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "CounterRandom.h"
+
+#include <cmath>
+
+#undef NDEBUG
+#include <cassert>
+
+CounterRandom::CounterRandom (uint64_t seed_)
+: seed (seed_), stream (0), counter (0), nused (2)
+{
+  for (int i = 0; i < 4; ++i) block[i] = 0;
+}
+
+void CounterRandom::setSeed (uint64_t seed_) {
+  seed = seed_;
+  setStream (0);
+}
+
+uint64_t CounterRandom::getSeed() const {
+  return seed;
+}
+
+void CounterRandom::setStream (uint64_t stream_) {
+  stream = stream_;
+  counter = 0;
+  nused = 2;
+}
+
+uint64_t CounterRandom::getStream() const {
+  return stream;
+}
+
+void CounterRandom::nextBlock() {
+  // Philox4x32 with 10 rounds
+  const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+  const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+  uint32_t ctr[4] = {uint32_t (counter), uint32_t (counter >> 32),
+                     uint32_t (stream),  uint32_t (stream >> 32)};
+  uint32_t key[2] = {uint32_t (seed), uint32_t (seed >> 32)};
+
+  for (int iround = 0; iround < 10; ++iround) {
+    uint64_t p0 = uint64_t (M0)*ctr[0];
+    uint64_t p1 = uint64_t (M1)*ctr[2];
+    uint32_t c0 = uint32_t (p1 >> 32) ^ ctr[1] ^ key[0];
+    uint32_t c2 = uint32_t (p0 >> 32) ^ ctr[3] ^ key[1];
+    ctr[0] = c0;
+    ctr[1] = uint32_t (p1);
+    ctr[2] = c2;
+    ctr[3] = uint32_t (p0);
+    key[0] += W0;
+    key[1] += W1;
+  }
+  for (int i = 0; i < 4; ++i) block[i] = ctr[i];
+  ++counter;
+  nused = 0;
+}
+
+double CounterRandom::Rndm() {
+  if (nused >= 2) nextBlock();
+  uint64_t bits = (uint64_t (block[2*nused]) << 32) | block[2*nused+1];
+  ++nused;
+  // 53 significant bits, centred in the bin: never 0 or 1
+  return ((bits >> 11) + 0.5)*(1.0/9007199254740992.0);
+}
+
+void CounterRandom::RndmArray (int n, double *array) {
+  assert (n <= 0 || array);
+  for (int i = 0; i < n; ++i) array[i] = Rndm();
+}
+
+double CounterRandom::Gaus (double mean, double sigma) {
+  // Box-Muller; uses two numbers per call, so that the
+  // position in the stream does not depend on earlier calls
+  double r = std::sqrt (-2*std::log (Rndm()));
+  double phi = 2*M_PI*Rndm();
+  return mean + sigma*r*std::cos (phi);
+}
@@ -13,6 +13,7 @@
 
 #include "JetFitObject.h"
 #include "LeptonFitObject.h"
+#include "CounterRandom.h"
 
 #include <iostream>              // - cout
 #include <cmath>            
@@ -36,8 +37,8 @@ DijetEventILC::DijetEventILC()
   ec  (1, 0, 0, 0, 500),
   mc( MassConstraint() )
   {
-  for (int i = 0; i < NFV; ++i) fv[i] = 0;
-  for (int i = 0; i < NBFO; ++i) bfo[i] = bfosmear[i] = 0;
+  for (int i = 0; i < NFV; ++i) fv[i] = fvsmear[i] = fvfinal[i] = 0;
+  for (int i = 0; i < NBFO; ++i) bfo[i] = bfostart[i] = bfosmear[i] = 0;
   mc.setMass (500);
   pxc.setName ("px");
   pyc.setName ("py");
@@ -48,13 +49,58 @@ DijetEventILC::DijetEventILC()
 
 //destructor: 
 DijetEventILC::~DijetEventILC() {
-  for (int i = 0; i < NFV; ++i) delete fv[i];
+  clearEvent();
+}
+
+DijetEventILC *DijetEventILC::copy() const {
+  DijetEventILC *result = new DijetEventILC;
+  result->leptonic    = leptonic;
+  result->leptonasjet = leptonasjet;
+  result->debug       = debug;
+  return result;
+}
+
+void DijetEventILC::clearEvent() {
+  for (int i = 0; i < NFV; ++i) {
+    delete fv[i];
+    delete fvsmear[i];
+    delete fvfinal[i];
+    fv[i] = fvsmear[i] = fvfinal[i] = 0;
+  }
   for (int i = 0; i < NBFO; ++i) {
     delete bfo[i];
+    delete bfostart[i];
     delete bfosmear[i];
+    bfo[i] = bfostart[i] = bfosmear[i] = 0;
   }  
 }
 
+void DijetEventILC::getRandoms (int n, double r[]) {
+  if (random) {
+    random->RndmArray (n, r);
+    return;
+  }
+  if (rnd == 0) rnd = new TRandom3();
+  rnd->RndmArray (n, r);
+}
+
+double DijetEventILC::getGaus() {
+  if (random) return random->Gaus();
+  if (rnd == 0) rnd = new TRandom3();
+  return rnd->Gaus();
+}
+
+void DijetEventILC::decay (const FourVector& mother, FourVector& d1, FourVector& d2) {
+  if (random) {
+    double r[2];
+    random->RndmArray (2, r);
+    mother.decayto (d1, d2, r[0], r[1]);
+  }
+  else {
+    mother.decayto (d1, d2);
+  }
+}
+
 
 // generate four vectors
 void DijetEventILC::genEvent(){
@@ -65,6 +111,8 @@ void DijetEventILC::genEvent(){
     pzc.resetFOList();
     ec.resetFOList();
     mc.resetFOList();
+    
+    clearEvent();
    
    
   // generate 4-vectors of two jets, like step 0 of TopEvent:
@@ -74,8 +122,7 @@ void DijetEventILC::genEvent(){
   double Ecm = 500.;
       
   double rw[4];
-  if (rnd == 0) rnd = new TRandom3();
-  rnd->RndmArray (4, rw);
+  getRandoms (4, rw);
   
   FourVector *jetpair = fv[0] = new FourVector (Ecm, 0., 0., 0.);
   if (debug) {
@@ -89,7 +136,7 @@ void DijetEventILC::genEvent(){
   FourVector *jet1 = fv[1] = new FourVector (mjet1, 0, 0, 0);
   FourVector *jet2 = fv[2] = new FourVector (mjet2, 0, 0, 0);
   
-  jetpair->decayto (*jet1, *jet2);
+  decay (*jetpair, *jet1, *jet2);
   if (debug) {
     cout << "jet 1: m=" << mjet1 << " = " << jet1->getM() << endl;
     cout << "jet 2: m=" << mjet2 << " = " << jet2->getM() << endl;
@@ -153,8 +200,7 @@ void DijetEventILC::genEvent(){
     }  
     
     double randoms[3];
-    if (rnd == 0) rnd = new TRandom3();
-    for (int irnd = 0; irnd < 3; ++irnd) randoms[irnd] = rnd->Gaus();
+    for (int irnd = 0; irnd < 3; ++irnd) randoms[irnd] = getGaus();
     
     // Create fit object with smeared quantities as fit input
     double ESmear = E + EError*randoms[0];
@@ -292,6 +338,10 @@ int DijetEventILC::fitEvent (BaseFitter& fitter){
          << ", iterations: " << fitter.getIterations() << endl;
   }       
 
+  for (int i = 0; i < NFV; ++i) {
+    delete fvfinal[i];
+    fvfinal[i] = 0;
+  }
   for (int j = 0; j < 2; ++j) {
     int i = j+1;
     fvfinal[i] = new FourVector (bfosmear[j]->getE(), bfosmear[j]->getPx(), bfosmear[j]->getPy(), bfosmear[j]->getPz());
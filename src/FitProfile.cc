@@ -0,0 +1,350 @@
+/*! \file
+ *  \brief Implements classes FitProfile and FitProfileMap
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Added hardware performance counters, per class attribution
+ *              and FitProfileMap
+ * - 18.10.2026 Added counter SOLVEARROWHEAD
+ * - 18.10.2026 Added counter COVFACTORREUSED
+ * - 18.10.2026 Added counter EIGENREFINED
+ * - 18.10.2026 Added counter SOLVENULLSPACE
+ * - 18.10.2026 Added counter BUDGETEXHAUSTED
+ *
+ */
+
+#include "FitProfile.h"
+#include "BaseFitter.h"
+#include "BaseFitObject.h"
+#include "BaseHardConstraint.h"
+#include "BaseSoftConstraint.h"
+
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+
+#undef NDEBUG
+#include <cassert>
+
+namespace {
+  double measureTicksPerSecond() {
+#if defined(__x86_64__) || defined(__i386__)
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    uint64_t c0 = FitProfile::now();
+    std::this_thread::sleep_for (std::chrono::milliseconds (20));
+    uint64_t c1 = FitProfile::now();
+    double dt = std::chrono::duration<double> (std::chrono::steady_clock::now() - t0).count();
+    return dt > 0 ? (c1-c0)/dt : 1E9;
+#else
+    return 1E9;
+#endif
+  }
+  
+  // Append "n classname" for each class of objects to key
+  template <class T>
+  void addClasses (std::ostringstream& key, const std::vector<T *>& objects) {
+    std::map<std::string, int> n;
+    for (unsigned int i = 0; i < objects.size(); ++i) {
+      assert (objects[i]);
+      ++n[FitProfile::getClassName (typeid (*objects[i]))];
+    }
+    if (n.empty()) key << '0';
+    for (std::map<std::string, int>::const_iterator it = n.begin(); it != n.end(); ++it) {
+      if (it != n.begin()) key << ", ";
+      key << it->second << ' ' << it->first;
+    }
+  }
+  
+  // Divide, 0 if the denominator is 0
+  double ratio (double a, double b) {
+    return b != 0 ? a/b : 0;
+  }
+}
+
+FitProfile::ObjectStats::ObjectStats()
+: ncalls (0), ticks (0), ncounted (0)
+{
+  for (int ievent = 0; ievent < PerfCounterGroup::NEVENTS; ++ievent) events[ievent] = 0;
+}
+
+FitProfile::FitProfile() 
+: objectstats (), hardwarecounters (false), objectprofiling (false), perf (0), perfthread ()
+{
+  clear();
+}
+
+FitProfile::~FitProfile() {
+  delete perf;
+}
+
+void FitProfile::setHardwareCounters (bool on) {
+  hardwarecounters = on;
+}
+
+void FitProfile::setObjectProfiling (bool on) {
+  objectprofiling = on;
+}
+
+bool FitProfile::readCountersSlow (uint64_t values[PerfCounterGroup::NEVENTS]) {
+  // counters count only for the thread that opened them
+  if (!perf || perfthread != std::this_thread::get_id()) {
+    delete perf;
+    perf = new PerfCounterGroup;
+    perfthread = std::this_thread::get_id();
+    if (!perf->isValid()) {
+      std::cerr << "FitProfile: hardware performance counters are not available, switching them off" << std::endl;
+      hardwarecounters = false;
+      return false;
+    }
+  }
+  return perf->read (values);
+}
+
+double FitProfile::getTicksPerSecond() {
+  static const double tickspersecond = measureTicksPerSecond();
+  return tickspersecond;
+}
+
+void FitProfile::addTime (int phase, uint64_t t) {
+  assert (phase >= 0 && phase < NPHASES);
+  ++ncalls[phase];
+  ticks[phase] += t;
+  int ibin = 0;
+  while (ibin < NBINS-1 && (t >> (ibin+1)) != 0) ++ibin;
+  ++hist[phase][ibin];
+}
+
+void FitProfile::addEvents (int phase, const uint64_t *start, const uint64_t *end) {
+  assert (phase >= 0 && phase < NPHASES);
+  assert (start && end);
+  ++ncounted[phase];
+  for (int ievent = 0; ievent < PerfCounterGroup::NEVENTS; ++ievent) events[phase][ievent] += end[ievent] - start[ievent];
+}
+
+void FitProfile::addObject (int phase, const std::type_info& type, uint64_t t, 
+                            const uint64_t *start, const uint64_t *end) {
+  assert (phase >= 0 && phase < NPHASES);
+  ObjectStats& stats = objectstats.insert (std::make_pair (ObjectKey (phase, std::type_index (type)), ObjectStats())).first->second;
+  ++stats.ncalls;
+  stats.ticks += t;
+  if (start && end) {
+    ++stats.ncounted;
+    for (int ievent = 0; ievent < PerfCounterGroup::NEVENTS; ++ievent) stats.events[ievent] += end[ievent] - start[ievent];
+  }
+}
+
+void FitProfile::clear() {
+  for (int iphase = 0; iphase < NPHASES; ++iphase) {
+    ncalls[iphase] = 0;
+    ticks[iphase] = 0;
+    for (int ibin = 0; ibin < NBINS; ++ibin) hist[iphase][ibin] = 0;
+    ncounted[iphase] = 0;
+    for (int ievent = 0; ievent < PerfCounterGroup::NEVENTS; ++ievent) events[iphase][ievent] = 0;
+  }
+  for (int icounter = 0; icounter < NCOUNTERS; ++icounter) counters[icounter] = 0;
+  objectstats.clear();
+}
+
+void FitProfile::add (const FitProfile& rhs) {
+  for (int iphase = 0; iphase < NPHASES; ++iphase) {
+    ncalls[iphase] += rhs.ncalls[iphase];
+    ticks[iphase] += rhs.ticks[iphase];
+    for (int ibin = 0; ibin < NBINS; ++ibin) hist[iphase][ibin] += rhs.hist[iphase][ibin];
+    ncounted[iphase] += rhs.ncounted[iphase];
+    for (int ievent = 0; ievent < PerfCounterGroup::NEVENTS; ++ievent) events[iphase][ievent] += rhs.events[iphase][ievent];
+  }
+  for (int icounter = 0; icounter < NCOUNTERS; ++icounter) counters[icounter] += rhs.counters[icounter];
+  for (std::map<ObjectKey, ObjectStats>::const_iterator it = rhs.objectstats.begin(); it != rhs.objectstats.end(); ++it) {
+    ObjectStats& stats = objectstats.insert (std::make_pair (it->first, ObjectStats())).first->second;
+    stats.ncalls   += it->second.ncalls;
+    stats.ticks    += it->second.ticks;
+    stats.ncounted += it->second.ncounted;
+    for (int ievent = 0; ievent < PerfCounterGroup::NEVENTS; ++ievent) stats.events[ievent] += it->second.events[ievent];
+  }
+}
+
+const char *FitProfile::getPhaseName (int phase) {
+  static const char *names[NPHASES] = {
+    "initialize", "assembleM", "assembley", "solveSystem", "lineSearch",
+    "2ndOrderCorr", "determineLambdas", "covMatrix"
+  };
+  if (phase < 0 || phase >= NPHASES) return "undefined";
+  return names[phase];
+}
+
+const char *FitProfile::getCounterName (int counter) {
+  static const char *names[NCOUNTERS] = {
+    "fits", "failed fits", "budget exhausted", "iterations", "LU solutions",
+    "arrowhead solutions", "null space solutions", "SVD fallbacks", "failed solutions",
+    "Cholesky failures", "cov. decomp. reused", "eigenvectors refined",
+    "2nd order corr. tried", "2nd order corr. accepted",
+    "pTLp retries", "step cuts"
+  };
+  if (counter < 0 || counter >= NCOUNTERS) return "undefined";
+  return names[counter];
+}
+
+std::string FitProfile::getClassName (const std::type_index& type) {
+  std::string result (type.name());
+#ifdef __GNUC__
+  int status = 0;
+  char *demangled = abi::__cxa_demangle (type.name(), 0, 0, &status);
+  if (status == 0 && demangled) result = demangled;
+  std::free (demangled);
+#endif
+  return result;
+}
+
+void FitProfile::print (std::ostream& os) const {
+  double tickspersecond = getTicksPerSecond();
+  uint64_t total = 0;
+  for (int iphase = 0; iphase < NPHASES; ++iphase) total += ticks[iphase];
+  long nfits = counters[FITS];
+  
+  std::ios::fmtflags oldflags = os.flags();
+  std::streamsize oldprec = os.precision (4);
+  os << "FitProfile: " << nfits << " fits, " << tickspersecond*1E-9 << " Gticks/s\n"
+     << std::setw (18) << std::left << "phase" << std::right 
+     << std::setw (12) << "calls"
+     << std::setw (14) << "ticks/call"
+     << std::setw (14) << "us/fit"
+     << std::setw (10) << "fraction" << '\n';
+  for (int iphase = 0; iphase < NPHASES; ++iphase) {
+    os << std::setw (18) << std::left << getPhaseName (iphase) << std::right
+       << std::setw (12) << ncalls[iphase]
+       << std::setw (14) << (ncalls[iphase] > 0 ? double (ticks[iphase])/ncalls[iphase] : 0.)
+       << std::setw (14) << (nfits > 0 ? 1E6*ticks[iphase]/tickspersecond/nfits : 0.)
+       << std::setw (10) << (total > 0 ? double (ticks[iphase])/total : 0.) << '\n';
+  }
+  for (int icounter = 0; icounter < NCOUNTERS; ++icounter) {
+    os << std::setw (26) << std::left << getCounterName (icounter) << std::right
+       << std::setw (12) << counters[icounter] << '\n';
+  }
+  
+  bool hasevents = false;
+  for (int iphase = 0; iphase < NPHASES; ++iphase) hasevents |= (ncounted[iphase] > 0);
+  if (hasevents) {
+    os << std::setw (18) << std::left << "phase" << std::right 
+       << std::setw (14) << "cycles/call"
+       << std::setw (14) << "instr/call"
+       << std::setw (8)  << "IPC"
+       << std::setw (16) << "cachemiss/call"
+       << std::setw (14) << "brmiss/call" << '\n';
+    for (int iphase = 0; iphase < NPHASES; ++iphase) {
+      if (ncounted[iphase] == 0) continue;
+      const uint64_t *e = events[iphase];
+      os << std::setw (18) << std::left << getPhaseName (iphase) << std::right
+         << std::setw (14) << ratio (e[PerfCounterGroup::CYCLES], ncounted[iphase])
+         << std::setw (14) << ratio (e[PerfCounterGroup::INSTRUCTIONS], ncounted[iphase])
+         << std::setw (8)  << ratio (e[PerfCounterGroup::INSTRUCTIONS], e[PerfCounterGroup::CYCLES])
+         << std::setw (16) << ratio (e[PerfCounterGroup::CACHEMISSES], ncounted[iphase])
+         << std::setw (14) << ratio (e[PerfCounterGroup::BRANCHMISSES], ncounted[iphase]) << '\n';
+    }
+  }
+  
+  if (!objectstats.empty()) {
+    os << std::setw (18) << std::left << "phase" 
+       << std::setw (26) << "class" << std::right 
+       << std::setw (12) << "calls"
+       << std::setw (14) << "ticks/call"
+       << std::setw (8)  << "IPC"
+       << std::setw (16) << "cachemiss/call"
+       << std::setw (14) << "brmiss/call" << '\n';
+    for (std::map<ObjectKey, ObjectStats>::const_iterator it = objectstats.begin(); it != objectstats.end(); ++it) {
+      const ObjectStats& s = it->second;
+      os << std::setw (18) << std::left << getPhaseName (it->first.first)
+         << std::setw (26) << getClassName (it->first.second) << std::right
+         << std::setw (12) << s.ncalls
+         << std::setw (14) << ratio (s.ticks, s.ncalls)
+         << std::setw (8)  << ratio (s.events[PerfCounterGroup::INSTRUCTIONS], s.events[PerfCounterGroup::CYCLES])
+         << std::setw (16) << ratio (s.events[PerfCounterGroup::CACHEMISSES], s.ncounted)
+         << std::setw (14) << ratio (s.events[PerfCounterGroup::BRANCHMISSES], s.ncounted) << '\n';
+    }
+  }
+  os.precision (oldprec);
+  os.flags (oldflags);
+}
+
+void FitProfile::printHistograms (std::ostream& os) const {
+  for (int iphase = 0; iphase < NPHASES; ++iphase) {
+    if (ncalls[iphase] == 0) continue;
+    os << "FitProfile: log2(ticks) of phase " << getPhaseName (iphase) << '\n';
+    for (int ibin = 0; ibin < NBINS; ++ibin) {
+      if (hist[iphase][ibin] == 0) continue;
+      os << std::setw (4) << ibin << std::setw (12) << hist[iphase][ibin] << '\n';
+    }
+  }
+}
+
+FitProfileMap::FitProfileMap()
+: profiles (), hardwarecounters (false), objectprofiling (false)
+{}
+
+FitProfileMap::~FitProfileMap() {
+  clear();
+}
+
+void FitProfileMap::setHardwareCounters (bool on) {
+  hardwarecounters = on;
+  for (std::map<std::string, FitProfile *>::iterator it = profiles.begin(); it != profiles.end(); ++it) 
+    it->second->setHardwareCounters (on);
+}
+
+void FitProfileMap::setObjectProfiling (bool on) {
+  objectprofiling = on;
+  for (std::map<std::string, FitProfile *>::iterator it = profiles.begin(); it != profiles.end(); ++it) 
+    it->second->setObjectProfiling (on);
+}
+
+std::string FitProfileMap::getTopology (BaseFitter& fitter) {
+  std::ostringstream key;
+  addClasses (key, *fitter.getFitObjects());
+  key << " | ";
+  addClasses (key, *fitter.getConstraints());
+  key << " | ";
+  addClasses (key, *fitter.getSoftConstraints());
+  return key.str();
+}
+
+FitProfile *FitProfileMap::getOrCreate (const std::string& topology) {
+  FitProfile *& profile = profiles[topology];
+  if (!profile) {
+    profile = new FitProfile;
+    profile->setHardwareCounters (hardwarecounters);
+    profile->setObjectProfiling (objectprofiling);
+  }
+  return profile;
+}
+
+FitProfile *FitProfileMap::select (BaseFitter& fitter) {
+  FitProfile *profile = getOrCreate (getTopology (fitter));
+  fitter.setProfile (profile);
+  return profile;
+}
+
+const FitProfile *FitProfileMap::getProfile (const std::string& topology) const {
+  std::map<std::string, FitProfile *>::const_iterator it = profiles.find (topology);
+  return it != profiles.end() ? it->second : 0;
+}
+
+void FitProfileMap::add (const FitProfileMap& rhs) {
+  for (std::map<std::string, FitProfile *>::const_iterator it = rhs.profiles.begin(); it != rhs.profiles.end(); ++it) 
+    getOrCreate (it->first)->add (*it->second);
+}
+
+void FitProfileMap::clear() {
+  for (std::map<std::string, FitProfile *>::iterator it = profiles.begin(); it != profiles.end(); ++it) 
+    delete it->second;
+  profiles.clear();
+}
+
+void FitProfileMap::print (std::ostream& os) const {
+  for (std::map<std::string, FitProfile *>::const_iterator it = profiles.begin(); it != profiles.end(); ++it) {
+    os << "Topology: " << it->first << '\n';
+    it->second->print (os);
+  }
+}
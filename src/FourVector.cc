@@ -22,19 +22,33 @@
 static TRandom *rnd = 0;
 
 FourVector& FourVector::boost (const FourVector& P) {
+  return boost (P, P.getM());
+}
+
+FourVector& FourVector::boost (const FourVector& P, double M) {
   // See CERNLIB U101 for a description
   
   double pP = -(p*P.p);
   double e = getE();
-  double M = P.getM();
   
   E = (e*P.getE() - pP)/M;
-  p = p - ((pP/(P.getE()+M)-e)/M)*P.p;
+  p -= ((pP/(P.getE()+M)-e)/M)*P.p;
   
   return *this;
 }
 
 void FourVector::decayto (FourVector& d1, FourVector& d2) const {
+  double randoms[2];
+//  FInteger ilen = 2;
+//  ranmar_ (randoms, &ilen);
+//  ranmar (randoms, 2);
+  if (rnd == 0) rnd = new TRandom3();
+  rnd->RndmArray (2, randoms);
+  
+  decayto (d1, d2, randoms[0], randoms[1]);
+}
+
+void FourVector::decayto (FourVector& d1, FourVector& d2, double r1, double r2) const {
   // Let this particle decay isotropically into 4-vectors d1 and d2;
   // d1 and d2 must have definite mass at beginning
   using std::abs;
@@ -46,37 +60,29 @@ void FourVector::decayto (FourVector& d1, FourVector& d2) const {
   double m1 = d1.getM();
   double m2 = d2.getM();
   
-  double randoms[2];
-//  FInteger ilen = 2;
-//  ranmar_ (randoms, &ilen);
-//  ranmar (randoms, 2);
-  if (rnd == 0) rnd = new TRandom3();
-  rnd->RndmArray (2, randoms);
-  
-  
   assert (m1+m2<=M);
   
   double pstar = 0.5*sqrt (abs((M2-pow(m1+m2,2))*(M2-pow(m1-m2,2))))/M;
-  double phistar = 2*M_PI*randoms[0];
-  double costhetastar = 2*randoms[1]-1;
+  double phistar = 2*M_PI*r1;
+  double costhetastar = 2*r2-1;
   double sinthetastar = sqrt(abs (1-costhetastar*costhetastar));
   double E1 = sqrt(m1*m1+pstar*pstar);
   double E2 = sqrt(m2*m2+pstar*pstar);
+  double px = pstar*sinthetastar*cos(phistar);
+  double py = pstar*sinthetastar*sin(phistar);
+  double pz = pstar*costhetastar;
   
 //  cout << "pstar=" << pstar << ", E1=" << E1 << ", E2=" << E2 << endl;
   
   
           
-  d1 = FourVector (E1, pstar*sinthetastar*cos(phistar), 
-                       pstar*sinthetastar*sin(phistar),  
-                       pstar*costhetastar);
-  d2 = FourVector (E2, -pstar*sinthetastar*cos(phistar),  
-                       -pstar*sinthetastar*sin(phistar),  
-                       -pstar*costhetastar);
+  d1.setValues (E1,  px,  py,  pz);
+  d2.setValues (E2, -px, -py, -pz);
                        
 //   cout << "d1 = " << d1 << "\nd2 = " << d2 << "\nsum= " << d1+d2 << ", mass: " << (d1+d2).getM() << endl;
-  d1.boost (*this);
-  d2.boost (*this);
+  // the mass of this particle is known, so the boosts need no square root
+  d1.boost (*this, M);
+  d2.boost (*this, M);
   
 //   std::cout << "Decay of " << mother 
 //             << "\nto  " << d1 
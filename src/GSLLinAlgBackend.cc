@@ -0,0 +1,134 @@
+/*! \file
+ *  \brief Implements class GSLLinAlgBackend
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Added dtrsv
+ *
+ */
+
+#include "GSLLinAlgBackend.h"
+
+#include <cmath>
+
+#include <gsl/gsl_linalg.h>
+
+GSLLinAlgBackend::GSLLinAlgBackend()
+{}
+
+GSLLinAlgBackend::~GSLLinAlgBackend()
+{}
+
+const char *GSLLinAlgBackend::getName() const {
+  return "GSL";
+}
+
+double GSLLinAlgBackend::ddot (const gsl_vector *x, const gsl_vector *y) const {
+  double result = 0;
+  gsl_blas_ddot (x, y, &result);
+  return result;
+}
+
+double GSLLinAlgBackend::dnrm2 (const gsl_vector *x) const {
+  return gsl_blas_dnrm2 (x);
+}
+
+double GSLLinAlgBackend::dasum (const gsl_vector *x) const {
+  return gsl_blas_dasum (x);
+}
+
+size_t GSLLinAlgBackend::idamax (const gsl_vector *x) const {
+  return gsl_blas_idamax (x);
+}
+
+void GSLLinAlgBackend::dcopy (const gsl_vector *x, gsl_vector *y) const {
+  gsl_blas_dcopy (x, y);
+}
+
+void GSLLinAlgBackend::daxpy (double alpha, const gsl_vector *x, gsl_vector *y) const {
+  gsl_blas_daxpy (alpha, x, y);
+}
+
+void GSLLinAlgBackend::dscal (double alpha, gsl_vector *x) const {
+  gsl_blas_dscal (alpha, x);
+}
+
+void GSLLinAlgBackend::dgemv (CBLAS_TRANSPOSE_t TransA, double alpha, const gsl_matrix *A,
+                              const gsl_vector *x, double beta, gsl_vector *y) const {
+  gsl_blas_dgemv (TransA, alpha, A, x, beta, y);
+}
+
+void GSLLinAlgBackend::dsymv (CBLAS_UPLO_t Uplo, double alpha, const gsl_matrix *A,
+                              const gsl_vector *x, double beta, gsl_vector *y) const {
+  gsl_blas_dsymv (Uplo, alpha, A, x, beta, y);
+}
+
+void GSLLinAlgBackend::dgemm (CBLAS_TRANSPOSE_t TransA, CBLAS_TRANSPOSE_t TransB, double alpha,
+                              const gsl_matrix *A, const gsl_matrix *B, double beta, gsl_matrix *C) const {
+  gsl_blas_dgemm (TransA, TransB, alpha, A, B, beta, C);
+}
+
+void GSLLinAlgBackend::dsymm (CBLAS_SIDE_t Side, CBLAS_UPLO_t Uplo, double alpha,
+                              const gsl_matrix *A, const gsl_matrix *B, double beta, gsl_matrix *C) const {
+  gsl_blas_dsymm (Side, Uplo, alpha, A, B, beta, C);
+}
+
+void GSLLinAlgBackend::dtrsv (CBLAS_UPLO_t Uplo, CBLAS_TRANSPOSE_t TransA, CBLAS_DIAG_t Diag,
+                              const gsl_matrix *A, gsl_vector *x) const {
+  gsl_blas_dtrsv (Uplo, TransA, Diag, A, x);
+}
+
+int GSLLinAlgBackend::LUDecomp (gsl_matrix *A, gsl_permutation *p, int *signum) const {
+  return gsl_linalg_LU_decomp (A, p, signum);
+}
+
+double GSLLinAlgBackend::LUDet (gsl_matrix *LU, int signum) const {
+  return gsl_linalg_LU_det (LU, signum);
+}
+
+int GSLLinAlgBackend::LUSolve (const gsl_matrix *LU, const gsl_permutation *p, const gsl_vector *b, gsl_vector *x) const {
+  return gsl_linalg_LU_solve (LU, p, b, x);
+}
+
+int GSLLinAlgBackend::LUSvx (const gsl_matrix *LU, const gsl_permutation *p, gsl_vector *x) const {
+  return gsl_linalg_LU_svx (LU, p, x);
+}
+
+int GSLLinAlgBackend::LUInvert (const gsl_matrix *LU, const gsl_permutation *p, gsl_matrix *inverse) const {
+  return gsl_linalg_LU_invert (LU, p, inverse);
+}
+
+int GSLLinAlgBackend::choleskyDecomp (gsl_matrix *A) const {
+  return gsl_linalg_cholesky_decomp (A);
+}
+
+int GSLLinAlgBackend::choleskySolve (const gsl_matrix *LLT, const gsl_vector *b, gsl_vector *x) const {
+  return gsl_linalg_cholesky_solve (LLT, b, x);
+}
+
+int GSLLinAlgBackend::choleskySvx (const gsl_matrix *LLT, gsl_vector *x) const {
+  return gsl_linalg_cholesky_svx (LLT, x);
+}
+
+int GSLLinAlgBackend::choleskyInvert (gsl_matrix *LLT) const {
+  return gsl_linalg_cholesky_invert (LLT);
+}
+
+void GSLLinAlgBackend::scaleSym (gsl_matrix *Mscal, const gsl_matrix *M, const gsl_vector *e) const {
+  for (size_t i = 0; i < M->size1; ++i) 
+    for (size_t j = 0; j < M->size2; ++j) 
+      gsl_matrix_set (Mscal, i, j, gsl_vector_get (e, i)*gsl_vector_get (e, j)*gsl_matrix_get (M, i, j));
+}
+
+bool GSLLinAlgBackend::isfinite (const gsl_vector *v) const {
+  for (size_t i = 0; i < v->size; ++i)
+    if (!std::isfinite (gsl_vector_get (v, i))) return false;
+  return true;
+}
+
+bool GSLLinAlgBackend::isfinite (const gsl_matrix *m) const {
+  for (size_t i = 0; i < m->size1; ++i)
+    for (size_t j = 0; j < m->size2; ++j)
+      if (!std::isfinite (gsl_matrix_get (m, i, j))) return false;
+  return true;
+}
@@ -273,20 +273,24 @@ double ISRPhotonFitObject::getSecondDerivative_Meta_Local( int iMeta, int ilocal
 
 
          
-double ISRPhotonFitObject::PgFromPz(double ppz){
+bool ISRPhotonFitObject::setPz (double pz_, bool warn) {
+  return setParam (2, PgFromPz (pz_, warn));
+}
+
+double ISRPhotonFitObject::PgFromPz(double ppz, bool warn){
 
   int sign = (ppz>0.) - (ppz<0.);
   double u = ( pow(fabs(ppz),b) - PzMinB ) / (PzMaxB-PzMinB);
 
-   if(u<0.){
+   if(u<0. && warn){
    #ifdef NO_MARLIN
      cout << 
    #else
      m_out(WARNING) << 
    #endif
      "ISRPhotonFitObject: Initial pz with abs(pz) < pzMin adjusted to zero." << std::endl;
-     u = 0.;
    }
+   if(u<0.) u = 0.;
  
    if(u>=1.){
 //    #ifdef NO_MARLIN
@@ -11,30 +11,174 @@
  * -
  *
  */ 
-#ifdef MARLIN_USE_ROOT
-
 #include "IterationScanner.h"
 
 #include "BaseFitter.h"
-#include "NewFitterGSL.h"
 #include "BaseFitObject.h"
-#include "BaseHardConstraint.h"
+#include "TraceValues.h"
 
+#ifdef MARLIN_USE_ROOT
 #include <TString.h>
 #include <TH2F.h>
-
-#include <gsl/gsl_vector.h>
+#endif
 
 #undef NDEBUG
 #include <cassert>
+#include <cmath>
 #include <iostream>
 
 using namespace std;
 
 IterationScanner::IterationScanner (BaseFitter& fitter_)
-: fitter (fitter_)
+: BaseScanner (fitter_), nittolerance (0), soltolerance (1E-3),
+  adaptive (false), adaptiveresult (), pending ()
 {}
 
+IterationScanner::IterationScanner (const std::vector<BaseFitter *>& fitters_)
+: BaseScanner (fitters_), nittolerance (0), soltolerance (1E-3),
+  adaptive (false), adaptiveresult (), pending ()
+{}
+
+void IterationScanner::setRefinement (int nittolerance_, double soltolerance_) {
+  nittolerance = nittolerance_;
+  soltolerance = soltolerance_;
+}
+
+const AdaptiveScanResult& IterationScanner::getAdaptiveResult() const {
+  return adaptiveresult;
+}
+
+bool IterationScanner::adaptiveScan (int xglobal, 
+                                     double xstart,
+                                     double xstop,
+                                     int yglobal, 
+                                     double ystart,
+                                     double ystop,
+                                     int nstart,
+                                     int maxlevel) {
+  if (nstart <= 0 || maxlevel < 0) return false;
+  if (!prepareScan (xglobal, 1, xstart, xstop, yglobal, 1, ystart, ystop)) return false;
+  
+  AdaptiveScanResult& r = adaptiveresult;
+  r.setRange (xglobal, xstart, xstop, yglobal, ystart, ystop, nstart, maxlevel);
+  r.xname = result.xname;
+  r.yname = result.yname;
+  adaptive = true;
+  
+  // Level 0: the full coarse grid
+  pending.resize (0);
+  for (int ix = 0; ix < nstart; ++ix) 
+    for (int iy = 0; iy < nstart; ++iy) 
+      pending.push_back (r.addCell (0, ix, iy));
+  pool.run (*this, pending.size());
+  
+  static const int dix[4] = {-1, 1, 0, 0};
+  static const int diy[4] = {0, 0, -1, 1};
+  std::vector<char> refine;
+  for (int level = 0; level < maxlevel; ++level) {
+    // Compare the cells of this level with their neighbours (or the cells covering them)
+    std::vector<int> current (pending);
+    refine.assign (r.cells.size(), 0);
+    int npoints = r.getNPoints (level);
+    for (unsigned int i = 0; i < current.size(); ++i) {
+      int icell = current[i];
+      const AdaptiveScanResult::Cell& cell = r.cells[icell];
+      for (int k = 0; k < 4; ++k) {
+        int jx = cell.ix + dix[k];
+        int jy = cell.iy + diy[k];
+        if (jx < 0 || jx >= npoints || jy < 0 || jy >= npoints) continue;
+        int jcell = r.findCell (level, jx, jy);
+        if (jcell < 0 || !differ (cell.point, r.cells[jcell].point)) continue;
+        refine[icell] = 1;
+        if (r.cells[jcell].level == level) refine[jcell] = 1;
+      }
+    }
+    
+    // Divide the marked cells
+    pending.resize (0);
+    for (unsigned int i = 0; i < current.size(); ++i) {
+      int icell = current[i];
+      if (!refine[icell]) continue;
+      r.cells[icell].leaf = false;
+      int ix = r.cells[icell].ix;
+      int iy = r.cells[icell].iy;
+      for (int jx = 2*ix; jx <= 2*ix+1; ++jx)
+        for (int jy = 2*iy; jy <= 2*iy+1; ++jy)
+          pending.push_back (r.addCell (level+1, jx, jy));
+    }
+    if (pending.empty()) break;
+    pool.run (*this, pending.size());
+  }
+  
+  adaptive = false;
+  pending.resize (0);
+  restoreFitObjects();
+  return true;
+}
+
+bool IterationScanner::differ (const ScanPoint& p1, const ScanPoint& p2) const {
+  if (p1.error != p2.error) return true;
+  if (std::abs (p1.nit - p2.nit) > nittolerance) return true;
+  if (std::abs (p1.xend - p2.xend) > soltolerance*std::abs (adaptiveresult.xstop-adaptiveresult.xstart)) return true;
+  if (std::abs (p1.yend - p2.yend) > soltolerance*std::abs (adaptiveresult.ystop-adaptiveresult.ystart)) return true;
+  return false;
+}
+
+void IterationScanner::execute (int itask, int ithread) {
+  if (!adaptive) {
+    BaseScanner::execute (itask, ithread);
+    return;
+  }
+  assert (itask >= 0 && itask < (int)pending.size());
+  fitPoint (adaptiveresult.cells[pending[itask]].point, ithread);
+}
+
+void IterationScanner::scanPoint (int ix, int iy, int ithread) {
+  ScanPoint point;
+  point.x = result.getX (ix);
+  point.y = result.getY (iy);
+  fitPoint (point, ithread);
+  
+  int i = result.index (ix, iy);
+  result.chi2[i]  = point.chi2;
+  result.nit[i]   = point.nit;
+  result.error[i] = point.error;
+  result.xend[i]  = point.xend;
+  result.yend[i]  = point.yend;
+  result.alpha[i] = point.alpha;
+  result.mu[i]    = point.mu;
+  result.phi[i]   = point.phi;
+}
+
+void IterationScanner::fitPoint (ScanPoint& point, int ithread) {
+  BaseFitter& fitter = *fitters[ithread];
+  FitObjectContainer* fitobjects = fitter.getFitObjects();
+  FitObjectContainer& backup = fitobjects_backup[ithread];
+  
+  // Restore parameters and covariance matrices of the start point
+  for (unsigned int i = 0; i < fitobjects->size();  ++i) {
+    BaseFitObject *fo = (*fitobjects)[i];
+    assert (fo);
+    assert (backup[i]);
+    fo->assign (*backup[i]);
+  }
+  setParameters (point.x, point.y, ithread);
+      
+  fitter.fit();
+  
+  point.chi2  = fitter.getChi2();
+  point.nit   = fitter.getIterations();
+  point.error = fitter.getError();
+  point.xend  = getParameter (result.xglobal, ithread);
+  point.yend  = getParameter (result.yglobal, ithread);
+#ifndef FIT_TRACEOFF
+  point.alpha = fitter.traceValues.get (TraceValues::ALPHA);
+  point.mu    = fitter.traceValues.get (TraceValues::MU);
+  point.phi   = fitter.traceValues.get (TraceValues::PHI);
+#endif
+}
+
+#ifdef MARLIN_USE_ROOT
 void IterationScanner::doScan (int xglobal, 
             int nx,
             double xstart,
@@ -46,76 +190,68 @@ void IterationScanner::doScan (int xglobal,
             const char *idprefix,
             const char *titleprefix) {
   
-  NewFitterGSL *newfitter = dynamic_cast<NewFitterGSL *>(&fitter);
-            
-  FitObjectContainer* fitobjects = fitter.getFitObjects();
-  if (fitobjects == 0) return;
-  ConstraintContainer* constraints = fitter.getConstraints();
-  if (constraints == 0) return;
+  if (!scan (xglobal, nx, xstart, xstop, yglobal, ny, ystart, ystop)) return;
+
+  // Book Histograms
   
-  FitObjectContainer fitobjects_backup(fitobjects->size());
-  for (unsigned int i = 0; i < fitobjects->size();  ++i) {
-    BaseFitObject *fo = (*fitobjects)[i];
-    assert (fo);
-    fitobjects_backup[i] = fo->copy();
-  }
-  // Get largest global parameter number,
-  // find parameter names
-  TString xname ("");
-  TString yname ("");
-  
-  int idim = 1;
-  for (FitObjectIterator i = fitobjects->begin(); i != fitobjects->end(); ++i) {
-    BaseFitObject *fo = *i;
-    assert (fo);
-    for (int ilocal = 0; ilocal < fo->getNPar(); ++ilocal) {
-      int iglobal = fo->getGlobalParNum (ilocal);
-      if (iglobal >= idim) idim = iglobal+1;
-      if (iglobal == xglobal) xname = fo->getParamName (ilocal);
-      if (iglobal == yglobal) yname = fo->getParamName (ilocal);
-    }
-  }
-  for (ConstraintIterator i = constraints->begin(); i != constraints->end(); ++i) {
-    BaseHardConstraint *c = *i;
-    assert (c);
-    int iglobal = c->getGlobalNum();
-      if (iglobal >= idim) idim = iglobal+1;
-  }
+  TString idpostfix("");
+  idpostfix += xglobal;
+  idpostfix += "_";
+  idpostfix += yglobal;
   
-  if (xglobal >= idim) return;
-  if (yglobal >= idim) return;
+  TString titlepostfix(" vs ");
+  titlepostfix += result.xname.c_str();
+  titlepostfix += " and ";
+  titlepostfix += result.yname.c_str();
+  titlepostfix += ";";
+  titlepostfix += result.xname.c_str();
+  titlepostfix += ";";
+  titlepostfix += result.yname.c_str();
   
-  double *parsave  = new double [idim];
-  double *par  = new double [idim];
+  TString id (idprefix);
+  id += "nit_";
+  id += idpostfix;
   
-  // Get starting values
-  for (FitObjectIterator i = fitobjects->begin(); i != fitobjects->end(); ++i) {
-    BaseFitObject *fo = *i;
-    assert (fo);
-    for (int ilocal = 0; ilocal < fo->getNPar(); ++ilocal) {
-      int iglobal = fo->getGlobalParNum (ilocal);
-      assert (iglobal >= 0 && iglobal < idim);
-      parsave[iglobal] = fo->getParam (ilocal);
-    }
-  }
+  TString title (titleprefix);
+  title += "Iterations ";
+  title += titlepostfix;
+  
+  TH2F *hnit = result.createHist (ScanResult::NIT, id, title);
+  cout << "Booking Histo '" << id << "': '" << title << "'" << endl;
+  
+  // Write histos;
+  hnit->Write();
+}
 
-  // Book Histograms
+void IterationScanner::doAdaptiveScan (int xglobal, 
+            double xstart,
+            double xstop,
+            int yglobal, 
+            double ystart,
+            double ystop,
+            int nstart,
+            int maxlevel,
+            const char *idprefix,
+            const char *titleprefix) {
   
+  if (!adaptiveScan (xglobal, xstart, xstop, yglobal, ystart, ystop, nstart, maxlevel)) return;
+  const AdaptiveScanResult& r = adaptiveresult;
+  cout << "IterationScanner::doAdaptiveScan: " << r.getNCells() << " fits, " 
+       << r.getNLeaves() << " leaves" << endl;
+
   TString idpostfix("");
   idpostfix += xglobal;
   idpostfix += "_";
   idpostfix += yglobal;
   
   TString titlepostfix(" vs ");
-  titlepostfix += xname;
+  titlepostfix += r.xname.c_str();
   titlepostfix += " and ";
-  titlepostfix += yname;
+  titlepostfix += r.yname.c_str();
   titlepostfix += ";";
-  titlepostfix += xname;
+  titlepostfix += r.xname.c_str();
   titlepostfix += ";";
-  titlepostfix += yname;
-  
-  // Chi2 Histogram
+  titlepostfix += r.yname.c_str();
   
   TString id (idprefix);
   id += "nit_";
@@ -125,64 +261,22 @@ void IterationScanner::doScan (int xglobal,
   title += "Iterations ";
   title += titlepostfix;
   
-  TH2F *hnit = new TH2F (id, title, nx, xstart, xstop, ny, ystart, ystop);
+  TH2F *hnit = r.createHist (ScanResult::NIT, id, title);
   cout << "Booking Histo '" << id << "': '" << title << "'" << endl;
-    
   
-  // Do the scan
+  id = idprefix;
+  id += "level_";
+  id += idpostfix;
   
-  for (int ix = 1; ix <= nx; ++ix) {
-    double x = (ix - 0.5)*(xstop-xstart)/nx + xstart;
-    for (int iy = 1; iy <= ny; ++iy) {
-      double y = (iy - 0.5)*(ystop-ystart)/ny + ystart;
-      
-      // Set parameters
-      for (int i = 0; i < idim; ++i) par[i] = parsave[i];
-      par[xglobal] = x;
-      par[yglobal] = y;
-      for (FitObjectIterator i = fitobjects->begin(); i != fitobjects->end(); ++i) {
-        BaseFitObject *fo = *i;
-        assert (fo);
-        fo->updateParams(par, idim);
-      }
-      
-      for (unsigned int i = 0; i < fitobjects->size();  ++i) {
-        BaseFitObject *fo = (*fitobjects)[i];
-        BaseFitObject *fobu = fitobjects_backup[i];
-        assert (fo);
-        assert (fobu);
-        for (int j = 0; j < fobu->getNPar(); ++j) {
-          for (int k = 0; k < fobu->getNPar(); ++k) {
-            fo->setCov (j, k, fobu->getCov(j, k));
-          }
-        }
-      }
-      
-      // Calculate nit
-      
-      double fprob = fitter.fit();
-      double nit = fitter.getIterations();
-      
-      cout << "IterationScanner::doScan: x=" << x;
-      if (newfitter) cout << " -> " << gsl_vector_get (newfitter->x, xglobal);
-      cout << ", y=" << y;
-      if (newfitter) cout << " -> " << gsl_vector_get (newfitter->x, yglobal);
-      cout << ", fitprob=" << fprob << ", nit=" << nit << endl;
-      
-      // Fill Histos
-      hnit->SetBinContent (ix, iy, nit);      
-    }
-  }
+  title = titleprefix;
+  title += "Refinement level ";
+  title += titlepostfix;
+  
+  TH2F *hlevel = r.createHist (AdaptiveScanResult::LEVEL, id, title);
+  cout << "Booking Histo '" << id << "': '" << title << "'" << endl;
   
   // Write histos;
   hnit->Write();
-
-  for (unsigned int i = 0; i < fitobjects_backup.size();  ++i) {
-    delete fitobjects_backup[i];
-  }
-
-  delete par;
-  delete parsave;
+  hlevel->Write();
 }
-
 #endif // MARLIN_USE_ROOT
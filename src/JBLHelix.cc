@@ -35,7 +35,7 @@ JBLHelix::~JBLHelix()
 {}
 
 
-double JBLHelix::getPar (int i) {
+double JBLHelix::getPar (int i) const {
   assert (i >= 0 && i < NPAR);
   return par[i];          
 }              
@@ -0,0 +1,254 @@
+/*! \file
+ *  \brief Implements class JBLHelixBatch
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Fixed closest points of nested circles
+ * - 18.10.2026 Vectorized loops over pairs
+ *
+ */
+
+#include "JBLHelixBatch.h"
+#include "JBLHelix.h"
+#include "ThreeVector.h"
+
+#undef NDEBUG
+#include <cassert>
+#include <cmath>
+
+// The kernel must be inlined into the loops over pairs for these to be vectorized
+#ifdef __GNUC__
+#define ALWAYS_INLINE inline __attribute__ ((always_inline))
+#else
+#define ALWAYS_INLINE inline
+#endif
+
+namespace {
+  // The precomputed values of one helix, as used by the kernel
+  struct HelixValues {
+    double kappa, r, phi0, xc, yc, z0, cottheta;
+  };
+
+  // Same as JBLHelix::getNormalS, without branches
+  ALWAYS_INLINE double normalS (double s, double kappa) {
+    double kappas = kappa*s;
+    // floor through a conversion to int, which is vectorized also without SSE4.1;
+    // |kappa*s| is at most a few pi here
+    double t = (kappas + M_PI)/(2*M_PI);
+    double n = int (t);
+    n -= (t < n);
+    double wrapped = kappas - 2*M_PI*n;
+    return (kappas >= -M_PI && kappas < M_PI) ? s : wrapped/kappa;
+  }
+
+  // Same as JBLHelix::getClosestS for a curved helix, without branches
+  ALWAYS_INLINE double closestS (const HelixValues& h, double px, double py) {
+    double sign = (h.r > 0) ? 1 : -1;
+    double psi = std::atan2 (px - h.xc, -sign*(py - h.yc)) - sign*h.phi0;
+    return normalS (std::abs (h.r)*psi, h.kappa);
+  }
+
+  // Same as JBLHelix::getClosestApproach, without branches; all cases are
+  // calculated, and the result is selected at the end
+  ALWAYS_INLINE int closestApproach (const HelixValues& h0, const HelixValues& h1,
+                              double& s0, double& s1, double& s02nd, double& s12nd) {
+    double dx = h0.xc - h1.xc;
+    double dy = h0.yc - h1.yc;
+    double dist2 = dx*dx + dy*dy;
+    double dist = std::sqrt (dist2);
+    double r0a = std::abs (h0.r);
+    double r1a = std::abs (h1.r);
+    double sc0 = closestS (h0, h1.xc, h1.yc);
+    double sc1 = closestS (h1, h0.xc, h0.yc);
+
+    double cospsi0 = (h0.r*h0.r + dist2 - h1.r*h1.r)/(2*r0a*dist);
+    double cospsi1 = (h1.r*h1.r + dist2 - h0.r*h0.r)/(2*r1a*dist);
+    cospsi0 = std::min (1., std::max (-1., cospsi0));
+    cospsi1 = std::min (1., std::max (-1., cospsi1));
+    double psi0 = std::acos (cospsi0);
+    double psi1 = std::acos (cospsi1);
+
+    double s0try1 = normalS (sc0 + h0.r*psi0, h0.kappa);
+    double s1try1 = normalS (sc1 - h1.r*psi1, h1.kappa);
+    double dz1 = std::abs (h0.z0 + s0try1*h0.cottheta - h1.z0 - s1try1*h1.cottheta);
+    double s0try2 = normalS (sc0 - h0.r*psi0, h0.kappa);
+    double s1try2 = normalS (sc1 + h1.r*psi1, h1.kappa);
+    double dz2 = std::abs (h0.z0 + s0try2*h0.cottheta - h1.z0 - s1try2*h1.cottheta);
+    bool first = dz1 < dz2;
+
+    // If one circle lies within the other, the point of the inner circle
+    // that is closest to the outer one is on the far side of the outer
+    // circle's center, i.e. half a turn away from sc0 (sc1)
+    bool inner0 = dist < r1a - r0a;
+    bool inner1 = dist < r0a - r1a;
+    double sfar0 = normalS (sc0 + M_PI*r0a, h0.kappa);
+    double sfar1 = normalS (sc1 + M_PI*r1a, h1.kappa);
+    double sn0 = inner0 ? sfar0 : sc0;
+    double sn1 = inner1 ? sfar1 : sc1;
+
+    bool line = (h0.r == 0 || h1.r == 0);
+    bool intersect = dist < r0a + r1a && dist > std::abs (r0a - r1a);
+    bool touch = (dist == r0a + r1a);
+
+    s0    = line ? 0 : intersect ? (first ? s0try1 : s0try2) : sn0;
+    s1    = line ? 0 : intersect ? (first ? s1try1 : s1try2) : sn1;
+    s02nd = line ? 0 : intersect ? (first ? s0try2 : s0try1) : sn0;
+    s12nd = line ? 0 : intersect ? (first ? s1try2 : s1try1) : sn1;
+    // selected as double: SSE2 cannot vectorize the conversion of a comparison to int
+    double code = line ? -1. : intersect ? 2. : touch ? 1. : 0.;
+    return int (code);
+  }
+}
+
+JBLHelixBatch::JBLHelixBatch ()
+: kappa (), phi0 (), dca (), z0 (), r (), sphi0 (), cphi0 (), xc (), yc (), cottheta ()
+{}
+
+JBLHelixBatch::~JBLHelixBatch()
+{}
+
+void JBLHelixBatch::clear() {
+  kappa.clear();
+  phi0.clear();
+  dca.clear();
+  z0.clear();
+  r.clear();
+  sphi0.clear();
+  cphi0.clear();
+  xc.clear();
+  yc.clear();
+  cottheta.clear();
+}
+
+void JBLHelixBatch::reserve (int n) {
+  kappa.reserve (n);
+  phi0.reserve (n);
+  dca.reserve (n);
+  z0.reserve (n);
+  r.reserve (n);
+  sphi0.reserve (n);
+  cphi0.reserve (n);
+  xc.reserve (n);
+  yc.reserve (n);
+  cottheta.reserve (n);
+}
+
+int JBLHelixBatch::addHelix (double kappa_, double phi0_, double theta_, double dca_, double z0_) {
+  // same threshold as in JBLHelix::getClosestApproach
+  double r_ = (std::abs (kappa_) > 1E-7) ? 1/kappa_ : 0;
+  double sphi0_ = std::sin (phi0_);
+  double cphi0_ = std::cos (phi0_);
+  kappa.push_back (kappa_);
+  phi0.push_back (phi0_);
+  dca.push_back (dca_);
+  z0.push_back (z0_);
+  r.push_back (r_);
+  sphi0.push_back (sphi0_);
+  cphi0.push_back (cphi0_);
+  xc.push_back ( (dca_ - r_)*sphi0_);
+  yc.push_back (-(dca_ - r_)*cphi0_);
+  cottheta.push_back (std::cos (theta_)/std::sin (theta_));
+  return kappa.size()-1;
+}
+
+int JBLHelixBatch::addHelix (const JBLHelix& helix) {
+  return addHelix (helix.getPar (0), helix.getPar (1), helix.getPar (2), helix.getPar (3), helix.getPar (4));
+}
+
+int JBLHelixBatch::getNHelices() const {
+  return kappa.size();
+}
+
+int JBLHelixBatch::getNPairs() const {
+  int n = getNHelices();
+  return n*(n-1)/2;
+}
+
+void JBLHelixBatch::getClosestApproaches (int npairs, const int *ihelix0, const int *ihelix1,
+                                          double *__restrict s0, double *__restrict s1,
+                                          double *__restrict s02nd, double *__restrict s12nd,
+                                          int *__restrict result) const {
+  assert (npairs == 0 || (ihelix0 && ihelix1 && s0 && s1 && s02nd && s12nd && result));
+  int n = getNHelices();
+  for (int ipair = 0; ipair < npairs; ++ipair) {
+    assert (ihelix0[ipair] >= 0 && ihelix0[ipair] < n);
+    assert (ihelix1[ipair] >= 0 && ihelix1[ipair] < n);
+  }
+
+  const double *__restrict k = &kappa[0];
+  const double *__restrict rr = &r[0];
+  const double *__restrict p = &phi0[0];
+  const double *__restrict x = &xc[0];
+  const double *__restrict y = &yc[0];
+  const double *__restrict z = &z0[0];
+  const double *__restrict c = &cottheta[0];
+#pragma omp simd
+  for (int ipair = 0; ipair < npairs; ++ipair) {
+    int i = ihelix0[ipair];
+    int j = ihelix1[ipair];
+    HelixValues h0 = {k[i], rr[i], p[i], x[i], y[i], z[i], c[i]};
+    HelixValues h1 = {k[j], rr[j], p[j], x[j], y[j], z[j], c[j]};
+    double t0, t1, t02nd, t12nd;
+    result[ipair] = closestApproach (h0, h1, t0, t1, t02nd, t12nd);
+    s0[ipair] = t0;
+    s1[ipair] = t1;
+    s02nd[ipair] = t02nd;
+    s12nd[ipair] = t12nd;
+  }
+}
+
+void JBLHelixBatch::getAllClosestApproaches (double *__restrict s0, double *__restrict s1,
+                                             double *__restrict s02nd, double *__restrict s12nd,
+                                             int *__restrict result) const {
+  int n = getNHelices();
+  if (n < 2) return;
+  assert (s0 && s1 && s02nd && s12nd && result);
+
+  const double *__restrict k = &kappa[0];
+  const double *__restrict rr = &r[0];
+  const double *__restrict p = &phi0[0];
+  const double *__restrict x = &xc[0];
+  const double *__restrict y = &yc[0];
+  const double *__restrict z = &z0[0];
+  const double *__restrict c = &cottheta[0];
+  int ipair = 0;
+  for (int i = 0; i < n-1; ++i) {
+    HelixValues h0 = {k[i], rr[i], p[i], x[i], y[i], z[i], c[i]};
+    // inner loop over contiguous helices j, with contiguous output;
+    // the results go through local variables, which keeps the loop free of control flow
+#pragma omp simd
+    for (int j = i+1; j < n; ++j) {
+      HelixValues h1 = {k[j], rr[j], p[j], x[j], y[j], z[j], c[j]};
+      int o = ipair + j-i-1;
+      double t0, t1, t02nd, t12nd;
+      result[o] = closestApproach (h0, h1, t0, t1, t02nd, t12nd);
+      s0[o] = t0;
+      s1[o] = t1;
+      s02nd[o] = t02nd;
+      s12nd[o] = t12nd;
+    }
+    ipair += n-i-1;
+  }
+  assert (ipair == getNPairs());
+}
+
+void JBLHelixBatch::getTrajectoryPointEx (int ihelix, double s, ThreeVector& p) const {
+  assert (ihelix >= 0 && ihelix < getNHelices());
+  // Same as JBLHelix::getTrajectoryPointEx, with precomputed sin and cos of phi0
+  double kappas = kappa[ihelix]*s;
+  double z = z0[ihelix] + s*cottheta[ihelix];
+  if (std::abs (kappas) < 1.e-6) {
+    double dcamikssq = dca[ihelix] - 0.5*kappas*s;
+    p.setValues ( sphi0[ihelix]*dcamikssq + cphi0[ihelix]*s,
+                 -cphi0[ihelix]*dcamikssq + sphi0[ihelix]*s,
+                  z);
+  }
+  else {
+    double phi0plkappas = phi0[ihelix] + kappas;
+    double rh = 1/kappa[ihelix];
+    double dcamir = dca[ihelix] - rh;
+    p.setValues ( dcamir*sphi0[ihelix] + rh*std::sin (phi0plkappas),
+                 -dcamir*cphi0[ihelix] - rh*std::cos (phi0plkappas),
+                  z);
+  }
+}
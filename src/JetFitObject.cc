@@ -144,6 +144,27 @@ JetFitObject& JetFitObject::assign (const BaseFitObject& source) {
     if (psource != this) {
       ParticleFitObject::assign (source);
       // only mutable data members, need not to be copied, if cache is invalid
+      if (psource->cachevalid) {
+        ctheta    = psource->ctheta;
+        stheta    = psource->stheta;
+        cphi      = psource->cphi;
+        sphi      = psource->sphi;
+        p2        = psource->p2;
+        p         = psource->p;
+        pt        = psource->pt;
+        px        = psource->px;
+        py        = psource->py;
+        pz        = psource->pz;
+        dpdE      = psource->dpdE;
+        dptdE     = psource->dptdE;
+        dpxdE     = psource->dpxdE;
+        dpydE     = psource->dpydE;
+        dpzdE     = psource->dpzdE;
+        dpxdtheta = psource->dpxdtheta;
+        dpydtheta = psource->dpydtheta;
+        fourMomentum = psource->fourMomentum;
+        cachevalid = true;
+      }
     }
   }
   else {
@@ -163,8 +184,6 @@ const char *JetFitObject::getParamName (int ilocal) const {
 
  
 bool JetFitObject::updateParams (double pp[], int idim) {
-  invalidateCache();
-  
   int iE  = getGlobalParNum(0);
   int ith = getGlobalParNum(1);
   int iph = getGlobalParNum(2);
@@ -189,6 +208,9 @@ bool JetFitObject::updateParams (double pp[], int idim) {
   bool result = ((e -par[0])*(e -par[0]) > eps2*cov[0][0]) ||
                 ((th-par[1])*(th-par[1]) > eps2*cov[1][1]) ||
                 ((ph-par[2])*(ph-par[2]) > eps2*cov[2][2]);
+  
+  // keep the cache (e.g. taken over by assign) if the parameters are unchanged
+  if (e != par[0] || th != par[1] || ph != par[2]) invalidateCache();
                 
   par[0] = e;
   par[1] = th;
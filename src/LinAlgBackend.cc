@@ -0,0 +1,39 @@
+/*! \file
+ *  \brief Implements class LinAlgBackend
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "LinAlgBackend.h"
+#include "GSLLinAlgBackend.h"
+#include "SmallLinAlgBackend.h"
+
+LinAlgBackend::~LinAlgBackend()
+{}
+
+const LinAlgBackend& LinAlgBackend::getGSL() {
+  static const GSLLinAlgBackend backend;
+  return backend;
+}
+
+const LinAlgBackend& LinAlgBackend::getSmall() {
+  static const SmallLinAlgBackend backend;
+  return backend;
+}
+
+const LinAlgBackend *LinAlgBackend::defaultbackend = 0;
+
+const LinAlgBackend& LinAlgBackend::getDefault() {
+  if (defaultbackend) return *defaultbackend;
+#ifdef FIT_LINALG_SMALL
+  return getSmall();
+#else
+  return getGSL();
+#endif
+}
+
+void LinAlgBackend::setDefault (const LinAlgBackend& backend) {
+  defaultbackend = &backend;
+}
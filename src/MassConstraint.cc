@@ -146,6 +146,35 @@ double MassConstraint::getMass (int flag) {
   return std::sqrt(std::abs(totE*totE-totpx*totpx-totpy*totpy-totpz*totpz));
 }
 
+int MassConstraint::getTargetMass (const BaseFitObject *fo, double& target, double partners[4]) const {
+  int flag = 0;
+  for (unsigned int i = 0; i < fitobjects.size() && !flag; i++) {
+    if (fitobjects[i] == fo) flag = flags[i];
+  }
+  for (int k = 0; k < 4; ++k) partners[k] = 0;
+  target = 0;
+  if (!flag) return 0;
+  
+  double tot[2][4] = {{0, 0, 0, 0}, {0, 0, 0, 0}};
+  for (unsigned int i = 0; i < fitobjects.size(); i++) {
+    if (fitobjects[i] == fo) continue;
+    const ParticleFitObject *pfo = dynamic_cast < ParticleFitObject* > ( fitobjects[i] );
+    assert(pfo);
+    int index = (flags[i] == 1) ? 0 : 1;
+    tot[index][0] += pfo->getE(); 
+    tot[index][1] += pfo->getPx(); 
+    tot[index][2] += pfo->getPy(); 
+    tot[index][3] += pfo->getPz(); 
+  }
+  int index = (flag == 1) ? 0 : 1;
+  for (int k = 0; k < 4; ++k) partners[k] = tot[index][k];
+  // mass of the other set of objects
+  const double *other = tot[1-index];
+  double mother = std::sqrt(std::abs(other[0]*other[0]-other[1]*other[1]-other[2]*other[2]-other[3]*other[3]));
+  target = (flag == 1) ? mother + mass : mother - mass;
+  return flag;
+}
+
 void MassConstraint::setMass (double mass_) {
   mass = mass_;
 }
@@ -115,3 +115,15 @@ bool MomentumConstraint::firstDerivatives (int i, double *dderivatives) const {
 int MomentumConstraint::getVarBasis() const {
   return VAR_BASIS;
 }
+
+int MomentumConstraint::getFactors (const BaseFitObject *fo, double fact[4]) const {
+  int n = 0;
+  for (unsigned int i = 0; i < fitobjects.size(); i++) {
+    if (fitobjects[i] == fo) ++n;
+  }
+  fact[0] = n*efact;
+  fact[1] = n*pxfact;
+  fact[2] = n*pyfact;
+  fact[3] = n*pzfact;
+  return n;
+}
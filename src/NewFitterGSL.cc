@@ -30,11 +30,18 @@
 #include<cmath>
 #include<cassert>
 #include<limits>
+#include<algorithm>
 
 #include "BaseFitObject.h"
 #include "BaseHardConstraint.h"
 #include "BaseSoftConstraint.h"
 #include "BaseTracer.h"
+#include "FitProfile.h"
+#include "ArrowheadSolver.h"
+#include "LinAlgBackend.h"
+#include "MomentumConstraint.h"
+#include "NeutrinoFitObject.h"
+#include "ZinvisibleFitObject.h"
 
 #include <gsl/gsl_block.h>
 #include <gsl/gsl_vector.h>
@@ -52,13 +59,34 @@ using std::abs;
 static int debuglevel = 0;
 static int nitdebug = 0;
 // static int nitcalc = 0;
+
+// Inverse of a 3x3 matrix; returns false if a is singular
+static bool invert3 (const double a[3][3], double ainv[3][3]) {
+  double amax = 0;
+  for (int i = 0; i < 3; ++i) 
+    for (int j = 0; j < 3; ++j) amax = std::max (amax, std::fabs (a[i][j]));
+  double det = a[0][0]*(a[1][1]*a[2][2]-a[1][2]*a[2][1]) 
+             - a[0][1]*(a[1][0]*a[2][2]-a[1][2]*a[2][0]) 
+             + a[0][2]*(a[1][0]*a[2][1]-a[1][1]*a[2][0]);
+  if (!(std::fabs (det) > 1E-12*amax*amax*amax)) return false;
+  ainv[0][0] = (a[1][1]*a[2][2]-a[1][2]*a[2][1])/det;
+  ainv[0][1] = (a[0][2]*a[2][1]-a[0][1]*a[2][2])/det;
+  ainv[0][2] = (a[0][1]*a[1][2]-a[0][2]*a[1][1])/det;
+  ainv[1][0] = (a[1][2]*a[2][0]-a[1][0]*a[2][2])/det;
+  ainv[1][1] = (a[0][0]*a[2][2]-a[0][2]*a[2][0])/det;
+  ainv[1][2] = (a[0][2]*a[1][0]-a[0][0]*a[1][2])/det;
+  ainv[2][0] = (a[1][0]*a[2][1]-a[1][1]*a[2][0])/det;
+  ainv[2][1] = (a[0][1]*a[2][0]-a[0][0]*a[2][1])/det;
+  ainv[2][2] = (a[0][0]*a[1][1]-a[0][1]*a[1][0])/det;
+  return true;
+}
 // static int nitsvd = 0;
 
 // constructor
 NewFitterGSL::NewFitterGSL() 
 : npar (0), ncon (0), nsoft (0), idim (0),
   x(0), xold(0), xnew (0),
-  // xbest(0), 
+  xbest(0), 
   dx(0), dxscal (0), 
   //grad(0), 
   y(0), yscal(0), 
@@ -72,6 +100,12 @@ NewFitterGSL::NewFitterGSL()
   eigenws(0), eigenwsdim (0),
   imerit (1),
   try2ndOrderCorr (true),
+  arrowhead (0), sharedfitobjects (), sharedrows (),
+  nullspace (false),
+  eliminate (false), eliminations (), keptrows (), elimrows (), elimcons (),
+  Sred (0), yred (0), yredscal (0), ered (0), dxredscal (0),
+  trustregion (false), trradius0 (100), trradius (100), trmu (0), nrejected (0), Wcg (0),
+  lmlambda (0), lmnu (2), violbest (0),
   debug (debuglevel)
 {}
 
@@ -81,7 +115,7 @@ NewFitterGSL::~NewFitterGSL() {
   if (x) gsl_vector_free (x);               x=0;
   if (xold) gsl_vector_free (xold);         xold=0;
   if (xnew) gsl_vector_free (xnew);         xnew=0;
-//   if (xbest) gsl_vector_free (xbest);       xbest=0;
+  if (xbest) gsl_vector_free (xbest);       xbest=0;
   if (dx) gsl_vector_free (dx);             dx=0;
   if (dxscal) gsl_vector_free (dxscal);     dxscal=0;
 //   if (grad) gsl_vector_free (grad);         grad=0;
@@ -107,19 +141,32 @@ NewFitterGSL::~NewFitterGSL() {
   if (CCinv) gsl_matrix_free (CCinv);       CCinv=0;
   if (permW) gsl_permutation_free (permW);  permW=0;
   if (eigenws) gsl_eigen_symm_free (eigenws); eigenws=0; eigenwsdim=0;
+  delete arrowhead; arrowhead = 0;
+  if (Sred) gsl_matrix_free (Sred);         Sred=0;
+  if (yred) gsl_vector_free (yred);         yred=0;
+  if (yredscal) gsl_vector_free (yredscal); yredscal=0;
+  if (ered) gsl_vector_free (ered);         ered=0;
+  if (dxredscal) gsl_vector_free (dxredscal); dxredscal=0;
+  if (Wcg) gsl_matrix_free (Wcg);           Wcg=0;
 }
 
 
 
 double NewFitterGSL::fit() {
 
+  startBudget();
+  seedStartValues();
+  
   // order parameters etc
+  FitProfileTimer tinit (profile, FitProfile::INITIALIZE);
   initialize();
+  tinit.stop();
   
   // initialize eta, etasv, y   
   assert (x && x->size == idim);
   assert (xold && xold->size == idim);
   assert (xnew && xnew->size == idim);
+  assert (xbest && xbest->size == idim);
   assert (dx && dx->size == idim);
   assert (y && y->size == idim);
   assert (perr && perr->size == idim);
@@ -147,8 +194,11 @@ double NewFitterGSL::fit() {
   updateParams (x);
   fillx(x);    
   
-  assembleConstDer (M);
-  determineLambdas (x, M, x, W, v1); 
+  // without hard constraints, there are no lambdas
+  if (ncon > 0) {
+    assembleConstDer (M);
+    determineLambdas (x, M, x, W, v1); 
+  }
   
   // Get starting values into x
 //  gsl_vector_memcpy (x, xold);  
@@ -157,12 +207,16 @@ double NewFitterGSL::fit() {
   // LET THE GAMES BEGIN
   
 #ifndef FIT_TRACEOFF
-  calcChi2();
-  traceValues["alpha"] = 0;
-  traceValues["phi"] = 0;
-  traceValues["mu"] = 0;
-  traceValues["detW"] = 0;
-  if (tracer) tracer->initialize (*this);
+  // the trace values are recorded also without tracer, e.g. for the IterationScanner
+  traceValues.clear();
+  traceValues.set (TraceValues::ALPHA, 0);
+  traceValues.set (TraceValues::PHI, 0);
+  traceValues.set (TraceValues::MU, 0);
+  traceValues.set (TraceValues::DETW, 0);
+  if (tracer) {
+    calcChi2();
+    tracer->initialize (*this);
+  }
 #endif   
   
   bool converged = 0;
@@ -170,6 +224,16 @@ double NewFitterGSL::fit() {
   
   double chi2new = calcChi2();
   nit = 0;
+  nrejected = 0;
+  trradius = trradius0;
+  trmu = 0;
+  lmlambda = 0;
+  lmnu = 2;
+  if (hasBudget()) {
+    linalg->dcopy (x, xbest);
+    chi2best = chi2new;
+    violbest = getConstraintViolation();
+  }
   
   do {
 #ifndef FIT_TRACEOFF
@@ -177,36 +241,67 @@ double NewFitterGSL::fit() {
 #endif  
       
     // Store old x values in xold
-    gsl_blas_dcopy (x, xold);    
+    linalg->dcopy (x, xold);    
     // Fill errors into perr
     fillperr(perr);    
 
-    // Now, calculate the result vector y with the values of the derivatives
-    // d chi^2/d x
-    int ifail = calcNewtonDx(dx, dxscal, x, perr, M, Mscal, y, yscal, W, W2, permW, v1);
-    
-    if (ifail) {
-      ierr = 99;
-      if (debug > 0) {
-        std::cout << "NewFitterGSL::fit: calcNewtonDx error " << ifail << std::endl;
+    if (ncon == 0) {
+      // only soft constraints: unconstrained minimisation of chi2
+      int ifail = calcLevenbergMarquardtDx (converged, xnew, x, dx, dxscal, perr, M, Mscal, y, yscal, W);
+      if (ifail) {
+        ierr = 99;
+        if (debug > 0) {
+          std::cout << "NewFitterGSL::fit: calcLevenbergMarquardtDx error " << ifail << std::endl;
+        }
+        
+        break;
       }
-      
-      break;
+      if (converged) break;
     }
-    
-    // test convergence: 
-    if (gsl_blas_dasum (dxscal) < 1E-6*idim) {
-      converged = true;
-      break;
+    else if (trustregion) {
+      // Newton step and step length control in one go
+      int ifail = calcTrustRegionDx (converged, xnew, x, dx, dxscal, perr, M, Mscal, y, yscal, 
+                                     W, W2, W3, v1, v2, permW);
+      if (ifail) {
+        ierr = 99;
+        if (debug > 0) {
+          std::cout << "NewFitterGSL::fit: calcTrustRegionDx error " << ifail << std::endl;
+        }
+        
+        break;
+      }
+      if (converged) break;
+    }
+    else {
+      // Now, calculate the result vector y with the values of the derivatives
+      // d chi^2/d x
+      int ifail = calcNewtonDx(dx, dxscal, x, perr, M, Mscal, y, yscal, W, W2, permW, v1);
+      
+      if (ifail) {
+        ierr = 99;
+        if (debug > 0) {
+          std::cout << "NewFitterGSL::fit: calcNewtonDx error " << ifail << std::endl;
+        }
+        
+        break;
+      }
+      
+      // test convergence: 
+      if (linalg->dasum (dxscal) < 1E-6*idim) {
+        converged = true;
+        break;
+      }
+      
+      double alpha = 1;
+      double mu = 0;
+      int imode = 2;
+      
+      FitProfileTimer tlinesearch (profile, FitProfile::LINESEARCH);
+      calcLimitedDx (alpha, mu, xnew, imode, x, v2, dx, dxscal, perr, M, Mscal, W, v1);
+      tlinesearch.stop();
     }
-    
-    double alpha = 1;
-    double mu = 0;
-    int imode = 2;
-    
-    calcLimitedDx (alpha, mu, xnew, imode, x, v2, dx, dxscal, perr, M, Mscal, W, v1);
 
-    gsl_blas_dcopy (xnew, x);    
+    linalg->dcopy (xnew, x);    
 
     chi2new = calcChi2();
     //cout << "chi2: " << chi2old << " -> " << chi2new << endl;
@@ -217,6 +312,17 @@ double NewFitterGSL::fit() {
     if (nit > 200) ierr = 1;
     
     converged = (abs (chi2new - chi2old) < 0.0001);
+    
+    // keep the best iterate, in case the budget runs out
+    if (hasBudget() && !ierr) {
+      double viol = getConstraintViolation();
+      if (isBetterIterate (chi2new, viol, chi2best, violbest)) {
+        linalg->dcopy (x, xbest);
+        chi2best = chi2new;
+        violbest = viol;
+      }
+      if (!converged && budgetExhausted()) ierr = BUDGETEXHAUSTED;
+    }
                 
 //     if (abs (chi2new - chi2old) >= 0.001)
 //       cout << "abs (chi2new - chi2old)=" << abs (chi2new - chi2old) << " -> try again\n";      
@@ -240,11 +346,23 @@ double NewFitterGSL::fit() {
   if (tracer) tracer->step (*this);
 #endif  
   
+  if (ierr == BUDGETEXHAUSTED) {
+    // return the best iterate instead of the last one
+    linalg->dcopy (xbest, x);
+    updateParams (x);
+    chi2new = calcChi2();
+    if (debug > 0) {
+      cout << "NewFitterGSL::fit: budget exhausted after " << nit << " iterations, " 
+           << nevaluations << " evaluations; chi2=" << chi2new 
+           << ", constraint violation=" << violbest << endl;
+    }
+  }
+  
 //*-- End of iterations - calculate errors.
 
 // ERROR CALCULATION 
 
-  if (!ierr) {
+  if (ierr <= 0) {
 
     calcCovMatrix(W, permW, x);  
 
@@ -292,6 +410,13 @@ double NewFitterGSL::fit() {
   }
 
   if (ierr > 0) fitprob = -1;
+  
+  if (profile) {
+    profile->count (FitProfile::FITS);
+    profile->count (FitProfile::ITERATIONS, nit);
+    if (ierr == BUDGETEXHAUSTED) profile->count (FitProfile::BUDGETEXHAUSTED);
+    else if (ierr) profile->count (FitProfile::FAILEDFITS);
+  }
 
   return fitprob;
     
@@ -339,7 +464,7 @@ bool NewFitterGSL::initialize() {
   ini_gsl_vector (x, idim);
   ini_gsl_vector (xold, idim);
   ini_gsl_vector (xnew, idim);
-//   ini_gsl_vector (xbest, idim);
+  ini_gsl_vector (xbest, idim);
   ini_gsl_vector (dx, idim);
   ini_gsl_vector (dxscal, idim);
 //   ini_gsl_vector (grad, idim);
@@ -364,6 +489,7 @@ bool NewFitterGSL::initialize() {
   ini_gsl_matrix (CC, idim, idim);
   ini_gsl_matrix (CC1, idim, idim);
   ini_gsl_matrix (CCinv, idim, idim);
+  ini_gsl_matrix (Wcg, 3, idim);
   
   ini_gsl_permutation (permW, idim);
   
@@ -373,6 +499,8 @@ bool NewFitterGSL::initialize() {
   }
   if (eigenws == 0) eigenws = gsl_eigen_symm_alloc (idim); 
   eigenwsdim = idim;
+  
+  findEliminations();
  
   return true;
 
@@ -394,6 +522,7 @@ double NewFitterGSL::calcChi2() {
 }
 
 int NewFitterGSL::getError() const {return ierr;}
+bool NewFitterGSL::supportsBudget() const {return true;}
 double NewFitterGSL::getProbability() const {return fitprob;}
 double NewFitterGSL::getChi2() const {return chi2;}
 int NewFitterGSL::getDoF() const {return ncon+nsoft-nunm;}
@@ -456,8 +585,8 @@ void NewFitterGSL::add (gsl_vector *vecz, const gsl_vector *vecx, double a, cons
   assert (vecx->size == vecy->size);
   assert (vecx->size == vecz->size);
 
-  gsl_blas_dcopy (vecx, vecz);
-  gsl_blas_daxpy (a, vecy, vecz);
+  linalg->dcopy (vecx, vecz);
+  linalg->daxpy (a, vecy, vecz);
 }
 
 int NewFitterGSL::getNcon() const {return ncon;}
@@ -469,6 +598,7 @@ bool NewFitterGSL::updateParams (gsl_vector *vecx) {
   assert (vecx);
   assert (vecx->size == idim);
   bool significant = false;
+  countEvaluation();
   for (FitObjectIterator i = fitobjects.begin(); i != fitobjects.end(); ++i) {
     BaseFitObject *fo = *i;
     assert (fo);
@@ -479,22 +609,18 @@ bool NewFitterGSL::updateParams (gsl_vector *vecx) {
            << fo->getName() << ")\n";
     }
   }
+  if (!eliminations.empty()) significant |= projectEliminated (vecx);
   return significant;
 }
 
-bool NewFitterGSL::isfinite (const gsl_vector *vec) {
+bool NewFitterGSL::isfinite (const gsl_vector *vec) const {
   if (vec == 0) return true;
-  for (size_t i = 0; i < vec->size; ++i)
-    if (!std::isfinite (gsl_vector_get (vec, i))) return false;
-  return true;
+  return linalg->isfinite (vec);
 }
 
-bool NewFitterGSL::isfinite (const gsl_matrix *mat) {
+bool NewFitterGSL::isfinite (const gsl_matrix *mat) const {
   if (mat == 0) return true;
-  for (size_t i = 0; i < mat->size1; ++i)
-    for (size_t j = 0; j < mat->size2; ++j)
-      if (!std::isfinite (gsl_matrix_get (mat, i, j))) return false;
-  return true;
+  return linalg->isfinite (mat);
 }
 
 
@@ -503,6 +629,8 @@ void NewFitterGSL::fillx(gsl_vector *vecx) {
   assert (vecx->size == idim);
   
   gsl_vector_set_zero (vecx);
+  double *x = vecx->data;
+  size_t stride = vecx->stride;
   for (FitObjectIterator i = fitobjects.begin(); i != fitobjects.end(); ++i) {
     BaseFitObject *fo = *i;
     assert (fo);
@@ -510,7 +638,7 @@ void NewFitterGSL::fillx(gsl_vector *vecx) {
       if (!fo->isParamFixed(ilocal)) {
         int iglobal = fo->getGlobalParNum (ilocal);
         assert (iglobal >= 0 && iglobal < npar);
-        gsl_vector_set (vecx, iglobal, fo->getParam (ilocal));
+        x[iglobal*stride] = fo->getParam (ilocal);
       }
     }
   }
@@ -520,6 +648,8 @@ void NewFitterGSL::fillperr(gsl_vector *vece) {
   assert (vece);
   assert (vece->size == idim);
   gsl_vector_set_all (vece, 1);
+  double *e = vece->data;
+  size_t stride = vece->stride;
   for (FitObjectIterator i = fitobjects.begin(); i != fitobjects.end(); ++i) {
     BaseFitObject *fo = *i;
     assert (fo);
@@ -527,8 +657,8 @@ void NewFitterGSL::fillperr(gsl_vector *vece) {
       if (!fo->isParamFixed(ilocal)) {
         int iglobal = fo->getGlobalParNum (ilocal);
         assert (iglobal >= 0 && iglobal < npar);
-        double e = std::abs(fo->getError (ilocal));
-        gsl_vector_set (vece, iglobal, e ? e : 1);
+        double err = std::abs(fo->getError (ilocal));
+        e[iglobal*stride] = err ? err : 1;
       }
     }
   }
@@ -537,8 +667,8 @@ void NewFitterGSL::fillperr(gsl_vector *vece) {
     assert (c);
     int iglobal = c->getGlobalNum ();
     assert (iglobal >= 0 && iglobal < (int)idim);
-    double e =  c->getError();
-    gsl_vector_set (vece, iglobal, e ? 1/e : 1);
+    double err =  c->getError();
+    e[iglobal*stride] = err ? 1/err : 1;
   }
 }
 
@@ -554,6 +684,7 @@ void NewFitterGSL::assembleM(gsl_matrix *MatM, const gsl_vector *vecx, bool erro
   for (FitObjectIterator i = fitobjects.begin(); i != fitobjects.end(); ++i) {
     BaseFitObject *fo = *i;
     assert (fo);
+    FitProfileObjectTimer tobject (profile, FitProfile::ASSEMBLEM, typeid (*fo));
     fo->addToGlobalChi2DerMatrix (MatM->block->data, MatM->tda);
     if (debug > 0 && !isfinite (MatM)) {
       cout << "NewFitterGSL::assembleM: illegal elements in MatM after adding fo " << *fo << ":\n";
@@ -574,6 +705,7 @@ void NewFitterGSL::assembleM(gsl_matrix *MatM, const gsl_vector *vecx, bool erro
     assert (c);
     int kglobal = c->getGlobalNum();
     assert (kglobal >= 0 && kglobal < (int)idim);
+    FitProfileObjectTimer tobject (profile, FitProfile::ASSEMBLEM, typeid (*c));
     c->add1stDerivativesToMatrix (MatM->block->data, MatM->tda);
     if (debug > 0 && !isfinite (MatM)) {
       cout << "NewFitterGSL::assembleM: illegal elements in MatM after adding 1st derivatives of constraint " << *c << ":\n";
@@ -605,6 +737,7 @@ void NewFitterGSL::assembleM(gsl_matrix *MatM, const gsl_vector *vecx, bool erro
   for (SoftConstraintIterator i = softconstraints.begin(); i != softconstraints.end(); ++i) {
     BaseSoftConstraint *bsc = *i;
     assert (bsc);
+    FitProfileObjectTimer tobject (profile, FitProfile::ASSEMBLEM, typeid (*bsc));
     bsc->add2ndDerivativesToMatrix (MatM->block->data, MatM->tda);
     if (debug > 0 && !isfinite (MatM)) {
       cout << "NewFitterGSL::assembleM: illegal elements in MatM after adding soft constraint " << *bsc << ":\n";
@@ -661,10 +794,7 @@ void NewFitterGSL::scaleM (gsl_matrix *MatMscal, const gsl_matrix *MatM, const g
   assert (vece->size == idim);
 
   // Rescale columns and rows by perr
-  for (unsigned int i = 0; i < idim; ++i) 
-    for (unsigned int j = 0; j < idim; ++j) 
-      gsl_matrix_set (MatMscal, i, j,  
-        gsl_vector_get (vece, i)*gsl_vector_get (vece, j)*gsl_matrix_get (MatM, i, j));
+  linalg->scaleSym (MatMscal, MatM, vece);
 }
 
 
@@ -679,6 +809,7 @@ void NewFitterGSL::assembley(gsl_vector *vecy, const gsl_vector *vecx) {
   for (FitObjectIterator i = fitobjects.begin(); i != fitobjects.end(); ++i) {
     BaseFitObject *fo = *i;
     assert (fo);
+    FitProfileObjectTimer tobject (profile, FitProfile::ASSEMBLEY, typeid (*fo));
     fo->addToGlobalChi2DerVector (vecy->block->data, vecy->size);
   }
   
@@ -689,6 +820,7 @@ void NewFitterGSL::assembley(gsl_vector *vecy, const gsl_vector *vecx) {
     assert (c);
     int kglobal = c->getGlobalNum();
     assert (kglobal >= 0 && kglobal < (int)idim);
+    FitProfileObjectTimer tobject (profile, FitProfile::ASSEMBLEY, typeid (*c));
     c->addToGlobalChi2DerVector (vecy->block->data, vecy->size, gsl_vector_get (vecx, kglobal));
     gsl_vector_set (vecy, kglobal, c->getValue());
   }
@@ -698,6 +830,7 @@ void NewFitterGSL::assembley(gsl_vector *vecy, const gsl_vector *vecx) {
   for (SoftConstraintIterator i = softconstraints.begin(); i != softconstraints.end(); ++i) {
     BaseSoftConstraint *bsc = *i;
     assert (bsc);
+    FitProfileObjectTimer tobject (profile, FitProfile::ASSEMBLEY, typeid (*bsc));
     bsc->addToGlobalChi2DerVector (vecy->block->data, vecy->size);
   }
 }
@@ -817,18 +950,26 @@ int NewFitterGSL::calcNewtonDx (gsl_vector *vecdx, gsl_vector *vecdxscal,
       if (debug>2) cout << "NewFitterGSL::calcNewtonDx: ptLp=" << ptLp << " with zero lambdas" << endl;
       break;
     }    
+    if (ncalc > 0 && profile) profile->count (FitProfile::PTLPRETRIES);
       
     if (debug>5) {
       cout << "calcNewtonDx: before setting up equations: \n";
       debug_print (vecx, "x");
     }
          
+    FitProfileTimer tassembleM (profile, FitProfile::ASSEMBLEM);
     assembleM (MatM, vecx);
+    tassembleM.stop();
     if (!isfinite (MatM)) return 1;
     
-    scaleM  (MatMscal, MatM, vece);
+    FitProfileTimer tassembley (profile, FitProfile::ASSEMBLEY);
     assembley (vecy, vecx);
+    tassembley.stop();
     if (!isfinite (vecy)) return 2;
+    
+    if (!eliminations.empty()) adjustEliminatedLambdas (vecx, MatM, vecy);
+    
+    scaleM  (MatMscal, MatM, vece);
     scaley (vecyscal, vecy, vece);
       
     if (debug>5) {
@@ -848,15 +989,26 @@ int NewFitterGSL::calcNewtonDx (gsl_vector *vecdx, gsl_vector *vecdxscal,
     double epsLU = 1E-12;
     double epsSV = 1E-3;
     double detW;
-    solveSystem (vecdxscal, detW, vecyscal, MatMscal, MatW, MatW2, vecw, epsLU, epsSV);
+    FitProfileTimer tsolve (profile, FitProfile::SOLVESYSTEM);
+    bool reducedstep = !eliminations.empty() && 
+        solveReduced (vecdxscal, detW, vecy, vece, MatM, MatW, MatW2, vecw, epsLU, epsSV) >= 0;
+    bool nullspacestep = !reducedstep && nullspace && 
+        solveNullSpace (vecdxscal, detW, vecyscal, MatMscal, MatW, MatW2, W3, vecw, v2, permW, epsLU) == 0;
+    if (nullspacestep) {
+      if (profile) profile->count (FitProfile::SOLVENULLSPACE);
+    }
+    else if (!reducedstep) {
+      solveSystem (vecdxscal, detW, vecyscal, MatMscal, MatW, MatW2, vecw, epsLU, epsSV);
+    }
+    tsolve.stop();
     
 
 #ifndef FIT_TRACEOFF
-    traceValues["detW"] = detW;
+    traceValues.set (TraceValues::DETW, detW);
 #endif  
   
     // step is - computed vector
-    gsl_blas_dscal (-1, dxscal);
+    linalg->dscal (-1, dxscal);
   
     // dx = dxscal*e (component wise)
     gsl_vector_memcpy (vecdx, vecdxscal);
@@ -869,6 +1021,9 @@ int NewFitterGSL::calcNewtonDx (gsl_vector *vecdx, gsl_vector *vecdxscal,
     }              
 
     
+    // the reduced Hessian is positive definite: no need to check p^T L p
+    if (nullspacestep) break;
+    
     ptLp = calcpTLp (dx, M, v1);
     ++ncalc;
   }
@@ -915,11 +1070,11 @@ int NewFitterGSL::calcLimitedDx (double& alpha, double& mu, gsl_vector *vecxnew,
   if (debug>5) {
     cout << "calcLimitedDx: After solving equations: \n";
     debug_print (vecx, "x");
-    gsl_blas_dcopy (vecx, vecw);
+    linalg->dcopy (vecx, vecw);
     gsl_vector_div (vecw, vece);
     debug_print (vecw, "xscal");
     debug_print (vecxnew, "xnew");
-    gsl_blas_dcopy (vecxnew, vecw);
+    linalg->dcopy (vecxnew, vecw);
     gsl_vector_div (vecw, vece);
     debug_print (vecw, "xnewscal");
   }
@@ -942,9 +1097,9 @@ int NewFitterGSL::calcLimitedDx (double& alpha, double& mu, gsl_vector *vecxnew,
   }
   
 #ifndef FIT_TRACEOFF
-  traceValues["alpha"] = 0;
-  traceValues["phi"] = phi0;
-  traceValues["mu"] = mu;
+  traceValues.set (TraceValues::ALPHA, 0);
+  traceValues.set (TraceValues::PHI, phi0);
+  traceValues.set (TraceValues::MU, mu);
   if (tracer) tracer->substep (*this, 0);
 #endif   
     
@@ -961,27 +1116,29 @@ int NewFitterGSL::calcLimitedDx (double& alpha, double& mu, gsl_vector *vecxnew,
   }
   
 #ifndef FIT_TRACEOFF
-  traceValues["alpha"] = 1;
-  traceValues["phi"] = phiR;
+  traceValues.set (TraceValues::ALPHA, 1);
+  traceValues.set (TraceValues::PHI, phiR);
   if (tracer) tracer->substep (*this, 0);
 #endif   
 
   
   // Try Armijo's rule for alpha=1 first, do linesearch only if it fails
   if (phiR > phi0 + eta*alpha*dphi0) {
+    ++nrejected;
   
     // try second order correction first
     if (try2ndOrderCorr) {
+      if (profile) profile->count (FitProfile::SECONDORDERTRIED);
       calc2ndOrderCorr (vecdxhat, vecxnew, MatM, MatW, vecw);
-      gsl_blas_dcopy (vecxnew, vecw);
+      linalg->dcopy (vecxnew, vecw);
       add (vecxnew, vecxnew, 1, vecdxhat);
       updateParams (vecxnew);
       double phi2ndOrder  = meritFunction (mu, vecxnew, vece);
       
       #ifndef FIT_TRACEOFF
-        traceValues["alpha"] = 1.5;
-        traceValues["phi"] = phi2ndOrder;
-        if (tracer) tracer->substep (*this, 2);
+      traceValues.set (TraceValues::ALPHA, 1.5);
+      traceValues.set (TraceValues::PHI, phi2ndOrder);
+      if (tracer) tracer->substep (*this, 2);
       #endif   
 
       if (debug > 2) {
@@ -993,17 +1150,21 @@ int NewFitterGSL::calcLimitedDx (double& alpha, double& mu, gsl_vector *vecxnew,
       if (phi2ndOrder <= phi0 + eta*alpha*dphi0) {
         if (debug > 2) 
           cout << "  -> 2nd order correction successfull!"  << endl;
+        if (profile) profile->count (FitProfile::SECONDORDEROK);
         return 1;
       }
       if (debug > 2) 
         cout << "  -> 2nd order correction failed, do linesearch!"  << endl;
-      gsl_blas_dcopy (vecw, vecxnew);
+      ++nrejected;
+      linalg->dcopy (vecw, vecxnew);
       updateParams (vecxnew);
       #ifndef FIT_TRACEOFF
+      traceValues.set (TraceValues::ALPHA, 1);
+      traceValues.set (TraceValues::PHI, phiR);
+      if (tracer) {
         calcChi2();
-        traceValues["alpha"] = 1;
-        traceValues["phi"] = phiR;
-        if (tracer) tracer->substep (*this, 2);
+        tracer->substep (*this, 2);
+      }
       #endif   
 
     }
@@ -1052,8 +1213,8 @@ int NewFitterGSL::doLineSearch (double& alpha, gsl_vector *vecxnew,
     double phi = meritFunction (mu, vecxnew, vece);
   
 #ifndef FIT_TRACEOFF
-    traceValues["alpha"] = alpha;
-    traceValues["phi"] = phi;
+    traceValues.set (TraceValues::ALPHA, alpha);
+    traceValues.set (TraceValues::PHI, phi);
     if (tracer) tracer->substep (*this, 1);
 #endif   
     return 2;
@@ -1083,8 +1244,8 @@ int NewFitterGSL::doLineSearch (double& alpha, gsl_vector *vecxnew,
     phi = meritFunction (mu, vecxnew, vece);
   
 #ifndef FIT_TRACEOFF
-    traceValues["alpha"] = alpha;
-    traceValues["phi"] = phi;
+    traceValues.set (TraceValues::ALPHA, alpha);
+    traceValues.set (TraceValues::PHI, phi);
     if (tracer) tracer->substep (*this, 1);
 #endif   
     
@@ -1095,6 +1256,8 @@ int NewFitterGSL::doLineSearch (double& alpha, gsl_vector *vecxnew,
                           << " at alpha=" << alpha << endl;
       alphaR = alpha;
       phiR = phi;
+      ++nrejected;
+      if (profile) profile->count (FitProfile::STEPCUTS);
       continue;
     }
     
@@ -1127,7 +1290,7 @@ int NewFitterGSL::doLineSearch (double& alpha, gsl_vector *vecxnew,
         break;
       }  
     }
-  } while (nit < 30 && (alphaL == 0 || nit < 6));
+  } while (nit < 30 && (alphaL == 0 || nit < 6) && !budgetExhausted());
   if (alphaL > 0) alpha = alphaL;
   return 1;
 }
@@ -1168,12 +1331,12 @@ double NewFitterGSL::calcMu (const gsl_vector *vecx, const gsl_vector *vece,
         addConstraints (vecw);
         gsl_vector_view c (gsl_vector_subvector (vecw, npar, ncon));
         // ||c||_1
-        double cnorm1 = gsl_blas_dasum (&c.vector);
+        double cnorm1 = linalg->dasum (&c.vector);
         // scale constraint values by 1/(delta e)
         gsl_vector_const_view lambdaerr (gsl_vector_const_subvector (vece, npar, ncon));
         gsl_vector_mul (&c.vector, &lambdaerr.vector);
         // ||c||_1
-        double cnorm1scal = gsl_blas_dasum (&c.vector);
+        double cnorm1scal = linalg->dasum (&c.vector);
 
         double rho = 0.1;
         double eps = 0.001;
@@ -1181,8 +1344,7 @@ double NewFitterGSL::calcMu (const gsl_vector *vecx, const gsl_vector *vece,
         assembleChi2Der (vecw);                              
         gsl_vector_view gradf (gsl_vector_subvector (vecw, 0, npar));               
         gsl_vector_const_view p (gsl_vector_const_subvector (vecdx, 0, npar));                  
-        double gradfTp;                                      
-        gsl_blas_ddot (&gradf.vector, &p.vector, &gradfTp);  
+        double gradfTp = linalg->ddot (&gradf.vector, &p.vector);  
         
         if (debug > 7)
           cout << "NewFitterGSL::calcMu: cnorm1scal=" << cnorm1scal
@@ -1327,10 +1489,10 @@ int NewFitterGSL::invertM() {
     
     int signum;
     // Calculate LU decomposition of M into W
-    int result = gsl_linalg_LU_decomp (W, permW, &signum);
+    int result = linalg->LUDecomp (W, permW, &signum);
     if (debug>1)cout << "invertM: gsl_linalg_LU_decomp result=" << result << endl;
     // Calculate inverse of M
-    ifail = gsl_linalg_LU_invert (W, permW, M);
+    ifail = linalg->LUInvert (W, permW, M);
     if (debug>1)cout << "invertM: gsl_linalg_LU_invert result=" << ifail << endl;
     
     if (ifail != 0) {
@@ -1343,10 +1505,40 @@ void NewFitterGSL::setDebug (int debuglevel) {
   debug = debuglevel;
 }
 
+void NewFitterGSL::setArrowheadSolver (bool on) {
+  if (on && !arrowhead) arrowhead = new ArrowheadSolver;
+  if (!on) {
+    delete arrowhead;
+    arrowhead = 0;
+  }
+}
+
+void NewFitterGSL::setNullSpaceSolver (bool on) {
+  nullspace = on;
+}
+
+void NewFitterGSL::setEliminateUnmeasured (bool on) {
+  eliminate = on;
+}
+
+void NewFitterGSL::setTrustRegion (bool on, double radius) {
+  trustregion = on;
+  if (radius > 0) trradius0 = radius;
+}
+
+int NewFitterGSL::getRejectedSteps() const {return nrejected;}
+
+void NewFitterGSL::addSharedFitObject (BaseFitObject *fo) {
+  assert (fo);
+  if (std::find (sharedfitobjects.begin(), sharedfitobjects.end(), fo) == sharedfitobjects.end())
+    sharedfitobjects.push_back (fo);
+}
+
 
 void NewFitterGSL::calcCovMatrix(gsl_matrix *MatW, 
                                  gsl_permutation *permW,
                                  gsl_vector *vecx) {
+  FitProfileTimer tcov (profile, FitProfile::COVMATRIX);
   // Set up equation system M*dadeta + dydeta = 0
   // here, dadeta is d a / d eta, i.e. the derivatives of the fitted 
   // parameters a w.r.t. to the measured parameters eta,
@@ -1394,7 +1586,7 @@ void NewFitterGSL::calcCovMatrix(gsl_matrix *MatW,
 
   // Calculate LU decomposition of M into M3
   int signum;
-  int result = gsl_linalg_LU_decomp (MatW, permW, &signum);
+  int result = linalg->LUDecomp (MatW, permW, &signum);
  
   if (debug > 3) {
     cout << "calcCovMatrix: gsl_linalg_LU_decomp result=" << result << endl;
@@ -1402,7 +1594,7 @@ void NewFitterGSL::calcCovMatrix(gsl_matrix *MatW,
   }  
 
   // Calculate inverse of M, store in M3
-  int ifail = gsl_linalg_LU_invert (MatW, permW, M3);
+  int ifail = linalg->LUInvert (MatW, permW, M3);
   
   if (debug > 3) {
     cout << "calcCovMatrix: gsl_linalg_LU_invert ifail=" << ifail << endl;
@@ -1418,18 +1610,18 @@ void NewFitterGSL::calcCovMatrix(gsl_matrix *MatW,
   }
   
   // dadeta = 1*M*dydeta + 0*dadeta
-  gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1, M3, &dydeta.matrix, 0, &dadeta.matrix);
+  linalg->dgemm (CblasNoTrans, CblasNoTrans, 1, M3, &dydeta.matrix, 0, &dadeta.matrix);
   
   
   // Now calculate Cov_a = dadeta*Cov_eta*dadeta^T
 
   // First, calculate M3 = Cov_eta*dadeta^T as 
   gsl_matrix_view M3part   = gsl_matrix_submatrix (M3, 0, 0, npar, idim);
-  gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1, &Cov_eta.matrix, &dadeta.matrix, 0, &M3part.matrix);
+  linalg->dgemm (CblasNoTrans, CblasTrans, 1, &Cov_eta.matrix, &dadeta.matrix, 0, &M3part.matrix);
   // Now Cov_a = dadeta*M3part
   gsl_matrix_set_zero (M5);
   gsl_matrix_view  Cov_a = gsl_matrix_submatrix (M5, 0, 0, npar, npar);
-  gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1, &dadeta.matrix, &M3part.matrix, 0, M5);
+  linalg->dgemm (CblasNoTrans, CblasNoTrans, 1, &dadeta.matrix, &M3part.matrix, 0, M5);
   gsl_matrix_memcpy(CCinv,M5);
 
   if (debug > 3) {
@@ -1468,6 +1660,7 @@ void NewFitterGSL::determineLambdas (gsl_vector *vecxnew,
   assert (vecw);
   assert (vecw->size == idim);
   assert (idim == static_cast<unsigned int>(npar + ncon));
+  FitProfileTimer tlambdas (profile, FitProfile::DETERMINELAMBDAS);
 
   gsl_matrix_const_view A (gsl_matrix_const_submatrix (MatM, 0, npar, npar, ncon));
   gsl_matrix_view ATA (gsl_matrix_submatrix (MatW, npar, npar, ncon, ncon));
@@ -1488,14 +1681,14 @@ void NewFitterGSL::determineLambdas (gsl_vector *vecxnew,
   }
   
   // ATA = 1*A^T*A + 0*ATA
-  gsl_blas_dgemm (CblasTrans, CblasNoTrans, 1, &A.matrix, &A.matrix, 0, &ATA.matrix);
+  linalg->dgemm (CblasTrans, CblasNoTrans, 1, &A.matrix, &A.matrix, 0, &ATA.matrix);
 
   // put grad(f) into vecw
   assembleChi2Der (vecw);
 
   
   // ATgradf = -1*A^T*gradf + 0*ATgradf
-  gsl_blas_dgemv (CblasTrans, -1, &A.matrix, &gradf.vector, 0, &ATgradf.vector);
+  linalg->dgemv (CblasTrans, -1, &A.matrix, &gradf.vector, 0, &ATgradf.vector);
   
   if (debug > 7) {
     cout << "A: " <<endl;;
@@ -1514,9 +1707,10 @@ void NewFitterGSL::determineLambdas (gsl_vector *vecxnew,
   
   // solve ATA * lambdanew = ATgradf using the Cholsky factorization method
   gsl_error_handler_t *old_handler =  gsl_set_error_handler_off ();
-  int cholesky_result = gsl_linalg_cholesky_decomp (&ATA.matrix);
+  int cholesky_result = linalg->choleskyDecomp (&ATA.matrix);
   gsl_set_error_handler (old_handler);
   if (cholesky_result) {
+    if (profile) profile->count (FitProfile::CHOLESKYFAILED);
     cout << "NewFitterGSL::determineLambdas: resorting to SVD" << endl;
     // ATA is not positive definite, i.e. A does not have full column rank
     // => use the SVD of A to solve A lambdanew = gradf
@@ -1535,7 +1729,7 @@ void NewFitterGSL::determineLambdas (gsl_vector *vecxnew,
     gsl_linalg_SV_solve (&Acopy.matrix, &V.matrix, &s.vector, &gradf.vector, &lambdanew.vector);
   }
   else {
-    gsl_linalg_cholesky_solve (&ATA.matrix, &ATgradf.vector, &lambdanew.vector);
+    linalg->choleskySolve (&ATA.matrix, &ATgradf.vector, &lambdanew.vector);
   }
   if (debug > 5) {
     cout << "lambdanew: " <<endl;;
@@ -1583,7 +1777,7 @@ void NewFitterGSL::MoorePenroseInverse (gsl_matrix *Ainv, gsl_matrix *A,
       gsl_matrix_set (W, i, j, wval*gsl_matrix_get (W, i, j));
   }
   // Ainv = 1*W*A^T + 0*Ainv
-  gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1, W, A, 0, Ainv);
+  linalg->dgemm (CblasNoTrans, CblasTrans, 1, W, A, 0, Ainv);
   
 }
 
@@ -1599,9 +1793,8 @@ double NewFitterGSL::calcpTLp (const gsl_vector *vecdx, const gsl_matrix *MatM,
   gsl_vector_const_view p (gsl_vector_const_subvector (vecdx, 0, npar));
   gsl_vector_view Lp (gsl_vector_subvector (vecw, 0, npar));
   gsl_matrix_const_view L (gsl_matrix_const_submatrix (MatM, 0, 0, npar, npar));
-  gsl_blas_dsymv (CblasUpper, 1, &L.matrix, &p.vector, 0, &Lp.vector);
-  double result;
-  gsl_blas_ddot (&p.vector, &Lp.vector, &result);
+  linalg->dsymv (CblasUpper, 1, &L.matrix, &p.vector, 0, &Lp.vector);
+  double result = linalg->ddot (&p.vector, &Lp.vector);
 
   return result;
 }
@@ -1623,6 +1816,7 @@ void NewFitterGSL::calc2ndOrderCorr (gsl_vector *vecdxhat,
   assert (vecw);
   assert (vecw->size == idim);
   assert (idim == static_cast<unsigned int>(npar + ncon));
+  FitProfileTimer tcorr (profile, FitProfile::SECONDORDERCORR);
 
 
   // Calculate 2nd order correction 
@@ -1643,13 +1837,14 @@ void NewFitterGSL::calc2ndOrderCorr (gsl_vector *vecdxhat,
   
   
   // AAT = 1*A*A^T + 0*AAT
-  gsl_blas_dgemm (CblasTrans, CblasNoTrans, 1, &AT.matrix, &AT.matrix, 0, &AAT.matrix);
+  linalg->dgemm (CblasTrans, CblasNoTrans, 1, &AT.matrix, &AT.matrix, 0, &AAT.matrix);
   
   // solve AAT * AATinvc = c using the Cholsky factorization method
   gsl_error_handler_t *old_handler =  gsl_set_error_handler_off ();
-  int cholesky_result = gsl_linalg_cholesky_decomp (&AAT.matrix);
+  int cholesky_result = linalg->choleskyDecomp (&AAT.matrix);
   gsl_set_error_handler (old_handler);
   if (cholesky_result) {
+    if (profile) profile->count (FitProfile::CHOLESKYFAILED);
     cout << "NewFitterGSL::calc2ndOrderCorr: resorting to SVD" << endl;
     // AAT is not positive definite, i.e. A does not have full column rank
     // => use the SVD of AT to solve A lambdanew = gradf
@@ -1668,11 +1863,11 @@ void NewFitterGSL::calc2ndOrderCorr (gsl_vector *vecdxhat,
     gsl_linalg_SV_solve (&ATcopy.matrix, &V.matrix, &s.vector, &c.vector, &AATinvc.vector);
   }
   else {
-    gsl_linalg_cholesky_solve (&AAT.matrix, &c.vector, &AATinvc.vector);
+    linalg->choleskySolve (&AAT.matrix, &c.vector, &AATinvc.vector);
   }
   
   // phat = -1*A^T*AATinvc+ 0*phat
-  gsl_blas_dgemv (CblasNoTrans, -1, &AT.matrix, &AATinvc.vector, 0, &phat.vector);
+  linalg->dgemv (CblasNoTrans, -1, &AT.matrix, &AATinvc.vector, 0, &phat.vector);
   gsl_vector_set_zero (&c.vector);
                                        
 }
@@ -1687,27 +1882,56 @@ int NewFitterGSL::solveSystem (      gsl_vector *vecdxscal,
                                      double epsLU,
                                      double epsSV) {  
   assert (vecdxscal);
-  assert (vecdxscal->size == idim);
+  // the system may be the reduced one, of dimension n < idim
+  unsigned int n = vecdxscal->size;
+  assert (n <= idim);
   assert (vecyscal);
-  assert (vecyscal->size == idim);
+  assert (vecyscal->size == n);
   assert (MatMscal);
-  assert (MatMscal->size1 == idim && MatMscal->size2 == idim);
+  assert (MatMscal->size1 == n && MatMscal->size2 == n);
   assert (MatW);
-  assert (MatW->size1 == idim && MatW->size2 == idim);
+  assert (MatW->size1 == n && MatW->size2 == n);
   assert (MatW2);
-  assert (MatW2->size1 == idim && MatW2->size2 == idim);
+  assert (MatW2->size1 == n && MatW2->size2 == n);
   assert (vecw);
-  assert (vecw->size == idim);
+  assert (vecw->size == n);
   
   int result = 0;
   
+  if (arrowhead && n == idim) {
+    // shared fit objects that are not part of this fit have no valid global numbers
+    sharedrows.clear();
+    for (unsigned int i = 0; i < sharedfitobjects.size(); ++i) {
+      BaseFitObject *fo = sharedfitobjects[i];
+      if (std::find (fitobjects.begin(), fitobjects.end(), fo) == fitobjects.end()) continue;
+      for (int ilocal = 0; ilocal < fo->getNPar(); ++ilocal) {
+        int iglobal = fo->getGlobalParNum (ilocal);
+        if (iglobal >= 0) sharedrows.push_back (iglobal);
+      }
+    }
+    arrowhead->setLinAlgBackend (*linalg);
+    if (arrowhead->analyse (MatMscal, sharedrows) && 
+        arrowhead->solve (vecdxscal, detW, MatMscal, vecyscal) == 0 &&
+        std::fabs (detW) >= epsLU) {
+      if (debug > 2) cout << "NewFitterGSL::solveSystem: solved with " << arrowhead->getNBlocks() 
+                          << " blocks and " << arrowhead->getNShared() << " shared rows" << endl;
+      if (profile) profile->count (FitProfile::SOLVEARROWHEAD);
+      return result;
+    }
+  }
+  
   int iLU = solveSystemLU (vecdxscal, detW, vecyscal, MatMscal, MatW, vecw, epsLU);
-  if (iLU == 0) return result;
+  if (iLU == 0) {
+    if (profile) profile->count (FitProfile::SOLVELU);
+    return result;
+  }
   
   result = 1;
+  if (profile) profile->count (FitProfile::SOLVESVD);
   int iSVD = solveSystemSVD (vecdxscal, detW, vecyscal, MatMscal, MatW, MatW2, vecw, epsSV);
   if (iSVD == 0) return result;
   
+  if (profile) profile->count (FitProfile::SOLVEFAILED);
   return -1;
 }
 
@@ -1719,27 +1943,30 @@ int NewFitterGSL::solveSystemLU (      gsl_vector *vecdxscal,
                                        gsl_vector *vecw,
                                        double eps) {  
   assert (vecdxscal);
-  assert (vecdxscal->size == idim);
+  unsigned int n = vecdxscal->size;
+  assert (n <= idim);
   assert (vecyscal);
-  assert (vecyscal->size == idim);
+  assert (vecyscal->size == n);
   assert (MatMscal);
-  assert (MatMscal->size1 == idim && MatMscal->size2 == idim);
+  assert (MatMscal->size1 == n && MatMscal->size2 == n);
   assert (MatW);
-  assert (MatW->size1 == idim && MatW->size2 == idim);
+  assert (MatW->size1 == n && MatW->size2 == n);
   assert (vecw);
-  assert (vecw->size == idim);
+  assert (vecw->size == n);
   
   gsl_matrix_memcpy (MatW, MatMscal);
   
   int ifail = 0;
   detW = 0;
   
+  // the permutation is stored in the first n elements of permW
+  gsl_permutation permn = {n, permW->data};
   int signum;
-  int result = gsl_linalg_LU_decomp (MatW, permW, &signum);
+  int result = linalg->LUDecomp (MatW, &permn, &signum);
   if (debug>4)cout << "NewFitterGSL::solveSystem: gsl_linalg_LU_decomp result=" << result << endl;
   if (result != 0) return 1;
   
-  detW = gsl_linalg_LU_det (MatW, signum);
+  detW = linalg->LUDet (MatW, signum);
   if (debug>4)cout << "NewFitterGSL::solveSystem: determinant of W=" << detW << endl;
   if (std::fabs(detW) < eps) return 2;
   if (!std::isfinite(detW)) {
@@ -1751,7 +1978,7 @@ int NewFitterGSL::solveSystemLU (      gsl_vector *vecdxscal,
     debug_print (MatW, "W");
   }
   // Solve W*dxscal = yscal
-  ifail = gsl_linalg_LU_solve (MatW, permW, vecyscal, vecdxscal);
+  ifail = linalg->LUSolve (MatW, &permn, vecyscal, vecdxscal);
   if (debug>4)cout << "NewFitterGSL::solveSystem: gsl_linalg_LU_solve result=" << ifail << endl;
   
   if (ifail != 0) {
@@ -1773,17 +2000,18 @@ int NewFitterGSL::solveSystemSVD (      gsl_vector *vecdxscal,
                                          gsl_vector *vecw,
                                          double eps) {  
   assert (vecdxscal);
-  assert (vecdxscal->size == idim);
+  unsigned int n = vecdxscal->size;
+  assert (n <= idim);
   assert (vecyscal);
-  assert (vecyscal->size == idim);
+  assert (vecyscal->size == n);
   assert (MatMscal);
-  assert (MatMscal->size1 == idim && MatMscal->size2 == idim);
+  assert (MatMscal->size1 == n && MatMscal->size2 == n);
   assert (MatW);
-  assert (MatW->size1 == idim && MatW->size2 == idim);
+  assert (MatW->size1 == n && MatW->size2 == n);
   assert (MatW2);
-  assert (MatW2->size1 == idim && MatW2->size2 == idim);
+  assert (MatW2->size1 == n && MatW2->size2 == n);
   assert (vecw);
-  assert (vecw->size == idim);
+  assert (vecw->size == n);
   
   if (debug>0) cout << "solveSystemSVD called" << endl;
   
@@ -1794,7 +2022,7 @@ int NewFitterGSL::solveSystemSVD (      gsl_vector *vecdxscal,
   // set small values to zero
   double mins = eps*std::fabs (gsl_vector_get (vecw, 0));
   if (debug>5) cout << "SV 0 = " << gsl_vector_get (vecw, 0) << endl;
-  for (unsigned int i = 0; i < idim; ++i) {
+  for (unsigned int i = 0; i < n; ++i) {
     if (std::fabs (gsl_vector_get (vecw, i)) <= mins) {
       if (debug>5) cout << "Setting SV" << i << " = " << gsl_vector_get (vecw, i) << " to zero!" << endl;
       gsl_vector_set (vecw, i, 0);
@@ -1804,6 +2032,888 @@ int NewFitterGSL::solveSystemSVD (      gsl_vector *vecdxscal,
   return 0;
 }  
 
+int NewFitterGSL::decomposeConstDer (int& rankA, gsl_matrix *MatQR, const gsl_matrix *MatA, 
+                                     gsl_vector *vecw1, gsl_vector *vecw2, 
+                                     gsl_permutation *permW, double eps) {
+  assert (MatQR);
+  assert (MatQR->size1 == idim && MatQR->size2 == idim);
+  assert (MatA);
+  assert (MatA->size1 == idim && MatA->size2 == idim);
+  assert (vecw1);
+  assert (vecw1->size == idim);
+  assert (vecw2);
+  assert (vecw2->size == idim);
+  assert (permW);
+  assert (permW->size == idim);
+  
+  gsl_matrix_view Q        (gsl_matrix_submatrix       (MatQR, 0,    0,    npar, npar));
+  rankA = 0;
+  if (ncon == 0) {
+    gsl_matrix_set_identity (&Q.matrix);
+    return 0;
+  }
+  
+  int nmin = (npar < ncon) ? npar : ncon;
+  gsl_matrix_const_view AT (gsl_matrix_const_submatrix (MatA,  0,    npar, npar, ncon));
+  gsl_matrix_view R        (gsl_matrix_submatrix       (MatQR, 0,    npar, npar, ncon));
+  gsl_vector_view tau      (gsl_vector_subvector       (vecw1, 0,    nmin));
+  gsl_vector_view norm     (gsl_vector_subvector       (vecw2, 0,    ncon));
+  // the column permutation is stored in the first ncon elements of permW
+  gsl_permutation permA = {static_cast<size_t>(ncon), permW->data};
+
+  int signum = 0;
+  int ifail = gsl_linalg_QRPT_decomp2 (&AT.matrix, &Q.matrix, &R.matrix, &tau.vector, &permA, &signum, &norm.vector); 
+  if (ifail) return ifail;
+
+  // column pivoting sorts the diagonal elements of R by decreasing size
+  double mins = eps*std::fabs (gsl_matrix_get (&R.matrix, 0, 0));
+  for (int i = 0; i < nmin; ++i) {
+    double rii = std::fabs (gsl_matrix_get (&R.matrix, i, i));
+    if (rii == 0 || rii <= mins) break;
+    rankA++;
+  }
+  return 0;
+}
+
+int NewFitterGSL::solveNullSpace (      gsl_vector *vecdxscal, 
+                                        double& detW,
+                                  const gsl_vector *vecyscal, 
+                                  const gsl_matrix *MatMscal,  
+                                        gsl_matrix *MatW,   
+                                        gsl_matrix *MatW2,   
+                                        gsl_matrix *MatW3,   
+                                        gsl_vector *vecw1,
+                                        gsl_vector *vecw2,
+                                        gsl_permutation *permW,
+                                        double eps) {
+  assert (vecdxscal);
+  assert (vecdxscal->size == idim);
+  assert (vecyscal);
+  assert (vecyscal->size == idim);
+  assert (MatMscal);
+  assert (MatMscal->size1 == idim && MatMscal->size2 == idim);
+  assert (MatW);
+  assert (MatW->size1 == idim && MatW->size2 == idim);
+  assert (MatW2);
+  assert (MatW2->size1 == idim && MatW2->size2 == idim);
+  assert (MatW3);
+  assert (MatW3->size1 == idim && MatW3->size2 == idim);
+  assert (vecw1);
+  assert (vecw1->size == idim);
+  assert (vecw2);
+  assert (vecw2->size == idim);
+  assert (permW);
+  assert (permW->size == idim);
+  
+  // Mscal = ( G  A^T )   with A^T P = Q R = (Y Z) (R1)
+  //         ( A  0   )                            (0 )
+  // The solution dxscal = (px, pl) is split into px = Y*uY + Z*uZ:
+  // - range space step:  R11^T uY = (P^T yc)
+  // - null space step:   (Z^T G Z) uZ = Z^T (yx - G Y uY)
+  // - multipliers:       R11 P^T pl = Y^T (yx - G px)
+  // Z^T G Z is made positive definite by adding a multiple of the unit matrix
+  
+  int rankA = 0;
+  if (decomposeConstDer (rankA, MatW, MatMscal, vecw1, vecw2, permW, eps)) return 1;
+  // linearly dependent constraints: leave it to the SVD of the full system
+  if (rankA < ncon) return 3;
+  int nz = npar - rankA;
+  const size_t *perm = permW->data;
+  
+  gsl_matrix_const_view G (gsl_matrix_const_submatrix (MatMscal, 0, 0, npar, npar));
+  gsl_vector_const_view yx (gsl_vector_const_subvector (vecyscal, 0, npar));
+  gsl_matrix_view Q       (gsl_matrix_submatrix (MatW, 0, 0, npar, npar));
+  gsl_vector_view px      (gsl_vector_subvector (vecdxscal, 0, npar));
+  gsl_vector_view u       (gsl_vector_subvector (vecw1, 0, npar));
+  gsl_vector_view w       (gsl_vector_subvector (vecw2, 0, npar));
+  
+  detW = 1;
+  gsl_vector_set_zero (&px.vector);
+  
+  if (rankA > 0) {
+    gsl_matrix_view R11   (gsl_matrix_submatrix (MatW, 0, npar, rankA, rankA));
+    gsl_matrix_view Y     (gsl_matrix_submatrix (MatW, 0, 0, npar, rankA));
+    gsl_vector_view uY    (gsl_vector_subvector (vecw1, 0, rankA));
+    for (int i = 0; i < rankA; ++i) {
+      double rii = gsl_matrix_get (&R11.matrix, i, i);
+      gsl_vector_set (&uY.vector, i, gsl_vector_get (vecyscal, npar + perm[i]));
+      detW *= -rii*rii;
+    }
+    linalg->dtrsv (CblasUpper, CblasTrans, CblasNonUnit, &R11.matrix, &uY.vector);
+    // px = Y*uY
+    linalg->dgemv (CblasNoTrans, 1, &Y.matrix, &uY.vector, 0, &px.vector);
+  }
+  
+  if (nz > 0) {
+    gsl_matrix_view Z     (gsl_matrix_submatrix (MatW, 0, rankA, npar, nz));
+    gsl_matrix_view GZ    (gsl_matrix_submatrix (MatW2, 0, 0, npar, nz));
+    gsl_matrix_view Hred  (gsl_matrix_submatrix (MatW3, 0, 0, nz, nz));
+    gsl_matrix_view Hchol (gsl_matrix_submatrix (MatW2, 0, 0, nz, nz));
+    gsl_vector_view uZ    (gsl_vector_subvector (vecw1, rankA, nz));
+    
+    // Hred = Z^T G Z, as in calcReducedHessian
+    linalg->dsymm (CblasLeft, CblasUpper, 1, &G.matrix, &Z.matrix, 0, &GZ.matrix);
+    linalg->dgemm (CblasTrans, CblasNoTrans, 1, &Z.matrix, &GZ.matrix, 0, &Hred.matrix);
+    
+    // uZ = Z^T (yx - G px)
+    gsl_vector_memcpy (&w.vector, &yx.vector);
+    linalg->dsymv (CblasUpper, -1, &G.matrix, &px.vector, 1, &w.vector);
+    linalg->dgemv (CblasTrans, 1, &Z.matrix, &w.vector, 0, &uZ.vector);
+    
+    double hmax = 0;
+    for (int i = 0; i < nz; ++i) hmax = std::max (hmax, std::fabs (gsl_matrix_get (&Hred.matrix, i, i)));
+    if (hmax == 0) hmax = 1;
+    double shift = 0;
+    int cholesky_result = 0;
+    gsl_error_handler_t *old_handler =  gsl_set_error_handler_off ();
+    for (int itry = 0; itry < 20; ++itry) {
+      gsl_matrix_memcpy (&Hchol.matrix, &Hred.matrix);
+      for (int i = 0; i < nz; ++i) *gsl_matrix_ptr (&Hchol.matrix, i, i) += shift;
+      cholesky_result = linalg->choleskyDecomp (&Hchol.matrix);
+      if (cholesky_result == 0) break;
+      if (profile) profile->count (FitProfile::CHOLESKYFAILED);
+      shift = (shift == 0) ? 1E-3*hmax : 10*shift;
+    }
+    gsl_set_error_handler (old_handler);
+    if (cholesky_result) return 2;
+    if (debug > 2 && shift > 0) 
+      cout << "NewFitterGSL::solveNullSpace: reduced Hessian shifted by " << shift << endl;
+    for (int i = 0; i < nz; ++i) {
+      double lii = gsl_matrix_get (&Hchol.matrix, i, i);
+      detW *= lii*lii;
+    }
+    linalg->choleskySvx (&Hchol.matrix, &uZ.vector);
+  }
+  
+  // px = Q*u
+  linalg->dgemv (CblasNoTrans, 1, &Q.matrix, &u.vector, 0, &px.vector);
+  
+  if (rankA > 0) {
+    gsl_matrix_view R11   (gsl_matrix_submatrix (MatW, 0, npar, rankA, rankA));
+    gsl_matrix_view Y     (gsl_matrix_submatrix (MatW, 0, 0, npar, rankA));
+    gsl_vector_view lY    (gsl_vector_subvector (vecw1, 0, rankA));
+    // lY = Y^T (yx - G px)
+    gsl_vector_memcpy (&w.vector, &yx.vector);
+    linalg->dsymv (CblasUpper, -1, &G.matrix, &px.vector, 1, &w.vector);
+    linalg->dgemv (CblasTrans, 1, &Y.matrix, &w.vector, 0, &lY.vector);
+    linalg->dtrsv (CblasUpper, CblasNoTrans, CblasNonUnit, &R11.matrix, &lY.vector);
+    for (int i = 0; i < rankA; ++i) gsl_vector_set (vecdxscal, npar + perm[i], gsl_vector_get (&lY.vector, i));
+  }
+  
+  if (debug > 2) cout << "NewFitterGSL::solveNullSpace: dimension of reduced Hessian: " << nz << endl;
+  return 0;
+}
+
+void NewFitterGSL::findEliminations () {
+  eliminations.clear();
+  keptrows.clear();
+  elimrows.clear();
+  elimcons.clear();
+  
+  if (eliminate) {
+    std::vector<bool> used (constraints.size(), false);
+    for (FitObjectIterator i = fitobjects.begin(); i != fitobjects.end(); ++i) {
+      if (!dynamic_cast<NeutrinoFitObject *>(*i) && !dynamic_cast<ZinvisibleFitObject *>(*i)) continue;
+      ParticleFitObject *fo = static_cast<ParticleFitObject *>(*i);
+      bool ok = true;
+      for (int ilocal = 0; ilocal < 3; ++ilocal) {
+        if (fo->isParamFixed (ilocal) || fo->isParamMeasured (ilocal)) ok = false;
+      }
+      // fo must not appear in the constraints of another eliminated fit object
+      double fact[4];
+      for (unsigned int k = 0; ok && k < eliminations.size(); ++k) {
+        for (int d = 0; d < 3; ++d) {
+          if (eliminations[k].con[d]->getFactors (fo, fact)) ok = false;
+        }
+      }
+      if (!ok) continue;
+      
+      // find one unused momentum constraint each for px, py and pz of fo, without energy term
+      Elimination elim;
+      double F[3][3];
+      int icon[3] = {-1, -1, -1};
+      for (int d = 0; ok && d < 3; ++d) {
+        elim.con[d] = 0;
+        for (unsigned int k = 0; k < constraints.size() && !elim.con[d]; ++k) {
+          if (used[k] || (int)k == icon[0] || (int)k == icon[1]) continue;
+          MomentumConstraint *mc = dynamic_cast<MomentumConstraint *>(constraints[k]);
+          if (!mc || !mc->getFactors (fo, fact) || fact[0] != 0 || fact[1+d] == 0) continue;
+          bool other = false;
+          for (unsigned int l = 0; l < eliminations.size(); ++l) {
+            double factl[4];
+            if (mc->getFactors (eliminations[l].fo, factl)) other = true;
+          }
+          if (other) continue;
+          elim.con[d] = mc;
+          icon[d] = k;
+          for (int a = 0; a < 3; ++a) F[d][a] = fact[1+a];
+        }
+        if (!elim.con[d]) ok = false;
+      }
+      if (!ok || !invert3 (F, elim.Finv)) continue;
+      
+      elim.fo = fo;
+      for (int d = 0; d < 3; ++d) used[icon[d]] = true;
+      eliminations.push_back (elim);
+    }
+  }
+  
+  // numbering of the reduced system
+  std::vector<bool> eliminated (idim, false);
+  for (unsigned int k = 0; k < eliminations.size(); ++k) {
+    for (int j = 0; j < 3; ++j) {
+      int iglobal = eliminations[k].fo->getGlobalParNum (j);
+      elimrows.push_back (iglobal);
+      eliminated[iglobal] = true;
+    }
+    for (int d = 0; d < 3; ++d) {
+      int kglobal = eliminations[k].con[d]->getGlobalNum();
+      elimcons.push_back (kglobal);
+      eliminated[kglobal] = true;
+    }
+  }
+  if (!eliminations.empty()) {
+    for (unsigned int i = 0; i < idim; ++i) {
+      if (!eliminated[i]) keptrows.push_back (i);
+    }
+  }
+  
+  if (debug > 1 && !eliminations.empty()) {
+    cout << "NewFitterGSL::findEliminations: eliminated " << eliminations.size() 
+         << " fit objects, dimension of reduced system: " << keptrows.size() << endl;
+  }
+  
+  ini_gsl_matrix (Sred, elimrows.size(), keptrows.size());
+  ini_gsl_vector (yred, keptrows.size());
+  ini_gsl_vector (yredscal, keptrows.size());
+  ini_gsl_vector (ered, keptrows.size());
+  ini_gsl_vector (dxredscal, keptrows.size());
+}
+
+bool NewFitterGSL::projectEliminated (gsl_vector *vecx) {
+  assert (vecx);
+  assert (vecx->size == idim);
+  
+  bool significant = false;
+  for (unsigned int k = 0; k < eliminations.size(); ++k) {
+    const Elimination& elim = eliminations[k];
+    ParticleFitObject *fo = elim.fo;
+    // the constraints are linear in the momentum of fo: p -> p - F^-1 c
+    double c[3];
+    for (int d = 0; d < 3; ++d) c[d] = elim.con[d]->getValue();
+    double p[3] = {fo->getPx(), fo->getPy(), fo->getPz()};
+    for (int a = 0; a < 3; ++a) {
+      for (int d = 0; d < 3; ++d) p[a] -= elim.Finv[a][d]*c[d];
+    }
+    double pt = std::sqrt (p[0]*p[0] + p[1]*p[1]);
+    double m = fo->getMass();
+    gsl_vector_set (vecx, fo->getGlobalParNum (0), std::sqrt (pt*pt + p[2]*p[2] + m*m));
+    gsl_vector_set (vecx, fo->getGlobalParNum (1), std::atan2 (pt, p[2]));
+    gsl_vector_set (vecx, fo->getGlobalParNum (2), std::atan2 (p[1], p[0]));
+    significant |= fo->updateParams (vecx->block->data, vecx->size);
+  }
+  return significant;
+}
+
+void NewFitterGSL::adjustEliminatedLambdas (gsl_vector *vecx, gsl_matrix *MatM, gsl_vector *vecy) {
+  assert (vecx);
+  assert (vecx->size == idim);
+  assert (MatM);
+  assert (MatM->size1 == idim && MatM->size2 == idim);
+  assert (vecy);
+  assert (vecy->size == idim);
+  
+  for (unsigned int k = 0; k < eliminations.size(); ++k) {
+    const int *iu = &elimrows[3*k];
+    const int *kp = &elimcons[3*k];
+    // A_pu: derivatives of the eliminated constraints w.r.t. the eliminated parameters
+    double A[3][3], Ainv[3][3];
+    for (int d = 0; d < 3; ++d) {
+      for (int j = 0; j < 3; ++j) A[d][j] = gsl_matrix_get (MatM, kp[d], iu[j]);
+    }
+    if (!invert3 (A, Ainv)) continue;
+    // A_pu^T dlambda = -y_u
+    double dlambda[3];
+    for (int d = 0; d < 3; ++d) {
+      dlambda[d] = 0;
+      for (int j = 0; j < 3; ++j) dlambda[d] -= Ainv[j][d]*gsl_vector_get (vecy, iu[j]);
+    }
+    for (int d = 0; d < 3; ++d) {
+      *gsl_vector_ptr (vecx, kp[d]) += dlambda[d];
+      eliminations[k].con[d]->add2ndDerivativesToMatrix (MatM->block->data, MatM->tda, dlambda[d]);
+      for (int i = 0; i < npar; ++i) *gsl_vector_ptr (vecy, i) += dlambda[d]*gsl_matrix_get (MatM, i, kp[d]);
+    }
+  }
+}
+
+int NewFitterGSL::solveReduced (      gsl_vector *vecdxscal, 
+                                      double& detW,
+                                const gsl_vector *vecy, 
+                                const gsl_vector *vece, 
+                                const gsl_matrix *MatM,  
+                                      gsl_matrix *MatW,   
+                                      gsl_matrix *MatW2,   
+                                      gsl_vector *vecw,
+                                      double epsLU,
+                                      double epsSV) {
+  assert (vecdxscal);
+  assert (vecdxscal->size == idim);
+  assert (vecy);
+  assert (vecy->size == idim);
+  assert (vece);
+  assert (vece->size == idim);
+  assert (MatM);
+  assert (MatM->size1 == idim && MatM->size2 == idim);
+  assert (MatW);
+  assert (MatW->size1 == idim && MatW->size2 == idim);
+  assert (MatW2);
+  assert (MatW2->size1 == idim && MatW2->size2 == idim);
+  assert (vecw);
+  assert (vecw->size == idim);
+  
+  unsigned int nred = keptrows.size();
+  unsigned int nu = elimrows.size();
+  assert (Sred && Sred->size1 == nu && Sred->size2 == nred);
+  assert (yred && yred->size == nred);
+  assert (yredscal && yredscal->size == nred);
+  assert (ered && ered->size == nred);
+  assert (dxredscal && dxredscal->size == nred);
+  
+  // The full variables are T*(reduced variables), where T is the unit matrix for the 
+  // kept variables, S = -A_pu^-1 A_pK for the eliminated parameters and 0 for the 
+  // eliminated lambdas; the reduced system is T^T M T dxred = T^T y
+  
+  const double *m = MatM->data;
+  size_t tda = MatM->tda;
+  
+  gsl_matrix_set_zero (Sred);
+  for (unsigned int k = 0; k < eliminations.size(); ++k) {
+    const int *iu = &elimrows[3*k];
+    const int *kp = &elimcons[3*k];
+    double A[3][3], Ainv[3][3];
+    for (int d = 0; d < 3; ++d) {
+      for (int j = 0; j < 3; ++j) A[d][j] = m[kp[d]*tda + iu[j]];
+    }
+    if (!invert3 (A, Ainv)) return -1;
+    for (unsigned int r = 0; r < nred; ++r) {
+      int kr = keptrows[r];
+      if (kr >= npar) continue;
+      for (int j = 0; j < 3; ++j) {
+        double s = 0;
+        for (int d = 0; d < 3; ++d) s -= Ainv[j][d]*m[kp[d]*tda + kr];
+        gsl_matrix_set (Sred, 3*k+j, r, s);
+      }
+    }
+  }
+  const double *s = Sred->data;
+  size_t tdas = Sred->tda;
+  
+  // B = M T
+  gsl_matrix_view B     (gsl_matrix_submatrix (M1, 0, 0, idim, nred));
+  double *b = B.matrix.data;
+  size_t tdab = B.matrix.tda;
+  for (unsigned int i = 0; i < idim; ++i) {
+    for (unsigned int r = 0; r < nred; ++r) {
+      double sum = m[i*tda + keptrows[r]];
+      for (unsigned int j = 0; j < nu; ++j) sum += m[i*tda + elimrows[j]]*s[j*tdas + r];
+      b[i*tdab + r] = sum;
+    }
+  }
+  
+  // Mred = T^T B, yred = T^T y
+  gsl_matrix_view Mred     (gsl_matrix_submatrix (M2, 0, 0, nred, nred));
+  gsl_matrix_view Mredscal (gsl_matrix_submatrix (M3, 0, 0, nred, nred));
+  for (unsigned int r = 0; r < nred; ++r) {
+    for (unsigned int q = 0; q < nred; ++q) {
+      double sum = b[keptrows[r]*tdab + q];
+      for (unsigned int j = 0; j < nu; ++j) sum += s[j*tdas + r]*b[elimrows[j]*tdab + q];
+      gsl_matrix_set (&Mred.matrix, r, q, sum);
+    }
+    double sum = gsl_vector_get (vecy, keptrows[r]);
+    for (unsigned int j = 0; j < nu; ++j) sum += s[j*tdas + r]*gsl_vector_get (vecy, elimrows[j]);
+    gsl_vector_set (yred, r, sum);
+    gsl_vector_set (ered, r, gsl_vector_get (vece, keptrows[r]));
+  }
+  
+  linalg->scaleSym (&Mredscal.matrix, &Mred.matrix, ered);
+  gsl_vector_memcpy (yredscal, yred);
+  gsl_vector_mul (yredscal, ered);
+  
+  gsl_matrix_view Wred  (gsl_matrix_submatrix (MatW, 0, 0, nred, nred));
+  gsl_matrix_view W2red (gsl_matrix_submatrix (MatW2, 0, 0, nred, nred));
+  gsl_vector_view wred  (gsl_vector_subvector (vecw, 0, nred));
+  int result = solveSystem (dxredscal, detW, yredscal, &Mredscal.matrix, &Wred.matrix, &W2red.matrix, &wred.vector, epsLU, epsSV);
+  if (result < 0) return result;
+  
+  // dxscal = (T*dxred)/e
+  gsl_vector_mul (dxredscal, ered);
+  gsl_vector_set_zero (vecdxscal);
+  for (unsigned int r = 0; r < nred; ++r) {
+    gsl_vector_set (vecdxscal, keptrows[r], gsl_vector_get (dxredscal, r));
+  }
+  for (unsigned int j = 0; j < nu; ++j) {
+    double sum = 0;
+    for (unsigned int r = 0; r < nred; ++r) sum += s[j*tdas + r]*gsl_vector_get (dxredscal, r);
+    gsl_vector_set (vecdxscal, elimrows[j], sum);
+  }
+  gsl_vector_div (vecdxscal, vece);
+  
+  return result;
+}
+
+int NewFitterGSL::calcTrustRegionDx (      bool& converged,
+                                           gsl_vector *vecxnew, 
+                                           gsl_vector *vecx, 
+                                           gsl_vector *vecdx, 
+                                           gsl_vector *vecdxscal, 
+                                     const gsl_vector *vece,      
+                                           gsl_matrix *MatM, 
+                                           gsl_matrix *MatMscal,  
+                                           gsl_vector *vecy, 
+                                           gsl_vector *vecyscal, 
+                                           gsl_matrix *MatW, 
+                                           gsl_matrix *MatW2, 
+                                           gsl_matrix *MatW3, 
+                                           gsl_vector *vecw1,
+                                           gsl_vector *vecw2,
+                                           gsl_permutation *permW
+                                    ) {
+  assert (vecxnew);
+  assert (vecxnew->size == idim);
+  assert (vecx);
+  assert (vecx->size == idim);
+  assert (vecdx);
+  assert (vecdx->size == idim);
+  assert (vecdxscal);
+  assert (vecdxscal->size == idim);
+  assert (vece);
+  assert (vece->size == idim);
+  assert (MatM);
+  assert (MatM->size1 == idim && MatM->size2 == idim);
+  assert (MatMscal);
+  assert (MatMscal->size1 == idim && MatMscal->size2 == idim);
+  assert (vecy);
+  assert (vecy->size == idim);
+  assert (vecyscal);
+  assert (vecyscal->size == idim);
+  assert (MatW);
+  assert (MatW->size1 == idim && MatW->size2 == idim);
+  assert (MatW2);
+  assert (MatW2->size1 == idim && MatW2->size2 == idim);
+  assert (MatW3);
+  assert (MatW3->size1 == idim && MatW3->size2 == idim);
+  assert (vecw1);
+  assert (vecw1->size == idim);
+  assert (vecw2);
+  assert (vecw2->size == idim);
+  assert (permW);
+  assert (permW->size == idim);
+  
+  converged = false;
+  
+  FitProfileTimer tassembleM (profile, FitProfile::ASSEMBLEM);
+  assembleM (MatM, vecx);
+  tassembleM.stop();
+  if (!isfinite (MatM)) return 1;
+  
+  FitProfileTimer tassembley (profile, FitProfile::ASSEMBLEY);
+  assembley (vecy, vecx);
+  tassembley.stop();
+  if (!isfinite (vecy)) return 2;
+  
+  if (!eliminations.empty()) adjustEliminatedLambdas (vecx, MatM, vecy);
+  
+  scaleM  (MatMscal, MatM, vece);
+  scaley (vecyscal, vecy, vece);
+  
+  // The decomposition of A and the reduced Hessian are the same for all trial steps
+  FitProfileTimer tsolve (profile, FitProfile::SOLVESYSTEM);
+  int rankA = 0;
+  if (decomposeConstDer (rankA, MatW, MatMscal, vecw1, vecw2, permW, 1E-12)) return 3;
+  int nz = npar - rankA;
+  if (nz > 0) {
+    gsl_matrix_const_view G (gsl_matrix_const_submatrix (MatMscal, 0, 0, npar, npar));
+    gsl_matrix_view Z     (gsl_matrix_submatrix (MatW, 0, rankA, npar, nz));
+    gsl_matrix_view GZ    (gsl_matrix_submatrix (MatW2, 0, 0, npar, nz));
+    gsl_matrix_view Hred  (gsl_matrix_submatrix (MatW3, 0, 0, nz, nz));
+    linalg->dsymm (CblasLeft, CblasUpper, 1, &G.matrix, &Z.matrix, 0, &GZ.matrix);
+    linalg->dgemm (CblasTrans, CblasNoTrans, 1, &Z.matrix, &GZ.matrix, 0, &Hred.matrix);
+  }
+  tsolve.stop();
+  
+  FitProfileTimer tlinesearch (profile, FitProfile::LINESEARCH);
+  
+  // merit function at vecx; the parameters are still set to vecx
+  double chi20 = calcChi2();
+  double cnorm0 = meritConstraintNorm (vecy, vece);
+  gsl_vector_const_view yx     (gsl_vector_const_subvector (vecy, 0, npar));
+  gsl_vector_const_view p      (gsl_vector_const_subvector (vecdx, 0, npar));
+  gsl_vector_const_view pscal  (gsl_vector_const_subvector (vecdxscal, 0, npar));
+  gsl_matrix_const_view AT     (gsl_matrix_const_submatrix (MatM, 0, npar, npar, ncon));
+  gsl_vector_view cnew         (gsl_vector_subvector (vecw2, npar, ncon));
+  double radius0 = trradius;
+  double eta = 0.01;
+  double rho = 0.1;
+  
+  for (int itry = 0; ; ++itry) {
+    if (!(trradius > 0)) return 4;
+    
+    solveTrustRegion (vecdxscal, trradius, rankA, vecyscal, MatMscal, MatW, MatW3, vecw1, vecw2, permW);
+    gsl_vector_memcpy (vecdx, vecdxscal);
+    gsl_vector_mul (vecdx, vece);
+    double pnorm = linalg->dnrm2 (&pscal.vector);
+    
+    if (itry == 0 && pnorm < 0.5*trradius && linalg->dasum (vecdxscal) < 1E-6*idim) {
+      converged = true;
+      return 0;
+    }
+    
+    // Quadratic model of chi2: grad(chi2)^T p + 1/2 p^T L p, with grad(chi2) = y - A^T lambda,
+    // and the l1 norm of the linearised constraints c + A p
+    gsl_vector_set_zero (vecw2);
+    for (int k = npar; k < (int)idim; ++k) gsl_vector_set (vecw2, k, gsl_vector_get (vecy, k));
+    if (ncon > 0) linalg->dgemv (CblasTrans, 1, &AT.matrix, &p.vector, 1, &cnew.vector);
+    double gradfTp = linalg->ddot (&yx.vector, &p.vector);
+    for (int k = npar; k < (int)idim; ++k) 
+      gradfTp -= gsl_vector_get (vecx, k)*(gsl_vector_get (vecw2, k) - gsl_vector_get (vecy, k));
+    double pTLp = calcpTLp (vecdx, MatM, vecw1);
+    double dchi2pred = gradfTp + 0.5*pTLp;
+    double dcnorm = cnorm0 - meritConstraintNorm (vecw2, vece);
+    
+    // Penalty parameter, Nocedal&Wright Eq. (18.36); it never decreases during a fit
+    if (dcnorm > 0 && dchi2pred > 0) trmu = std::max (trmu, dchi2pred/((1-rho)*dcnorm));
+    double pred = trmu*dcnorm - dchi2pred;
+    if (!(pred > 0)) {
+      // no decrease of the model is possible: we are at a stationary point
+      if (debug > 2) cout << "NewFitterGSL::calcTrustRegionDx: predicted reduction " << pred << endl;
+      converged = true;
+      return 0;
+    }
+    
+    double phi0 = chi20 + trmu*cnorm0;
+    add (vecxnew, vecx, 1, vecdx);
+    updateParams (vecxnew);
+    double phi = meritFunction (trmu, vecxnew, vece);
+    double ratio = (phi0 - phi)/pred;
+    
+#ifndef FIT_TRACEOFF
+    traceValues.set (TraceValues::ALPHA, trradius/radius0);
+    traceValues.set (TraceValues::PHI, phi);
+    traceValues.set (TraceValues::MU, trmu);
+    if (tracer) tracer->substep (*this, 0);
+#endif   
+    
+    if (debug > 2) {
+      cout << "NewFitterGSL::calcTrustRegionDx: radius=" << trradius << ", |p|=" << pnorm 
+           << ", phi0=" << phi0 << ", phi=" << phi << ", pred=" << pred 
+           << ", ratio=" << ratio << endl;
+    }
+    
+    // Near the solution, the curvature of the constraints may lead to the
+    // rejection of good steps (Maratos effect): try the 2nd order correction
+    if (!(ratio >= eta) && try2ndOrderCorr) {
+      if (profile) profile->count (FitProfile::SECONDORDERTRIED);
+      calc2ndOrderCorr (vecw1, vecxnew, MatM, MatW2, vecw2);
+      add (vecxnew, vecxnew, 1, vecw1);
+      updateParams (vecxnew);
+      double phi2ndOrder = meritFunction (trmu, vecxnew, vece);
+      if (debug > 2) 
+        cout << "NewFitterGSL::calcTrustRegionDx: tried 2nd order correction, phi2ndOrder = " 
+             << phi2ndOrder << endl;
+      if ((phi0 - phi2ndOrder)/pred >= eta) {
+        if (profile) profile->count (FitProfile::SECONDORDEROK);
+        ratio = (phi0 - phi2ndOrder)/pred;
+      }
+    }
+    
+    if (ratio >= eta) {
+      if (ratio > 0.75 && pnorm > 0.8*trradius) trradius *= 2;
+      else if (ratio < 0.25) trradius = 0.25*pnorm;
+      return 0;
+    }
+    
+    ++nrejected;
+    if (profile) profile->count (FitProfile::STEPCUTS);
+    
+    // no time for another trial step: fit() goes back to the best iterate
+    if (budgetExhausted()) return 0;
+    
+    if (pnorm < 1E-6) {
+      // The merit function is not continuous here, e.g. because a parameter was
+      // mirrored by updateParams: as in doLineSearch for dphi0 >= 0, take the minimal 
+      // step anyway, and start again with the initial radius
+      if (debug > 1) cout << "NewFitterGSL::calcTrustRegionDx: trust region collapsed, |p|=" << pnorm << endl;
+      trradius = trradius0;
+      return 0;
+    }
+    trradius = 0.25*pnorm;
+  }
+  return 0;
+}
+
+void NewFitterGSL::solveTrustRegion (      gsl_vector *vecdxscal, 
+                                           double radius,
+                                           int rankA,
+                                     const gsl_vector *vecyscal, 
+                                     const gsl_matrix *MatMscal,  
+                                     const gsl_matrix *MatW,   
+                                     const gsl_matrix *MatW3,   
+                                           gsl_vector *vecw1,
+                                           gsl_vector *vecw2,
+                                     const gsl_permutation *permW) {
+  assert (vecdxscal);
+  assert (vecdxscal->size == idim);
+  assert (vecyscal);
+  assert (vecyscal->size == idim);
+  assert (MatMscal);
+  assert (MatMscal->size1 == idim && MatMscal->size2 == idim);
+  assert (MatW);
+  assert (MatW->size1 == idim && MatW->size2 == idim);
+  assert (MatW3);
+  assert (MatW3->size1 == idim && MatW3->size2 == idim);
+  assert (vecw1);
+  assert (vecw1->size == idim);
+  assert (vecw2);
+  assert (vecw2->size == idim);
+  assert (permW);
+  assert (permW->size == idim);
+  assert (Wcg && Wcg->size1 == 3 && Wcg->size2 == idim);
+  
+  // Byrd-Omojokun step p = Y*uY + Z*uZ, with A^T P = Q R = (Y Z) (R1)
+  //                                                              (0 )
+  // - normal step:      R11^T uY = -(P^T c), shortened to |uY| <= 0.8*radius
+  // - tangential step:  minimise uZ^T Z^T (y + G Y uY) + 1/2 uZ^T (Z^T G Z) uZ 
+  //                     for |uZ| <= sqrt (radius^2 - |uY|^2), with Steihaug's CG method
+  // - multipliers:      R11 P^T dl = -Y^T (y + G p)
+  
+  int nz = npar - rankA;
+  const size_t *perm = permW->data;
+  
+  gsl_matrix_const_view G (gsl_matrix_const_submatrix (MatMscal, 0, 0, npar, npar));
+  gsl_vector_const_view yx (gsl_vector_const_subvector (vecyscal, 0, npar));
+  gsl_matrix_const_view Q  (gsl_matrix_const_submatrix (MatW, 0, 0, npar, npar));
+  gsl_vector_view px       (gsl_vector_subvector (vecdxscal, 0, npar));
+  gsl_vector_view u        (gsl_vector_subvector (vecw1, 0, npar));
+  gsl_vector_view w        (gsl_vector_subvector (vecw2, 0, npar));
+  
+  gsl_vector_set_zero (vecdxscal);
+  gsl_vector_set_zero (vecw1);
+  
+  double unorm2 = 0;
+  if (rankA > 0) {
+    gsl_matrix_const_view R11 (gsl_matrix_const_submatrix (MatW, 0, npar, rankA, rankA));
+    gsl_matrix_const_view Y   (gsl_matrix_const_submatrix (MatW, 0, 0, npar, rankA));
+    gsl_vector_view uY        (gsl_vector_subvector (vecw1, 0, rankA));
+    for (int i = 0; i < rankA; ++i) gsl_vector_set (&uY.vector, i, -gsl_vector_get (vecyscal, npar + perm[i]));
+    linalg->dtrsv (CblasUpper, CblasTrans, CblasNonUnit, &R11.matrix, &uY.vector);
+    double uYnorm = linalg->dnrm2 (&uY.vector);
+    if (uYnorm > 0.8*radius) {
+      linalg->dscal (0.8*radius/uYnorm, &uY.vector);
+      uYnorm = 0.8*radius;
+    }
+    unorm2 = uYnorm*uYnorm;
+    // px = Y*uY
+    linalg->dgemv (CblasNoTrans, 1, &Y.matrix, &uY.vector, 0, &px.vector);
+  }
+  
+  if (nz > 0) {
+    gsl_matrix_const_view Z    (gsl_matrix_const_submatrix (MatW, 0, rankA, npar, nz));
+    gsl_matrix_const_view Hred (gsl_matrix_const_submatrix (MatW3, 0, 0, nz, nz));
+    gsl_vector_view uZ (gsl_vector_subvector (vecw1, rankA, nz));
+    gsl_vector_view r  = gsl_vector_view_array (gsl_matrix_ptr (Wcg, 0, 0), nz);
+    gsl_vector_view d  = gsl_vector_view_array (gsl_matrix_ptr (Wcg, 1, 0), nz);
+    gsl_vector_view Hd = gsl_vector_view_array (gsl_matrix_ptr (Wcg, 2, 0), nz);
+    gsl_vector_view ut (gsl_vector_subvector (vecw2, 0, nz));
+    double radiusZ2 = radius*radius - unorm2;
+    
+    // r = Z^T (y + G px)
+    gsl_vector_memcpy (&w.vector, &yx.vector);
+    linalg->dsymv (CblasUpper, 1, &G.matrix, &px.vector, 1, &w.vector);
+    linalg->dgemv (CblasTrans, 1, &Z.matrix, &w.vector, 0, &r.vector);
+    gsl_vector_memcpy (&d.vector, &r.vector);
+    linalg->dscal (-1, &d.vector);
+    double rr = linalg->ddot (&r.vector, &r.vector);
+    double rrmin = 1E-20*rr;
+    
+    for (int icg = 0; icg < 2*nz && rr > rrmin; ++icg) {
+      linalg->dsymv (CblasUpper, 1, &Hred.matrix, &d.vector, 0, &Hd.vector);
+      double dHd = linalg->ddot (&d.vector, &Hd.vector);
+      double alpha = (dHd > 0) ? rr/dHd : 0;
+      // stop at the boundary for negative curvature or too long steps
+      gsl_vector_memcpy (&ut.vector, &uZ.vector);
+      if (dHd > 0) linalg->daxpy (alpha, &d.vector, &ut.vector);
+      if (dHd <= 0 || linalg->ddot (&ut.vector, &ut.vector) >= radiusZ2) {
+        double dd = linalg->ddot (&d.vector, &d.vector);
+        double ud = linalg->ddot (&uZ.vector, &d.vector);
+        double uu = linalg->ddot (&uZ.vector, &uZ.vector);
+        double tau = (-ud + std::sqrt (std::max (0., ud*ud + dd*(radiusZ2 - uu))))/dd;
+        linalg->daxpy (tau, &d.vector, &uZ.vector);
+        break;
+      }
+      linalg->dcopy (&ut.vector, &uZ.vector);
+      linalg->daxpy (alpha, &Hd.vector, &r.vector);
+      double rrnew = linalg->ddot (&r.vector, &r.vector);
+      linalg->dscal (rrnew/rr, &d.vector);
+      linalg->daxpy (-1, &r.vector, &d.vector);
+      rr = rrnew;
+    }
+    // px = Q*u
+    linalg->dgemv (CblasNoTrans, 1, &Q.matrix, &u.vector, 0, &px.vector);
+  }
+  
+  if (rankA > 0) {
+    gsl_matrix_const_view R11 (gsl_matrix_const_submatrix (MatW, 0, npar, rankA, rankA));
+    gsl_matrix_const_view Y   (gsl_matrix_const_submatrix (MatW, 0, 0, npar, rankA));
+    gsl_vector_view lY        (gsl_vector_subvector (vecw1, 0, rankA));
+    // lY = -Y^T (y + G px)
+    gsl_vector_memcpy (&w.vector, &yx.vector);
+    linalg->dsymv (CblasUpper, 1, &G.matrix, &px.vector, 1, &w.vector);
+    linalg->dgemv (CblasTrans, -1, &Y.matrix, &w.vector, 0, &lY.vector);
+    linalg->dtrsv (CblasUpper, CblasNoTrans, CblasNonUnit, &R11.matrix, &lY.vector);
+    for (int i = 0; i < rankA; ++i) gsl_vector_set (vecdxscal, npar + perm[i], gsl_vector_get (&lY.vector, i));
+  }
+}
+
+double NewFitterGSL::meritConstraintNorm (const gsl_vector *vecc, const gsl_vector *vece) {
+  assert (vecc);
+  assert (vecc->size == idim);
+  assert (vece);
+  assert (vece->size == idim);
+  
+  double result = 0;
+  for (int kglobal = npar; kglobal < npar+ncon; ++kglobal) {
+    switch (imerit) {
+      case 1: result += std::fabs (gsl_vector_get (vecc, kglobal)); break;
+      case 2: result += std::fabs (gsl_vector_get (vecc, kglobal)*gsl_vector_get (vece, kglobal)); break;
+      default: assert (0);
+    }
+  }
+  return result;
+}
+
+int NewFitterGSL::calcLevenbergMarquardtDx (      bool& converged,
+                                                  gsl_vector *vecxnew, 
+                                                  gsl_vector *vecx, 
+                                                  gsl_vector *vecdx, 
+                                                  gsl_vector *vecdxscal, 
+                                            const gsl_vector *vece,      
+                                                  gsl_matrix *MatM, 
+                                                  gsl_matrix *MatMscal,  
+                                                  gsl_vector *vecy, 
+                                                  gsl_vector *vecyscal, 
+                                                  gsl_matrix *MatW
+                                           ) {
+  assert (vecxnew);
+  assert (vecxnew->size == idim);
+  assert (vecx);
+  assert (vecx->size == idim);
+  assert (vecdx);
+  assert (vecdx->size == idim);
+  assert (vecdxscal);
+  assert (vecdxscal->size == idim);
+  assert (vece);
+  assert (vece->size == idim);
+  assert (MatM);
+  assert (MatM->size1 == idim && MatM->size2 == idim);
+  assert (MatMscal);
+  assert (MatMscal->size1 == idim && MatMscal->size2 == idim);
+  assert (vecy);
+  assert (vecy->size == idim);
+  assert (vecyscal);
+  assert (vecyscal->size == idim);
+  assert (MatW);
+  assert (MatW->size1 == idim && MatW->size2 == idim);
+  assert (ncon == 0);
+  
+  converged = false;
+  
+  FitProfileTimer tassembleM (profile, FitProfile::ASSEMBLEM);
+  assembleM (MatM, vecx);
+  tassembleM.stop();
+  if (!isfinite (MatM)) return 1;
+  
+  FitProfileTimer tassembley (profile, FitProfile::ASSEMBLEY);
+  assembley (vecy, vecx);
+  tassembley.stop();
+  if (!isfinite (vecy)) return 2;
+  
+  scaleM  (MatMscal, MatM, vece);
+  scaley (vecyscal, vecy, vece);
+  
+  // Solve (Mscal + lmlambda*1) dxscal = -yscal; lmlambda is adapted to the ratio
+  // of actual to predicted reduction of chi2, see Madsen, Nielsen, Tingleff,
+  // "Methods for Non-Linear Least Squares Problems", Eq. (2.21)
+  double hmax = 0;
+  for (unsigned int i = 0; i < idim; ++i) hmax = std::max (hmax, gsl_matrix_get (MatMscal, i, i));
+  if (hmax <= 0) hmax = 1;
+  if (lmlambda == 0) lmlambda = 1E-6*hmax;
+  
+  // the parameters are still set to vecx
+  double chi20 = calcChi2();
+  
+  for (int itry = 0; itry < 50; ++itry) {
+    FitProfileTimer tsolve (profile, FitProfile::SOLVESYSTEM);
+    gsl_matrix_memcpy (MatW, MatMscal);
+    for (unsigned int i = 0; i < idim; ++i) *gsl_matrix_ptr (MatW, i, i) += lmlambda;
+    gsl_error_handler_t *old_handler =  gsl_set_error_handler_off ();
+    int cholesky_result = linalg->choleskyDecomp (MatW);
+    gsl_set_error_handler (old_handler);
+    if (cholesky_result) {
+      if (profile) profile->count (FitProfile::CHOLESKYFAILED);
+      lmlambda *= lmnu;
+      lmnu *= 2;
+      continue;
+    }
+    linalg->choleskySolve (MatW, vecyscal, vecdxscal);
+    linalg->dscal (-1, vecdxscal);
+    tsolve.stop();
+    
+    gsl_vector_memcpy (vecdx, vecdxscal);
+    gsl_vector_mul (vecdx, vece);
+    
+    if (itry == 0 && lmlambda < hmax && linalg->dasum (vecdxscal) < 1E-6*idim) {
+      converged = true;
+      return 0;
+    }
+    
+    // predicted reduction -(y^T dx + 1/2 dx^T M dx) = 1/2 dxscal^T (lmlambda*dxscal - yscal)
+    double pred = 0.5*(lmlambda*linalg->ddot (vecdxscal, vecdxscal) - linalg->ddot (vecdxscal, vecyscal));
+    
+    add (vecxnew, vecx, 1, vecdx);
+    updateParams (vecxnew);
+    double chi2trial = calcChi2();
+    double ratio = (chi20 - chi2trial)/pred;
+    
+#ifndef FIT_TRACEOFF
+    traceValues.set (TraceValues::ALPHA, 1);
+    traceValues.set (TraceValues::PHI, chi2trial);
+    if (tracer) tracer->substep (*this, 0);
+#endif   
+    
+    if (debug > 2) {
+      cout << "NewFitterGSL::calcLevenbergMarquardtDx: lambda=" << lmlambda 
+           << ", chi2=" << chi20 << " -> " << chi2trial << ", pred=" << pred 
+           << ", ratio=" << ratio << endl;
+    }
+    
+    if (pred > 0 && ratio > 0) {
+      double r = 2*ratio - 1;
+      lmlambda *= std::max (1./3., 1 - r*r*r);
+      lmnu = 2;
+      return 0;
+    }
+    
+    ++nrejected;
+    if (profile) profile->count (FitProfile::STEPCUTS);
+    lmlambda *= lmnu;
+    lmnu *= 2;
+    
+    // no time for another trial step: fit() goes back to the best iterate
+    if (budgetExhausted()) return 0;
+  }
+  return 3;
+}
+
 gsl_matrix_view NewFitterGSL::calcZ (int& rankA, gsl_matrix *MatW1,  gsl_matrix *MatW2, 
                                      gsl_vector *vecw1, gsl_vector *vecw2, 
                                      gsl_permutation *permW, double eps) {
@@ -1821,21 +2931,10 @@ gsl_matrix_view NewFitterGSL::calcZ (int& rankA, gsl_matrix *MatW1,  gsl_matrix
   // fill A and AT
   assembleConstDer (MatW2);                    
                           
-  gsl_matrix_const_view AT (gsl_matrix_const_submatrix (MatW2, 0,    0,    npar, npar));
-  //gsl_matrix_view QR       (gsl_matrix_submatrix       (MatW2, 0,    0,    npar, npar));
-  gsl_matrix_view Q        (gsl_matrix_submatrix       (MatW1, 0,    0,    npar, npar));
-  gsl_matrix_view R        (gsl_matrix_submatrix       (MatW1, npar, 0,    ncon, npar));
-
-  int signum = 0;
-  //gsl_linalg_QRPT_decomp   (&QR.matrix, vecw1, permW, &signum, vecw2);
-  //gsl_linalg_QR_unpack     (&QR.matrix, vecw1, &Q.matrix, &R.matrix);
-  gsl_linalg_QRPT_decomp2 (&AT.matrix, &Q.matrix, &R.matrix, vecw1, permW, &signum, vecw2); 
-
-  rankA = 0;
-  for (int i = 0; i < ncon; ++i) {
-    if (fabs(gsl_matrix_get (&R.matrix, i, i)) > eps) rankA++;
-  }
-  gsl_matrix_view result = gsl_matrix_view (gsl_matrix_submatrix       (MatW1, 0, rankA, ncon-rankA, npar));
+  decomposeConstDer (rankA, MatW1, MatW2, vecw1, vecw2, permW, eps);
+  
+  // Z: the last npar-rankA columns of Q
+  gsl_matrix_view result = gsl_matrix_view (gsl_matrix_submatrix       (MatW1, 0, rankA, npar, npar-rankA));
   return result;
 }
 
@@ -1875,9 +2974,9 @@ gsl_matrix_view NewFitterGSL::calcReducedHessian (int& rankH, gsl_matrix *MatW1,
   // Calculate Z^T G Z
   
   // GZ = 1*G*Z + 0*GZ
-  gsl_blas_dsymm (CblasLeft, CblasUpper, 1, &G.matrix, &Z.matrix, 0, &GZ.matrix);
+  linalg->dsymm (CblasLeft, CblasUpper, 1, &G.matrix, &Z.matrix, 0, &GZ.matrix);
   // ZGZ = 1*Z^T*GZ + 0*ZGZ
-  gsl_blas_dgemm (CblasTrans, CblasNoTrans, 1, &Z.matrix, &GZ.matrix, 0, &ZGZ.matrix);
+  linalg->dgemm (CblasTrans, CblasNoTrans, 1, &Z.matrix, &GZ.matrix, 0, &ZGZ.matrix);
 
   return ZGZ;
 }
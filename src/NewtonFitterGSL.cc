@@ -58,6 +58,8 @@
 #include "BaseHardConstraint.h"
 #include "BaseSoftConstraint.h"
 #include "BaseTracer.h"
+#include "FitProfile.h"
+#include "LinAlgBackend.h"
 
 #include <gsl/gsl_block.h>
 #include <gsl/gsl_vector.h>
@@ -73,8 +75,8 @@ using std::endl;
 using std::abs;
 
 static int nitdebug = 100;
-static int nitcalc = 0;
-static int nitsvd = 0;
+// static int nitcalc = 0;
+// static int nitsvd = 0;
 
 // constructor
 NewtonFitterGSL::NewtonFitterGSL() 
@@ -84,7 +86,7 @@ NewtonFitterGSL::NewtonFitterGSL()
     perr(0), v1 (0), v2(0), Meval (0),
     M(0), Mscal (0), M1(0), M2 (0), M3 (0), M4 (0), M5 (0), Mevec (0), 
     CC (0), CC1 (0), CCinv (0), permM(0), ws(0),
-    wsdim(0), chi2best(0),
+    wsdim(0), evecvalid (false), chi2best(0),
     chi2new(0),
     chi2old(0),
     fvalbest(0),scale(0),scalebest(0),stepsize(0),stepbest(0),
@@ -126,8 +128,12 @@ NewtonFitterGSL::~NewtonFitterGSL() {
 
 double NewtonFitterGSL::fit() {
 
+  seedStartValues();
+  
   // order parameters etc
+  FitProfileTimer tinit (profile, FitProfile::INITIALIZE);
   initialize();
+  tinit.stop();
   
   // initialize eta, etasv, y   
   assert (x && x->size == idim);
@@ -239,11 +245,15 @@ double NewtonFitterGSL::fit() {
     fillperr();    
  
     // Compose M:
+    FitProfileTimer tassembleM (profile, FitProfile::ASSEMBLEM);
     calcM(); 
+    tassembleM.stop();
     
     // Now, calculate the result vector y with the values of the derivatives
     // d chi^2/d x
+    FitProfileTimer tassembley (profile, FitProfile::ASSEMBLEY);
     calcy();
+    tassembley.stop();
 
     if (debug>3 && (nit==0 || nit<nitdebug)) {
       cout << "After setting up equations: \n";
@@ -257,7 +267,7 @@ double NewtonFitterGSL::fit() {
     }
     
     scalevals[0] = 0;
-    fvals[0] = 0.5*pow (gsl_blas_dnrm2 (yscal), 2);
+    fvals[0] = 0.5*pow (linalg->dnrm2 (yscal), 2);
     fvalbest = fvals[0];
     stepsize = 0;
     scalebest = 0;
@@ -327,7 +337,9 @@ double NewtonFitterGSL::fit() {
 
   if (!ierr) {
 
+    FitProfileTimer tcov (profile, FitProfile::COVMATRIX);
     calcCovMatrix();  
+    tcov.stop();
 
     // update errors in fitobjects
     for (unsigned int ifitobj = 0; ifitobj < fitobjects.size(); ++ifitobj) {
@@ -373,6 +385,12 @@ double NewtonFitterGSL::fit() {
   }
 
   if (ierr > 0) fitprob = -1;
+  
+  if (profile) {
+    profile->count (FitProfile::FITS);
+    profile->count (FitProfile::ITERATIONS, nit);
+    if (ierr) profile->count (FitProfile::FAILEDFITS);
+  }
 
   return fitprob;
     
@@ -453,6 +471,7 @@ bool NewtonFitterGSL::initialize() {
   }
   if (ws == 0) ws = gsl_eigen_symmv_alloc (idim); 
   wsdim = idim;
+  evecvalid = false;
  
   return true;
 
@@ -489,7 +508,7 @@ int NewtonFitterGSL::getIterations() const {return nit;}
 
 int NewtonFitterGSL::calcDx () {
     if (debug>1)cout << "entering calcDx" << endl;
-    nitcalc++;
+    // nitcalc++;
     // from x_(n+1) = x_n - y/y' = x_n - M^(-1)*y we have M*(x_n-x_(n+1)) = y, 
     // which we solve for dx = x_n-x_(n+1) and hence x_(n+1) = x_n-dx
   
@@ -501,18 +520,21 @@ int NewtonFitterGSL::calcDx () {
     int ifail = 0;
     
     int signum;
-    int result = gsl_linalg_LU_decomp (M1, permM, &signum);
+    FitProfileTimer tsolve (profile, FitProfile::SOLVESYSTEM);
+    int result = linalg->LUDecomp (M1, permM, &signum);
     if (debug>1)cout << "calcDx: gsl_linalg_LU_decomp result=" << result << endl;
     // Solve M1*dx = y
-    ifail = gsl_linalg_LU_solve (M1, permM, yscal, dxscal);
+    ifail = linalg->LUSolve (M1, permM, yscal, dxscal);
+    tsolve.stop();
     if (debug>1)cout << "calcDx: gsl_linalg_LU_solve result=" << ifail << endl;
     
     if (ifail != 0) {
       cerr << "NewtonFitter::calcDx: ifail from gsl_linalg_LU_solve=" << ifail << endl;
+      if (profile) profile->count (FitProfile::SOLVESVD);
       return calcDxSVD ();
       return -1;
     }
-    stepsize=std::abs(gsl_vector_get (dxscal, gsl_blas_idamax (dxscal)));
+    stepsize=std::abs(gsl_vector_get (dxscal, linalg->idamax (dxscal)));
 
     // dx = dxscal*perr (component wise)
     gsl_vector_memcpy (dx, dxscal);
@@ -523,20 +545,24 @@ int NewtonFitterGSL::calcDx () {
     gsl_vector_memcpy (xbest, xold);
     chi2best = chi2old;
     
+    FitProfileTimer tlinesearch (profile, FitProfile::LINESEARCH);
     optimizeScale();
+    tlinesearch.stop();
     
     if (scalebest < 0.01) {
       if (debug > 1) cout << "NewtonFitter::calcDx: reverting to calcDxSVD\n";
+      if (profile) profile->count (FitProfile::SOLVESVD);
       return calcDxSVD ();
     }
         
+    if (profile) profile->count (FitProfile::SOLVELU);
     return 0;
 }
 
 int NewtonFitterGSL::calcDxSVD () {
     //cout << "entering calcDxSVD" << endl;
 
-    nitsvd++;
+    // nitsvd++;
     // from x_(n+1) = x_n - y/y' = x_n - M^(-1)*y we have M*(x_n-x_(n+1)) = y, 
     // which we solve for dx = x_n-x_(n+1) and hence x_(n+1) = x_n-dx
   
@@ -545,19 +571,8 @@ int NewtonFitterGSL::calcDxSVD () {
 //     cout << "Complete system:\n";
 //     printMy(M, y, idim);
      // Get eigenvalues and eigenvectors of Mscal
-     int ierr=0;
-     gsl_matrix_memcpy (M1, Mscal);
-     if (debug > 3) cout << "NewtonFitterGSL::calcDxSVD: Calling gsl_eigen_symmv" << endl;
-     ierr = gsl_eigen_symmv (M1, Meval, Mevec, ws); 
-     if (debug > 3) cout << "NewtonFitterGSL::calcDxSVD: result of gsl_eigen_symmv: " << ierr << endl;
-     if (ierr != 0) {
-       cerr << "NewtonFitter::calcDxSVD: ierr=" << ierr << "from gsl_eigen_symmv!\n";
-     }
-     // Sort the eigenvalues and eigenvectors in descending order in magnitude
-     ierr = gsl_eigen_symmv_sort (Meval, Mevec, GSL_EIGEN_SORT_ABS_DESC);
-     if (ierr != 0) {
-       cerr << "NewtonFitter::calcDxSVD: ierr=" << ierr << "from gsl_eigen_symmv_sort!\n";
-     }
+     FitProfileTimer tsolve (profile, FitProfile::SOLVESYSTEM);
+     calcEigen();
      
      
      // The eigenvectors are stored in the columns of Mevec;
@@ -573,7 +588,10 @@ int NewtonFitterGSL::calcDxSVD () {
      // therefore we can restrict the calculation of Mevec * v2
      // to the first ndim rows.
      // So, we calculate v2 only once, with only the inverse of zero eigenvalues
-     // set to 0, and then calculate Mevec * v2 for fewer and fewer rows
+     // set to 0, and then calculate Mevec * v2 for fewer and fewer rows.
+     // Going from ndim to ndim-1 rows only removes the term
+     // v2[ndim-1]*Mevec[.][ndim-1], so the untruncated sum is kept in v1
+     // and updated by one column per trial
    
 //    cout << "calcDxSVD: info = " << info << endl;
 //    cout << " s = ";
@@ -596,7 +614,7 @@ int NewtonFitterGSL::calcDxSVD () {
    
    
    // Calculate v2 = 1*Mevec^T*y + 0*v2
-   gsl_blas_dgemv (CblasTrans, 1, Mevec, yscal, 0, v2);
+   linalg->dgemv (CblasTrans, 1, Mevec, yscal, 0, v2);
     
    // Divide by nonzero eigenvalues
    for (unsigned int i = 0; i<idim; ++i) {
@@ -604,20 +622,26 @@ int NewtonFitterGSL::calcDxSVD () {
      else gsl_vector_set (v2, i, 0);
    }
    
+   // Calculate v1 = 1*Mevecpart*v2part + 0*v1 for the first ndim columns
+   gsl_vector_set_zero (v1);
+   if (ndim > 0) {
+     gsl_vector_view v2part = gsl_vector_subvector (v2, 0, ndim);
+     gsl_matrix_view Mevecpart = gsl_matrix_submatrix (Mevec, 0, 0, idim, ndim);
+     linalg->dgemv (CblasNoTrans, 1, &Mevecpart.matrix, &v2part.vector, 0, v1);
+   }
+   tsolve.stop();
+   
    stepsize = 0;
       
    do { 
-     gsl_vector_view v2part = gsl_vector_subvector (v2, 0, ndim);
-     gsl_matrix_view Mevecpart = gsl_matrix_submatrix (Mevec, 0, 0, idim, ndim);
-     
-     // Calculate dx = 1*Mevecpart^T*v2 + 0*dx
-     gsl_blas_dgemv (CblasNoTrans, 1, &Mevecpart.matrix, &v2part.vector, 0, dxscal);
+     // dxscal = v1; optimizeScale may rescale dxscal, but not v1
+     gsl_vector_memcpy (dxscal, v1);
      // get maximum element
 //      for (unsigned int i = 0; i < idim; ++i) {
 //        if(std::abs(gsl_vector_get (dxscal, i))>stepsize) 
 //          stepsize=std::abs(gsl_vector_get (dxscal, i));
 //      }
-     stepsize=std::abs(gsl_vector_get (dxscal, gsl_blas_idamax (dxscal)));
+     stepsize=std::abs(gsl_vector_get (dxscal, linalg->idamax (dxscal)));
      
      // dx = dxscal*perr (component wise)
      gsl_vector_memcpy (dx, dxscal);
@@ -630,7 +654,12 @@ int NewtonFitterGSL::calcDxSVD () {
      
      optimizeScale();
      
-     --ndim;
+     if (ndim > 0) {
+       --ndim;
+       // Remove the term of column ndim: v1 = -v2[ndim]*Mevec[.][ndim] + v1
+       gsl_vector_view Meveccol = gsl_matrix_column (Mevec, ndim);
+       linalg->daxpy (-gsl_vector_get (v2, ndim), &Meveccol.vector, v1);
+     }
      
      if (debug>1 && (scalebest < 0.01 || ndim < idim-1)) {
        cout << "ndim=" << ndim << ", scalebest=" << scalebest << endl;
@@ -642,6 +671,104 @@ int NewtonFitterGSL::calcDxSVD () {
     return 0;
 }
 
+int NewtonFitterGSL::calcEigen () {
+  int ierr = 0;
+  if (evecvalid && refineEigen()) {
+    if (profile) profile->count (FitProfile::EIGENREFINED);
+  }
+  else {
+    gsl_matrix_memcpy (M1, Mscal);
+    if (debug > 3) cout << "NewtonFitterGSL::calcEigen: Calling gsl_eigen_symmv" << endl;
+    ierr = gsl_eigen_symmv (M1, Meval, Mevec, ws); 
+    if (debug > 3) cout << "NewtonFitterGSL::calcEigen: result of gsl_eigen_symmv: " << ierr << endl;
+    if (ierr != 0) {
+      cerr << "NewtonFitter::calcEigen: ierr=" << ierr << "from gsl_eigen_symmv!\n";
+    }
+  }
+  evecvalid = (ierr == 0);
+  // Sort the eigenvalues and eigenvectors in descending order in magnitude
+  int ierrsort = gsl_eigen_symmv_sort (Meval, Mevec, GSL_EIGEN_SORT_ABS_DESC);
+  if (ierrsort != 0) {
+    cerr << "NewtonFitter::calcEigen: ierr=" << ierrsort << "from gsl_eigen_symmv_sort!\n";
+  }
+  return ierr ? ierr : ierrsort;
+}
+
+bool NewtonFitterGSL::refineEigen () {
+  // Rayleigh-Ritz step: with the eigenvectors Q = Mevec of the previous Mscal,
+  // T = Q^T * Mscal * Q has the same eigenvalues as Mscal, and is almost 
+  // diagonal if Mscal has changed little. T is then diagonalized by 
+  // Jacobi rotations J, which converge after very few sweeps for an almost 
+  // diagonal matrix, and the eigenvectors of Mscal are Q*J.
+  // Returns false and leaves Mevec unchanged if T is too far from diagonal.
+  static const double maxoffdiag = 0.05;  // Max. off-diagonal norm relative to diagonal norm
+  static const double eps = 1E-12;        // Target relative off-diagonal norm
+  static const int maxsweep = 5;
+  
+  // M2 = Mscal*Q, M3 = T = Q^T*M2
+  linalg->dsymm (CblasLeft, CblasUpper, 1, Mscal, Mevec, 0, M2);
+  linalg->dgemm (CblasTrans, CblasNoTrans, 1, Mevec, M2, 0, M3);
+  
+  double *t = M3->block->data;
+  unsigned int tdat = M3->tda;
+  double diag = 0, off = 0;
+  for (unsigned int i = 0; i < idim; ++i) {
+    diag += t[i*tdat+i]*t[i*tdat+i];
+    for (unsigned int j = i+1; j < idim; ++j) off += t[i*tdat+j]*t[i*tdat+j];
+  }
+  if (debug > 3) cout << "NewtonFitterGSL::refineEigen: relative off-diagonal norm " 
+                      << (diag > 0 ? std::sqrt (2*off/diag) : 0) << endl;
+  if (!(2*off <= maxoffdiag*maxoffdiag*diag)) return false;
+  
+  // Work on a copy of Q, so that Mevec stays unchanged if the rotations fail
+  gsl_matrix_memcpy (M4, Mevec);
+  double *q = M4->block->data;
+  unsigned int tdaq = M4->tda;
+  
+  int isweep = 0;
+  while (2*off > eps*eps*diag) {
+    if (++isweep > maxsweep) return false;
+    for (unsigned int ip = 0; ip < idim; ++ip) {
+      for (unsigned int iq = ip+1; iq < idim; ++iq) {
+        double tpq = t[ip*tdat+iq];
+        if (tpq == 0) continue;
+        // Rotation angle phi that zeroes T[p][q]: cot 2phi = theta
+        double theta = (t[iq*tdat+iq] - t[ip*tdat+ip])/(2*tpq);
+        double tanphi = 1/(std::abs (theta) + std::sqrt (theta*theta + 1));
+        if (theta < 0) tanphi = -tanphi;
+        double c = 1/std::sqrt (tanphi*tanphi + 1);
+        double s = tanphi*c;
+        // T = T*J, Q = Q*J, with columns p' = c*p - s*q, q' = s*p + c*q
+        for (unsigned int k = 0; k < idim; ++k) {
+          double tkp = t[k*tdat+ip], tkq = t[k*tdat+iq];
+          t[k*tdat+ip] = c*tkp - s*tkq;
+          t[k*tdat+iq] = s*tkp + c*tkq;
+          double qkp = q[k*tdaq+ip], qkq = q[k*tdaq+iq];
+          q[k*tdaq+ip] = c*qkp - s*qkq;
+          q[k*tdaq+iq] = s*qkp + c*qkq;
+        }
+        // T = J^T*T, rows as columns above
+        for (unsigned int k = 0; k < idim; ++k) {
+          double tpk = t[ip*tdat+k], tqk = t[iq*tdat+k];
+          t[ip*tdat+k] = c*tpk - s*tqk;
+          t[iq*tdat+k] = s*tpk + c*tqk;
+        }
+        t[ip*tdat+iq] = t[iq*tdat+ip] = 0;
+      }
+    }
+    diag = off = 0;
+    for (unsigned int i = 0; i < idim; ++i) {
+      diag += t[i*tdat+i]*t[i*tdat+i];
+      for (unsigned int j = i+1; j < idim; ++j) off += t[i*tdat+j]*t[i*tdat+j];
+    }
+  }
+  if (debug > 3) cout << "NewtonFitterGSL::refineEigen: converged after " << isweep << " sweeps" << endl;
+  
+  gsl_matrix_memcpy (Mevec, M4);
+  for (unsigned int i = 0; i < idim; ++i) gsl_vector_set (Meval, i, t[i*tdat+i]);
+  return true;
+}
+
 void NewtonFitterGSL::ini_gsl_permutation (gsl_permutation *&p, unsigned int size) {
   if (p) {
     if (p->size != size) {
@@ -824,10 +951,7 @@ int NewtonFitterGSL::calcM (bool errorpropagation) {
   }  
 
   // Rescale columns and rows by perr
-  for (unsigned int i = 0; i < idim; ++i) 
-    for (unsigned int j = 0; j < idim; ++j) 
-      gsl_matrix_set (Mscal, i, j,  
-        gsl_vector_get (perr, i)*gsl_vector_get (perr, j)*gsl_matrix_get (M, i, j));
+  linalg->scaleSym (Mscal, M, perr);
 
   return 0;
 }
@@ -880,7 +1004,7 @@ int NewtonFitterGSL::optimizeScale () {
     debug_print (dxscal, "dxscal");  
   }
   scalevals[0] = 0;
-  fvals[0] = 0.5*pow (gsl_blas_dnrm2 (yscal), 2);
+  fvals[0] = 0.5*pow (linalg->dnrm2 (yscal), 2);
   if (debug > 1) {
     cout << "NewtonFitterGSL::optimizeScale: fvals[0] = " << fvals[0] << endl;
   }
@@ -890,7 +1014,7 @@ int NewtonFitterGSL::optimizeScale () {
   // = Mscal*yscal
   
   // Calculate grad = 1*Mscal*yscal + 0*grad
-  gsl_blas_dgemv (CblasNoTrans, 1, Mscal, yscal, 0, grad);
+  linalg->dgemv (CblasNoTrans, 1, Mscal, yscal, 0, grad);
   if (debug > 1) {
     debug_print (grad, "grad");  
   }
@@ -902,7 +1026,7 @@ int NewtonFitterGSL::optimizeScale () {
   
   static const double ALF = 1E-4;
   
-  stepsize=std::abs(gsl_vector_get (dxscal, gsl_blas_idamax (dxscal)));
+  stepsize=std::abs(gsl_vector_get (dxscal, linalg->idamax (dxscal)));
   static const double maxstepsize = 5;
   double scalefactor = maxstepsize/stepsize;
   if (stepsize > maxstepsize) {
@@ -910,15 +1034,13 @@ int NewtonFitterGSL::optimizeScale () {
     if (debug > 2) {
       cout << "NewtonFitterGSL::optimizeScale: Rescaling dxscal by factor " << scalefactor << endl;
     }
-    stepsize=std::abs(gsl_vector_get (dxscal, gsl_blas_idamax (dxscal)));
+    stepsize=std::abs(gsl_vector_get (dxscal, linalg->idamax (dxscal)));
     if (debug > 1) {
       debug_print (dxscal, "dxscal");  
     }
   }
   
-  double slope;
-  gsl_blas_ddot (dxscal, grad, &slope);
-  slope *= -1;
+  double slope = -linalg->ddot (dxscal, grad);
   if (debug > 2) {
     cout << "NewtonFitterGSL::optimizeScale: slope=" << slope 
          << ", 2*fvals[0]*factor=" << 2*fvals[0]*scalefactor
@@ -934,7 +1056,7 @@ int NewtonFitterGSL::optimizeScale () {
     if (debug > 1) {
       debug_print (x, "x(1)");  
     }
-    gsl_blas_daxpy (-scale, dx, x);
+    linalg->daxpy (-scale, dx, x);
     if (debug > 1) {
       debug_print (x, "x(2)");  
     }
@@ -947,7 +1069,7 @@ int NewtonFitterGSL::optimizeScale () {
     }
     ++nit;
     scalevals[nit] = scale;
-    fvals[nit] = 0.5*pow (gsl_blas_dnrm2 (yscal), 2);
+    fvals[nit] = 0.5*pow (linalg->dnrm2 (yscal), 2);
     
     chi2new = calcChi2();
     
@@ -1010,10 +1132,10 @@ int NewtonFitterGSL::invertM() {
     
     int signum;
     // Calculate LU decomposition of M into M1
-    int result = gsl_linalg_LU_decomp (M1, permM, &signum);
+    int result = linalg->LUDecomp (M1, permM, &signum);
     if (debug>1)cout << "invertM: gsl_linalg_LU_decomp result=" << result << endl;
     // Calculate inverse of M
-    ifail = gsl_linalg_LU_invert (M1, permM, M);
+    ifail = linalg->LUInvert (M1, permM, M);
     if (debug>1)cout << "invertM: gsl_linalg_LU_solve result=" << ifail << endl;
     
     if (ifail != 0) {
@@ -1076,7 +1198,7 @@ void NewtonFitterGSL::calcCovMatrix() {
 
   // Calculate LU decomposition of M into M3
   int signum;
-  int result = gsl_linalg_LU_decomp (M, permM, &signum);
+  int result = linalg->LUDecomp (M, permM, &signum);
 
   if (debug > 3) {
     cout << "invertM: gsl_linalg_LU_decomp result=" << result << endl;
@@ -1084,7 +1206,7 @@ void NewtonFitterGSL::calcCovMatrix() {
   }  
 
   // Calculate inverse of M, store in M3
-  int ifail = gsl_linalg_LU_invert (M, permM, M3);
+  int ifail = linalg->LUInvert (M, permM, M3);
   
   if (debug > 3) {
     cout << "invertM: gsl_linalg_LU_invert ifail=" << ifail << endl;
@@ -1100,18 +1222,18 @@ void NewtonFitterGSL::calcCovMatrix() {
   }
   
   // dadeta = 1*M*dydeta + 0*dadeta
-  gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1, M3, &dydeta.matrix, 0, &dadeta.matrix);
+  linalg->dgemm (CblasNoTrans, CblasNoTrans, 1, M3, &dydeta.matrix, 0, &dadeta.matrix);
   
   
   // Now calculate Cov_a = dadeta*Cov_eta*dadeta^T
 
   // First, calculate M3 = Cov_eta*dadeta^T as 
   gsl_matrix_view M3part   = gsl_matrix_submatrix (M3, 0, 0, npar, idim);
-  gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1, &Cov_eta.matrix, &dadeta.matrix, 0, &M3part.matrix);
+  linalg->dgemm (CblasNoTrans, CblasTrans, 1, &Cov_eta.matrix, &dadeta.matrix, 0, &M3part.matrix);
   // Now Cov_a = dadeta*M3part
   gsl_matrix_set_zero (M5);
   gsl_matrix_view  Cov_a = gsl_matrix_submatrix (M5, 0, 0, npar, npar);
-  gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1, &dadeta.matrix, &M3part.matrix, 0, M5);
+  linalg->dgemm (CblasNoTrans, CblasNoTrans, 1, &dadeta.matrix, &M3part.matrix, 0, M5);
   gsl_matrix_memcpy(CCinv,M5);
 
   if (debug > 3) {
@@ -54,6 +54,8 @@
 #include "BaseFitObject.h"
 #include "BaseHardConstraint.h"
 #include "BaseTracer.h"
+#include "FitProfile.h"
+#include "LinAlgBackend.h"
 
 #include <gsl/gsl_block.h>
 #include <gsl/gsl_vector.h>
@@ -62,6 +64,7 @@
 #include <gsl/gsl_linalg.h>
 #include <gsl/gsl_blas.h>
 #include <gsl/gsl_cdf.h>
+#include <gsl/gsl_errno.h>
 
 using std::cout;
 using std::cerr;
@@ -73,12 +76,13 @@ using std::abs;
 OPALFitterGSL::OPALFitterGSL() 
 : npar(0), nmea(0), nunm(0), ncon(0), ierr (0), nit (0),
   fitprob(0), chi2(0),
-  f(0), r(0), Fetaxi (0), S(0), Sinv (0), SinvFxi(0), SinvFeta (0), 
-  W1(0), G (0), H (0), HU (0), IGV (0), V(0), VLU(0), Vinv(0), Vnew (0), 
+  f(0), r(0), Fetaxi (0), S(0), SLU (0), SinvFxi(0), SinvFeta (0), 
+  W1(0), G (0), H (0), HU (0), IGV (0), V(0), VLU(0), Vsv(0), Vinv(0), Vnew (0), 
   Minv(0), dxdt(0), Vdxdt(0),
   dxi(0), Fxidxi (0), lambda(0), FetaTlambda(0),
   etaxi(0), etasv(0), y(0), y_eta(0), Vinvy_eta(0), FetaV (0),
-  permS (0), permU(0), permV(0), debug(0)
+  permS (0), permU(0), permV(0), 
+  Scholesky (false), Vcholesky (false), Vvalid (false), debug(0)
 {}
 
 // destructor
@@ -89,7 +93,7 @@ OPALFitterGSL::~OPALFitterGSL()
   if (r) gsl_vector_free (r);
   if (Fetaxi) gsl_matrix_free (Fetaxi);
   if (S) gsl_matrix_free (S);
-  if (Sinv) gsl_matrix_free (Sinv);
+  if (SLU) gsl_matrix_free (SLU);
   if (SinvFxi) gsl_matrix_free (SinvFxi);
   if (SinvFeta) gsl_matrix_free (SinvFeta);
   if (W1) gsl_matrix_free (W1);
@@ -99,6 +103,7 @@ OPALFitterGSL::~OPALFitterGSL()
   if (IGV) gsl_matrix_free (IGV);
   if (V) gsl_matrix_free (V);
   if (VLU) gsl_matrix_free (VLU);
+  if (Vsv) gsl_matrix_free (Vsv);
   if (Vinv) gsl_matrix_free (Vinv);
   if (Vnew) gsl_matrix_free (Vnew);
   if (Minv) gsl_matrix_free (Minv);
@@ -122,7 +127,7 @@ OPALFitterGSL::~OPALFitterGSL()
   r=0;
   Fetaxi=0;
   S=0;
-  Sinv=0;
+  SLU=0;
   SinvFxi=0;
   SinvFeta=0;
   W1=0;
@@ -132,6 +137,7 @@ OPALFitterGSL::~OPALFitterGSL()
   IGV=0;
   V=0;
   VLU=0;
+  Vsv=0;
   Vinv=0;
   Vnew=0;
   Minv=0;
@@ -209,14 +215,21 @@ double OPALFitterGSL::fit() {
   // cout statements
   int inverr = 0;
 
+  seedStartValues();
+  
+  // counts the fit on every return
+  FitProfileFitCounter fitcounter (profile, ierr, nit);
+
   // order parameters etc
+  FitProfileTimer tinit (profile, FitProfile::INITIALIZE);
   initialize();
+  tinit.stop();
   
   assert (f && (int)f->size == ncon);
   assert (r && (int)r->size == ncon);
   assert (Fetaxi && (int)Fetaxi->size1 == ncon && (int)Fetaxi->size2 == npar);
   assert (S && (int)S->size1 == ncon && (int)S->size2 == ncon);
-  assert (Sinv && (int)Sinv->size1 == ncon && (int)Sinv->size2 == ncon);
+  assert (SLU && (int)SLU->size1 == ncon && (int)SLU->size2 == ncon);
   assert (nunm == 0 || (SinvFxi && (int)SinvFxi->size1 == ncon && (int)SinvFxi->size2 == nunm));
   assert (SinvFeta && (int)SinvFeta->size1 == ncon && (int)SinvFeta->size2 == nmea);
   assert (nunm==0 || (W1 && (int)W1->size1 == nunm && (int)W1->size2 == nunm));
@@ -226,6 +239,7 @@ double OPALFitterGSL::fit() {
   assert (IGV && (int)IGV->size1 == nmea && (int)IGV->size2 == nmea);
   assert (V && (int)V->size1 == npar && (int)V->size2 == npar);
   assert (VLU && (int)VLU->size1 == nmea && (int)VLU->size2 == nmea);
+  assert (Vsv && (int)Vsv->size1 == nmea && (int)Vsv->size2 == nmea);
   assert (Vinv && (int)Vinv->size1 == nmea && (int)Vinv->size2 == nmea);
   assert (Vnew && (int)Vnew->size1 == npar && (int)Vnew->size2 == npar);
   assert (Minv && (int)Minv->size1 == npar && (int)Minv->size2 == npar);
@@ -317,6 +331,7 @@ double OPALFitterGSL::fit() {
       updatesuccess = updateFitObjects (etaxi->block->data);
       if (!updatesuccess) {
         std::cerr << "OPALFitterGSL::fit: old parameters are garbage!" << std::endl;
+        ierr = -1;
         return -1;
       }
       
@@ -334,6 +349,7 @@ double OPALFitterGSL::fit() {
     }
     
     // Get covariance matrix
+    FitProfileTimer tassembleM (profile, FitProfile::ASSEMBLEM);
     gsl_matrix_set_zero (V);
     
     for (unsigned int ifitobj = 0; ifitobj<fitobjects.size(); ++ifitobj) {
@@ -341,22 +357,25 @@ double OPALFitterGSL::fit() {
     }  
     if (debug>1)  debug_print (V, "V");
             
-    gsl_matrix_memcpy (VLU, &Vetaeta.matrix);  
-        
-    // invert covariance matrix (needed for chi2 calculation later)
-    
-    int signum;
-    int result;
-    result = gsl_linalg_LU_decomp (VLU, permV, &signum);
-    if (debug>1)cout << "gsl_linalg_LU_decomp result=" << result << endl;
-    if (debug>3)  debug_print (VLU, "VLU");
-
-    result = gsl_linalg_LU_invert (VLU, permV, Vinv);
-    if (debug>1)cout << "gsl_linalg_LU_invert result=" << result << endl;
-
-    if (debug>2) debug_print (Vinv, "Vinv");
+    // decompose covariance matrix (needed for chi2 calculation later);
+    // V normally does not change between iterations, so the decomposition
+    // is only redone when it has changed
+    bool Vchanged = !Vvalid;
+    for (int i = 0; !Vchanged && i < nmea; ++i) 
+      for (int j = 0; !Vchanged && j < nmea; ++j) 
+        Vchanged = (gsl_matrix_get (&Vetaeta.matrix, i, j) != gsl_matrix_get (Vsv, i, j));
+    if (Vchanged) {
+      gsl_matrix_memcpy (Vsv, &Vetaeta.matrix);
+      int result = decomposeSym (Vsv, VLU, permV, Vcholesky);
+      Vvalid = true;
+      if (debug>1)cout << "decomposeSym result=" << result << ", Cholesky=" << Vcholesky << endl;
+      if (debug>3)  debug_print (VLU, "VLU");
+    }
+    else if (profile) profile->count (FitProfile::COVFACTORREUSED);
+    tassembleM.stop();
     
 // *-- Evaluate f and S.
+    FitProfileTimer tassembley (profile, FitProfile::ASSEMBLEY);
     for (int k = 0; k < ncon; ++k) {
       gsl_vector_set (f, k, constraints[k]->getValue());
     }  
@@ -368,7 +387,7 @@ double OPALFitterGSL::fit() {
     // r=f
     gsl_vector_memcpy (r, f);
     // r = 1*Feta*y_eta + 1*r
-    gsl_blas_dgemv (CblasNoTrans, 1, &Feta.matrix, y_eta, 1, r);
+    linalg->dgemv (CblasNoTrans, 1, &Feta.matrix, y_eta, 1, r);
     
     if (debug>1) debug_print (r, "r");
     
@@ -376,10 +395,10 @@ double OPALFitterGSL::fit() {
     
     //FetaV = 1*Feta*V + 0*FetaV
     //if (debug>2) cout << "Creating FetaV" << endl;  
-    gsl_blas_dsymm (CblasRight, CblasUpper, 1, &Vetaeta.matrix, &Feta.matrix, 0,  FetaV);
+    linalg->dsymm (CblasRight, CblasUpper, 1, &Vetaeta.matrix, &Feta.matrix, 0,  FetaV);
     // S = 1 * FetaV * Feta^T + 0*S
     //if (debug>2) cout << "Creating S" << endl;;  
-    gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1, FetaV, &Feta.matrix, 0, S);
+    linalg->dgemm (CblasNoTrans, CblasTrans, 1, FetaV, &Feta.matrix, 0, S);
     
     if (nunm > 0) {
       // New invention by B. List, 6.12.04:
@@ -390,19 +409,22 @@ double OPALFitterGSL::fit() {
       gsl_matrix_view Fxi = gsl_matrix_submatrix (Fetaxi,  0, nmea, ncon, nunm);
 
       //S = 1*Fxi*Fxi^T + 1*S
-      gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1, &Fxi.matrix, &Fxi.matrix, 1, S);    
+      linalg->dgemm (CblasNoTrans, CblasTrans, 1, &Fxi.matrix, &Fxi.matrix, 1, S);    
     }
     
     if (debug>1) debug_print (S, "S");
+    tassembley.stop();
     
-// *-- Invert S to Sinv; S is destroyed here!
-// S is symmetric and positive definite
+// *-- Decompose S into SLU
+// S is symmetric and positive definite, so Cholesky normally works
 
-   gsl_linalg_LU_decomp (S, permS, &signum);
-   inverr = gsl_linalg_LU_invert (S, permS, Sinv); 
+   FitProfileTimer tsolve (profile, FitProfile::SOLVESYSTEM);
+   inverr = decomposeSym (S, SLU, permS, Scholesky);
+   if (!Scholesky && profile) profile->count (FitProfile::CHOLESKYFAILED);
 
    if (inverr != 0) {
-     cerr << "S: gsl_linalg_LU_invert error " << inverr << endl;
+     if (profile) profile->count (FitProfile::SOLVEFAILED);
+     cerr << "S: decomposition error " << inverr << endl;
      ierr = 7;
      calcerr = false;
      break;
@@ -410,8 +432,9 @@ double OPALFitterGSL::fit() {
    
    // Calculate S^1*r here, we will need it
    // Store it in lambda!
-   // lambda = 1*Sinv*r + 0*lambda; Sinv is symmetric
-   gsl_blas_dsymv (CblasUpper, 1, Sinv, r, 0, lambda);
+   // lambda = S^-1*r
+   gsl_vector_memcpy (lambda, r);
+   solveSym (SLU, permS, Scholesky, lambda);
 
 // *-- Calculate new unmeasured quantities, if any
 
@@ -419,10 +442,11 @@ double OPALFitterGSL::fit() {
       // Fxi is the part of Fetaxi containing the unmeasured quantities, if any    
       gsl_matrix_view Fxi = gsl_matrix_submatrix (Fetaxi,  0, nmea, ncon, nunm);
       // W1 = Fxi^T * Sinv * Fxi
-      // SinvFxi = 1*Sinv*Fxi + 0*SinvFxi
-      gsl_blas_dsymm (CblasLeft, CblasUpper, 1, Sinv, &Fxi.matrix, 0,  SinvFxi);
+      // SinvFxi = S^-1*Fxi
+      gsl_matrix_memcpy (SinvFxi, &Fxi.matrix);
+      solveSym (SLU, permS, Scholesky, SinvFxi);
       // W1 = 1*Fxi^T*SinvFxi + 0*W1
-      gsl_blas_dgemm (CblasTrans, CblasNoTrans, 1, &Fxi.matrix, SinvFxi, 0, W1);
+      linalg->dgemm (CblasTrans, CblasNoTrans, 1, &Fxi.matrix, SinvFxi, 0, W1);
       
       if (debug > 1) {
         debug_print (W1, "W1");
@@ -451,7 +475,7 @@ double OPALFitterGSL::fit() {
       if (debug>1) debug_print (lambda, "lambda");
       if (debug>1) debug_print (&(Fxi.matrix), "Fxi");
 
-      gsl_blas_dgemv (CblasTrans, -alph, &Fxi.matrix, lambda, 0, dxi);
+      linalg->dgemv (CblasTrans, -alph, &Fxi.matrix, lambda, 0, dxi);
 
       if (debug>1) debug_print (dxi, "dxi0");
       if (debug>1) debug_print (W1, "W1");
@@ -459,13 +483,14 @@ double OPALFitterGSL::fit() {
       // now solve the system
       // Note added 23.12.04: W1 is symmetric and positive definite,
       // so we can use the Cholesky instead of LU decomposition
-      gsl_linalg_cholesky_decomp (W1);
-      inverr = gsl_linalg_cholesky_svx (W1, dxi);
+      linalg->choleskyDecomp (W1);
+      inverr = linalg->choleskySvx (W1, dxi);
 
       if (debug>1) debug_print (dxi, "dxi1");
 
       
       if (inverr != 0) {
+        if (profile) profile->count (FitProfile::CHOLESKYFAILED);
         cerr << "W1: gsl_linalg_cholesky_svx error " << inverr << endl;
         ierr = 8;
         calcerr = false;
@@ -482,6 +507,7 @@ double OPALFitterGSL::fit() {
       gsl_vector_add (&xi.vector, dxi);
       
     }
+    tsolve.stop();
     
 // *-- Calculate new Lagrange multipliers.
     // lambda = Sinv*r + Sinv*Fxi*dxi
@@ -491,9 +517,10 @@ double OPALFitterGSL::fit() {
       // Fxi is the part of Fetaxi containing the unmeasured quantities, if any    
       gsl_matrix_view Fxi = gsl_matrix_submatrix (Fetaxi,  0, nmea, ncon, nunm);
       // calculate Fxidxi = 1*Fxi*dxi + 0*Fxidxi
-      gsl_blas_dgemv (CblasNoTrans, 1, &Fxi.matrix, dxi, 0, Fxidxi);
-      // add to existing lambda: lambda = 1*Sinv*Fxidxi + 1*lambda; Sinv is symmetric
-      gsl_blas_dsymv (CblasUpper, 1, Sinv, Fxidxi, 1, lambda);
+      linalg->dgemv (CblasNoTrans, 1, &Fxi.matrix, dxi, 0, Fxidxi);
+      // add to existing lambda: lambda = S^-1*Fxidxi + lambda
+      solveSym (SLU, permS, Scholesky, Fxidxi);
+      gsl_vector_add (lambda, Fxidxi);
     
     }
 
@@ -503,9 +530,9 @@ double OPALFitterGSL::fit() {
     // eta = y - V*Feta^T*lambda
     gsl_vector_memcpy (&eta.vector, y);
     // FetaTlambda = 1*Feta^T*lambda + 0*FetaTlambda
-    gsl_blas_dgemv (CblasTrans, 1, &Feta.matrix, lambda, 0, FetaTlambda);
+    linalg->dgemv (CblasTrans, 1, &Feta.matrix, lambda, 0, FetaTlambda);
     // eta = -1*V*FetaTlambda + 1*eta; V is symmetric
-    gsl_blas_dsymv (CblasUpper, -1, &Vetaeta.matrix, FetaTlambda, 1, &eta.vector);
+    linalg->dsymv (CblasUpper, -1, &Vetaeta.matrix, FetaTlambda, 1, &eta.vector);
 
     
     if (debug>1) debug_print (&eta.vector, "updated eta");
@@ -536,19 +563,17 @@ double OPALFitterGSL::fit() {
     gsl_vector_memcpy (y_eta, y);
     gsl_vector_sub (y_eta, &eta.vector);
     // Now calculate Vinv*y_eta [ as solution to V* Vinvy_eta = y_eta]
-    // Vinvy_eta = 1*Vinv*y_eta + 0*Vinvy_eta; Vinv is symmetric
-    gsl_blas_dsymv (CblasUpper, 1, Vinv, y_eta, 0, Vinvy_eta);
+    gsl_vector_memcpy (Vinvy_eta, y_eta);
+    solveSym (VLU, permV, Vcholesky, Vinvy_eta);
      // Now calculate y_eta *Vinvy_eta
-    gsl_blas_ddot (y_eta, Vinvy_eta, &chit);
+    chit = linalg->ddot (y_eta, Vinvy_eta);
 
     if (debug > 1) {
-    for (int i = 0; i < nmea; ++i) 
-      for (int j = 0; j < nmea; ++j) {
+    for (int i = 0; i < nmea; ++i) {
         double dchit = (gsl_vector_get (y_eta, i)) * 
-                        gsl_matrix_get (Vinv, i, j) * 
-                        (gsl_vector_get (y_eta, j));
+                       (gsl_vector_get (Vinvy_eta, i));
         if (dchit != 0)
-          cout << "chit for i,j = " << i << " , " << j << " = " 
+          cout << "chit for i = " << i << " = " 
                << dchit << endl;
       }
     }
@@ -616,6 +641,7 @@ double OPALFitterGSL::fit() {
       else {
         alph  =  std::max (almin, 0.5 * alph);
         scut  =  true;
+        if (profile) profile->count (FitProfile::STEPCUTS);
         repeat = true;
         ierr = 4;
       }
@@ -661,6 +687,7 @@ double OPALFitterGSL::fit() {
   if (debug) cout << "OPALFitterGSL: calcerr = " << calcerr << endl;
   
   if (calcerr) {
+    FitProfileTimer tcov (profile, FitProfile::COVMATRIX);
   
 // *-- As a first step, calculate Minv as in 9.4.2 of Benno's book chapter 
 //                    (in O.Behnke et al "Data Analysis in High Energy Physics")
@@ -673,9 +700,9 @@ double OPALFitterGSL::fit() {
     
     // CblasRight means C = alpha B A + beta C with symmetric matrix A
     //FetaV[ncon][nmea] = 1*Feta[ncon][nmea]*V[nmea][nmea] + 0*FetaV
-    gsl_blas_dsymm (CblasRight, CblasUpper, 1, &Vetaeta.matrix, &Feta.matrix, 0,  FetaV);
+    linalg->dsymm (CblasRight, CblasUpper, 1, &Vetaeta.matrix, &Feta.matrix, 0,  FetaV);
     // S[ncon][ncon] = 1 * FetaV[ncon][nmea] * Feta^T[nmea][ncon] + 0*S
-    gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1, FetaV, &Feta.matrix, 0, S);
+    linalg->dgemm (CblasNoTrans, CblasTrans, 1, FetaV, &Feta.matrix, 0, S);
 
     
     if (nunm > 0) {
@@ -686,20 +713,19 @@ double OPALFitterGSL::fit() {
       // Fxi is the part of Fetaxi containing the unmeasured quantities, if any    
       gsl_matrix_view Fxi = gsl_matrix_submatrix (Fetaxi,  0, nmea, ncon, nunm);
       //S[ncon][ncon] = 1*Fxi[ncon][nunm]*Fxi^T[nunm][ncon] + 1*S[ncon][ncon]
-      gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1, &Fxi.matrix, &Fxi.matrix, 1, S);    
+      linalg->dgemm (CblasNoTrans, CblasTrans, 1, &Fxi.matrix, &Fxi.matrix, 1, S);    
    }
    
     if (debug>2) debug_print (S, "S");
 
-// *-- Invert S, testing for singularity first.
+// *-- Decompose S, testing for singularity first.
 // S is symmetric and positive definite
 
    int signum;
-   gsl_linalg_LU_decomp (S, permS, &signum);
-   inverr = gsl_linalg_LU_invert (S, permS, Sinv); 
+   inverr = decomposeSym (S, SLU, permS, Scholesky);
 
    if (inverr != 0) {
-     cerr << "S: gsl_linalg_LU_invert error " << inverr << " in error calculation" << endl;
+     cerr << "S: decomposition error " << inverr << " in error calculation" << endl;
      ierr = -1;
      return -1;
    }
@@ -709,10 +735,11 @@ double OPALFitterGSL::fit() {
 //  (same as W1, but for measured parameters) 
 // G = Feta^T * Sinv * Feta
 
-    // SinvFeta[ncon][nmea] = 1*Sinv[ncon][ncon]*Feta[ncon][nmea] + 0*SinvFeta
-    gsl_blas_dsymm (CblasLeft, CblasUpper, 1, Sinv, &Feta.matrix, 0,  SinvFeta);
+    // SinvFeta[ncon][nmea] = S^-1[ncon][ncon]*Feta[ncon][nmea]
+    gsl_matrix_memcpy (SinvFeta, &Feta.matrix);
+    solveSym (SLU, permS, Scholesky, SinvFeta);
     // G[nmea][nmea] = 1*Feta^T[nmea][ncon]*SinvFeta[ncon][nmea] + 0*G
-    gsl_blas_dgemm (CblasTrans, CblasNoTrans, 1, &Feta.matrix, SinvFeta, 0, G);
+    linalg->dgemm (CblasTrans, CblasNoTrans, 1, &Feta.matrix, SinvFeta, 0, G);
 
     if (debug>2) debug_print (G, "G(1)");
 
@@ -724,10 +751,11 @@ double OPALFitterGSL::fit() {
       // Fxi is the part of Fetaxi containing the unmeasured quantities, if any    
       gsl_matrix_view Fxi = gsl_matrix_submatrix (Fetaxi,  0, nmea, ncon, nunm);
       // H = Feta^T * Sinv * Fxi
-      // SinvFxi[ncon][nunm] = 1*Sinv[ncon][ncon]*Fxi[ncon][nunm] + 0*SinvFxi
-      gsl_blas_dsymm (CblasLeft, CblasUpper, 1, Sinv, &Fxi.matrix, 0,  SinvFxi);
+      // SinvFxi[ncon][nunm] = S^-1[ncon][ncon]*Fxi[ncon][nunm]
+      gsl_matrix_memcpy (SinvFxi, &Fxi.matrix);
+      solveSym (SLU, permS, Scholesky, SinvFxi);
       // H[nmea][nunm] = 1*Feta^T[nmea][ncon]*SinvFxi[ncon][nunm] + 0*H
-      gsl_blas_dgemm (CblasTrans, CblasNoTrans, 1, &Feta.matrix, SinvFxi, 0, H);
+      linalg->dgemm (CblasTrans, CblasNoTrans, 1, &Feta.matrix, SinvFxi, 0, H);
 
       if (debug>2) debug_print (H, "H");
       
@@ -739,10 +767,10 @@ double OPALFitterGSL::fit() {
       gsl_matrix_view U = gsl_matrix_submatrix (Minv, nmea, nmea, nunm, nunm);
       // Uinv = Fxi^T * Sinv * Fxi
       // Uinv[nunm][nunm] = 1*Fxi^T[nunm][ncon]*SinvFxi[ncon][nunm] + 0*W1
-      gsl_blas_dgemm (CblasTrans, CblasNoTrans, 1, &Fxi.matrix, SinvFxi, 0, Uinv);
+      linalg->dgemm (CblasTrans, CblasNoTrans, 1, &Fxi.matrix, SinvFxi, 0, Uinv);
       
-      gsl_linalg_LU_decomp (Uinv, permU, &signum);
-      inverr = gsl_linalg_LU_invert (Uinv, permU, &U.matrix); 
+      linalg->LUDecomp (Uinv, permU, &signum);
+      inverr = linalg->LUInvert (Uinv, permU, &U.matrix); 
             
       if (debug>2) debug_print (&U.matrix, "U"); 
       if (debug > 2) {
@@ -762,10 +790,10 @@ double OPALFitterGSL::fit() {
 // *-- Covariance matrix between measured and unmeasured parameters.
 
 //    HU[nmea][nunm] = 1*H[nmea][nunm]*U[nunm][nunm] + 0*HU
-      gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1, H, &U.matrix, 0, HU);
+      linalg->dgemm (CblasNoTrans, CblasNoTrans, 1, H, &U.matrix, 0, HU);
 //    Vnewetaxi is a view of Vnew      
       gsl_matrix_view Minvetaxi = gsl_matrix_submatrix (Minv, 0, nmea, nmea, nunm);
-      gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, -1, &Vetaeta.matrix, HU, 0, &Minvetaxi.matrix);
+      linalg->dgemm (CblasNoTrans, CblasNoTrans, -1, &Vetaeta.matrix, HU, 0, &Minvetaxi.matrix);
     if (debug > 2) {
       for (int i = 0; i < npar; ++i) {
         for (int j = 0; j < npar; ++j) {
@@ -789,7 +817,7 @@ double OPALFitterGSL::fit() {
       
 // *-- Calculate G-HUH^T:
 //    G = -1*HU*H^T +1*G
-      gsl_blas_dgemm (CblasNoTrans, CblasTrans, -1, HU, H, +1, G);
+      linalg->dgemm (CblasNoTrans, CblasTrans, -1, HU, H, +1, G);
       
     }  // endif nunm > 0
 
@@ -797,13 +825,13 @@ double OPALFitterGSL::fit() {
    // IGV = 1
    gsl_matrix_set_identity (IGV);
    // IGV = -1*G*Vetaeta + 1*IGV
-   gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, -1, G, &Vetaeta.matrix, 1, IGV);
+   linalg->dgemm (CblasNoTrans, CblasNoTrans, -1, G, &Vetaeta.matrix, 1, IGV);
 
 // *-- And finally error matrix on fitted parameters.
    gsl_matrix_view Minvetaeta = gsl_matrix_submatrix (Minv, 0, 0, nmea, nmea);
 
    // Vnewetaeta = 1*Vetaeta*IGV + 0*Vnewetaeta
-   gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1, &Vetaeta.matrix, IGV, 0, &Minvetaeta.matrix);
+   linalg->dgemm (CblasNoTrans, CblasNoTrans, 1, &Vetaeta.matrix, IGV, 0, &Minvetaeta.matrix);
 
     if (debug > 2) {
       for (int i = 0; i < npar; ++i) {
@@ -828,6 +856,9 @@ double OPALFitterGSL::fit() {
 //       in OPALFitter it is the derivatives of the constraints wrt to the parameters (A in book)
 //       in the book, F are the second derivatives of the objective function wrt the parameters
 
+      // Vinv is only needed here, once per fit
+      invertSym (VLU, permV, Vcholesky, Vinv);
+      if (debug>2) debug_print (Vinv, "Vinv");
       
       gsl_matrix_view detadt = gsl_matrix_submatrix (dxdt, 0, 0, nmea, nmea);
       if (debug > 3) cout << "after detadt" << endl;
@@ -836,16 +867,16 @@ double OPALFitterGSL::fit() {
       if (debug > 3) cout << "after Vdetadt" << endl;
       
       // detadt = - Minvetaeta * Fetat = -1 * Minvetaeta * (-1) * Vinv + 0 * detadt   // replace by symm?
-      gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1, &Minvetaeta.matrix, Vinv, 0, &detadt.matrix);
+      linalg->dgemm (CblasNoTrans, CblasNoTrans, 1, &Minvetaeta.matrix, Vinv, 0, &detadt.matrix);
       if (debug>2) debug_print (&detadt.matrix, "deta/dt");
       
       // Vdetadt = 1 * Vetaeta * detadt^T + 0* Vdetadt
-      gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1, &Vetaeta.matrix, &detadt.matrix, 0, &Vdetadt.matrix);  // ok
+      linalg->dgemm (CblasNoTrans, CblasTrans, 1, &Vetaeta.matrix, &detadt.matrix, 0, &Vdetadt.matrix);  // ok
       if (debug>2) debug_print (&Vdetadt.matrix, "Vetata * deta/dt");
       
       gsl_matrix_view Vnewetaeta = gsl_matrix_submatrix (Vnew, 0, 0, nmea, nmea);   //[nmea],[nmea]
       // Vnewetaeta = 1 * detadt * Vdetadt + 0* Vnewetaeta
-      gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1, &detadt.matrix, &Vdetadt.matrix, 0, &Vnewetaeta.matrix);
+      linalg->dgemm (CblasNoTrans, CblasNoTrans, 1, &detadt.matrix, &Vdetadt.matrix, 0, &Vnewetaeta.matrix);
       
       if (debug>2) debug_print (Vnew, "Vnew after part for measured parameters");
       
@@ -859,14 +890,14 @@ double OPALFitterGSL::fit() {
         gsl_matrix_view dxidt = gsl_matrix_submatrix (dxdt, nmea, 0, nunm, nmea);      //[nunm][nmea]
         if (debug > 3) cout << "after dxidt" << endl;
         // dxidt[nunm][nmea] = - Minvxieta * Fetat = -1 * Minvxieta[nunm][nmea] * Vinv[nmea][nmea] + 0 * dxidt
-        gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1, &Minvxieta.matrix, Vinv, 0, &dxidt.matrix);   //ok
+        linalg->dgemm (CblasNoTrans, CblasNoTrans, 1, &Minvxieta.matrix, Vinv, 0, &dxidt.matrix);   //ok
         if (debug>2) debug_print (&dxidt.matrix, "dxi/dt");
      
         // Vdxdt = V * dxdt^T => Vdxdt[nmea][npar]
         gsl_matrix_view Vdxidt = gsl_matrix_submatrix (Vdxdt, 0, nmea, nmea, nunm);    //[nmea][nunm]
         if (debug > 3) cout << "after Vdxidt" << endl;
         // Vdxidt = 1 * Vetaeta[nmea][nmea] * dxidt^T[nmea][nunm] + 0* Vdxidt => Vdxidt[nmea][nunm]
-        gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1, &Vetaeta.matrix, &dxidt.matrix, 0, &Vdxidt.matrix);  // ok
+        linalg->dgemm (CblasNoTrans, CblasTrans, 1, &Vetaeta.matrix, &dxidt.matrix, 0, &Vdxidt.matrix);  // ok
         if (debug>2) debug_print (&Vdxidt.matrix, "Vetaeta * dxi/dt^T");
       
         gsl_matrix_view Vnewetaxi = gsl_matrix_submatrix (Vnew, 0, nmea, nmea, nunm);    //[nmea][nunm]
@@ -874,13 +905,13 @@ double OPALFitterGSL::fit() {
         gsl_matrix_view Vnewxixi = gsl_matrix_submatrix (Vnew, nmea, nmea, nunm, nunm);  //[nunm][nunm]
       
         // Vnewxieta[nunm][nmea] = 1 * dxidt[nunm][nmea] * Vdetadt[nmea][nmea] + 0* Vnewxieta
-        gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1, &dxidt.matrix, &Vdetadt.matrix, 0, &Vnewxieta.matrix);  // ok
+        linalg->dgemm (CblasNoTrans, CblasNoTrans, 1, &dxidt.matrix, &Vdetadt.matrix, 0, &Vnewxieta.matrix);  // ok
         if (debug>2) debug_print (Vnew, "Vnew after xieta part");
         // Vnewetaxi[nmea][nunm] = 1 * detadt[nmea][nmea] * Vdxidt[nmea][nunm] + 0* Vnewetaxi
-        gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1, &detadt.matrix, &Vdxidt.matrix, 0, &Vnewetaxi.matrix);  // ok
+        linalg->dgemm (CblasNoTrans, CblasNoTrans, 1, &detadt.matrix, &Vdxidt.matrix, 0, &Vnewetaxi.matrix);  // ok
         if (debug>2) debug_print (Vnew, "Vnew after etaxi part");
         // Vnewxixi[nunm][nunm] = 1 * dxidt[nunm][nmea] * Vdxidt[nmea][nunm] + 0* Vnewxixi
-        gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1, &dxidt.matrix, &Vdxidt.matrix, 0, &Vnewxixi.matrix);
+        linalg->dgemm (CblasNoTrans, CblasNoTrans, 1, &dxidt.matrix, &Vdxidt.matrix, 0, &Vnewxixi.matrix);
         if (debug>2) debug_print (Vnew, "Vnew after xixi part");
      }
     
@@ -917,7 +948,7 @@ double OPALFitterGSL::fit() {
 #ifndef FIT_TRACEOFF
     if (tracer) tracer->finish (*this);
 #endif   
-
+  
   return fitprob;
     
 }
@@ -969,7 +1000,7 @@ bool OPALFitterGSL::initialize() {
   
   ini_gsl_matrix (Fetaxi, ncon, npar);
   ini_gsl_matrix (S, ncon, ncon);
-  ini_gsl_matrix (Sinv, ncon, ncon);
+  ini_gsl_matrix (SLU, ncon, ncon);
   ini_gsl_matrix (SinvFxi, ncon, nunm);
   ini_gsl_matrix (SinvFeta, ncon, nmea);
   ini_gsl_matrix (W1, nunm, nunm);
@@ -979,6 +1010,8 @@ bool OPALFitterGSL::initialize() {
   ini_gsl_matrix (IGV, nmea, nmea);
   ini_gsl_matrix (V, npar, npar);
   ini_gsl_matrix (VLU, nmea, nmea);
+  ini_gsl_matrix (Vsv, nmea, nmea);
+  Vvalid = false;
   ini_gsl_matrix (Vinv, nmea, nmea);
   ini_gsl_matrix (Vnew, npar, npar);
   ini_gsl_matrix (Minv, npar, npar);
@@ -1006,7 +1039,7 @@ bool OPALFitterGSL::initialize() {
   assert (r && (int)r->size == ncon);
   assert (Fetaxi && (int)Fetaxi->size1 == ncon && (int)Fetaxi->size2 == npar);
   assert (S && (int)S->size1 == ncon && (int)S->size2 == ncon);
-  assert (Sinv && (int)Sinv->size1 == ncon && (int)Sinv->size2 == ncon);
+  assert (SLU && (int)SLU->size1 == ncon && (int)SLU->size2 == ncon);
   assert (nunm == 0 || (SinvFxi && (int)SinvFxi->size1 == ncon && (int)SinvFxi->size2 == nunm));
   assert (SinvFeta && (int)SinvFeta->size1 == ncon && (int)SinvFeta->size2 == nmea);
   assert (nunm==0 || (W1 && (int)W1->size1 == nunm && (int)W1->size2 == nunm));
@@ -1016,6 +1049,7 @@ bool OPALFitterGSL::initialize() {
   assert (IGV && (int)IGV->size1 == nmea && (int)IGV->size2 == nmea);
   assert (V && (int)V->size1 == npar && (int)V->size2 == npar);
   assert (VLU && (int)VLU->size1 == nmea && (int)VLU->size2 == nmea);
+  assert (Vsv && (int)Vsv->size1 == nmea && (int)Vsv->size2 == nmea);
   assert (Vinv && (int)Vinv->size1 == nmea && (int)Vinv->size2 == nmea);
   assert (Vnew && (int)Vnew->size1 == npar && (int)Vnew->size2 == npar);
   assert (nunm==0 || (dxi && (int)dxi->size == nunm));
@@ -1060,6 +1094,7 @@ bool OPALFitterGSL::updateFitObjects (double eetaxi[]) {
 }
 
 int OPALFitterGSL::getError() const {return ierr;}
+bool OPALFitterGSL::supportsSoftConstraints() const {return false;}
 double OPALFitterGSL::getProbability() const {return fitprob;}
 double OPALFitterGSL::getChi2() const {return chi2;}
 int OPALFitterGSL::getDoF() const {return ncon-nunm;}
@@ -1102,6 +1137,45 @@ void OPALFitterGSL::ini_gsl_matrix (gsl_matrix *&m, unsigned int size1, unsigned
     if (size1*size2 > 0) m = gsl_matrix_alloc (size1, size2);
 }
 
+int OPALFitterGSL::decomposeSym (const gsl_matrix *A, gsl_matrix *Adec, gsl_permutation *perm, bool& cholesky) {
+  assert (A && Adec && perm);
+  assert (A->size1 == A->size2 && Adec->size1 == A->size1 && Adec->size2 == A->size2);
+  // A covariance matrix or S is positive definite, unless something is
+  // badly wrong; then fall back to LU decomposition
+  gsl_matrix_memcpy (Adec, A);
+  gsl_error_handler_t *old_handler = gsl_set_error_handler_off ();
+  int result = linalg->choleskyDecomp (Adec);
+  gsl_set_error_handler (old_handler);
+  cholesky = (result == 0);
+  if (cholesky) return 0;
+
+  gsl_matrix_memcpy (Adec, A);
+  int signum;
+  linalg->LUDecomp (Adec, perm, &signum);
+  for (unsigned int i = 0; i < Adec->size1; ++i) 
+    if (gsl_matrix_get (Adec, i, i) == 0) return GSL_ESING;
+  return 0;
+}
+
+int OPALFitterGSL::solveSym (const gsl_matrix *Adec, const gsl_permutation *perm, bool cholesky, gsl_vector *v) {
+  return cholesky ? linalg->choleskySvx (Adec, v) : linalg->LUSvx (Adec, perm, v);
+}
+
+int OPALFitterGSL::solveSym (const gsl_matrix *Adec, const gsl_permutation *perm, bool cholesky, gsl_matrix *B) {
+  int result = 0;
+  for (unsigned int j = 0; j < B->size2; ++j) {
+    gsl_vector_view col = gsl_matrix_column (B, j);
+    result |= solveSym (Adec, perm, cholesky, &col.vector);
+  }
+  return result;
+}
+
+int OPALFitterGSL::invertSym (const gsl_matrix *Adec, const gsl_permutation *perm, bool cholesky, gsl_matrix *Ainv) {
+  if (!cholesky) return linalg->LUInvert (Adec, perm, Ainv);
+  gsl_matrix_memcpy (Ainv, Adec);
+  return linalg->choleskyInvert (Ainv);
+}
+
 void OPALFitterGSL::setDebug (int debuglevel) {
   debug = debuglevel;
 }
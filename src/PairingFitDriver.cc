@@ -0,0 +1,285 @@
+/*! \file
+ *  \brief Implements class PairingFitDriver
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Added pruning of permutations with chi2 bounds
+ * - 18.10.2026 Reuse inverse covariance matrices and caches of the jets across permutations
+ *
+ */
+
+#include "PairingFitDriver.h"
+
+#include "BaseJetPairing.h"
+#include "BasePairingHypothesis.h"
+#include "BaseFitter.h"
+
+#include <algorithm>
+#include <limits>
+
+#undef NDEBUG
+#include <cassert>
+
+PairingFitResult::PairingFitResult()
+: iperm (-1), fitted (false), pruned (false), bound (0), error (-1), prob (-1), chi2 (-1), nit (0),
+  fitted_jets ()
+{}
+
+namespace {
+  // Orders permutation numbers by decreasing probability, then increasing chi2
+  class ResultOrder {
+    public:
+      ResultOrder (const std::vector<PairingFitResult>& results_): results (results_) {}
+      bool operator() (int i, int j) const {
+        const PairingFitResult& ri = results[i];
+        const PairingFitResult& rj = results[j];
+        if (ri.prob != rj.prob) return ri.prob > rj.prob;
+        if (ri.chi2 != rj.chi2) return ri.chi2 < rj.chi2;
+        return i < j;
+      }
+    private:
+      const std::vector<PairingFitResult>& results;
+  };
+  
+  // Orders permutation numbers by increasing chi2 bound
+  class BoundOrder {
+    public:
+      BoundOrder (const std::vector<PairingFitResult>& results_): results (results_) {}
+      bool operator() (int i, int j) const {
+        if (results[i].bound != results[j].bound) return results[i].bound < results[j].bound;
+        return i < j;
+      }
+    private:
+      const std::vector<PairingFitResult>& results;
+  };
+}
+
+PairingFitDriver::PairingFitDriver (const BasePairingHypothesis& hypothesis_, int nthreads)
+: pool (nthreads), topk (0), probcut (2),
+  prune (false), prunefactor (1), phase (PHASE_FIT),
+  nperm (0), njets (0),
+  jets (), permtable (),
+  hypotheses (), jetcopies (), permjets (),
+  results (), ranking (), fitorder (),
+  npermtotal (0), nprunedtotal (0),
+  bestchi2 (std::numeric_limits<double>::max()),
+  cancelled (false)
+{
+  int n = pool.getNThreads();
+  hypotheses.resize (n, 0);
+  jetcopies.resize (n);
+  permjets.resize (n);
+  for (int ithread = 0; ithread < n; ++ithread) {
+    hypotheses[ithread] = hypothesis_.copy();
+    assert (hypotheses[ithread]);
+  }
+}
+
+PairingFitDriver::~PairingFitDriver() {
+  for (unsigned int ithread = 0; ithread < hypotheses.size(); ++ithread) {
+    delete hypotheses[ithread];
+    for (unsigned int i = 0; i < jetcopies[ithread].size(); ++i) delete jetcopies[ithread][i];
+  }
+}
+
+void PairingFitDriver::setTopK (int topk_) {
+  topk = topk_;
+}
+
+void PairingFitDriver::setCancelProbability (double probcut_) {
+  probcut = probcut_;
+}
+
+void PairingFitDriver::setPruning (bool prune_, double prunefactor_) {
+  prune = prune_;
+  prunefactor = prunefactor_;
+}
+
+int PairingFitDriver::getNThreads() const {
+  return pool.getNThreads();
+}
+
+void PairingFitDriver::readPermutations (BaseJetPairing& pairing) {
+  nperm = pairing.getNPerm();
+  njets = pairing.getNJets();
+  jets.resize (0);
+  permtable.resize (nperm*njets);
+
+  std::vector<JetFitObject *> permObjects (njets, 0);
+  pairing.reset();
+  for (int iperm = 0; iperm < nperm; ++iperm) {
+    pairing.nextPermutation (&permObjects[0]);
+    for (int j = 0; j < njets; ++j) {
+      assert (permObjects[j]);
+      std::vector<JetFitObject *>::iterator it = std::find (jets.begin(), jets.end(), permObjects[j]);
+      if (it == jets.end()) {
+        jets.push_back (permObjects[j]);
+        it = jets.end()-1;
+      }
+      permtable[iperm*njets+j] = it - jets.begin();
+    }
+  }
+  pairing.reset();
+}
+
+void PairingFitDriver::copyJets() {
+  // prepare the constraint-independent quantities once per event;
+  // assign passes them on to the jet copies for every permutation
+  for (unsigned int i = 0; i < jets.size(); ++i) jets[i]->precompute();
+
+  for (unsigned int ithread = 0; ithread < jetcopies.size(); ++ithread) {
+    std::vector<JetFitObject *>& mine = jetcopies[ithread];
+    for (unsigned int i = 0; i < mine.size(); ++i) delete mine[i];
+    mine.resize (jets.size());
+    for (unsigned int i = 0; i < jets.size(); ++i) mine[i] = jets[i]->copy();
+    permjets[ithread].resize (njets);
+  }
+}
+
+int PairingFitDriver::fitPermutations (BaseJetPairing& pairing) {
+  readPermutations (pairing);
+  copyJets();
+
+  results.resize (0);
+  results.resize (nperm);
+  ranking.resize (0);
+  fitorder.resize (nperm);
+  for (int iperm = 0; iperm < nperm; ++iperm) fitorder[iperm] = iperm;
+  cancelled = false;
+  bestchi2 = std::numeric_limits<double>::max();
+
+  if (prune) {
+    // cheap pre-filter: bounds first, then fit the most promising permutations first
+    phase = PHASE_BOUND;
+    pool.run (*this, nperm);
+    std::sort (fitorder.begin(), fitorder.end(), BoundOrder (results));
+  }
+  
+  phase = PHASE_FIT;
+  pool.run (*this, nperm);
+
+  npermtotal += nperm;
+  nprunedtotal += getNPruned();
+
+  rankResults();
+  return ranking.size();
+}
+
+void PairingFitDriver::execute (int itask, int ithread) {
+  assert (itask >= 0 && itask < nperm);
+  assert (ithread >= 0 && ithread < (int)hypotheses.size());
+  
+  if (phase == PHASE_BOUND) boundPermutation (itask, ithread);
+  else fitPermutation (fitorder[itask], ithread);
+}
+
+void PairingFitDriver::setupPermutation (int iperm, int ithread) {
+  std::vector<JetFitObject *>& mine = jetcopies[ithread];
+  std::vector<JetFitObject *>& perm = permjets[ithread];
+
+  // start every permutation from the measured jets
+  for (unsigned int i = 0; i < jets.size(); ++i) mine[i]->assign (*jets[i]);
+  for (int j = 0; j < njets; ++j) perm[j] = mine[permtable[iperm*njets+j]];
+}
+
+void PairingFitDriver::boundPermutation (int iperm, int ithread) {
+  setupPermutation (iperm, ithread);
+  results[iperm].bound = hypotheses[ithread]->getChi2Bound (&permjets[ithread][0]);
+}
+
+void PairingFitDriver::updateBestChi2 (double chi2) {
+  double best = bestchi2;
+  while (chi2 < best && !bestchi2.compare_exchange_weak (best, chi2)) {}
+}
+
+void PairingFitDriver::fitPermutation (int iperm, int ithread) {
+  PairingFitResult& result = results[iperm];
+  result.iperm = iperm;
+  if (cancelled) return;
+  if (prune && prunefactor*result.bound > bestchi2) {
+    result.pruned = true;
+    return;
+  }
+
+  setupPermutation (iperm, ithread);
+  std::vector<JetFitObject *>& mine = jetcopies[ithread];
+
+  BasePairingHypothesis *hypothesis = hypotheses[ithread];
+  result.prob = hypothesis->fitPermutation (&permjets[ithread][0]);
+
+  BaseFitter& fitter = hypothesis->getFitter();
+  result.fitted = true;
+  result.error  = fitter.getError();
+  result.chi2   = fitter.getChi2();
+  result.nit    = fitter.getIterations();
+
+  result.fitted_jets.reserve (mine.size());
+  for (unsigned int i = 0; i < mine.size(); ++i) result.fitted_jets.push_back (*mine[i]);
+
+  if (result.error == 0) {
+    updateBestChi2 (result.chi2);
+    if (result.prob >= probcut) cancelled = true;
+  }
+}
+
+void PairingFitDriver::rankResults() {
+  ranking.resize (0);
+  for (int iperm = 0; iperm < nperm; ++iperm) {
+    if (results[iperm].fitted && results[iperm].error == 0) ranking.push_back (iperm);
+  }
+  std::sort (ranking.begin(), ranking.end(), ResultOrder (results));
+  if (topk > 0 && (int)ranking.size() > topk) ranking.resize (topk);
+}
+
+int PairingFitDriver::getNPerm() const {
+  return nperm;
+}
+
+int PairingFitDriver::getNFitted() const {
+  int result = 0;
+  for (unsigned int iperm = 0; iperm < results.size(); ++iperm)
+    if (results[iperm].fitted) ++result;
+  return result;
+}
+
+int PairingFitDriver::getNPruned() const {
+  int result = 0;
+  for (unsigned int iperm = 0; iperm < results.size(); ++iperm)
+    if (results[iperm].pruned) ++result;
+  return result;
+}
+
+long PairingFitDriver::getNPermTotal() const {
+  return npermtotal;
+}
+
+long PairingFitDriver::getNPrunedTotal() const {
+  return nprunedtotal;
+}
+
+void PairingFitDriver::resetStatistics() {
+  npermtotal = 0;
+  nprunedtotal = 0;
+}
+
+int PairingFitDriver::getNResults() const {
+  return ranking.size();
+}
+
+const PairingFitResult& PairingFitDriver::getResult (int irank) const {
+  assert (irank >= 0 && irank < (int)ranking.size());
+  return results[ranking[irank]];
+}
+
+const PairingFitResult& PairingFitDriver::getPermutationResult (int iperm) const {
+  assert (iperm >= 0 && iperm < (int)results.size());
+  return results[iperm];
+}
+
+bool PairingFitDriver::applyResult (int irank) {
+  if (irank < 0 || irank >= (int)ranking.size()) return false;
+  const PairingFitResult& result = results[ranking[irank]];
+  assert (result.fitted_jets.size() == jets.size());
+  for (unsigned int i = 0; i < jets.size(); ++i) jets[i]->assign (result.fitted_jets[i]);
+  return true;
+}
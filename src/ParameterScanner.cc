@@ -18,8 +18,6 @@
  * -
  *
  */ 
-#ifdef MARLIN_USE_ROOT
-
 #include "ParameterScanner.h"
 
 #include "BaseFitter.h"
@@ -27,10 +25,12 @@
 #include "BaseFitObject.h"
 #include "BaseHardConstraint.h"
 
+#ifdef MARLIN_USE_ROOT
 #include <TString.h>
 #include <TH2F.h>
 #include <TMultiGraph.h>
 #include <TGraph.h>
+#endif
 
 #include <gsl/gsl_vector.h>
 
@@ -42,9 +42,79 @@
 using namespace std;
 
 ParameterScanner::ParameterScanner (BaseFitter& fitter_)
-: fitter (fitter_)
+: BaseScanner (fitter_), mumerit (0)
 {}
 
+ParameterScanner::ParameterScanner (const std::vector<BaseFitter *>& fitters_)
+: BaseScanner (fitters_), mumerit (0)
+{}
+
+void ParameterScanner::setMuMerit (double mumerit_) {
+  mumerit = mumerit_;
+}
+
+void ParameterScanner::scanPoint (int ix, int iy, int ithread) {
+  BaseFitter& fitter = *fitters[ithread];
+  NewFitterGSL *newfitter = dynamic_cast<NewFitterGSL *>(&fitter);
+  FitObjectContainer* fitobjects = fitter.getFitObjects();
+  ConstraintContainer* constraints = fitter.getConstraints();
+
+  setParameters (ix, iy, ithread);
+  int i = result.index (ix, iy);
+      
+  // Calculate chi2
+  double chi2 = 0;
+  for (FitObjectIterator it = fitobjects->begin(); it != fitobjects->end(); ++it) {
+    BaseFitObject *fo = *it;
+    assert (fo);
+    chi2 += fo->getChi2();
+  }
+  result.chi2[i] = chi2;
+  
+  for (int icon = 0; icon < result.ncon; ++icon) {
+    BaseHardConstraint *c = (*constraints)[icon];
+    if (c) result.con[i*result.ncon+icon] = c->getValue();
+  }
+      
+  if (!newfitter) return;
+  
+  newfitter->fillx (newfitter->x);    
+  newfitter->fillperr(newfitter->perr);    
+  newfitter->assembleConstDer (newfitter->M);
+  newfitter->determineLambdas (newfitter->x, newfitter->M, newfitter->x, newfitter->W, newfitter->v1); 
+  
+  for (int icon = 0; icon < result.ncon; ++icon) {
+    BaseHardConstraint *c = (*constraints)[icon];
+    if (c) result.lambda[i*result.ncon+icon] = gsl_vector_get (newfitter->x, c->getGlobalNum());
+  }
+        
+  result.phi[i] = newfitter->meritFunction (mumerit, newfitter->x,  newfitter->perr);
+
+  newfitter->calcNewtonDx (newfitter->dx, newfitter->dxscal, newfitter->x, 
+                           newfitter->perr, newfitter->M, newfitter->Mscal, 
+                           newfitter->y, newfitter->yscal, newfitter->W, newfitter->W2, 
+                           newfitter->permW, newfitter->v1);
+  newfitter->add (newfitter->xnew, newfitter->x, 1, newfitter->dx);
+  
+  result.xfull[i] = gsl_vector_get (newfitter->xnew, result.xglobal);
+  result.yfull[i] = gsl_vector_get (newfitter->xnew, result.yglobal);
+  
+  double alpha = 1;
+  double mu = 0;
+  int imode = 2;
+    
+  newfitter->calcLimitedDx (alpha, mu, newfitter->xnew, imode, 
+                            newfitter->x, newfitter->v2, newfitter->dx, newfitter->dxscal, 
+                            newfitter->perr, newfitter->M, newfitter->Mscal, 
+                            newfitter->W, newfitter->v1);
+                                  
+  result.xend[i]  = gsl_vector_get (newfitter->xnew, result.xglobal);
+  result.yend[i]  = gsl_vector_get (newfitter->xnew, result.yglobal);
+  result.alpha[i] = alpha;
+  result.mu[i]    = mu;
+}
+
+#ifdef MARLIN_USE_ROOT
 void ParameterScanner::doScan (int xglobal, 
             int nx,
             double xstart,
@@ -55,55 +125,13 @@ void ParameterScanner::doScan (int xglobal,
             double ystop,
             const char *idprefix,
             const char *titleprefix,
-            double mumerit) {
-  
-  NewFitterGSL *newfitter = dynamic_cast<NewFitterGSL *>(&fitter);
-            
-  FitObjectContainer* fitobjects = fitter.getFitObjects();
-  if (fitobjects == 0) return;
-  ConstraintContainer* constraints = fitter.getConstraints();
-  if (constraints == 0) return;
+            double mumerit_) {
   
-  // Get largest global parameter number,
-  // find parameter names
-  TString xname ("");
-  TString yname ("");
+  setMuMerit (mumerit_);
+  if (!scan (xglobal, nx, xstart, xstop, yglobal, ny, ystart, ystop)) return;
   
-  int idim = 1;
-  for (FitObjectIterator i = fitobjects->begin(); i != fitobjects->end(); ++i) {
-    BaseFitObject *fo = *i;
-    assert (fo);
-    for (int ilocal = 0; ilocal < fo->getNPar(); ++ilocal) {
-      int iglobal = fo->getGlobalParNum (ilocal);
-      if (iglobal >= idim) idim = iglobal+1;
-      if (iglobal == xglobal) xname = fo->getParamName (ilocal);
-      if (iglobal == yglobal) yname = fo->getParamName (ilocal);
-    }
-  }
-  for (ConstraintIterator i = constraints->begin(); i != constraints->end(); ++i) {
-    BaseHardConstraint *c = *i;
-    assert (c);
-    int iglobal = c->getGlobalNum();
-      if (iglobal >= idim) idim = iglobal+1;
-  }
-  
-  if (xglobal >= idim) return;
-  if (yglobal >= idim) return;
+  bool newfitter = dynamic_cast<NewFitterGSL *>(fitters[0]) != 0;
   
-  double *parsave  = new double [idim];
-  double *par  = new double [idim];
-  
-  // Get starting values
-  for (FitObjectIterator i = fitobjects->begin(); i != fitobjects->end(); ++i) {
-    BaseFitObject *fo = *i;
-    assert (fo);
-    for (int ilocal = 0; ilocal < fo->getNPar(); ++ilocal) {
-      int iglobal = fo->getGlobalParNum (ilocal);
-      assert (iglobal >= 0 && iglobal < idim);
-      parsave[iglobal] = fo->getParam (ilocal);
-    }
-  }
-
   // Book Histograms
   
   TString idpostfix("");
@@ -112,359 +140,185 @@ void ParameterScanner::doScan (int xglobal,
   idpostfix += yglobal;
   
   TString titlepostfix(" vs ");
-  titlepostfix += xname;
+  titlepostfix += result.xname.c_str();
   titlepostfix += " and ";
-  titlepostfix += yname;
+  titlepostfix += result.yname.c_str();
   titlepostfix += ";";
-  titlepostfix += xname;
+  titlepostfix += result.xname.c_str();
   titlepostfix += ";";
-  titlepostfix += yname;
+  titlepostfix += result.yname.c_str();
   
-  // Chi2 Histogram
+  // Chi2 Histogram, and for NewFitterGSL alpha, log2(alpha), mu and phi1
   
-  TString id (idprefix);
-  id += "chi2_";
-  id += idpostfix;
-  
-  TString title (titleprefix);
-  title += "Chi2 ";
-  title += titlepostfix;
+  static const int quantities[] = {ScanResult::CHI2, ScanResult::ALPHA, ScanResult::LOG2ALPHA, 
+                                   ScanResult::MU, ScanResult::PHI};
+  static const char *titles[] = {"Chi2 ", "#alpha ", "log_{2} (#alpha) ", "#mu ", "Merit function #phi_{1} "};
+  int nquant = newfitter ? 5 : 1;
   
-  TH2F *hchi2 = new TH2F (id, title, nx, xstart, xstop, ny, ystart, ystop);
-  cout << "Booking Histo '" << id << "': '" << title << "'" << endl;
-
-  TH2F *halpha = 0;
-  TH2F *hlog2alpha = 0;
-  TH2F *hmu = 0;
-  TH2F *hphi1 = 0;
-  
-  if (newfitter) {
-    id = idprefix;
-    id += "alpha_";
+  for (int iquant = 0; iquant < nquant; ++iquant) {
+    TString id (idprefix);
+    id += ScanResult::getQuantityName (quantities[iquant]);
+    id += "_";
     id += idpostfix;
   
-    title = titleprefix;
-    title += "#alpha ";
+    TString title (titleprefix);
+    title += titles[iquant];
     title += titlepostfix;
   
-    halpha = new TH2F (id, title, nx, xstart, xstop, ny, ystart, ystop);
+    TH2F *h = result.createHist (quantities[iquant], id, title);
     cout << "Booking Histo '" << id << "': '" << title << "'" << endl;
-
-    id = idprefix;
-    id += "log2alpha_";
-    id += idpostfix;
-  
-    title = titleprefix;
-    title += "log_{2} (#alpha) ";
-    title += titlepostfix;
+    h->Write();
+  }
   
-    hlog2alpha = new TH2F (id, title, nx, xstart, xstop, ny, ystart, ystop);
-    cout << "Booking Histo '" << id << "': '" << title << "'" << endl;
-    
-    id = idprefix;
-    id += "mu_";
+  int ncon = result.ncon;
+  if (ncon > NCONMAX) ncon = NCONMAX;
+  for (int icon = 0; icon < ncon; ++icon) {
+    TString id (idprefix);
+    id += "con";
+    id += icon;
+    id += "_";
     id += idpostfix;
-  
-    title = titleprefix;
-    title += "#mu ";
-    title += titlepostfix;
-  
-    hmu = new TH2F (id, title, nx, xstart, xstop, ny, ystart, ystop);
-    cout << "Booking Histo '" << id << "': '" << title << "'" << endl;
     
-    id = idprefix;
-    id += "phi1_";
-    id += idpostfix;
-  
-    title = titleprefix;
-    title += "Merit function #phi_{1} ";
+    TString title (titleprefix);
+    title += "Constraint ";
+    title += icon;
+    title += ": ";
+    title += result.connames[icon].c_str();
     title += titlepostfix;
-  
-    hphi1 = new TH2F (id, title, nx, xstart, xstop, ny, ystart, ystop);
+      
+    TH2F *h = result.createHist (ScanResult::CON, id, title, icon);
     cout << "Booking Histo '" << id << "': '" << title << "'" << endl;
-    
-    
-  }
-  
-  TMultiGraph *mgstepsfull = 0;
-  TMultiGraph *mgsteps = 0;
-  TGraph *gstep0 = 0;
-  TGraph *gstep1 = 0;
-  TGraph *gstep2 = 0;
-  if (newfitter) {
-    id = idprefix;
-    id += "stepsfull_";
-    id += idpostfix;
-  
-    title = titleprefix;
-    title += "Full Steps ";
-    title += titlepostfix;
-  
-    mgstepsfull = new TMultiGraph (id, title);
-    cout << "Booking Multigraph '" << id << "': '" << title << "'" << endl;
-
-    id = idprefix;
-    id += "steps_";
-    id += idpostfix;
-  
-    title = titleprefix;
-    title += "Steps ";
-    title += titlepostfix;
-  
-    mgsteps = new TMultiGraph (id, title);
-    cout << "Booking Multigraph '" << id << "': '" << title << "'" << endl;
-
-    id = idprefix;
-    id += "stepstart_";
-    id += idpostfix;
-  
-    title = titleprefix;
-    title += "Step Start Points ";
-    title += titlepostfix;
- 
-    gstep0 = new TGraph(nx*ny);
-    gstep0 ->SetName (id);
-    gstep0 ->SetTitle (title);
-    gstep0->SetMarkerStyle (20);
-    gstep0->SetMarkerColor (kBlack);
-    gstep0->SetMarkerSize (0.5);
-
-    id = idprefix;
-    id += "stependfull_";
-    id += idpostfix;
-  
-    title = titleprefix;
-    title += "Full Step End Points ";
-    title += titlepostfix;
- 
-    gstep1 = new TGraph(nx*ny);
-    gstep1 ->SetName (id);
-    gstep1 ->SetTitle (title);
-    gstep1->SetMarkerStyle (20);
-    gstep1->SetMarkerColor (kRed);
-    gstep1->SetMarkerSize (0.5);
-
-    id = idprefix;
-    id += "stepend_";
-    id += idpostfix;
-  
-    title = titleprefix;
-    title += "Step End Points ";
-    title += titlepostfix;
- 
-    gstep2 = new TGraph(nx*ny);
-    gstep2 ->SetName (id);
-    gstep2 ->SetTitle (title);
-    gstep2->SetMarkerStyle (21);
-    gstep2->SetMarkerColor (kGreen);
-    gstep2->SetMarkerSize (0.5);
-    
-
-  }
-  
-  unsigned int ncon = constraints->size();
-  if (ncon > NCONMAX) ncon = NCONMAX;
-  TH2F *hcon[NCONMAX];
-  TH2F *hlambda[NCONMAX];
-  for (unsigned int icon = 0; icon < ncon; ++icon) {
-    hcon[icon] = 0;
-    hlambda[icon] = 0;
-    BaseConstraint *c = (*constraints)[icon];
-    if (c) {
+    h->Write();
+      
+    if (newfitter) {
       id = idprefix;
-      id += "con";
+      id += "lambda";
       id += icon;
       id += "_";
       id += idpostfix;
     
       title = titleprefix;
-      title += "Constraint ";
+      title += "Lambda ";
       title += icon;
       title += ": ";
-      title += c->getName();
+      title += result.connames[icon].c_str();
       title += titlepostfix;
       
-      hcon[icon] = new TH2F (id, title, nx, xstart, xstop, ny, ystart, ystop);
+      h = result.createHist (ScanResult::LAMBDA, id, title, icon);
       cout << "Booking Histo '" << id << "': '" << title << "'" << endl;
-      
-      if (newfitter) {
-        id = idprefix;
-        id += "lambda";
-        id += icon;
-        id += "_";
-        id += idpostfix;
-    
-        title = titleprefix;
-        title += "Lambda ";
-        title += icon;
-        title += ": ";
-        title += c->getName();
-        title += titlepostfix;
-      
-        hlambda[icon] = new TH2F (id, title, nx, xstart, xstop, ny, ystart, ystop);
-        cout << "Booking Histo '" << id << "': '" << title << "'" << endl;
-  
-      }
-      
-      
+      h->Write();
     }
   }
   
+  if (!newfitter) return;
   
-  // Do the scan
+  // Graphs of the steps
   
-  for (int ix = 1; ix <= nx; ++ix) {
-    double x = (ix - 0.5)*(xstop-xstart)/nx + xstart;
-    for (int iy = 1; iy <= ny; ++iy) {
-      double y = (iy - 0.5)*(ystop-ystart)/ny + ystart;
-      
-      // Set parameters
-      for (int i = 0; i < idim; ++i) par[i] = parsave[i];
-      par[xglobal] = x;
-      par[yglobal] = y;
-      for (FitObjectIterator i = fitobjects->begin(); i != fitobjects->end(); ++i) {
-        BaseFitObject *fo = *i;
-        assert (fo);
-        fo->updateParams(par, idim);
-      }
-      
-      
-      // Calculate chi2
-      double chi2 = 0;
-      for (FitObjectIterator i = fitobjects->begin(); i != fitobjects->end(); ++i) {
-        BaseFitObject *fo = *i;
-        assert (fo);
-        chi2 += fo->getChi2();
-      }
-      
-      //cout << "Chi2 for x=" << x << " and y=" << y << ": " << chi2 << endl;
-      
-      if (newfitter) {
-        newfitter->fillx (newfitter->x);
-        newfitter->assembleConstDer (newfitter->M);
-        newfitter->determineLambdas (newfitter->x, newfitter->M, newfitter->x, newfitter->W, newfitter->v1); 
-      }
-      
-      // Fill Histos
-      hchi2->SetBinContent (ix, iy, chi2);
-      for (unsigned int icon = 0; icon < ncon; ++icon) {
-        BaseHardConstraint *c = (*constraints)[icon];
-        TH2F *h = hcon[icon];
-        if (c && h) h->SetBinContent (ix, iy, c->getValue());
-        // if (c) cout << "x=" << x << ", y=" << y << ": Constraint " << c->getName() << ": " << c->getValue() << endl;
-        h = hlambda[icon];
-        if (c && h && newfitter) {
-          int kglobal = c->getGlobalNum();
-          h->SetBinContent (ix, iy, gsl_vector_get (newfitter->x, kglobal));; 
-        }
+  TString id (idprefix);
+  id += "stepsfull_";
+  id += idpostfix;
+  
+  TString title (titleprefix);
+  title += "Full Steps ";
+  title += titlepostfix;
+  
+  TMultiGraph *mgstepsfull = new TMultiGraph (id, title);
+  cout << "Booking Multigraph '" << id << "': '" << title << "'" << endl;
 
-      }
-      
-      if (newfitter) {
-        newfitter->setDebug ((ix == 1) ? 4 : 0);
-        
-        double xval[2], yval[2];
-        xval[0] = x;
-        yval[0] = y;
-        gstep0->SetPoint ((ix-1)*ny+(iy-1), xval[0], yval[0]);  
-        newfitter->fillx (newfitter->x);    
-        newfitter->fillperr(newfitter->perr);    
+  id = idprefix;
+  id += "steps_";
+  id += idpostfix;
   
-        newfitter->assembleConstDer (newfitter->M);
-        newfitter->determineLambdas (newfitter->x, newfitter->M, newfitter->x, newfitter->W, newfitter->v1); 
-        
-        double phi1 = newfitter->meritFunction (mumerit, newfitter->x,  newfitter->perr);
-        if (hphi1)    hphi1->SetBinContent (ix, iy, phi1);    
+  title = titleprefix;
+  title += "Steps ";
+  title += titlepostfix;
+  
+  TMultiGraph *mgsteps = new TMultiGraph (id, title);
+  cout << "Booking Multigraph '" << id << "': '" << title << "'" << endl;
 
-        newfitter->calcNewtonDx (newfitter->dx, newfitter->dxscal, newfitter->x, 
-                                 newfitter->perr, newfitter->M, newfitter->Mscal, 
-                                 newfitter->y, newfitter->yscal, newfitter->W, newfitter->W2, 
-                                 newfitter->permW, newfitter->v1);
-        newfitter->add (newfitter->xnew, newfitter->x, 1, newfitter->dx);
-        
-        xval[1] = gsl_vector_get (newfitter->xnew, xglobal);
-        yval[1] = gsl_vector_get (newfitter->xnew, yglobal);
-        
-        cout << "ParameterScanner::doScan: full step from (" << xval[0] << ", " << yval[0]
-             << ") -> (" << xval[1] << ", " << yval[1] << ")" << endl;
-        
-        
-        gstep1->SetPoint ((ix-1)*ny+(iy-1), xval[1], yval[1]);  
-        
-        TGraph *g = new TGraph (2, xval, yval);
-        g->SetLineColor (kRed);
-        
-        if (xval[1] > xstart - 10*(xstop-xstart) && 
-            xval[1] < xstop + 10*(xstop-xstart) &&
-            yval[1] > ystart - 10*(ystop-ystart) && 
-            yval[1] < ystop + 10*(ystop-ystart)) {
-        
-          mgstepsfull->Add (g, "L");
-          cout << " -> added\n";
-        }  
-        double alpha = 1;
-        double mu = 0;
-        int imode = 2;
-    
-        newfitter->calcLimitedDx (alpha, mu, newfitter->xnew, imode, 
-                                  newfitter->x, newfitter->v2, newfitter->dx, newfitter->dxscal, 
-                                  newfitter->perr, newfitter->M, newfitter->Mscal, 
-                                  newfitter->W, newfitter->v1);
-                                  
-        xval[1] = gsl_vector_get (newfitter->xnew, xglobal);
-        yval[1] = gsl_vector_get (newfitter->xnew, yglobal);
-        
-        cout << "    limited step from (" << xval[0] << ", " << yval[0]
-             << ") -> (" << xval[1] << ", " << yval[1] << "), alpha=" << alpha << endl;
-        
-        gstep2->SetPoint ((ix-1)*ny+(iy-1), xval[1], yval[1]);  
-        
-        g = new TGraph (2, xval, yval);
-        g->SetLineColor (kGreen);
-        
-        if (xval[1] > xstart - 10*(xstop-xstart) && 
-            xval[1] < xstop + 10*(xstop-xstart) &&
-            yval[1] > ystart - 10*(ystop-ystart) && 
-            yval[1] < ystop + 10*(ystop-ystart)) {
-        
-          mgsteps->Add (g, "L");
-          cout << " -> added\n";
-        }     
-        if (halpha) halpha->SetBinContent (ix, iy, alpha);
-        if (hlog2alpha) hlog2alpha->SetBinContent (ix, iy, std::log(alpha)/std::log(2.));
-        if (hmu)    hmu->SetBinContent (ix, iy, mu);    
+  id = idprefix;
+  id += "stepstart_";
+  id += idpostfix;
+  
+  title = titleprefix;
+  title += "Step Start Points ";
+  title += titlepostfix;
+ 
+  TGraph *gstep0 = new TGraph(nx*ny);
+  gstep0 ->SetName (id);
+  gstep0 ->SetTitle (title);
+  gstep0->SetMarkerStyle (20);
+  gstep0->SetMarkerColor (kBlack);
+  gstep0->SetMarkerSize (0.5);
 
+  id = idprefix;
+  id += "stependfull_";
+  id += idpostfix;
+  
+  title = titleprefix;
+  title += "Full Step End Points ";
+  title += titlepostfix;
+ 
+  TGraph *gstep1 = new TGraph(nx*ny);
+  gstep1 ->SetName (id);
+  gstep1 ->SetTitle (title);
+  gstep1->SetMarkerStyle (20);
+  gstep1->SetMarkerColor (kRed);
+  gstep1->SetMarkerSize (0.5);
+
+  id = idprefix;
+  id += "stepend_";
+  id += idpostfix;
+  
+  title = titleprefix;
+  title += "Step End Points ";
+  title += titlepostfix;
+ 
+  TGraph *gstep2 = new TGraph(nx*ny);
+  gstep2 ->SetName (id);
+  gstep2 ->SetTitle (title);
+  gstep2->SetMarkerStyle (21);
+  gstep2->SetMarkerColor (kGreen);
+  gstep2->SetMarkerSize (0.5);
+  
+  for (int ix = 0; ix < nx; ++ix) {
+    for (int iy = 0; iy < ny; ++iy) {
+      int i = result.index (ix, iy);
+      double xval[2], yval[2];
+      xval[0] = result.getX (ix);
+      yval[0] = result.getY (iy);
+      gstep0->SetPoint (i, xval[0], yval[0]);  
       
-      }
+      xval[1] = result.xfull[i];
+      yval[1] = result.yfull[i];
+      gstep1->SetPoint (i, xval[1], yval[1]);  
+      if (xval[1] > xstart - 10*(xstop-xstart) && 
+          xval[1] < xstop + 10*(xstop-xstart) &&
+          yval[1] > ystart - 10*(ystop-ystart) && 
+          yval[1] < ystop + 10*(ystop-ystart)) {
+        TGraph *g = new TGraph (2, xval, yval);
+        g->SetLineColor (kRed);
+        mgstepsfull->Add (g, "L");
+      }  
       
+      xval[1] = result.xend[i];
+      yval[1] = result.yend[i];
+      gstep2->SetPoint (i, xval[1], yval[1]);  
+      if (xval[1] > xstart - 10*(xstop-xstart) && 
+          xval[1] < xstop + 10*(xstop-xstart) &&
+          yval[1] > ystart - 10*(ystop-ystart) && 
+          yval[1] < ystop + 10*(ystop-ystart)) {
+        TGraph *g = new TGraph (2, xval, yval);
+        g->SetLineColor (kGreen);
+        mgsteps->Add (g, "L");
+      }     
     }
   }
   
-  // Write histos;
-  hchi2->Write();
-  for (unsigned int icon = 0; icon < ncon; ++icon) {
-    if (hcon[icon]) hcon[icon]->Write();
-    if (hlambda[icon]) hcon[icon]->Write();
-  }
-
-  for (FitObjectIterator i = fitobjects->begin(); i != fitobjects->end(); ++i) {
-    BaseFitObject *fo = *i;
-    assert (fo);
-    fo->updateParams(parsave, idim);
-  }
-  
-  if (mgstepsfull) mgstepsfull->Write();
-  if (mgsteps)     mgsteps->Write();
-  if (gstep0) gstep0->Write();
-  if (gstep1) gstep1->Write();
-  if (gstep2) gstep2->Write();
-  if (halpha) halpha->Write();
-  if (hlog2alpha) hlog2alpha->Write();
-  if (hmu)    hmu->Write();
-  if (hphi1)  hphi1->Write();
-
-  delete par;
-  delete parsave;
+  mgstepsfull->Write();
+  mgsteps->Write();
+  gstep0->Write();
+  gstep1->Write();
+  gstep2->Write();
 }
-
 #endif // MARLIN_USE_ROOT
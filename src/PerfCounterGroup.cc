@@ -0,0 +1,96 @@
+/*! \file
+ *  \brief Implements class PerfCounterGroup
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "PerfCounterGroup.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+#undef NDEBUG
+#include <cassert>
+
+#ifdef __linux__
+namespace {
+  int openCounter (uint64_t config, int groupfd) {
+    struct perf_event_attr attr;
+    std::memset (&attr, 0, sizeof (attr));
+    attr.size = sizeof (attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = (groupfd == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // this thread, any cpu
+    return syscall (__NR_perf_event_open, &attr, 0, -1, groupfd, 0);
+  }
+}
+#endif
+
+PerfCounterGroup::PerfCounterGroup() {
+  for (int ievent = 0; ievent < NEVENTS; ++ievent) fds[ievent] = -1;
+#ifdef __linux__
+  static const uint64_t configs[NEVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+  };
+  for (int ievent = 0; ievent < NEVENTS; ++ievent) {
+    fds[ievent] = openCounter (configs[ievent], fds[0]);
+    if (fds[ievent] < 0) {
+      for (int jevent = 0; jevent < ievent; ++jevent) close (fds[jevent]);
+      for (int jevent = 0; jevent < NEVENTS; ++jevent) fds[jevent] = -1;
+      return;
+    }
+  }
+  ioctl (fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl (fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+#ifdef __linux__
+  for (int ievent = 0; ievent < NEVENTS; ++ievent) if (fds[ievent] >= 0) close (fds[ievent]);
+#endif
+}
+
+bool PerfCounterGroup::isValid() const {
+  return fds[0] >= 0;
+}
+
+bool PerfCounterGroup::read (uint64_t values[NEVENTS]) const {
+#ifdef __linux__
+  if (fds[0] < 0) return false;
+  // layout for PERF_FORMAT_GROUP with enabled and running times
+  uint64_t buffer[3+NEVENTS];
+  ssize_t n = ::read (fds[0], buffer, sizeof (buffer));
+  if (n != sizeof (buffer) || buffer[0] != NEVENTS) return false;
+  uint64_t enabled = buffer[1];
+  uint64_t running = buffer[2];
+  for (int ievent = 0; ievent < NEVENTS; ++ievent) {
+    values[ievent] = (running > 0 && running < enabled)
+                     ? uint64_t (double (buffer[3+ievent])*enabled/running)
+                     : buffer[3+ievent];
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+const char *PerfCounterGroup::getEventName (int ievent) {
+  static const char *names[NEVENTS] = {
+    "cycles", "instructions", "cache misses", "branch misses"
+  };
+  if (ievent < 0 || ievent >= NEVENTS) return "undefined";
+  return names[ievent];
+}
@@ -0,0 +1,205 @@
+/*! \file
+ *  \brief Implements classes ScanResult, ScanPoint and AdaptiveScanResult
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Added ScanPoint and AdaptiveScanResult
+ *
+ */
+
+#include "ScanResult.h"
+
+#include <cmath>
+
+#ifdef MARLIN_USE_ROOT
+#include <TH2F.h>
+#endif
+
+#undef NDEBUG
+#include <cassert>
+
+ScanResult::ScanResult()
+: xglobal (-1), nx (0), xstart (0), xstop (0),
+  yglobal (-1), ny (0), ystart (0), ystop (0), ncon (0),
+  xname (), yname (), connames (),
+  chi2 (), alpha (), mu (), phi (), nit (), error (),
+  xend (), yend (), xfull (), yfull (), con (), lambda ()
+{}
+
+void ScanResult::setGrid (int xglobal_, int nx_, double xstart_, double xstop_,
+                          int yglobal_, int ny_, double ystart_, double ystop_,
+                          int ncon_) {
+  assert (nx_ >= 0 && ny_ >= 0 && ncon_ >= 0);
+  xglobal = xglobal_;
+  nx = nx_;
+  xstart = xstart_;
+  xstop = xstop_;
+  yglobal = yglobal_;
+  ny = ny_;
+  ystart = ystart_;
+  ystop = ystop_;
+  ncon = ncon_;
+  connames.resize (ncon);
+
+  int n = nx*ny;
+  chi2.assign (n, 0);
+  alpha.assign (n, 0);
+  mu.assign (n, 0);
+  phi.assign (n, 0);
+  nit.assign (n, 0);
+  error.assign (n, 0);
+  xend.assign (n, 0);
+  yend.assign (n, 0);
+  xfull.assign (n, 0);
+  yfull.assign (n, 0);
+  con.assign (n*ncon, 0);
+  lambda.assign (n*ncon, 0);
+}
+
+double ScanResult::getX (int ix) const {
+  return (ix + 0.5)*(xstop-xstart)/nx + xstart;
+}
+
+double ScanResult::getY (int iy) const {
+  return (iy + 0.5)*(ystop-ystart)/ny + ystart;
+}
+
+double ScanResult::getValue (int quantity, int ix, int iy, int icon) const {
+  assert (ix >= 0 && ix < nx);
+  assert (iy >= 0 && iy < ny);
+  int i = index (ix, iy);
+  switch (quantity) {
+    case CHI2:      return chi2[i];
+    case ALPHA:     return alpha[i];
+    case LOG2ALPHA: return alpha[i] > 0 ? std::log (alpha[i])/std::log (2.) : 0;
+    case MU:        return mu[i];
+    case PHI:       return phi[i];
+    case NIT:       return nit[i];
+    case ERROR:     return error[i];
+    case XEND:      return xend[i];
+    case YEND:      return yend[i];
+    case XFULL:     return xfull[i];
+    case YFULL:     return yfull[i];
+    case CON:       assert (icon >= 0 && icon < ncon); return con[i*ncon+icon];
+    case LAMBDA:    assert (icon >= 0 && icon < ncon); return lambda[i*ncon+icon];
+  }
+  return 0;
+}
+
+const char *ScanResult::getQuantityName (int quantity) {
+  static const char *names[NQUANTITIES] = {
+    "chi2", "alpha", "log2alpha", "mu", "phi1", "nit", "error",
+    "xend", "yend", "xfull", "yfull", "con", "lambda"
+  };
+  if (quantity < 0 || quantity >= NQUANTITIES) return "undefined";
+  return names[quantity];
+}
+
+#ifdef MARLIN_USE_ROOT
+TH2F *ScanResult::createHist (int quantity, const char *id, const char *title, int icon) const {
+  TH2F *h = new TH2F (id, title, nx, xstart, xstop, ny, ystart, ystop);
+  for (int ix = 0; ix < nx; ++ix)
+    for (int iy = 0; iy < ny; ++iy)
+      h->SetBinContent (ix+1, iy+1, getValue (quantity, ix, iy, icon));
+  return h;
+}
+#endif
+
+ScanPoint::ScanPoint()
+: x (0), y (0), chi2 (0), alpha (0), mu (0), phi (0), nit (0), error (0), xend (0), yend (0)
+{}
+
+double ScanPoint::getValue (int quantity) const {
+  switch (quantity) {
+    case ScanResult::CHI2:      return chi2;
+    case ScanResult::ALPHA:     return alpha;
+    case ScanResult::LOG2ALPHA: return alpha > 0 ? std::log (alpha)/std::log (2.) : 0;
+    case ScanResult::MU:        return mu;
+    case ScanResult::PHI:       return phi;
+    case ScanResult::NIT:       return nit;
+    case ScanResult::ERROR:     return error;
+    case ScanResult::XEND:      return xend;
+    case ScanResult::YEND:      return yend;
+  }
+  return 0;
+}
+
+AdaptiveScanResult::AdaptiveScanResult()
+: xglobal (-1), xstart (0), xstop (0), yglobal (-1), ystart (0), ystop (0),
+  nstart (0), maxlevel (0), xname (), yname (), cells (), cellindex ()
+{}
+
+void AdaptiveScanResult::setRange (int xglobal_, double xstart_, double xstop_,
+                                   int yglobal_, double ystart_, double ystop_,
+                                   int nstart_, int maxlevel_) {
+  assert (nstart_ > 0 && maxlevel_ >= 0);
+  // the indices of the finest level must fit into the key
+  assert ((long long)nstart_ << maxlevel_ < (1LL << 24));
+  xglobal = xglobal_;
+  xstart = xstart_;
+  xstop = xstop_;
+  yglobal = yglobal_;
+  ystart = ystart_;
+  ystop = ystop_;
+  nstart = nstart_;
+  maxlevel = maxlevel_;
+  cells.resize (0);
+  cellindex.clear();
+}
+
+int AdaptiveScanResult::addCell (int level, int ix, int iy) {
+  assert (level >= 0 && level <= maxlevel);
+  assert (ix >= 0 && ix < getNPoints (level));
+  assert (iy >= 0 && iy < getNPoints (level));
+  int icell = cells.size();
+  Cell cell;
+  cell.level = level;
+  cell.ix = ix;
+  cell.iy = iy;
+  cell.leaf = true;
+  cell.point.x = getX (level, ix);
+  cell.point.y = getY (level, iy);
+  cells.push_back (cell);
+  cellindex[key (level, ix, iy)] = icell;
+  return icell;
+}
+
+double AdaptiveScanResult::getX (int level, int ix) const {
+  return (ix + 0.5)*(xstop-xstart)/getNPoints (level) + xstart;
+}
+
+double AdaptiveScanResult::getY (int level, int iy) const {
+  return (iy + 0.5)*(ystop-ystart)/getNPoints (level) + ystart;
+}
+
+int AdaptiveScanResult::findCell (int level, int ix, int iy) const {
+  for (; level >= 0; --level, ix >>= 1, iy >>= 1) {
+    std::map<long long, int>::const_iterator it = cellindex.find (key (level, ix, iy));
+    if (it != cellindex.end()) return it->second;
+  }
+  return -1;
+}
+
+int AdaptiveScanResult::getNLeaves() const {
+  int n = 0;
+  for (unsigned int icell = 0; icell < cells.size(); ++icell) if (cells[icell].leaf) ++n;
+  return n;
+}
+
+double AdaptiveScanResult::getValue (int quantity, int ix, int iy) const {
+  int icell = findCell (maxlevel, ix, iy);
+  if (icell < 0) return 0;
+  if (quantity == LEVEL) return cells[icell].level;
+  return cells[icell].point.getValue (quantity);
+}
+
+#ifdef MARLIN_USE_ROOT
+TH2F *AdaptiveScanResult::createHist (int quantity, const char *id, const char *title) const {
+  int n = getNPoints (maxlevel);
+  TH2F *h = new TH2F (id, title, n, xstart, xstop, n, ystart, ystop);
+  for (int ix = 0; ix < n; ++ix)
+    for (int iy = 0; iy < n; ++iy)
+      h->SetBinContent (ix+1, iy+1, getValue (quantity, ix, iy));
+  return h;
+}
+#endif
@@ -0,0 +1,195 @@
+/*! \file
+ *  \brief Implements class StartValueSeeder
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Seed ISR photons without the warning for pz below PzMin
+ *
+ */
+
+#include "StartValueSeeder.h"
+
+#include "BaseFitter.h"
+#include "BaseHardConstraint.h"
+#include "MomentumConstraint.h"
+#include "MassConstraint.h"
+#include "NeutrinoFitObject.h"
+#include "ZinvisibleFitObject.h"
+#include "ISRPhotonFitObject.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#undef NDEBUG
+#include <cassert>
+
+StartValueSeeder::~StartValueSeeder()
+{}
+
+int StartValueSeeder::seed (BaseFitter& fitter) const {
+  std::vector<BaseFitObject *>& fitobjects = *fitter.getFitObjects();
+  std::vector<const BaseFitObject *> known;
+  int nseeded = 0;
+
+  for (unsigned int i = 0; i < fitobjects.size(); ++i) {
+    if (!isNeutrino (fitobjects[i])) continue;
+    ParticleFitObject *fo = static_cast<ParticleFitObject *>(fitobjects[i]);
+    bool seeded = seedTransverse (fitter, fo);
+    known.push_back (fo);
+
+    std::vector<double> candidates;
+    findPzCandidates (fitter, fo, known, candidates);
+    if (!candidates.empty()) {
+      // keep the candidate that fulfills the constraints best, with the photons adjusted to it
+      double px = fo->getPx();
+      double py = fo->getPy();
+      double pzbest = candidates[0];
+      double violbest = std::numeric_limits<double>::infinity();
+      for (unsigned int k = 0; k < candidates.size(); ++k) {
+        setMomentum (fo, px, py, candidates[k]);
+        seedPhotons (fitter, known);
+        double viol = fitter.getConstraintViolation();
+        if (viol < violbest) {
+          violbest = viol;
+          pzbest = candidates[k];
+        }
+      }
+      setMomentum (fo, px, py, pzbest);
+      seeded = true;
+    }
+    if (seeded) ++nseeded;
+  }
+
+  nseeded += seedPhotons (fitter, known);
+  return nseeded;
+}
+
+bool StartValueSeeder::isNeutrino (const BaseFitObject *fo) {
+  assert (fo);
+  if (!dynamic_cast<const NeutrinoFitObject *>(fo) && !dynamic_cast<const ZinvisibleFitObject *>(fo)) return false;
+  for (int ilocal = 0; ilocal < 3; ++ilocal) {
+    if (fo->isParamFixed (ilocal) || fo->isParamMeasured (ilocal)) return false;
+  }
+  return true;
+}
+
+bool StartValueSeeder::isPhoton (const BaseFitObject *fo) {
+  assert (fo);
+  return dynamic_cast<const ISRPhotonFitObject *>(fo) && !fo->isParamFixed (2);
+}
+
+bool StartValueSeeder::isUnknown (const BaseFitObject *fo, const std::vector<const BaseFitObject *>& known) {
+  return (isNeutrino (fo) || isPhoton (fo)) && std::find (known.begin(), known.end(), fo) == known.end();
+}
+
+bool StartValueSeeder::seedTransverse (BaseFitter& fitter, ParticleFitObject *fo) const {
+  std::vector<BaseFitObject *>& fitobjects = *fitter.getFitObjects();
+  std::vector<BaseHardConstraint *>& constraints = *fitter.getConstraints();
+
+  double p[2] = {fo->getPx(), fo->getPy()};
+  bool found[2] = {false, false};
+  for (unsigned int k = 0; k < constraints.size(); ++k) {
+    const MomentumConstraint *mc = dynamic_cast<const MomentumConstraint *>(constraints[k]);
+    double fact[4];
+    if (!mc || !mc->getFactors (fo, fact) || fact[0] != 0 || fact[3] != 0) continue;
+    for (int d = 0; d < 2; ++d) {
+      if (found[d] || fact[1+d] == 0 || fact[2-d] != 0) continue;
+      // the photons have fixed px, py; another neutrino would make the balance ambiguous
+      bool other = false;
+      for (unsigned int j = 0; j < fitobjects.size(); ++j) {
+        double factj[4];
+        if (fitobjects[j] != fo && isNeutrino (fitobjects[j]) && mc->getFactors (fitobjects[j], factj)) other = true;
+      }
+      if (other) continue;
+      // the constraint is linear in p: p -> p - c/f
+      p[d] -= mc->getValue()/fact[1+d];
+      found[d] = true;
+    }
+  }
+  if (!found[0] && !found[1]) return false;
+  setMomentum (fo, p[0], p[1], fo->getPz());
+  return true;
+}
+
+void StartValueSeeder::findPzCandidates (BaseFitter& fitter, ParticleFitObject *fo,
+                                         const std::vector<const BaseFitObject *>& known,
+                                         std::vector<double>& candidates) const {
+  std::vector<BaseFitObject *>& fitobjects = *fitter.getFitObjects();
+  std::vector<BaseHardConstraint *>& constraints = *fitter.getConstraints();
+  candidates.clear();
+
+  for (unsigned int k = 0; k < constraints.size(); ++k) {
+    // pz balance, if fo is the only unknown object
+    if (const MomentumConstraint *mc = dynamic_cast<const MomentumConstraint *>(constraints[k])) {
+      double fact[4];
+      if (!mc->getFactors (fo, fact) || fact[0] != 0 || fact[1] != 0 || fact[2] != 0 || fact[3] == 0) continue;
+      bool other = false;
+      for (unsigned int j = 0; j < fitobjects.size(); ++j) {
+        double factj[4];
+        if (fitobjects[j] != fo && isUnknown (fitobjects[j], known) && mc->getFactors (fitobjects[j], factj)) other = true;
+      }
+      if (!other) candidates.push_back (fo->getPz() - mc->getValue()/fact[3]);
+    }
+    // mass constraint: with the four-vector l of the partners of fo and mu = (M^2 - ml^2 - m^2)/2 + lT.pT,
+    // El*E = mu + lz*pz gives (El^2 - lz^2)*pz^2 - 2*mu*lz*pz + El^2*(pT^2 + m^2) - mu^2 = 0
+    else if (const MassConstraint *mc = dynamic_cast<const MassConstraint *>(constraints[k])) {
+      double M, l[4];
+      if (!mc->getTargetMass (fo, M, l) || M <= 0 || l[0] <= 0) continue;
+      double a = l[0]*l[0] - l[3]*l[3];
+      if (a <= 1E-6*l[0]*l[0]) continue;
+      double px = fo->getPx();
+      double py = fo->getPy();
+      double m = fo->getMass();
+      double ml2 = a - l[1]*l[1] - l[2]*l[2];
+      double mu = 0.5*(M*M - ml2 - m*m) + l[1]*px + l[2]*py;
+      double disc = l[0]*l[0]*(mu*mu - a*(px*px + py*py + m*m));
+      if (disc > 0) {
+        // both solutions; the wrong one is rejected by the constraint violation
+        double sq = std::sqrt (disc);
+        candidates.push_back ((mu*l[3] + sq)/a);
+        candidates.push_back ((mu*l[3] - sq)/a);
+      }
+      else {
+        // no real solution, e.g. because of the resolution: take the closest approach
+        candidates.push_back (mu*l[3]/a);
+      }
+    }
+  }
+}
+
+int StartValueSeeder::seedPhotons (BaseFitter& fitter, const std::vector<const BaseFitObject *>& known) const {
+  std::vector<BaseFitObject *>& fitobjects = *fitter.getFitObjects();
+  std::vector<BaseHardConstraint *>& constraints = *fitter.getConstraints();
+
+  int n = 0;
+  for (unsigned int i = 0; i < fitobjects.size(); ++i) {
+    if (!isPhoton (fitobjects[i])) continue;
+    ISRPhotonFitObject *fo = static_cast<ISRPhotonFitObject *>(fitobjects[i]);
+    for (unsigned int k = 0; k < constraints.size(); ++k) {
+      const MomentumConstraint *mc = dynamic_cast<const MomentumConstraint *>(constraints[k]);
+      double fact[4];
+      if (!mc || !mc->getFactors (fo, fact) || fact[0] != 0 || fact[3] == 0) continue;
+      bool other = false;
+      for (unsigned int j = 0; j < fitobjects.size(); ++j) {
+        double factj[4];
+        if (j != i && isUnknown (fitobjects[j], known) && mc->getFactors (fitobjects[j], factj)) other = true;
+      }
+      if (other) continue;
+      // set to zero without a warning below PzMin: this happens for wrong candidates, and is no user error
+      fo->setPz (fo->getPz() - mc->getValue()/fact[3], false);
+      ++n;
+      break;
+    }
+  }
+  return n;
+}
+
+void StartValueSeeder::setMomentum (ParticleFitObject *fo, double px, double py, double pz) {
+  assert (fo);
+  double pt = std::sqrt (px*px + py*py);
+  double m = fo->getMass();
+  fo->setParam (0, std::sqrt (pt*pt + pz*pz + m*m));
+  fo->setParam (1, std::atan2 (pt, pz));
+  fo->setParam (2, std::atan2 (py, px));
+}
@@ -131,11 +131,9 @@ void TextTracer::printConstraints (BaseFitter& fitter) {
 }
 
 void TextTracer::printTraceValues (BaseFitter& fitter) {
-  for (std::map<std::string, double>::iterator i =  fitter.traceValues.begin(); 
-       i != fitter.traceValues.end(); ++i) {
-    std::string name = i->first;
-    double value = i->second;
-    os << "Value of " << name << ": " << value << std::endl;;
+  for (int ikey = 0; ikey < TraceValues::getNKeys(); ++ikey) {
+    if (!fitter.traceValues.isSet (ikey)) continue;
+    os << "Value of " << TraceValues::getName (ikey) << ": " << fitter.traceValues.get (ikey) << std::endl;;
   }     
 }
 void TextTracer::printSums (BaseFitter& fitter) {
@@ -143,9 +141,8 @@ void TextTracer::printSums (BaseFitter& fitter) {
      << " = " << chi2fo + chi2sc << " = " << chi2fo << "(fo) + " << chi2sc << "(sc)"
      << std::endl;
   os << "Hard constraints: " << sumhc << ", scaled: " << sumhcscal << std::endl;
-  std::map<std::string, double>::iterator i = fitter.traceValues.find("mu"); 
-  if (i != fitter.traceValues.end()) {
-    double mu = i->second;
+  if (fitter.traceValues.isSet (TraceValues::MU)) {
+    double mu = fitter.traceValues.get (TraceValues::MU);
     os << "Contribution to merit function: " << sumhc*mu << ", scaled: " << sumhcscal*mu << std::endl;
     os << "Merit function: " << chi2fo + chi2sc + sumhc*mu << ", scaled: " << chi2fo + chi2sc + sumhcscal*mu << std::endl;
   }
@@ -0,0 +1,96 @@
+/*! \file
+ *  \brief Implements class ThreadPool
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ * - 18.10.2026 Switch the GSL error handler off during parallel work
+ *
+ */
+
+#include "ThreadPool.h"
+
+#include <gsl/gsl_errno.h>
+
+#undef NDEBUG
+#include <cassert>
+
+ThreadPool::ThreadPool (int nthreads)
+: workers (),
+  currenttask (0), ntask (0), nexttask (0), nbusy (0),
+  generation (0), stop (false)
+{
+  if (nthreads <= 0) nthreads = std::thread::hardware_concurrency();
+  if (nthreads <= 0) nthreads = 1;
+  for (int ithread = 1; ithread < nthreads; ++ithread) {
+    workers.push_back (std::thread (&ThreadPool::workerLoop, this, ithread));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::unique_lock<std::mutex> lock (mutex);
+    stop = true;
+  }
+  wakeup.notify_all();
+  for (unsigned int i = 0; i < workers.size(); ++i) workers[i].join();
+}
+
+int ThreadPool::getNThreads() const {
+  return workers.size()+1;
+}
+
+void ThreadPool::run (ParallelTask& task, int ntasks) {
+  if (ntasks <= 0) return;
+
+  // no worker threads: do everything here
+  if (workers.empty()) {
+    for (int itask = 0; itask < ntasks; ++itask) task.execute (itask, 0);
+    return;
+  }
+
+  // the fitters save and restore the error handler around decompositions
+  // that may fail; this is only safe across threads if it stays off throughout
+  gsl_error_handler_t *oldhandler = gsl_set_error_handler_off();
+
+  {
+    std::unique_lock<std::mutex> lock (mutex);
+    assert (currenttask == 0);
+    currenttask = &task;
+    ntask = ntasks;
+    nexttask = 0;
+    nbusy = workers.size();
+    ++generation;
+  }
+  wakeup.notify_all();
+
+  // the calling thread is thread number 0
+  work (0);
+
+  std::unique_lock<std::mutex> lock (mutex);
+  while (nbusy > 0) done.wait (lock);
+  currenttask = 0;
+  gsl_set_error_handler (oldhandler);
+}
+
+void ThreadPool::work (int ithread) {
+  for (int itask = nexttask++; itask < ntask; itask = nexttask++) {
+    currenttask->execute (itask, ithread);
+  }
+}
+
+void ThreadPool::workerLoop (int ithread) {
+  unsigned long seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock (mutex);
+      while (!stop && generation == seen) wakeup.wait (lock);
+      if (stop) return;
+      seen = generation;
+    }
+    work (ithread);
+    {
+      std::unique_lock<std::mutex> lock (mutex);
+      if (--nbusy == 0) done.notify_all();
+    }
+  }
+}
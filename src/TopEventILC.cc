@@ -16,7 +16,7 @@
 #include "NeutrinoFitObject.h"
 #include "MassConstraint.h"
 #include "SoftGaussMassConstraint.h"
-#include "OPALFitterGSL.h"
+#include "CounterRandom.h"
 
 #include <iostream>              // - cout
 #include <cmath>            
@@ -40,7 +40,7 @@ using std::sin;
 
 // constructor: 
 TopEventILC::TopEventILC()
-: leptonic (false), leptonasjet (false), debug (false),
+: softmasses (false), leptonic (false), leptonasjet (false), debug (false),
   pxc (0, 1),
   pyc (0, 0, 1),
   pzc (0, 0, 0, 1),
@@ -52,8 +52,8 @@ TopEventILC::TopEventILC()
   w2 (80.4),
   w (0)
   {
-  for (int i = 0; i < NFV; ++i) fv[i] = 0;
-  for (int i = 0; i < NBFO; ++i) bfo[i] = bfosmear[i] = 0;
+  for (int i = 0; i < NFV; ++i) fv[i] = fvsmear[i] = fvfinal[i] = 0;
+  for (int i = 0; i < NBFO; ++i) bfo[i] = bfostart[i] = bfosmear[i] = 0;
   pxc.setName ("px=0");
   pyc.setName ("py=0");
   pzc.setName ("pz=0");
@@ -68,13 +68,59 @@ TopEventILC::TopEventILC()
 
 //destructor: 
 TopEventILC::~TopEventILC() {
-  for (int i = 0; i < NFV; ++i) delete fv[i];
+  clearEvent();
+}
+
+TopEventILC *TopEventILC::copy() const {
+  TopEventILC *result = new TopEventILC;
+  result->softmasses  = softmasses;
+  result->leptonic    = leptonic;
+  result->leptonasjet = leptonasjet;
+  result->debug       = debug;
+  return result;
+}
+
+void TopEventILC::clearEvent() {
+  for (int i = 0; i < NFV; ++i) {
+    delete fv[i];
+    delete fvsmear[i];
+    delete fvfinal[i];
+    fv[i] = fvsmear[i] = fvfinal[i] = 0;
+  }
   for (int i = 0; i < NBFO; ++i) {
     delete bfo[i];
+    delete bfostart[i];
     delete bfosmear[i];
+    bfo[i] = bfostart[i] = bfosmear[i] = 0;
   }  
 }
 
+void TopEventILC::getRandoms (int n, double r[]) {
+  if (random) {
+    random->RndmArray (n, r);
+    return;
+  }
+  if (rnd == 0) rnd = new TRandom3();
+  rnd->RndmArray (n, r);
+}
+
+double TopEventILC::getGaus() {
+  if (random) return random->Gaus();
+  if (rnd == 0) rnd = new TRandom3();
+  return rnd->Gaus();
+}
+
+void TopEventILC::decay (const FourVector& mother, FourVector& d1, FourVector& d2) {
+  if (random) {
+    double r[2];
+    random->RndmArray (2, r);
+    mother.decayto (d1, d2, r[0], r[1]);
+  }
+  else {
+    mother.decayto (d1, d2);
+  }
+}
+
 // Generate Breit-Wigner Random number
 double TopEventILC::bwrandom (double r, double e0, double gamma, double emin, double emax) const {
   double a = atan (2.0*(emax - e0)/gamma);
@@ -97,6 +143,8 @@ void TopEventILC::genEvent(){
     w1.resetFOList();
     w2.resetFOList();
     w.resetFOList();
+    
+    clearEvent();
    
    
   // generate 4-vectors of top-decay:
@@ -121,8 +169,7 @@ void TopEventILC::genEvent(){
   double Ecm = 500;
       
   double rw[4];
-  if (rnd == 0) rnd = new TRandom3();
-  rnd->RndmArray (4, rw);
+  getRandoms (4, rw);
   
   FourVector *toppair = fv[0] = new FourVector (Ecm, 0, 0, 0);
   double mtop1 = bwrandom (rw[0], mtop, gammatop, mtop-3*gammatop, mtop+3*gammatop);
@@ -130,7 +177,7 @@ void TopEventILC::genEvent(){
   FourVector *top1 = fv[1] = new FourVector (mtop1, 0, 0, 0);
   FourVector *top2 = fv[2] = new FourVector (mtop2, 0, 0, 0);
   
-  toppair->decayto (*top1, *top2);
+  decay (*toppair, *top1, *top2);
   if (debug) {
     cout << "top 1: m=" << mtop1 << " = " << top1->getM() << endl;
     cout << "top 2: m=" << mtop2 << " = " << top2->getM() << endl;
@@ -148,8 +195,8 @@ void TopEventILC::genEvent(){
     cout << "W 2: m=" << mw2 << " = " << W2->getM() << endl;
   }  
   
-  top1->decayto (*W1, *b1);
-  top2->decayto (*W2, *b2);
+  decay (*top1, *W1, *b1);
+  decay (*top2, *W2, *b2);
   
   FourVector *j11 = fv[6]  = new FourVector (mj, 0, 0, 0);
   FourVector *j12 = fv[7]  = new FourVector (mj, 0, 0, 0);
@@ -157,8 +204,8 @@ void TopEventILC::genEvent(){
   FourVector *j21 = fv[9]  = new FourVector (mj, 0, 0, 0);
   FourVector *j22 = fv[10] = new FourVector (mj, 0, 0, 0);
   
-  W1->decayto (*j11, *j12);
-  W2->decayto (*j21, *j22);
+  decay (*W1, *j11, *j12);
+  decay (*W2, *j21, *j22);
   
   double Eresolhad = 0.35;     // 35% / sqrt (E)
   double Eresolem = 0.10;     // 10% / sqrt (E)
@@ -229,8 +276,7 @@ void TopEventILC::genEvent(){
     if (j == 4 && leptonic) bfo[4]->setName ("e22");
     
     double randoms[3];
-    if (rnd == 0) rnd = new TRandom3();
-    for (int irnd = 0; irnd < 3; ++irnd) randoms[irnd] = rnd->Gaus();
+    for (int irnd = 0; irnd < 3; ++irnd) randoms[irnd] = getGaus();
     
     // Create fit object with smeared quantities as fit input
     double ESmear = E + EError*randoms[0];
@@ -400,7 +446,7 @@ int TopEventILC::fitEvent (BaseFitter& fitter){
   fitter.addConstraint (pyc);
   fitter.addConstraint (pzc);
   fitter.addConstraint (ec);
-  if ( softmasses && !dynamic_cast<OPALFitterGSL*>(&fitter) ) {
+  if ( softmasses && fitter.supportsSoftConstraints() ) {
     fitter.addSoftConstraint (sw);
     fitter.addSoftConstraint (sw1);
     fitter.addSoftConstraint (sw2);
@@ -433,6 +479,10 @@ int TopEventILC::fitEvent (BaseFitter& fitter){
          << ", iterations: " << fitter.getIterations() << endl;
   }       
 
+  for (int i = 0; i < NFV; ++i) {
+    delete fvfinal[i];
+    fvfinal[i] = 0;
+  }
   for (int j = 0; j < 6; ++j) {
     int i = j+5;
     fvfinal[i] = new FourVector (bfosmear[j]->getE(), bfosmear[j]->getPx(), bfosmear[j]->getPy(), bfosmear[j]->getPz());
@@ -0,0 +1,235 @@
+/*! \file
+ *  \brief Implements classes ToyMCDriver, ToyMCStatistics and PullStatistics
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "ToyMCDriver.h"
+
+#include "BaseEvent.h"
+#include "BaseFitter.h"
+#include "BaseFitObject.h"
+#include "BaseDefs.h"
+
+#include <cmath>
+#include <chrono>
+
+#undef NDEBUG
+#include <cassert>
+
+const double PullStatistics::PULLMAX = 5;
+
+PullStatistics::PullStatistics()
+: n (0), sum (0), sum2 (0), underflow (0), overflow (0), hist (NBINS, 0)
+{}
+
+void PullStatistics::clear() {
+  n = 0;
+  sum = sum2 = 0;
+  underflow = overflow = 0;
+  hist.assign (NBINS, 0);
+}
+
+void PullStatistics::fill (double pull) {
+  ++n;
+  sum  += pull;
+  sum2 += pull*pull;
+  if (pull < -PULLMAX) ++underflow;
+  else if (pull >= PULLMAX) ++overflow;
+  else {
+    int ibin = int ((pull+PULLMAX)*NBINS/(2*PULLMAX));
+    if (ibin >= NBINS) ibin = NBINS-1;
+    ++hist[ibin];
+  }
+}
+
+void PullStatistics::add (const PullStatistics& rhs) {
+  n    += rhs.n;
+  sum  += rhs.sum;
+  sum2 += rhs.sum2;
+  underflow += rhs.underflow;
+  overflow  += rhs.overflow;
+  for (int ibin = 0; ibin < NBINS; ++ibin) hist[ibin] += rhs.hist[ibin];
+}
+
+double PullStatistics::getMean() const {
+  return n > 0 ? sum/n : 0;
+}
+
+double PullStatistics::getRMS() const {
+  if (n <= 0) return 0;
+  double mean = sum/n;
+  double var = sum2/n - mean*mean;
+  return var > 0 ? std::sqrt (var) : 0;
+}
+
+double PullStatistics::getBinLow (int ibin) {
+  return -PULLMAX + ibin*2*PULLMAX/NBINS;
+}
+
+ToyMCStatistics::ToyMCStatistics()
+: nevents (0), nfailed (0), nitsum (0), errors (), probhist (NPROBBINS, 0), pulls ()
+{}
+
+void ToyMCStatistics::clear() {
+  nevents = nfailed = nitsum = 0;
+  errors.clear();
+  probhist.assign (NPROBBINS, 0);
+  pulls.resize (0);
+}
+
+void ToyMCStatistics::add (const ToyMCStatistics& rhs) {
+  nevents += rhs.nevents;
+  nfailed += rhs.nfailed;
+  nitsum  += rhs.nitsum;
+  for (std::map<int, long>::const_iterator it = rhs.errors.begin(); it != rhs.errors.end(); ++it)
+    errors[it->first] += it->second;
+  for (int ibin = 0; ibin < NPROBBINS; ++ibin) probhist[ibin] += rhs.probhist[ibin];
+  if (pulls.size() < rhs.pulls.size()) pulls.resize (rhs.pulls.size());
+  for (unsigned int i = 0; i < rhs.pulls.size(); ++i) pulls[i].add (rhs.pulls[i]);
+}
+
+void ToyMCStatistics::fillPull (int ifo, int ilocal, double pull) {
+  assert (ifo >= 0);
+  assert (ilocal >= 0 && ilocal < BaseDefs::MAXPAR);
+  unsigned int i = ifo*BaseDefs::MAXPAR+ilocal;
+  if (i >= pulls.size()) pulls.resize (i+1);
+  pulls[i].fill (pull);
+}
+
+const PullStatistics *ToyMCStatistics::getPull (int ifo, int ilocal) const {
+  if (ifo < 0 || ilocal < 0 || ilocal >= BaseDefs::MAXPAR) return 0;
+  unsigned int i = ifo*BaseDefs::MAXPAR+ilocal;
+  if (i >= pulls.size() || pulls[i].n == 0) return 0;
+  return &pulls[i];
+}
+
+double ToyMCStatistics::getFailureRate() const {
+  return nevents > 0 ? double (nfailed)/nevents : 0;
+}
+
+double ToyMCStatistics::getMeanIterations() const {
+  return nevents > nfailed ? double (nitsum)/(nevents-nfailed) : 0;
+}
+
+ToyMCDriver::ToyMCDriver (const BaseEvent& prototype, const std::vector<BaseFitter *>& fitters_, uint64_t seed_)
+: pool (fitters_.size()),
+  events (), fitters (fitters_), randoms (fitters_.size(), CounterRandom (seed_)),
+  seed (seed_), blocksize (1000),
+  batchfirst (0), runend (0), blockstats (),
+  statistics (), realtime (0)
+{
+  assert (fitters.size() > 0);
+  assert (pool.getNThreads() == (int)fitters.size());
+  for (unsigned int ithread = 0; ithread < fitters.size(); ++ithread) {
+    assert (fitters[ithread]);
+    BaseEvent *event = prototype.copy();
+    assert (event);
+    event->setRandom (&randoms[ithread]);
+    events.push_back (event);
+  }
+}
+
+ToyMCDriver::~ToyMCDriver() {
+  for (unsigned int ithread = 0; ithread < events.size(); ++ithread) delete events[ithread];
+}
+
+void ToyMCDriver::setSeed (uint64_t seed_) {
+  seed = seed_;
+  for (unsigned int ithread = 0; ithread < randoms.size(); ++ithread) randoms[ithread].setSeed (seed);
+}
+
+void ToyMCDriver::setBlockSize (int blocksize_) {
+  if (blocksize_ > 0) blocksize = blocksize_;
+}
+
+void ToyMCDriver::run (long nevents, long firstevent) {
+  if (nevents <= 0) return;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  // enough blocks per batch to keep all threads busy
+  const long nblocksperbatch = 8*pool.getNThreads();
+  runend = firstevent+nevents;
+  for (batchfirst = firstevent; batchfirst < runend; batchfirst += nblocksperbatch*blocksize) {
+    long nblocks = (runend-batchfirst+blocksize-1)/blocksize;
+    if (nblocks > nblocksperbatch) nblocks = nblocksperbatch;
+    blockstats.resize (nblocks);
+    for (unsigned int iblock = 0; iblock < blockstats.size(); ++iblock) blockstats[iblock].clear();
+
+    pool.run (*this, nblocks);
+
+    // fixed order of summation, independent of the scheduling
+    for (unsigned int iblock = 0; iblock < blockstats.size(); ++iblock) statistics.add (blockstats[iblock]);
+  }
+
+  realtime += std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+}
+
+void ToyMCDriver::execute (int itask, int ithread) {
+  assert (itask >= 0 && itask < (int)blockstats.size());
+  assert (ithread >= 0 && ithread < (int)events.size());
+  long first = batchfirst + long (itask)*blocksize;
+  long last = first + blocksize;
+  if (last > runend) last = runend;
+  for (long ievent = first; ievent < last; ++ievent) processEvent (ievent, ithread, blockstats[itask]);
+}
+
+void ToyMCDriver::processEvent (long ievent, int ithread, ToyMCStatistics& stat) {
+  BaseEvent& event = *events[ithread];
+  BaseFitter& fitter = *fitters[ithread];
+
+  randoms[ithread].setStream (ievent);
+  event.genEvent();
+  int error = event.fitEvent (fitter);
+
+  ++stat.nevents;
+  ++stat.errors[error];
+  if (error != 0) {
+    ++stat.nfailed;
+    return;
+  }
+  stat.nitsum += fitter.getIterations();
+
+  double prob = fitter.getProbability();
+  int ibin = int (prob*ToyMCStatistics::NPROBBINS);
+  if (ibin < 0) ibin = 0;
+  if (ibin >= ToyMCStatistics::NPROBBINS) ibin = ToyMCStatistics::NPROBBINS-1;
+  ++stat.probhist[ibin];
+
+  for (int ifo = 0; ifo < event.getNFitObjects(); ++ifo) {
+    const BaseFitObject *start  = event.getStartFitObject (ifo);
+    const BaseFitObject *fitted = event.getFittedFitObject (ifo);
+    if (!start || !fitted) continue;
+    for (int ilocal = 0; ilocal < start->getNPar(); ++ilocal) {
+      if (!start->isParamMeasured (ilocal) || start->isParamFixed (ilocal)) continue;
+      double err0 = start->getError (ilocal);
+      double err1 = fitted->getError (ilocal);
+      double var = err0*err0 - err1*err1;
+      if (var <= 0) continue;
+      stat.fillPull (ifo, ilocal, (start->getParam (ilocal) - fitted->getParam (ilocal))/std::sqrt (var));
+    }
+  }
+}
+
+const ToyMCStatistics& ToyMCDriver::getStatistics() const {
+  return statistics;
+}
+
+void ToyMCDriver::resetStatistics() {
+  statistics.clear();
+  realtime = 0;
+}
+
+double ToyMCDriver::getRealTime() const {
+  return realtime;
+}
+
+double ToyMCDriver::getEventsPerSecond() const {
+  return realtime > 0 ? statistics.nevents/realtime : 0;
+}
+
+int ToyMCDriver::getNThreads() const {
+  return pool.getNThreads();
+}
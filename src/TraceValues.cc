@@ -0,0 +1,79 @@
+/*! \file
+ *  \brief Implements class TraceValues
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "TraceValues.h"
+
+#include <mutex>
+#include <atomic>
+
+#undef NDEBUG
+#include <cassert>
+
+namespace {
+  // The key names; entries below nkeys are never changed again,
+  // so they can be read without locking
+  struct KeyRegistry {
+    KeyRegistry(): nkeys (TraceValues::NSTANDARD) {
+      names[TraceValues::ALPHA] = "alpha";
+      names[TraceValues::PHI]   = "phi";
+      names[TraceValues::MU]    = "mu";
+      names[TraceValues::DETW]  = "detW";
+    }
+    std::string names[TraceValues::MAXKEYS];
+    std::atomic<int> nkeys;
+    std::mutex mutex;
+  };
+  
+  // constructed on first use, also if used during static initialisation
+  KeyRegistry& registry() {
+    static KeyRegistry theRegistry;
+    return theRegistry;
+  }
+}
+
+TraceValues::TraceValues()
+: setmask (0)
+{
+  for (int ikey = 0; ikey < MAXKEYS; ++ikey) values[ikey] = 0;
+}
+
+int TraceValues::registerKey (const std::string& name) {
+  int ikey = findKey (name);
+  if (ikey >= 0) return ikey;
+
+  KeyRegistry& r = registry();
+  std::lock_guard<std::mutex> lock (r.mutex);
+  // check again, another thread may have registered it meanwhile
+  int n = r.nkeys;
+  for (ikey = 0; ikey < n; ++ikey) if (r.names[ikey] == name) return ikey;
+  if (n >= MAXKEYS) return -1;
+  r.names[n] = name;
+  r.nkeys = n+1;
+  return n;
+}
+
+int TraceValues::findKey (const std::string& name) {
+  KeyRegistry& r = registry();
+  int n = r.nkeys;
+  for (int ikey = 0; ikey < n; ++ikey) if (r.names[ikey] == name) return ikey;
+  return -1;
+}
+
+const char *TraceValues::getName (int ikey) {
+  KeyRegistry& r = registry();
+  if (ikey < 0 || ikey >= r.nkeys) return "undefined";
+  return r.names[ikey].c_str();
+}
+
+int TraceValues::getNKeys() {
+  return registry().nkeys;
+}
+
+void TraceValues::set (const std::string& name, double value) {
+  set (registerKey (name), value);
+}
@@ -0,0 +1,145 @@
+/*! \file
+ *  \brief Implements class TriggeredTracer
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "TriggeredTracer.h"
+
+#include "BinaryTracer.h"
+#include "BaseFitter.h"
+#include "BaseFitObject.h"
+
+#undef NDEBUG
+#include <cassert>
+
+TriggeredTracer::TriggeredTracer (BaseTracer *next_)
+: tracefailures (true), itthreshold (0), samplerate (0), maxrecords (1000),
+  records (), nrecords (0), nfits (0), nselected (0), ndropped (0)
+{
+  next = next_;
+}
+
+TriggeredTracer::~TriggeredTracer() {}
+
+void TriggeredTracer::initialize (BaseFitter& fitter) {
+  nrecords = 0;
+  store (fitter, BinaryTraceRecord::INITIALIZE, 0);
+}
+
+void TriggeredTracer::step (BaseFitter& fitter) {
+  store (fitter, BinaryTraceRecord::STEP, 0);
+}
+
+void TriggeredTracer::substep (BaseFitter& fitter, int flag) {
+  store (fitter, BinaryTraceRecord::SUBSTEP, flag);
+}
+
+void TriggeredTracer::finish (BaseFitter& fitter) {
+  store (fitter, BinaryTraceRecord::FINISH, 0);
+  ++nfits;
+  if (next && isSelected (fitter)) {
+    ++nselected;
+    replay (fitter);
+  }
+  nrecords = 0;
+}
+
+void TriggeredTracer::setTraceFailures (bool tracefailures_) {
+  tracefailures = tracefailures_;
+}
+
+void TriggeredTracer::setIterationThreshold (int nit) {
+  itthreshold = nit > 0 ? nit : 0;
+}
+
+void TriggeredTracer::setSampleRate (int n) {
+  samplerate = n > 0 ? n : 0;
+}
+
+void TriggeredTracer::setMaxRecords (int maxrecords_) {
+  maxrecords = maxrecords_ > 2 ? maxrecords_ : 2;
+}
+
+long TriggeredTracer::getNFits() const {
+  return nfits;
+}
+
+long TriggeredTracer::getNSelected() const {
+  return nselected;
+}
+
+long TriggeredTracer::getNDropped() const {
+  return ndropped;
+}
+
+void TriggeredTracer::store (BaseFitter& fitter, int type, int flag) {
+  // record 0 is the first call of the fit, the others form a ring
+  int islot;
+  if (nrecords < maxrecords) {
+    islot = nrecords;
+  }
+  else {
+    islot = 1 + (nrecords-1) % (maxrecords-1);
+    ++ndropped;
+  }
+  if (islot >= (int)records.size()) records.resize (islot+1);
+  BinaryTracer::fillRecord (fitter, type, flag, records[islot]);
+  ++nrecords;
+}
+
+bool TriggeredTracer::isSelected (BaseFitter& fitter) const {
+  if (tracefailures && fitter.getError() != 0) return true;
+  if (itthreshold > 0 && fitter.getIterations() > itthreshold) return true;
+  if (samplerate > 0 && (nfits-1) % samplerate == 0) return true;
+  return false;
+}
+
+void TriggeredTracer::replay (BaseFitter& fitter) {
+  assert (next);
+  if (nrecords == 0) return;
+  // the final state, to be restored afterwards
+  BinaryTraceRecord last = records[nrecords <= maxrecords ? nrecords-1 : 1 + (nrecords-2) % (maxrecords-1)];
+
+  BinaryTracer *bt = dynamic_cast<BinaryTracer *>(next);
+  long nkept = nrecords < maxrecords ? nrecords : maxrecords;
+  for (long i = 0; i < nkept; ++i) {
+    // oldest first: record 0, then the ring starting after the newest entry
+    long islot = (i == 0 || nrecords <= maxrecords) ? i : 1 + (nrecords-1 + i-1) % (maxrecords-1);
+    const BinaryTraceRecord& r = records[islot];
+    restore (fitter, r);
+    if (bt) {
+      bt->replay (fitter, r);
+      continue;
+    }
+    switch (r.type) {
+      case BinaryTraceRecord::INITIALIZE: next->initialize (fitter); break;
+      case BinaryTraceRecord::STEP:       next->step (fitter); break;
+      case BinaryTraceRecord::SUBSTEP:    next->substep (fitter, r.flag); break;
+      case BinaryTraceRecord::FINISH:     next->finish (fitter); break;
+    }
+  }
+  restore (fitter, last);
+}
+
+void TriggeredTracer::restore (BaseFitter& fitter, const BinaryTraceRecord& r) {
+  std::vector<BaseFitObject *> *fitobjects = fitter.getFitObjects();
+  if (fitobjects) {
+    int ipar = 0;
+    for (unsigned int ifo = 0; ifo < fitobjects->size(); ++ifo) {
+      BaseFitObject *fo = (*fitobjects)[ifo];
+      if (!fo) continue;
+      for (int ilocal = 0; ilocal < fo->getNPar() && ipar < r.npar; ++ilocal)
+        fo->setParam (ilocal, r.par[ipar++]);
+    }
+  }
+#ifndef FIT_TRACEOFF
+  fitter.traceValues.clear();
+  fitter.traceValues.set (TraceValues::ALPHA, r.alpha);
+  fitter.traceValues.set (TraceValues::PHI,   r.phi);
+  fitter.traceValues.set (TraceValues::MU,    r.mu);
+  fitter.traceValues.set (TraceValues::DETW,  r.detW);
+#endif
+}
@@ -0,0 +1,136 @@
+/*! \file
+ *  \brief Implements classes VertexConstraintBlock and VertexConstraintRow
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "VertexConstraintBlock.h"
+#include "TrackParticleFitObject.h"
+#include "VertexFitObject.h"
+#include "ThreeVector.h"
+
+#undef NDEBUG
+#include <cassert>
+
+VertexConstraintRow::VertexConstraintRow ()
+: block (0), axis (0)
+{}
+
+VertexConstraintRow::~VertexConstraintRow ()
+{}
+
+void VertexConstraintRow::setBlock (const VertexConstraintBlock& block_, int axis_) {
+  assert (axis_ >= 0 && axis_ < 3);
+  block = &block_;
+  axis = axis_;
+}
+
+double VertexConstraintRow::getValue() const {
+  assert (block);
+  return block->getValue (axis);
+}
+
+void VertexConstraintRow::getDerivatives(int idim, double der[]) const {
+  assert (block);
+  block->getDerivatives (axis, idim, der);
+}
+
+bool VertexConstraintRow::firstDerivatives(int, double*) const {
+  // as VertexConstraint
+  assert(0);
+  return true;
+}
+
+bool VertexConstraintRow::secondDerivatives(int, int, double*) const {
+  assert(0);
+  return true;
+}
+
+VertexConstraintBlock::VertexConstraintBlock ()
+: vertex (0), track (0), ivertex (0), cachevalid (false)
+{
+  for (int axis = 0; axis < 3; ++axis) rows[axis].setBlock (*this, axis);
+}
+
+VertexConstraintBlock::~VertexConstraintBlock ()
+{}
+
+void VertexConstraintBlock::set (const VertexFitObject& vertex_,
+                                 const TrackParticleFitObject& track_,
+                                 int ivertex_) {
+  assert (ivertex_ == 0 || ivertex_ == 1);
+  assert (vertex_.getNPar() <= BaseDefs::MAXPAR);
+  assert (track_.getNPar() <= BaseDefs::MAXPAR);
+  vertex = &vertex_;
+  track = &track_;
+  ivertex = ivertex_;
+  cachevalid = false;
+}
+
+VertexConstraintRow& VertexConstraintBlock::getRow (int axis) {
+  assert (axis >= 0 && axis < 3);
+  return rows[axis];
+}
+
+void VertexConstraintBlock::update() const {
+  assert (vertex);
+  assert (track);
+  int nvertex = vertex->getNPar();
+  int ntrack = track->getNPar();
+
+  if (cachevalid) {
+    bool changed = false;
+    for (int ilocal = 0; ilocal < nvertex; ++ilocal) changed |= (vertex->getParam (ilocal) != vertexpar[ilocal]);
+    for (int ilocal = 0; ilocal < ntrack; ++ilocal)  changed |= (track->getParam (ilocal) != trackpar[ilocal]);
+    if (!changed) return;
+  }
+  for (int ilocal = 0; ilocal < nvertex; ++ilocal) vertexpar[ilocal] = vertex->getParam (ilocal);
+  for (int ilocal = 0; ilocal < ntrack; ++ilocal)  trackpar[ilocal] = track->getParam (ilocal);
+
+  // One evaluation of the track point and its derivatives for all three axes
+  ThreeVector v;
+  vertex->getVertexEx (v);
+  ThreeVector t = track->getVertex (ivertex);
+  for (int axis = 0; axis < 3; ++axis) value[axis] = v.getComponent (axis) - t.getComponent (axis);
+
+  ThreeVector d;
+  for (int ilocal = 0; ilocal < nvertex; ++ilocal) {
+    vertex->getVertexDerivativeEx (ilocal, d);
+    for (int axis = 0; axis < 3; ++axis) vertexder[axis][ilocal] = d.getComponent (axis);
+  }
+  for (int ilocal = 0; ilocal < ntrack; ++ilocal) {
+    d = track->getVertexDerivative (ivertex, ilocal);
+    for (int axis = 0; axis < 3; ++axis) trackder[axis][ilocal] = d.getComponent (axis);
+  }
+  cachevalid = true;
+}
+
+double VertexConstraintBlock::getValue (int axis) const {
+  assert (axis >= 0 && axis < 3);
+  update();
+  return value[axis];
+}
+
+void VertexConstraintBlock::getDerivatives (int axis, int idim, double der[]) const {
+  assert (axis >= 0 && axis < 3);
+  update();
+
+  for (int iglobal = 0; iglobal < idim; iglobal++) der[iglobal] = 0;
+
+  for (int ilocal = 0; ilocal < vertex->getNPar(); ilocal++) {
+    if (!vertex->isParamFixed(ilocal)) {
+      int iglobal = vertex->getGlobalParNum (ilocal);
+      assert (iglobal >= 0 && iglobal < idim);
+      der[iglobal] += vertexder[axis][ilocal];
+    }
+  }
+  for (int ilocal = 0; ilocal < track->getNPar(); ilocal++) {
+    if (!track->isParamFixed(ilocal)) {
+      int iglobal = track->getGlobalParNum (ilocal);
+      assert (iglobal >= 0 && iglobal < idim);
+      der[iglobal] -= trackder[axis][ilocal];
+    }
+  }
+}
@@ -15,11 +15,13 @@
 #include "TwoVector.h"
 #include "ThreeVector.h"
 #include "FourVector.h"
-#include "VertexConstraint.h"
+#include "VertexConstraintBlock.h"
 #include "MomentumConstraint.h"
 #include "TrackParticleFitObject.h"
 #include "BaseFitter.h"
+#include "NewFitterGSL.h"
 #include "JBLHelix.h"
+#include "JBLHelixBatch.h"
 #include <gsl/gsl_matrix.h>
 #include <gsl/gsl_linalg.h>
 
@@ -41,8 +43,9 @@ VertexFitObject::VertexFitObject(const char *name_,
                                  double y,
                                  double z
                                 )
-: tracks (0), constraints (0)
+: tracks (0), constraints (0), blocks (0)
 {
+  for (int i = 0; i < 4; ++i) momentumconstraints[i] = 0;
 
   assert( int(NPAR) <= int(BaseDefs::MAXPAR) );
 
@@ -58,7 +61,9 @@ VertexFitObject::VertexFitObject(const char *name_,
 }
 
 VertexFitObject::VertexFitObject (const VertexFitObject& rhs) 
+: tracks (0), constraints (0), blocks (0)
 {
+  for (int i = 0; i < 4; ++i) momentumconstraints[i] = 0;
   //  copy (rhs);
   VertexFitObject::assign (rhs);
 }
@@ -94,6 +99,7 @@ VertexFitObject::~VertexFitObject()
     delete (*it);
     (*it) = 0;
   }
+  for (unsigned int i = 0; i < blocks.size(); ++i) delete blocks[i];
 }
 
 const char *VertexFitObject::getParamName (int ilocal) const {
@@ -174,30 +180,40 @@ void VertexFitObject::addVertexConstraints (BaseFitter& fitter, int axis) {
 
   //  cout << "hello from addVertexConstraints: axis " << axis << endl;
 
-  for (TIterator it = tracks.begin(); it != tracks.end(); ++it) {
-    assert(it->track); 
+  // one block per track holds the constraints for all axes;
+  // blocks from a previous call are reused
+  while (blocks.size() < tracks.size()) blocks.push_back (new VertexConstraintBlock);
+
+  for (unsigned int i = 0; i < tracks.size(); ++i) {
+    TrackDescriptor& td = tracks[i];
+    assert(td.track); 
 
-    int iTrkVtx = it->inbound ? 1 : 0 ;
+    int iTrkVtx = td.inbound ? 1 : 0 ;
 
     // un-fix the vertex parameter of this track
-    it->track->releaseVertexParam( iTrkVtx );
+    td.track->releaseVertexParam( iTrkVtx );
 
-    VertexConstraint *con = new VertexConstraint (*this, *(it->track), iTrkVtx, axis);
-    con->setName (this->getName());
+    blocks[i]->set (*this, *(td.track), iTrkVtx);
+    VertexConstraintRow& con = blocks[i]->getRow (axis);
+    con.setName (this->getName());
 
-    //    cout << "vertex constraint value = " << con->getValue() << endl;
+    //    cout << "vertex constraint value = " << con.getValue() << endl;
 
     fitter.addConstraint (con);
-    constraints.push_back (con);
-
-    it->track->releaseVertexParam (it->inbound ? 1 : 0);
   }
 }
 
 void VertexFitObject::addMomentumConstraint (BaseFitter& fitter, int axis) {
-  MomentumConstraint *con = new MomentumConstraint (axis);
+  assert (axis >= 0 && axis < 4);
+  MomentumConstraint *con = momentumconstraints[axis];
+  if (con) {
+    con->resetFOList();
+  }
+  else {
+    con = momentumconstraints[axis] = new MomentumConstraint (axis);
+    constraints.push_back (con);
+  }
   fitter.addConstraint (con);
-  constraints.push_back (con);
   
   // Add first inbound track
   for (TIterator it = tracks.begin(); it != tracks.end(); ++it) {
@@ -223,6 +239,10 @@ void VertexFitObject::addConstraints (BaseFitter& fitter, int mask) {
   if (mask & PY) addMomentumConstraint (fitter, 2);
   if (mask & PZ) addMomentumConstraint (fitter, 3);
   if (mask & E)  addMomentumConstraint (fitter, 0);
+  
+  // The vertex couples to all tracks; a NewFitterGSL with arrowhead solver
+  // eliminates the tracks one by one and solves only for the vertex
+  if (NewFitterGSL *newfitter = dynamic_cast<NewFitterGSL *>(&fitter)) newfitter->addSharedFitObject (this);
 
 }
 
@@ -237,31 +257,40 @@ ThreeVector VertexFitObject::estimatePosition () {
 
   ThreeVector commonRefPoint(0,0,0);
 
-  // DANIEL removed for now (to get it to compile without the JBLhelix class)
-   int n = 0;
-   for (TIterator it0 = tracks.begin(); it0 != tracks.end(); ++it0) {
-     if (it0->measured) {
-       JBLHelix h0 = it0->track->getJBLHelix(commonRefPoint);
-       TIterator it1 = it0;
-       for (++it1; it1 != tracks.end(); ++it1) {
-         if (it1->measured) {
-           if (debug)
-             cout << "Intersecting " << it0->track->getName()
-                  << " and " << it1->track->getName() << endl;
-           JBLHelix h1 = it1->track->getJBLHelix(commonRefPoint);
-           double s0, s1, s02nd, s12nd;
-           h0.getClosestApproach (h1, s0, s1, s02nd, s12nd);
-           position += h0.getTrajectoryPoint (s0);
-           position += h1.getTrajectoryPoint (s1);
-           if (debug)
-             cout << "  point 0: " << h0.getTrajectoryPoint (s0)
-                  << ", point 1: " << h1.getTrajectoryPoint (s1) << endl;
-           n += 2;
-         }
-       }
-     }
-   }
-   position *= (1./n);
+  // Get the helices of all measured tracks once, then intersect all pairs
+  JBLHelixBatch helices;
+  std::vector<TrackParticleFitObject *> measured;
+  for (TIterator it = tracks.begin(); it != tracks.end(); ++it) {
+    if (it->measured) {
+      helices.addHelix (it->track->getJBLHelix(commonRefPoint));
+      measured.push_back (it->track);
+    }
+  }
+  int npairs = helices.getNPairs();
+  std::vector<double> s0 (npairs), s1 (npairs), s02nd (npairs), s12nd (npairs);
+  std::vector<int> result (npairs);
+  if (npairs > 0) helices.getAllClosestApproaches (&s0[0], &s1[0], &s02nd[0], &s12nd[0], &result[0]);
+  
+  int n = 0;
+  ThreeVector p0, p1;
+  int ipair = 0;
+  for (int i = 0; i < helices.getNHelices(); ++i) {
+    for (int j = i+1; j < helices.getNHelices(); ++j, ++ipair) {
+      if (debug)
+        cout << "Intersecting " << measured[i]->getName()
+             << " and " << measured[j]->getName() << endl;
+      // straight tracks cannot be intersected
+      if (result[ipair] < 0) continue;
+      helices.getTrajectoryPointEx (i, s0[ipair], p0);
+      helices.getTrajectoryPointEx (j, s1[ipair], p1);
+      position += p0;
+      position += p1;
+      if (debug)
+        cout << "  point 0: " << p0 << ", point 1: " << p1 << endl;
+      n += 2;
+    }
+  }
+  if (n > 0) position *= (1./n);
    if (debug) cout << "Final position estimate: " << position << endl;
 
   return position;
@@ -0,0 +1,237 @@
+/*! \file
+ *  \brief Checks ArrowheadSolver against a dense LU decomposition
+ *
+ * Sets up random linear systems with block arrowhead structure
+ * (blocks of different sizes, coupled by shared rows, with rows and
+ * columns in random order), solves them with ArrowheadSolver,
+ * with GSLLinAlgBackend and SmallLinAlgBackend, and compares
+ * solution and determinant with gsl_linalg_LU_solve and
+ * gsl_linalg_LU_det. Also checks that a row coupling all blocks is
+ * made shared, and that systems with a singular block or a singular
+ * Schur complement are reported as failed.
+ * Returns 1 if any check fails.
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "ArrowheadSolver.h"
+#include "GSLLinAlgBackend.h"
+#include "SmallLinAlgBackend.h"
+
+#include <gsl/gsl_vector.h>
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_permutation.h>
+#include <gsl/gsl_linalg.h>
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cmath>
+
+namespace {
+  const double tolerance = 1E-10;
+
+  // A random system with block arrowhead structure
+  struct System {
+    gsl_matrix *M;
+    gsl_vector *y;
+    std::vector<int> shared;     // the given shared rows
+    std::vector<int> coupling;   // rows that couple all blocks, not given as shared
+    int nblocks;
+  };
+
+  // Set up a system with nblocks blocks of 3 to maxsize rows, ns shared rows
+  // and ncoupling rows that couple to all blocks; rows are in random order
+  System generate (std::mt19937& rng, int nblocks, int maxsize, int ns, int ncoupling) {
+    std::uniform_real_distribution<double> flat (-1, 1);
+    std::uniform_int_distribution<int> size (3, maxsize);
+
+    // block of each row in the natural order; -1 for shared, -2 for coupling rows
+    std::vector<int> block;
+    for (int ib = 0; ib < nblocks; ++ib) {
+      int ni = size (rng);
+      for (int a = 0; a < ni; ++a) block.push_back (ib);
+    }
+    for (int c = 0; c < ns; ++c) block.push_back (-1);
+    for (int c = 0; c < ncoupling; ++c) block.push_back (-2);
+    int n = block.size();
+    std::shuffle (block.begin(), block.end(), rng);
+
+    System s;
+    s.M = gsl_matrix_alloc (n, n);
+    gsl_matrix_set_zero (s.M);
+    s.y = gsl_vector_alloc (n);
+    s.nblocks = nblocks;
+    for (int i = 0; i < n; ++i) {
+      if (block[i] == -1) s.shared.push_back (i);
+      if (block[i] == -2) s.coupling.push_back (i);
+      gsl_vector_set (s.y, i, flat (rng));
+      for (int j = 0; j < n; ++j) {
+        // no elements between different blocks; not symmetric, but with symmetric pattern
+        bool coupled = block[i] == block[j] || block[i] < 0 || block[j] < 0;
+        if (coupled) gsl_matrix_set (s.M, i, j, (i == j ? 4 : 0) + flat (rng));
+      }
+    }
+    return s;
+  }
+
+  void release (System& s) {
+    gsl_matrix_free (s.M);
+    gsl_vector_free (s.y);
+  }
+
+  // Solve with a dense LU decomposition; returns the determinant
+  double solveLU (const System& s, gsl_vector *x) {
+    int n = s.M->size1;
+    gsl_matrix *LU = gsl_matrix_alloc (n, n);
+    gsl_matrix_memcpy (LU, s.M);
+    gsl_permutation *p = gsl_permutation_alloc (n);
+    int signum;
+    gsl_linalg_LU_decomp (LU, p, &signum);
+    double det = gsl_linalg_LU_det (LU, signum);
+    if (det != 0) gsl_linalg_LU_solve (LU, p, s.y, x);
+    gsl_permutation_free (p);
+    gsl_matrix_free (LU);
+    return det;
+  }
+
+  // Solve s with solver and backend linalg, compare with the dense solution; returns whether it agrees
+  bool check (const System& s, ArrowheadSolver& solver, const LinAlgBackend& linalg, const char *name) {
+    int n = s.M->size1;
+    gsl_vector *x = gsl_vector_alloc (n);
+    gsl_vector *xLU = gsl_vector_alloc (n);
+    double detLU = solveLU (s, xLU);
+
+    solver.setLinAlgBackend (linalg);
+    bool ok = solver.analyse (s.M, s.shared);
+    double det = 0;
+    int ierr = ok ? solver.solve (x, det, s.M, s.y) : -1;
+    if (!ok) {
+      std::cout << name << ": no arrowhead structure found" << std::endl;
+    }
+    else if (solver.getNBlocks() != s.nblocks || solver.getNShared() != int (s.shared.size() + s.coupling.size())) {
+      std::cout << name << ": " << solver.getNBlocks() << " blocks, " << solver.getNShared()
+                << " shared rows instead of " << s.nblocks << ", " << s.shared.size() + s.coupling.size() << std::endl;
+      ok = false;
+    }
+    else if (ierr != 0) {
+      std::cout << name << ": solve failed with " << ierr << ", determinant " << detLU << std::endl;
+      ok = false;
+    }
+    else {
+      if (std::abs (det - detLU) > tolerance*std::abs (detLU)) {
+        std::cout << name << ": determinant " << det << " instead of " << detLU << std::endl;
+        ok = false;
+      }
+      double xmax = 0;
+      for (int i = 0; i < n; ++i) xmax = std::max (xmax, std::abs (gsl_vector_get (xLU, i)));
+      for (int i = 0; i < n; ++i) {
+        if (std::abs (gsl_vector_get (x, i) - gsl_vector_get (xLU, i)) > tolerance*xmax) {
+          std::cout << name << ": x[" << i << "] = " << gsl_vector_get (x, i)
+                    << " instead of " << gsl_vector_get (xLU, i) << std::endl;
+          ok = false;
+          break;
+        }
+      }
+    }
+    gsl_vector_free (x);
+    gsl_vector_free (xLU);
+    return ok;
+  }
+
+  // Make row i of s equal to row j, in the columns of the block (and shared columns) of j
+  void copyRow (System& s, int i, int j) {
+    for (unsigned int k = 0; k < s.M->size2; ++k) {
+      if (gsl_matrix_get (s.M, j, k) != 0 || gsl_matrix_get (s.M, i, k) != 0)
+        gsl_matrix_set (s.M, i, k, gsl_matrix_get (s.M, j, k));
+    }
+  }
+
+  // Solve s, which is singular, with solver and backend linalg; returns whether the failure is reported
+  bool checkSingular (const System& s, ArrowheadSolver& solver, const LinAlgBackend& linalg,
+                      int expected, const char *name) {
+    gsl_vector *x = gsl_vector_alloc (s.M->size1);
+    solver.setLinAlgBackend (linalg);
+    double det = 0;
+    int ierr = solver.analyse (s.M, s.shared) ? solver.solve (x, det, s.M, s.y) : -1;
+    gsl_vector_free (x);
+    if (ierr != expected) {
+      std::cout << name << ": singular system gives " << ierr << " instead of " << expected << std::endl;
+      return false;
+    }
+    return true;
+  }
+}
+
+int main() {
+  std::mt19937 rng (4711);
+  GSLLinAlgBackend gsl;
+  SmallLinAlgBackend small;
+  const LinAlgBackend *backends[2] = {&gsl, &small};
+  // with blocks of 3 to 6 rows, a row coupling all blocks makes a component larger than 6
+  ArrowheadSolver solver (6);
+
+  int nchecks = 0;
+  int nfailed = 0;
+
+  // regular systems: with and without shared rows, with and without rows coupling all blocks
+  const int nblocks[] = {2, 5, 20};
+  for (int isys = 0; isys < 3*3*2*10; ++isys) {
+    int nb = nblocks[isys%3];
+    int ns = (isys/3)%3*2;
+    int ncoupling = (isys/9)%2;
+    System s = generate (rng, nb, 6, ns, ncoupling);
+    for (int ib = 0; ib < 2; ++ib) {
+      ++nchecks;
+      if (!check (s, solver, *backends[ib], backends[ib]->getName())) {
+        std::cout << "  in system " << isys << " with " << nb << " blocks, " << ns << " shared and "
+                  << ncoupling << " coupling rows" << std::endl;
+        ++nfailed;
+      }
+    }
+    release (s);
+  }
+
+  // singular systems: two equal rows in a block, or two equal shared rows
+  for (int isys = 0; isys < 20; ++isys) {
+    bool inblock = isys%2 == 0;
+    System s = generate (rng, 5, 6, 3, 0);
+    if (inblock) {
+      // the first row of a block with at least two rows, and another row of it
+      int i = -1, j = -1;
+      std::vector<int> isshared (s.M->size1, 0);
+      for (unsigned int k = 0; k < s.shared.size(); ++k) isshared[s.shared[k]] = 1;
+      for (int a = 0; a < int (s.M->size1) && j < 0; ++a) {
+        if (isshared[a]) continue;
+        for (int b = a+1; b < int (s.M->size1) && j < 0; ++b) {
+          if (!isshared[b] && gsl_matrix_get (s.M, a, b) != 0) {
+            i = a;
+            j = b;
+          }
+        }
+      }
+      if (j < 0) {
+        release (s);
+        continue;
+      }
+      copyRow (s, i, j);
+    }
+    else {
+      copyRow (s, s.shared[0], s.shared[1]);
+    }
+    for (int ib = 0; ib < 2; ++ib) {
+      ++nchecks;
+      if (!checkSingular (s, solver, *backends[ib], inblock ? 1 : 2, backends[ib]->getName())) {
+        std::cout << "  in singular system " << isys << std::endl;
+        ++nfailed;
+      }
+    }
+    release (s);
+  }
+
+  std::cout << nchecks - nfailed << " of " << nchecks << " checks of ArrowheadSolver passed" << std::endl;
+  return nfailed ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+/*! \file
+ *  \brief Checks the closest approaches of JBLHelixBatch
+ *
+ * For random pairs of helices, compares the arc lengths of
+ * JBLHelixBatch::getAllClosestApproaches with those of
+ * JBLHelix::getClosestApproach, where the latter is defined.
+ * For circles that do not intersect, separate or nested, checks that
+ * the returned points have the smallest possible distance in (x, y);
+ * nested circles are also set up explicitly, with the inner
+ * circle first and second, and with both signs of the curvature.
+ * Returns 1 if any check fails.
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "JBLHelix.h"
+#include "JBLHelixBatch.h"
+#include "TwoVector.h"
+#include "ThreeVector.h"
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cmath>
+
+namespace {
+  const double tolerance = 1E-9;
+
+  bool close (double a, double b, double scale) {
+    return std::abs (a - b) <= tolerance*scale;
+  }
+
+  // Distance in (x, y) of the points at s0 and s1 of helices i and j
+  double distXY (const JBLHelixBatch& batch, int i, double s0, int j, double s1) {
+    ThreeVector p0, p1;
+    batch.getTrajectoryPointEx (i, s0, p0);
+    batch.getTrajectoryPointEx (j, s1, p1);
+    return std::sqrt ((p0.getX()-p1.getX())*(p0.getX()-p1.getX()) + (p0.getY()-p1.getY())*(p0.getY()-p1.getY()));
+  }
+
+  // Smallest distance in (x, y) of two circles that do not intersect
+  double minDistXY (const JBLHelix& h0, const JBLHelix& h1) {
+    double r0a = std::abs (1/h0.getPar (0));
+    double r1a = std::abs (1/h1.getPar (0));
+    double dist = (h0.getCenterPoint() - h1.getCenterPoint()).getMag();
+    return dist > r0a + r1a ? dist - r0a - r1a : std::abs (r0a - r1a) - dist;
+  }
+
+  // Check the pairs of batch against JBLHelix; returns the number of failures
+  int checkBatch (const std::vector<JBLHelix>& helices, int& nnested) {
+    JBLHelixBatch batch;
+    for (unsigned int i = 0; i < helices.size(); ++i) batch.addHelix (helices[i]);
+    int npairs = batch.getNPairs();
+    std::vector<double> s0 (npairs), s1 (npairs), s02nd (npairs), s12nd (npairs);
+    std::vector<int> result (npairs);
+    batch.getAllClosestApproaches (&s0[0], &s1[0], &s02nd[0], &s12nd[0], &result[0]);
+
+    int nfailed = 0;
+    int ipair = 0;
+    for (unsigned int i = 0; i < helices.size(); ++i) {
+      for (unsigned int j = i+1; j < helices.size(); ++j, ++ipair) {
+        const JBLHelix& h0 = helices[i];
+        const JBLHelix& h1 = helices[j];
+        double scale = 1 + std::abs (1/h0.getPar (0)) + std::abs (1/h1.getPar (0));
+        double dist = (h0.getCenterPoint() - h1.getCenterPoint()).getMag();
+        bool nested = dist < std::abs (std::abs (1/h0.getPar (0)) - std::abs (1/h1.getPar (0)));
+        bool ok = true;
+        if (nested) {
+          ++nnested;
+          ok = result[ipair] == 0;
+        }
+        else {
+          double t0, t1, t02nd, t12nd;
+          int tresult = h0.getClosestApproach (h1, t0, t1, t02nd, t12nd);
+          ok = result[ipair] == tresult
+            && close (s0[ipair], t0, scale) && close (s1[ipair], t1, scale)
+            && close (s02nd[ipair], t02nd, scale) && close (s12nd[ipair], t12nd, scale);
+        }
+        if (ok && result[ipair] == 0) {
+          ok = close (distXY (batch, i, s0[ipair], j, s1[ipair]), minDistXY (h0, h1), scale);
+        }
+        if (!ok) {
+          std::cout << "helices " << i << ", " << j << (nested ? " (nested)" : "")
+                    << ": result " << result[ipair] << ", s0=" << s0[ipair] << ", s1=" << s1[ipair]
+                    << ", distance " << distXY (batch, i, s0[ipair], j, s1[ipair])
+                    << " instead of " << (result[ipair] == 0 ? minDistXY (h0, h1) : 0.) << std::endl;
+          ++nfailed;
+        }
+      }
+    }
+    return nfailed;
+  }
+}
+
+int main() {
+  std::mt19937 rng (4711);
+  std::uniform_real_distribution<double> flat (0, 1);
+
+  int nfailed = 0;
+  int nnested = 0;
+  int nhelices = 0;
+
+  // random helices, with radii from 10 to 1000 and dca up to 50
+  for (int ievent = 0; ievent < 100; ++ievent) {
+    std::vector<JBLHelix> helices;
+    for (int i = 0; i < 20; ++i) {
+      double kappa = (flat (rng) < 0.5 ? -1 : 1)*std::exp (std::log (0.001) + flat (rng)*std::log (100.));
+      helices.push_back (JBLHelix (kappa, 2*M_PI*(flat (rng) - 0.5), 0.2 + 2.7*flat (rng),
+                                   100*(flat (rng) - 0.5), 10*(flat (rng) - 0.5)));
+    }
+    nhelices += helices.size();
+    nfailed += checkBatch (helices, nnested);
+  }
+
+  // nested circles: a helix through the origin with radius 100 (center at (0, 100)
+  // for phi0=0 and positive kappa), and helices with radius 20 inside of it
+  for (int sign0 = -1; sign0 <= 1; sign0 += 2) {
+    for (int sign1 = -1; sign1 <= 1; sign1 += 2) {
+      for (int iphi = 0; iphi < 8; ++iphi) {
+        double phi0 = 2*M_PI*(iphi + 0.5)/8 - M_PI;
+        JBLHelix outer (sign0*0.01, 0, 1, 0, 0);
+        // center of the inner helix at 30 from the outer one's center
+        double xc = 30*std::cos (phi0);
+        double yc = sign0*100 + 30*std::sin (phi0);
+        double r = sign1*20.;
+        // xc = (dca - r)*sin (phi0), yc = -(dca - r)*cos (phi0), for any phi0 of the inner helix
+        double phi0inner = std::atan2 (xc, -yc);
+        double dca = std::sqrt (xc*xc + yc*yc) + r;
+        JBLHelix inner (1/r, phi0inner, 1, dca, 0);
+        std::vector<JBLHelix> helices;
+        helices.push_back (outer);
+        helices.push_back (inner);
+        nfailed += checkBatch (helices, nnested);
+        std::swap (helices[0], helices[1]);
+        nfailed += checkBatch (helices, nnested);
+        nhelices += 4;
+      }
+    }
+  }
+
+  std::cout << nhelices << " helices, " << nnested << " nested pairs, "
+            << nfailed << " failed checks" << std::endl;
+  return nfailed ? 1 : 0;
+}
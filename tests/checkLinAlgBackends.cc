@@ -0,0 +1,261 @@
+/*! \file
+ *  \brief Checks that the fitters give the same results with all LinAlgBackends
+ *
+ * Fits a set of events (hadronic and semileptonic WW, with hard and
+ * soft constraints) with OPALFitterGSL, NewFitterGSL and NewtonFitterGSL,
+ * once with GSLLinAlgBackend and once with SmallLinAlgBackend, and
+ * compares error code, number of iterations, chi2, fitted parameters
+ * and global covariance matrix. Returns 1 if any fit differs.
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "GSLLinAlgBackend.h"
+#include "SmallLinAlgBackend.h"
+#include "JetFitObject.h"
+#include "NeutrinoFitObject.h"
+#include "MomentumConstraint.h"
+#include "MassConstraint.h"
+#include "SoftGaussMassConstraint.h"
+#include "OPALFitterGSL.h"
+#include "NewFitterGSL.h"
+#include "NewtonFitterGSL.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+
+namespace {
+  enum {HADRONIC, HADRONICSOFT, SEMILEPTONIC, NPROBLEMS};
+  const char *problemnames[NPROBLEMS] = {"hadronic", "hadronic, soft W mass", "semileptonic"};
+
+  const double ecm = 500;
+  const double mw = 80.4;
+  const double tolerance = 1E-7;
+
+  // A four-vector
+  struct FourMomentum {
+    double e, px, py, pz;
+  };
+
+  // Measured jets of an event: E, theta, phi
+  struct Event {
+    double e[4], theta[4], phi[4];
+  };
+
+  // The result of a fit
+  struct FitResult {
+    int ierr;
+    int nit;
+    double chi2;
+    std::vector<double> par;
+    std::vector<double> cov;
+  };
+
+  // Decay of a particle of mass m at rest into two massless particles, isotropic
+  void decay (std::mt19937& rng, double m, FourMomentum& p1, FourMomentum& p2) {
+    std::uniform_real_distribution<double> flat (-1, 1);
+    double costheta = flat (rng);
+    double sintheta = std::sqrt (1 - costheta*costheta);
+    double phi = M_PI*flat (rng);
+    double p = 0.5*m;
+    p1.e = p;
+    p1.px = p*sintheta*std::cos (phi);
+    p1.py = p*sintheta*std::sin (phi);
+    p1.pz = p*costheta;
+    p2.e = p;
+    p2.px = -p1.px;
+    p2.py = -p1.py;
+    p2.pz = -p1.pz;
+  }
+
+  // Boost p from the rest frame of a particle with four-momentum b
+  FourMomentum boost (const FourMomentum& p, const FourMomentum& b) {
+    double m = std::sqrt (b.e*b.e - b.px*b.px - b.py*b.py - b.pz*b.pz);
+    double bx = b.px/b.e, by = b.py/b.e, bz = b.pz/b.e;
+    double b2 = bx*bx + by*by + bz*bz;
+    double gamma = b.e/m;
+    double bp = bx*p.px + by*p.py + bz*p.pz;
+    double g2 = b2 > 0 ? (gamma - 1)/b2 : 0;
+    FourMomentum result = {gamma*(p.e + bp),
+                           p.px + g2*bp*bx + gamma*bx*p.e,
+                           p.py + g2*bp*by + gamma*by*p.e,
+                           p.pz + g2*bp*bz + gamma*bz*p.e};
+    return result;
+  }
+
+  // WW production at rest, both Ws decay into two massless particles, which are smeared
+  Event generate (std::mt19937& rng) {
+    std::normal_distribution<double> gauss;
+    FourMomentum w1, w2, d[4];
+    decay (rng, ecm, w1, w2);
+    double pw = std::sqrt (0.25*ecm*ecm - mw*mw)/w1.e;
+    w1.px *= pw; w1.py *= pw; w1.pz *= pw;
+    w2.px *= pw; w2.py *= pw; w2.pz *= pw;
+    decay (rng, mw, d[0], d[1]);
+    decay (rng, mw, d[2], d[3]);
+    for (int i = 0; i < 2; ++i) d[i] = boost (d[i], w1);
+    for (int i = 2; i < 4; ++i) d[i] = boost (d[i], w2);
+
+    Event event;
+    for (int i = 0; i < 4; ++i) {
+      double p = std::sqrt (d[i].px*d[i].px + d[i].py*d[i].py + d[i].pz*d[i].pz);
+      event.e[i]     = d[i].e + 0.3*std::sqrt (d[i].e)*gauss (rng);
+      event.theta[i] = std::acos (d[i].pz/p) + 0.02*gauss (rng);
+      event.phi[i]   = std::atan2 (d[i].py, d[i].px) + 0.02*gauss (rng);
+    }
+    return event;
+  }
+
+  // Set up problem iproblem for event, fit it with fitter and backend linalg
+  FitResult fitEvent (const Event& event, int iproblem, BaseFitter& fitter, const LinAlgBackend& linalg) {
+    std::vector<ParticleFitObject *> fitobjects;
+    for (int i = 0; i < 4; ++i) {
+      if (iproblem == SEMILEPTONIC && i == 3) {
+        // the fourth jet is replaced by a neutrino, with a start value from the momentum balance
+        double px = 0, py = 0, pz = 0;
+        for (int j = 0; j < 3; ++j) {
+          px -= fitobjects[j]->getPx();
+          py -= fitobjects[j]->getPy();
+          pz -= fitobjects[j]->getPz();
+        }
+        double p = std::sqrt (px*px + py*py + pz*pz);
+        NeutrinoFitObject *nu = new NeutrinoFitObject (p, std::acos (pz/p), std::atan2 (py, px), 1, 0.1, 0.1);
+        for (int ilocal = 0; ilocal < 3; ++ilocal) nu->setParam (ilocal, nu->getParam (ilocal), false, false);
+        fitobjects.push_back (nu);
+      }
+      else {
+        double de = (iproblem == SEMILEPTONIC && i == 2) ? 0.001*event.e[i] : 0.3*std::sqrt (event.e[i]);
+        fitobjects.push_back (new JetFitObject (event.e[i], event.theta[i], event.phi[i], de, 0.02, 0.02, 0));
+      }
+    }
+
+    MomentumConstraint pxc (0, 1, 0, 0, 0);
+    MomentumConstraint pyc (0, 0, 1, 0, 0);
+    MomentumConstraint pzc (0, 0, 0, 1, 0);
+    MomentumConstraint ec (1, 0, 0, 0, ecm);
+    MassConstraint equalmass (0);
+    MassConstraint w1 (mw);
+    MassConstraint w2 (mw);
+    SoftGaussMassConstraint softw (2, mw);
+    for (int i = 0; i < 4; ++i) {
+      pxc.addToFOList (*fitobjects[i]);
+      pyc.addToFOList (*fitobjects[i]);
+      pzc.addToFOList (*fitobjects[i]);
+      ec.addToFOList (*fitobjects[i]);
+      equalmass.addToFOList (*fitobjects[i], i < 2 ? 1 : 2);
+      if (i < 2) w1.addToFOList (*fitobjects[i]);
+      else       w2.addToFOList (*fitobjects[i]);
+      if (i < 2) softw.addToFOList (*fitobjects[i]);
+    }
+
+    fitter.reset();
+    fitter.setLinAlgBackend (linalg);
+    for (int i = 0; i < 4; ++i) fitter.addFitObject (fitobjects[i]);
+    fitter.addConstraint (pxc);
+    fitter.addConstraint (pyc);
+    fitter.addConstraint (pzc);
+    fitter.addConstraint (ec);
+    if (iproblem == SEMILEPTONIC) {
+      fitter.addConstraint (w1);
+      fitter.addConstraint (w2);
+    }
+    else {
+      fitter.addConstraint (equalmass);
+    }
+    if (iproblem == HADRONICSOFT) fitter.addSoftConstraint (softw);
+
+    fitter.fit();
+
+    FitResult result;
+    result.ierr = fitter.getError();
+    result.nit  = fitter.getIterations();
+    result.chi2 = fitter.getChi2();
+    for (int i = 0; i < 4; ++i) {
+      for (int ilocal = 0; ilocal < fitobjects[i]->getNPar(); ++ilocal) {
+        result.par.push_back (fitobjects[i]->getParam (ilocal));
+      }
+    }
+    int idim = 0;
+    const double *cov = fitter.getGlobalCovarianceMatrix (idim);
+    if (cov) result.cov.assign (cov, cov + idim*idim);
+
+    fitter.reset();
+    for (int i = 0; i < 4; ++i) delete fitobjects[i];
+    return result;
+  }
+
+  bool close (double a, double b) {
+    return std::abs (a - b) <= tolerance*(1 + std::abs (a) + std::abs (b));
+  }
+
+  // Compare two fit results, print the first difference
+  bool compare (const FitResult& r1, const FitResult& r2) {
+    if (r1.ierr != r2.ierr || r1.nit != r2.nit) {
+      std::cout << "error code " << r1.ierr << " vs. " << r2.ierr
+                << ", iterations " << r1.nit << " vs. " << r2.nit << std::endl;
+      return false;
+    }
+    if (!close (r1.chi2, r2.chi2)) {
+      std::cout << "chi2 " << r1.chi2 << " vs. " << r2.chi2 << std::endl;
+      return false;
+    }
+    for (unsigned int i = 0; i < r1.par.size(); ++i) {
+      if (!close (r1.par[i], r2.par[i])) {
+        std::cout << "parameter " << i << ": " << r1.par[i] << " vs. " << r2.par[i] << std::endl;
+        return false;
+      }
+    }
+    if (r1.cov.size() != r2.cov.size()) {
+      std::cout << "covariance matrix size " << r1.cov.size() << " vs. " << r2.cov.size() << std::endl;
+      return false;
+    }
+    for (unsigned int i = 0; i < r1.cov.size(); ++i) {
+      if (!close (r1.cov[i], r2.cov[i])) {
+        std::cout << "covariance element " << i << ": " << r1.cov[i] << " vs. " << r2.cov[i] << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+int main() {
+  const int nevents = 20;
+  std::mt19937 rng (4711);
+  std::vector<Event> events;
+  for (int ievent = 0; ievent < nevents; ++ievent) events.push_back (generate (rng));
+
+  GSLLinAlgBackend gsl;
+  SmallLinAlgBackend small;
+  OPALFitterGSL opal;
+  NewFitterGSL newfitter;
+  NewtonFitterGSL newton;
+  BaseFitter *fitters[3] = {&opal, &newfitter, &newton};
+  const char *fitternames[3] = {"OPALFitterGSL", "NewFitterGSL", "NewtonFitterGSL"};
+
+  int nfits = 0;
+  int nfailed = 0;
+  for (int iproblem = 0; iproblem < NPROBLEMS; ++iproblem) {
+    for (int ifitter = 0; ifitter < 3; ++ifitter) {
+      if (iproblem == HADRONICSOFT && !fitters[ifitter]->supportsSoftConstraints()) continue;
+      for (int ievent = 0; ievent < nevents; ++ievent) {
+        FitResult r1 = fitEvent (events[ievent], iproblem, *fitters[ifitter], gsl);
+        FitResult r2 = fitEvent (events[ievent], iproblem, *fitters[ifitter], small);
+        ++nfits;
+        if (!compare (r1, r2)) {
+          std::cout << "  in " << fitternames[ifitter] << ", " << problemnames[iproblem]
+                    << ", event " << ievent << std::endl;
+          ++nfailed;
+        }
+      }
+    }
+  }
+
+  std::cout << nfits - nfailed << " of " << nfits << " fits agree between "
+            << gsl.getName() << " and " << small.getName() << std::endl;
+  return nfailed ? 1 : 0;
+}
@@ -0,0 +1,335 @@
+/*! \file
+ *  \brief Checks the start values of StartValueSeeder
+ *
+ * Generates semileptonic WW events with an ISR photon along the beam,
+ * without smearing, so that the true momenta fulfil all constraints.
+ * The neutrino and the photon start far from their true momenta.
+ * Checks MassConstraint::getTargetMass for the objects with flag 1
+ * and 2 of an equal mass constraint, that both solutions of the W mass
+ * quadratic fulfil the W mass constraint and that the true pz is among
+ * them, and that StartValueSeeder::seed keeps the true pz of the neutrino
+ * and sets the true pz of the photon.
+ * Also checks that a photon pz below PzMin is set to zero without a warning.
+ * Returns 1 if any check fails.
+ *
+ * \b Changelog:
+ * - 18.10.2026 First version
+ *
+ */
+
+#include "StartValueSeeder.h"
+#include "JetFitObject.h"
+#include "NeutrinoFitObject.h"
+#include "ISRPhotonFitObject.h"
+#include "MomentumConstraint.h"
+#include "MassConstraint.h"
+#include "NewFitterGSL.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <random>
+#include <cmath>
+
+namespace {
+  const double ecm = 500;
+  const double mw = 80.4;
+  const double tolerance = 1E-7;
+
+  // ISR photon spectrum: b, and |pz| up to 225
+  const double bisr = 0.12;
+  const double pzmaxisr = 225;
+
+  // A four-vector
+  struct FourMomentum {
+    double e, px, py, pz;
+  };
+
+  // A semileptonic WW event with ISR: two jets, lepton, neutrino, photon pz
+  struct Event {
+    FourMomentum d[4];
+    double pzisr;
+  };
+
+  // Decay of a particle of mass m at rest into two massless particles, isotropic
+  void decay (std::mt19937& rng, double m, FourMomentum& p1, FourMomentum& p2) {
+    std::uniform_real_distribution<double> flat (-1, 1);
+    double costheta = flat (rng);
+    double sintheta = std::sqrt (1 - costheta*costheta);
+    double phi = M_PI*flat (rng);
+    double p = 0.5*m;
+    p1.e = p;
+    p1.px = p*sintheta*std::cos (phi);
+    p1.py = p*sintheta*std::sin (phi);
+    p1.pz = p*costheta;
+    p2.e = p;
+    p2.px = -p1.px;
+    p2.py = -p1.py;
+    p2.pz = -p1.pz;
+  }
+
+  // Boost p from the rest frame of a particle with four-momentum b
+  FourMomentum boost (const FourMomentum& p, const FourMomentum& b) {
+    double m = std::sqrt (b.e*b.e - b.px*b.px - b.py*b.py - b.pz*b.pz);
+    double bx = b.px/b.e, by = b.py/b.e, bz = b.pz/b.e;
+    double b2 = bx*bx + by*by + bz*bz;
+    double gamma = b.e/m;
+    double bp = bx*p.px + by*p.py + bz*p.pz;
+    double g2 = b2 > 0 ? (gamma - 1)/b2 : 0;
+    FourMomentum result = {gamma*(p.e + bp),
+                           p.px + g2*bp*bx + gamma*bx*p.e,
+                           p.py + g2*bp*by + gamma*by*p.e,
+                           p.pz + g2*bp*bz + gamma*bz*p.e};
+    return result;
+  }
+
+  // WW production recoiling against a photon with pz pzisr; the second W decays into lepton and neutrino
+  Event generate (std::mt19937& rng, double pzisr) {
+    FourMomentum w1, w2;
+    FourMomentum ww = {ecm - std::abs (pzisr), 0, 0, -pzisr};
+    double mww = std::sqrt (ww.e*ww.e - ww.pz*ww.pz);
+    decay (rng, mww, w1, w2);
+    double pw = std::sqrt (0.25*mww*mww - mw*mw)/w1.e;
+    w1.px *= pw; w1.py *= pw; w1.pz *= pw;
+    w2.px *= pw; w2.py *= pw; w2.pz *= pw;
+    w1 = boost (w1, ww);
+    w2 = boost (w2, ww);
+
+    Event event;
+    decay (rng, mw, event.d[0], event.d[1]);
+    decay (rng, mw, event.d[2], event.d[3]);
+    for (int i = 0; i < 2; ++i) event.d[i] = boost (event.d[i], w1);
+    for (int i = 2; i < 4; ++i) event.d[i] = boost (event.d[i], w2);
+    event.pzisr = pzisr;
+    return event;
+  }
+
+  // Exposes the candidates of the seeder
+  class TestSeeder : public StartValueSeeder {
+    public:
+      // Seed px, py of neutrino nu and return its pz candidates
+      void getCandidates (BaseFitter& fitter, ParticleFitObject *nu, std::vector<double>& candidates) const {
+        seedTransverse (fitter, nu);
+        std::vector<const BaseFitObject *> known (1, nu);
+        findPzCandidates (fitter, nu, known, candidates);
+      }
+  };
+
+  bool close (double a, double b) {
+    return std::abs (a - b) <= tolerance*(1 + std::abs (a) + std::abs (b));
+  }
+
+  // Invariant mass of the sum of the four-momenta of objects
+  double mass (const std::vector<const ParticleFitObject *>& objects) {
+    double e = 0, px = 0, py = 0, pz = 0;
+    for (unsigned int i = 0; i < objects.size(); ++i) {
+      e  += objects[i]->getE();
+      px += objects[i]->getPx();
+      py += objects[i]->getPy();
+      pz += objects[i]->getPz();
+    }
+    return std::sqrt (std::abs (e*e - px*px - py*py - pz*pz));
+  }
+
+  // Check getTargetMass of constraint mc for fo, against the mass of others (the other set)
+  // and the sum of partners (the other objects of the set of fo); returns whether it agrees
+  bool checkTarget (const MassConstraint& mc, const ParticleFitObject *fo, int flag, double target,
+                    const std::vector<const ParticleFitObject *>& partners) {
+    double m, l[4];
+    int result = mc.getTargetMass (fo, m, l);
+    double expected[4] = {0, 0, 0, 0};
+    for (unsigned int i = 0; i < partners.size(); ++i) {
+      expected[0] += partners[i]->getE();
+      expected[1] += partners[i]->getPx();
+      expected[2] += partners[i]->getPy();
+      expected[3] += partners[i]->getPz();
+    }
+    bool ok = result == flag && close (m, target);
+    for (int k = 0; k < 4; ++k) ok = ok && close (l[k], expected[k]);
+    if (!ok) {
+      std::cout << "getTargetMass for " << fo->getName() << ": flag " << result << ", mass " << m
+                << " instead of " << flag << ", " << target << std::endl;
+    }
+    return ok;
+  }
+
+  // Set up the fit of event, seed it, and check the results; returns the number of failed checks
+  int checkEvent (const Event& event, const TestSeeder& seeder, NewFitterGSL& fitter, int& nchecks) {
+    std::vector<ParticleFitObject *> fitobjects;
+    for (int i = 0; i < 3; ++i) {
+      const FourMomentum& d = event.d[i];
+      double p = std::sqrt (d.px*d.px + d.py*d.py + d.pz*d.pz);
+      fitobjects.push_back (new JetFitObject (d.e, std::acos (d.pz/p), std::atan2 (d.py, d.px), 1, 0.02, 0.02, 0));
+    }
+    // far from the true momenta
+    NeutrinoFitObject *nu = new NeutrinoFitObject (10, 0.3, 0, 1, 0.1, 0.1);
+    for (int ilocal = 0; ilocal < 3; ++ilocal) nu->setParam (ilocal, nu->getParam (ilocal), false, false);
+    fitobjects.push_back (nu);
+    ISRPhotonFitObject *photon = new ISRPhotonFitObject (0, 0, -event.pzisr, bisr, std::pow (pzmaxisr, bisr));
+    fitobjects.push_back (photon);
+    fitobjects[0]->setName ("jet1");
+    fitobjects[1]->setName ("jet2");
+    fitobjects[2]->setName ("lepton");
+    nu->setName ("neutrino");
+    photon->setName ("photon");
+
+    MomentumConstraint pxc (0, 1, 0, 0, 0);
+    MomentumConstraint pyc (0, 0, 1, 0, 0);
+    MomentumConstraint pzc (0, 0, 0, 1, 0);
+    MomentumConstraint ec (1, 0, 0, 0, ecm);
+    MassConstraint w1 (mw);
+    MassConstraint w2 (mw);
+    MassConstraint equalmass (0);
+    for (unsigned int i = 0; i < fitobjects.size(); ++i) {
+      pxc.addToFOList (*fitobjects[i]);
+      pyc.addToFOList (*fitobjects[i]);
+      pzc.addToFOList (*fitobjects[i]);
+      ec.addToFOList (*fitobjects[i]);
+      if (i < 2) w1.addToFOList (*fitobjects[i]);
+      else if (i < 4) w2.addToFOList (*fitobjects[i]);
+      if (i < 4) equalmass.addToFOList (*fitobjects[i], i < 2 ? 1 : 2);
+    }
+
+    fitter.reset();
+    for (unsigned int i = 0; i < fitobjects.size(); ++i) fitter.addFitObject (fitobjects[i]);
+    fitter.addConstraint (pxc);
+    fitter.addConstraint (pyc);
+    fitter.addConstraint (pzc);
+    fitter.addConstraint (ec);
+    fitter.addConstraint (w1);
+    fitter.addConstraint (w2);
+
+    int nfailed = 0;
+    std::vector<const ParticleFitObject *> jets (fitobjects.begin(), fitobjects.begin() + 2);
+    std::vector<const ParticleFitObject *> leptons (fitobjects.begin() + 2, fitobjects.begin() + 4);
+
+    // target masses: for a jet (flag 1) the mass of lepton and neutrino, for the neutrino (flag 2) the mass of the jets
+    nchecks += 4;
+    std::vector<const ParticleFitObject *> partners (1, fitobjects[1]);
+    if (!checkTarget (equalmass, fitobjects[0], 1, mass (leptons), partners)) ++nfailed;
+    partners.assign (1, fitobjects[2]);
+    if (!checkTarget (equalmass, nu, 2, mass (jets), partners)) ++nfailed;
+    if (!checkTarget (w2, nu, 1, mw, partners)) ++nfailed;
+    partners.clear();
+    if (!checkTarget (w1, nu, 0, 0, partners)) ++nfailed;
+
+    // the pz candidates: the photon is unknown, so only the W mass gives two candidates
+    std::vector<double> candidates;
+    seeder.getCandidates (fitter, nu, candidates);
+    const FourMomentum& truenu = event.d[3];
+    ++nchecks;
+    if (!close (nu->getPx(), truenu.px) || !close (nu->getPy(), truenu.py)) {
+      std::cout << "neutrino px, py " << nu->getPx() << ", " << nu->getPy()
+                << " instead of " << truenu.px << ", " << truenu.py << std::endl;
+      ++nfailed;
+    }
+    ++nchecks;
+    if (candidates.size() != 2) {
+      std::cout << candidates.size() << " pz candidates instead of 2" << std::endl;
+      ++nfailed;
+    }
+    bool found = false;
+    for (unsigned int k = 0; k < candidates.size(); ++k) {
+      double px = nu->getPx(), py = nu->getPy();
+      double pt = std::sqrt (px*px + py*py);
+      double e = std::sqrt (pt*pt + candidates[k]*candidates[k]);
+      nu->setParam (0, e);
+      nu->setParam (1, std::atan2 (pt, candidates[k]));
+      ++nchecks;
+      if (!close (mass (leptons), mw)) {
+        std::cout << "W mass " << mass (leptons) << " for pz candidate " << candidates[k] << std::endl;
+        ++nfailed;
+      }
+      if (close (candidates[k], truenu.pz)) found = true;
+    }
+    ++nchecks;
+    if (!found) {
+      std::cout << "true neutrino pz " << truenu.pz << " not among the candidates" << std::endl;
+      ++nfailed;
+    }
+
+    // back to the wrong start values, then seed
+    nu->setParam (0, 10);
+    nu->setParam (1, 0.3);
+    nu->setParam (2, 0);
+    photon->setPz (-event.pzisr);
+    seeder.seed (fitter);
+    ++nchecks;
+    if (!close (nu->getPx(), truenu.px) || !close (nu->getPy(), truenu.py) || !close (nu->getPz(), truenu.pz)) {
+      std::cout << "seeded neutrino " << nu->getPx() << ", " << nu->getPy() << ", " << nu->getPz()
+                << " instead of " << truenu.px << ", " << truenu.py << ", " << truenu.pz << std::endl;
+      ++nfailed;
+    }
+    ++nchecks;
+    if (!close (photon->getPz(), event.pzisr)) {
+      std::cout << "seeded photon pz " << photon->getPz() << " instead of " << event.pzisr << std::endl;
+      ++nfailed;
+    }
+    ++nchecks;
+    if (fitter.getConstraintViolation() > tolerance*ecm) {
+      std::cout << "constraint violation " << fitter.getConstraintViolation() << " after seeding" << std::endl;
+      ++nfailed;
+    }
+
+    fitter.reset();
+    for (unsigned int i = 0; i < fitobjects.size(); ++i) delete fitobjects[i];
+    return nfailed;
+  }
+
+  // Seed a photon whose pz from the balance is below PzMin; returns whether it is set to zero without a warning
+  bool checkClipping (const TestSeeder& seeder, NewFitterGSL& fitter) {
+    const double pzmin = 1;
+    ISRPhotonFitObject photon (0, 0, 10, bisr, std::pow (pzmaxisr, bisr), std::pow (pzmin, bisr));
+    JetFitObject jet (100, 1, 0, 1, 0.02, 0.02, 0);
+    MomentumConstraint pzc (0, 0, 0, 1, 0);
+    pzc.addToFOList (jet);
+    pzc.addToFOList (photon);
+    // the photon must balance the pz of the jet, which is below pzmin
+    double pz = -0.5*pzmin;
+    jet.setParam (1, std::acos (-pz/100));
+
+    fitter.reset();
+    fitter.addFitObject (jet);
+    fitter.addFitObject (photon);
+    fitter.addConstraint (pzc);
+
+    std::ostringstream out;
+    std::streambuf *old = std::cout.rdbuf (out.rdbuf());
+    seeder.seed (fitter);
+    std::cout.rdbuf (old);
+    fitter.reset();
+
+    bool ok = out.str().empty() && photon.getPz() == 0;
+    if (!ok) {
+      std::cout << "photon pz " << photon.getPz() << " instead of 0, output: " << out.str() << std::endl;
+    }
+    return ok;
+  }
+}
+
+int main() {
+  std::mt19937 rng (4711);
+  std::uniform_real_distribution<double> flat (-1, 1);
+  TestSeeder seeder;
+  NewFitterGSL fitter;
+
+  int nchecks = 0;
+  int nfailed = 0;
+  for (int ievent = 0; ievent < 50; ++ievent) {
+    // photon pz from 5 to 100, in both directions
+    double u = flat (rng);
+    double pzisr = (u < 0 ? -1 : 1)*(5 + 95*std::abs (u));
+    Event event = generate (rng, pzisr);
+    int n = checkEvent (event, seeder, fitter, nchecks);
+    if (n) {
+      std::cout << "  in event " << ievent << std::endl;
+      nfailed += n;
+    }
+  }
+
+  ++nchecks;
+  if (!checkClipping (seeder, fitter)) ++nfailed;
+
+  std::cout << nchecks - nfailed << " of " << nchecks << " checks of StartValueSeeder passed" << std::endl;
+  return nfailed ? 1 : 0;
+}